@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class AllocStackStressBenchmark {
+    // Larger than the large object threshold, so that the arrays go to the large object space.
+    private static final int LARGE_ARRAY_SIZE = 16 * 1024;
+    // Number of objects each thread keeps alive, so that some of them survive young collections.
+    private static final int LIVE_OBJECTS_PER_THREAD = 256;
+
+    private interface Allocator {
+        Object allocate(int i);
+    }
+
+    private static final Allocator SMALL_OBJECTS = new Allocator() {
+        public Object allocate(int i) {
+            return new Object[4];
+        }
+    };
+
+    private static final Allocator LARGE_ARRAYS = new Allocator() {
+        public Object allocate(int i) {
+            return new byte[LARGE_ARRAY_SIZE];
+        }
+    };
+
+    private static final Allocator MIXED = new Allocator() {
+        public Object allocate(int i) {
+            return ((i & 63) == 0) ? new byte[LARGE_ARRAY_SIZE] : new Object[4];
+        }
+    };
+
+    private static void run(final int count, int numThreads, final Allocator allocator) {
+        final int perThread = Math.max(1, count / numThreads);
+        Thread[] threads = new Thread[numThreads];
+        for (int t = 0; t < numThreads; ++t) {
+            threads[t] = new Thread() {
+                public void run() {
+                    Object[] live = new Object[LIVE_OBJECTS_PER_THREAD];
+                    for (int i = 0; i < perThread; ++i) {
+                        live[i % LIVE_OBJECTS_PER_THREAD] = allocator.allocate(i);
+                    }
+                    if (live[0] == null) {
+                        throw new AssertionError();
+                    }
+                }
+            };
+        }
+        for (Thread thread : threads) {
+            thread.start();
+        }
+        try {
+            for (Thread thread : threads) {
+                thread.join();
+            }
+        } catch (InterruptedException e) {
+            throw new AssertionError(e);
+        }
+    }
+
+    public void timeSmallObjects1Thread(int count) {
+        run(count, 1, SMALL_OBJECTS);
+    }
+
+    public void timeSmallObjects4Threads(int count) {
+        run(count, 4, SMALL_OBJECTS);
+    }
+
+    public void timeSmallObjects16Threads(int count) {
+        run(count, 16, SMALL_OBJECTS);
+    }
+
+    public void timeLargeArrays1Thread(int count) {
+        run(count, 1, LARGE_ARRAYS);
+    }
+
+    public void timeLargeArrays4Threads(int count) {
+        run(count, 4, LARGE_ARRAYS);
+    }
+
+    public void timeLargeArrays16Threads(int count) {
+        run(count, 16, LARGE_ARRAYS);
+    }
+
+    public void timeMixed4Threads(int count) {
+        run(count, 4, MIXED);
+    }
+
+    public void timeMixed16Threads(int count) {
+        run(count, 16, MIXED);
+    }
+}
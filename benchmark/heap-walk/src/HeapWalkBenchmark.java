@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Method;
+
+public class HeapWalkBenchmark {
+    // Number of small objects retained by each benchmark.
+    private static final int NUM_OBJECTS = 100 * 1000;
+    // Size of the arrays separating the small objects in the sparse case.
+    private static final int SPARSE_GAP_SIZE = 256;
+
+    private static class Node {
+        Node next;
+    }
+
+    private static final Method countInstancesOfClass;
+    static {
+        try {
+            Class<?> c = Class.forName("dalvik.system.VMDebug");
+            countInstancesOfClass =
+                c.getDeclaredMethod("countInstancesOfClass", Class.class, Boolean.TYPE);
+        } catch (Exception e) {
+            throw new RuntimeException(e);
+        }
+    }
+
+    private Object[] retained;
+
+    private void retain(boolean sparse) {
+        int stride = sparse ? 2 : 1;
+        retained = new Object[NUM_OBJECTS * stride];
+        for (int i = 0; i < NUM_OBJECTS; ++i) {
+            retained[i * stride] = new Node();
+            if (sparse) {
+                retained[i * stride + 1] = new byte[SPARSE_GAP_SIZE];
+            }
+        }
+        Runtime.getRuntime().gc();
+    }
+
+    private void walk(int count) throws Exception {
+        for (int i = 0; i < count; ++i) {
+            long instances = (Long) countInstancesOfClass.invoke(null, Node.class, false);
+            if (instances < NUM_OBJECTS) {
+                throw new AssertionError("Found only " + instances + " instances");
+            }
+        }
+    }
+
+    public void timeWalkDense(int count) throws Exception {
+        retain(/* sparse= */ false);
+        walk(count);
+        retained = null;
+    }
+
+    public void timeWalkSparse(int count) throws Exception {
+        retain(/* sparse= */ true);
+        walk(count);
+        retained = null;
+    }
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jni.h"
+
+#include "base/macros.h"
+#include "jit/jit_code_index.h"
+
+namespace art {
+namespace {
+
+// Number of compiled methods in the index, typical of a large app after a long run.
+static constexpr uintptr_t kNumMethods = 32 * 1024;
+// Average size of a compiled method.
+static constexpr uintptr_t kMethodSize = 512;
+static constexpr uintptr_t kCodeBase = 0x10000000;
+
+static jit::JitCodeIndex* GetIndex() {
+  // The index never dereferences its entries, so fake code pointers and methods are enough.
+  static jit::JitCodeIndex* index = []() {
+    jit::JitCodeIndex* result = new jit::JitCodeIndex();
+    for (uintptr_t i = 0; i != kNumMethods; ++i) {
+      result->Put(reinterpret_cast<const void*>(kCodeBase + i * kMethodSize),
+                  reinterpret_cast<ArtMethod*>(i + 1u));
+    }
+    return result;
+  }();
+  return index;
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_JitStackWalkBenchmark_lookupPcs(
+    JNIEnv*, jclass, jint reps, jint seed) {
+  jit::JitCodeIndex* index = GetIndex();
+  uint32_t state = static_cast<uint32_t>(seed) | 1u;
+  jlong checksum = 0;
+  for (jint i = 0; i < reps; ++i) {
+    // Pseudo-random pcs, so that consecutive lookups do not hit the same cache lines.
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    uintptr_t pc = kCodeBase + (state % (kNumMethods * kMethodSize));
+    jit::JitCodeIndex::Entry entry = index->Lookup(reinterpret_cast<const void*>(pc));
+    checksum += reinterpret_cast<uintptr_t>(entry.method);
+  }
+  return checksum;
+}
+
+}  // namespace
+}  // namespace art
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class JitStackWalkBenchmark {
+  private static final int DEPTH = 64;
+  private static final int THREADS = 4;
+  private static final int LOOKUPS_PER_REP = 1024;
+
+  public JitStackWalkBenchmark() {
+    System.loadLibrary("artbenchmark");
+    // Get the frames of the stack walk JIT compiled before the benchmark starts.
+    for (int i = 0; i < 10000; ++i) {
+      recurse(DEPTH, /* walk= */ false);
+    }
+    lookupPcs(1, 0);
+  }
+
+  private static int recurse(int depth, boolean walk) {
+    if (depth == 0) {
+      return walk ? new Throwable().getStackTrace().length : 0;
+    }
+    return recurseOdd(depth - 1, walk) + 1;
+  }
+
+  private static int recurseOdd(int depth, boolean walk) {
+    if (depth == 0) {
+      return walk ? new Throwable().getStackTrace().length : 0;
+    }
+    return recurse(depth - 1, walk) + 1;
+  }
+
+  private static void runOnThreads(final Runnable runnable) {
+    Thread[] threads = new Thread[THREADS];
+    for (int i = 0; i < THREADS; ++i) {
+      threads[i] = new Thread(runnable);
+      threads[i].start();
+    }
+    try {
+      for (Thread thread : threads) {
+        thread.join();
+      }
+    } catch (InterruptedException e) {
+      throw new RuntimeException(e);
+    }
+  }
+
+  public void timeStackWalk(int count) {
+    for (int i = 0; i < count; ++i) {
+      recurse(DEPTH, /* walk= */ true);
+    }
+  }
+
+  public void timeStackWalkContended(final int count) {
+    runOnThreads(new Runnable() {
+      public void run() {
+        for (int i = 0; i < count; ++i) {
+          recurse(DEPTH, /* walk= */ true);
+        }
+      }
+    });
+  }
+
+  public void timeLookup(int count) {
+    lookupPcs(count * LOOKUPS_PER_REP, 42);
+  }
+
+  public void timeLookupContended(final int count) {
+    runOnThreads(new Runnable() {
+      public void run() {
+        lookupPcs(count * LOOKUPS_PER_REP, (int) Thread.currentThread().getId());
+      }
+    });
+  }
+
+  private static native long lookupPcs(int reps, int seed);
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Prints the warm-up curve of workloads which the JIT only finds hot late when counting
+// method entries and back-edges. The curve is only meaningful for the first run in a process.
+public class JitWarmupBenchmark {
+  private static final int ROUNDS = 50;
+  private static final int CALLS_PER_ROUND = 200;
+  private static final int ITERATIONS_PER_ROUND = 20000;
+
+  // A long straight-line body: each call takes a lot of interpreter time but only counts once.
+  private static int mix(int seed) {
+    int a = seed * 0x9e3779b9;
+    int b = a ^ (a >>> 16);
+    int c = b * 0x85ebca6b;
+    int d = c ^ (c >>> 13);
+    int e = d * 0xc2b2ae35;
+    int f = e ^ (e >>> 16);
+    int g = (f << 5) - f + a;
+    int h = (g << 7) ^ (b >>> 3);
+    int i = h + c * 31;
+    int j = i ^ (d << 11);
+    int k = (j * 17) + (e >>> 7);
+    int l = k ^ (f * 13);
+    int m = (l << 3) + (g >>> 5);
+    int n = m ^ (h * 7);
+    int o = (n >>> 9) + (i << 2);
+    int p = o ^ (j * 3);
+    int q = (p << 13) - (k >>> 11);
+    int r = q ^ (l * 19);
+    int s = (r >>> 4) + (m << 6);
+    int t = s ^ (n * 23);
+    int u = (t << 9) + (o >>> 2);
+    int v = u ^ (p * 29);
+    int w = (v >>> 6) - (q << 4);
+    int x = w ^ (r * 37);
+    int y = (x << 2) + (s >>> 8);
+    int z = y ^ (t * 41);
+    return z + u + v + w + x + y;
+  }
+
+  private static int straightLine(int round) {
+    int result = 0;
+    for (int i = 0; i < CALLS_PER_ROUND; ++i) {
+      result += mix(round * CALLS_PER_ROUND + i);
+    }
+    return result;
+  }
+
+  // A small loop, which the back-edge counter already finds hot quickly. Sampling should not
+  // make it worse.
+  private static int loop(int round) {
+    int result = round;
+    for (int i = 0; i < ITERATIONS_PER_ROUND; ++i) {
+      result = result * 31 + i;
+    }
+    return result;
+  }
+
+  private interface Workload {
+    int run(int round);
+  }
+
+  private static void printCurve(String name, Workload workload) {
+    int result = 0;
+    for (int round = 0; round < ROUNDS; ++round) {
+      long start = System.nanoTime();
+      result += workload.run(round);
+      long elapsed = System.nanoTime() - start;
+      System.out.println(name + " round " + round + ": " + (elapsed / 1000) + " us");
+    }
+    // Keep the result alive.
+    if (result == 42) {
+      System.out.println();
+    }
+  }
+
+  public static void main(String[] args) {
+    printCurve("StraightLine", new Workload() {
+      public int run(int round) {
+        return straightLine(round);
+      }
+    });
+    printCurve("Loop", new Workload() {
+      public int run(int round) {
+        return loop(round);
+      }
+    });
+  }
+}
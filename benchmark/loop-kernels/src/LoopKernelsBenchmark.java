@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class LoopKernelsBenchmark {
+    private static final int SIZE = 1024;
+
+    private final int[] ints = new int[SIZE];
+    private final int[] ints2 = new int[SIZE];
+    private final long[] longs = new long[SIZE];
+    private final float[] floats = new float[SIZE];
+    private final float[] floats2 = new float[SIZE];
+    private final double[] doubles = new double[SIZE];
+
+    public LoopKernelsBenchmark() {
+        for (int i = 0; i < SIZE; ++i) {
+            ints[i] = i * 7 + 3;
+            ints2[i] = SIZE - i;
+            longs[i] = (long) i * 0x9e3779b9L;
+            floats[i] = i * 0.5f;
+            floats2[i] = 1.0f / (i + 1);
+            doubles[i] = i * 0.25;
+        }
+    }
+
+    private static int $noinline$dotProduct(int[] a, int[] b) {
+        int sum = 0;
+        for (int i = 0; i < a.length; ++i) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+    private static void $noinline$axpy(float alpha, float[] x, float[] y) {
+        for (int i = 0; i < x.length; ++i) {
+            y[i] = alpha * x[i] + y[i];
+        }
+    }
+
+    private static double $noinline$stencil(double[] a) {
+        double sum = 0.0;
+        for (int i = 1; i < a.length - 1; ++i) {
+            sum += a[i - 1] * 0.25 + a[i] * 0.5 + a[i + 1] * 0.25;
+        }
+        return sum;
+    }
+
+    private static long $noinline$hash(long[] a) {
+        long hash = 17;
+        for (int i = 0; i < a.length; ++i) {
+            long v = a[i];
+            v ^= v >>> 33;
+            v *= 0xff51afd7ed558ccdL;
+            hash = hash * 31 + (v ^ (v >>> 29));
+        }
+        return hash;
+    }
+
+    private static int $noinline$gather(int[] indices, int[] values) {
+        int sum = 0;
+        for (int i = 0; i < indices.length; ++i) {
+            sum += values[indices[i] & (values.length - 1)];
+        }
+        return sum;
+    }
+
+    public void timeDotProduct(int count) {
+        for (int i = 0; i < count; ++i) {
+            $noinline$dotProduct(ints, ints2);
+        }
+    }
+
+    public void timeAxpy(int count) {
+        for (int i = 0; i < count; ++i) {
+            $noinline$axpy(0.5f, floats2, floats);
+        }
+    }
+
+    public void timeStencil(int count) {
+        for (int i = 0; i < count; ++i) {
+            $noinline$stencil(doubles);
+        }
+    }
+
+    public void timeHash(int count) {
+        for (int i = 0; i < count; ++i) {
+            $noinline$hash(longs);
+        }
+    }
+
+    public void timeGather(int count) {
+        for (int i = 0; i < count; ++i) {
+            $noinline$gather(ints, ints2);
+        }
+    }
+}
@@ -40,7 +40,8 @@ namespace art {
            lhs.min_methods_to_save_ == rhs.min_methods_to_save_ &&
            lhs.min_classes_to_save_ == rhs.min_classes_to_save_ &&
            lhs.min_notification_before_wake_ == rhs.min_notification_before_wake_ &&
-           lhs.max_notification_before_wake_ == rhs.max_notification_before_wake_;
+           lhs.max_notification_before_wake_ == rhs.max_notification_before_wake_ &&
+           lhs.delta_log_max_bytes_ == rhs.delta_log_max_bytes_;
   }
 
   bool UsuallyEquals(double expected, double actual) {
@@ -489,6 +490,7 @@ TEST_F(CmdlineParserTest, TestJitOptions) {
 */
 TEST_F(CmdlineParserTest, ProfileSaverOptions) {
   ProfileSaverOptions opt = ProfileSaverOptions(true, 1, 2, 3, 4, 5, 6, 7, "abc", true);
+  opt.delta_log_max_bytes_ = 8;
 
   EXPECT_SINGLE_PARSE_VALUE(opt,
                             "-Xjitsaveprofilinginfo "
@@ -499,6 +501,7 @@ TEST_F(CmdlineParserTest, ProfileSaverOptions) {
                             "-Xps-min-notification-before-wake:5 "
                             "-Xps-max-notification-before-wake:6 "
                             "-Xps-inline-cache-threshold:7 "
+                            "-Xps-delta-log-max-bytes:8 "
                             "-Xps-profile-path:abc "
                             "-Xps-profile-boot-class-path",
                             M::ProfileSaverOpts);
@@ -553,6 +553,7 @@ struct XGcOption {
   bool verify_pre_gc_heap_ = false;
   bool verify_pre_sweeping_heap_ = kIsDebugBuild;
   bool generational_cc = kEnableGenerationalCCByDefault;
+  bool generational_cmc = false;
   bool verify_post_gc_heap_ = kIsDebugBuild;
   bool verify_pre_gc_rosalloc_ = kIsDebugBuild;
   bool verify_pre_sweeping_rosalloc_ = false;
@@ -595,6 +596,10 @@ struct CmdlineType<XGcOption> : CmdlineTypeParser<XGcOption> {
         // for compatibility reasons (this should not prevent the runtime from
         // starting up).
         xgc.generational_cc = false;
+      } else if (gc_option == "generational_cmc") {
+        xgc.generational_cmc = true;
+      } else if (gc_option == "nogenerational_cmc") {
+        xgc.generational_cmc = false;
       } else if (gc_option == "postverify") {
         xgc.verify_post_gc_heap_ = true;
       } else if (gc_option == "nopostverify") {
@@ -633,7 +638,8 @@ struct CmdlineType<XGcOption> : CmdlineTypeParser<XGcOption> {
   static const char* Name() { return "XgcOption"; }
   static const char* DescribeType() {
     return "MS|nonconccurent|concurrent|CMS|SS|CC|[no]preverify[_rosalloc]|"
-           "[no]presweepingverify[_rosalloc]|[no]generation_cc|[no]postverify[_rosalloc]|"
+           "[no]presweepingverify[_rosalloc]|[no]generation_cc|[no]generational_cmc|"
+           "[no]postverify[_rosalloc]|"
            "[no]gcstress|measure|[no]precisce|[no]verifycardtable";
   }
 };
@@ -862,6 +868,12 @@ struct CmdlineType<ProfileSaverOptions> : CmdlineTypeParser<ProfileSaverOptions>
       return ParseInto(
           existing, &ProfileSaverOptions::inline_cache_threshold_, type_parser.Parse(suffix));
     }
+    if (option.starts_with("delta-log-max-bytes:")) {
+      CmdlineType<unsigned int> type_parser;
+      return ParseInto(existing,
+             &ProfileSaverOptions::delta_log_max_bytes_,
+             type_parser.Parse(suffix));
+    }
     if (option.starts_with("profile-path:")) {
       existing.profile_path_ = suffix;
       return Result::SuccessNoValue();
@@ -79,7 +79,8 @@ CompilerOptions::CompilerOptions()
       initialize_app_image_classes_(false),
       check_profiled_methods_(ProfileMethodsCheck::kNone),
       max_image_block_size_(std::numeric_limits<uint32_t>::max()),
-      passes_to_run_(nullptr) {
+      passes_to_run_(nullptr),
+      register_allocation_strategy_() {
 }
 
 CompilerOptions::~CompilerOptions() {
@@ -113,6 +114,32 @@ bool CompilerOptions::ParseDumpInitFailures(const std::string& option, std::stri
   return true;
 }
 
+bool CompilerOptions::ParseRegisterAllocationStrategy(const std::string& option,
+                                                      std::string* error_msg) {
+  if (option == "linear-scan") {
+    register_allocation_strategy_ = RegisterAllocator::kRegisterAllocatorLinearScan;
+  } else if (option == "graph-color") {
+    register_allocation_strategy_ = RegisterAllocator::kRegisterAllocatorGraphColor;
+  } else {
+    *error_msg = "Unrecognized register allocation strategy: " + option;
+    return false;
+  }
+  return true;
+}
+
+RegisterAllocator::Strategy CompilerOptions::GetRegisterAllocationStrategy() const {
+  if (register_allocation_strategy_.has_value()) {
+    return register_allocation_strategy_.value();
+  }
+  if (IsAotCompiler() &&
+      !IsBaseline() &&
+      (compiler_filter_ == CompilerFilter::kSpeed ||
+       compiler_filter_ == CompilerFilter::kEverything)) {
+    return RegisterAllocator::kRegisterAllocatorGraphColor;
+  }
+  return RegisterAllocator::kRegisterAllocatorDefault;
+}
+
 bool CompilerOptions::ParseCompilerOptions(const std::vector<std::string>& options,
                                            bool ignore_unrecognized,
                                            std::string* error_msg) {
@@ -18,6 +18,7 @@
 #define ART_COMPILER_DRIVER_COMPILER_OPTIONS_H_
 
 #include <memory>
+#include <optional>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -330,6 +331,11 @@ class CompilerOptions final {
     return passes_to_run_;
   }
 
+  // Returns the register allocator to use. Unless one was selected explicitly, AOT compilation
+  // with the `speed` and `everything` filters, where compile time matters the least, uses graph
+  // coloring and everything else uses linear scan.
+  RegisterAllocator::Strategy GetRegisterAllocationStrategy() const;
+
   bool GetDumpTimings() const {
     return dump_timings_;
   }
@@ -379,6 +385,7 @@ class CompilerOptions final {
 
  private:
   EXPORT bool ParseDumpInitFailures(const std::string& option, std::string* error_msg);
+  EXPORT bool ParseRegisterAllocationStrategy(const std::string& option, std::string* error_msg);
 
   CompilerFilter::Filter compiler_filter_;
   size_t huge_method_threshold_;
@@ -480,6 +487,9 @@ class CompilerOptions final {
   // compiler-dependant behavior.
   const std::vector<std::string>* passes_to_run_;
 
+  // Register allocator selected with --register-allocation-strategy, if any.
+  std::optional<RegisterAllocator::Strategy> register_allocation_strategy_;
+
   friend class Dex2Oat;
   friend class CommonCompilerDriverTest;
   friend class CommonCompilerTestImpl;
@@ -92,6 +92,12 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
     options->check_profiled_methods_ = *map.Get(Base::CheckProfiledMethods);
   }
   map.AssignIfExists(Base::MaxImageBlockSize, &options->max_image_block_size_);
+  if (map.Exists(Base::RegisterAllocationStrategy)) {
+    if (!options->ParseRegisterAllocationStrategy(*map.Get(Base::RegisterAllocationStrategy),
+                                                  error_msg)) {
+      return false;
+    }
+  }
 
   if (map.Exists(Base::DumpTimings)) {
     options->dump_timings_ = true;
@@ -238,12 +244,18 @@ NO_INLINE void AddCompilerOptionsArgumentParserOptions(Builder& b) {
           .template WithType<unsigned int>()
           .WithHelp("Maximum solid block size for compressed images.")
           .IntoKey(Map::MaxImageBlockSize)
+
+      .Define("--register-allocation-strategy=_")
+          .template WithType<std::string>()
+          .WithHelp("Select the register allocator: linear-scan or graph-color.\n"
+                    "Default: graph-color for the speed and everything filters, linear-scan\n"
+                    "otherwise.")
+          .IntoKey(Map::RegisterAllocationStrategy)
       // Obsolete flags
       .Ignore({
         "--num-dex-methods=_",
         "--top-k-profile-threshold=_",
-        "--large-method-max=_",
-        "--register-allocation-strategy=_"
+        "--large-method-max=_"
       });
   // clang-format on
 }
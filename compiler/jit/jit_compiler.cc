@@ -36,6 +36,9 @@
 namespace art HIDDEN {
 namespace jit {
 
+// Dirty arena memory the JIT keeps in its arena pool between compilations.
+static constexpr size_t kMaxRetainedJitArenaBytes = 2 * MB;
+
 JitCompiler* JitCompiler::Create() {
   return new JitCompiler();
 }
@@ -210,9 +213,11 @@ bool JitCompiler::CompileMethod(
     runtime->GetMetrics()->JitMethodCompileCountDelta()->AddOne();
   }
 
-  // If we don't have a new task following this compile,
-  // trim maps to reduce memory usage.
-  if (jit->GetThreadPool() == nullptr || jit->GetThreadPool()->GetTaskCount(self) == 0) {
+  // If we don't have a new task following this compile, trim maps to reduce memory usage.
+  // Keep a few warmed-up arenas though, so that the next small compilations do not fault
+  // their pages in again.
+  if ((jit->GetThreadPool() == nullptr || jit->GetThreadPool()->GetTaskCount(self) == 0) &&
+      runtime->GetJitArenaPool()->GetBytesAllocated() > kMaxRetainedJitArenaBytes) {
     TimingLogger::ScopedTiming t2("TrimMaps", &logger);
     runtime->GetJitArenaPool()->TrimMaps();
   }
@@ -88,7 +88,10 @@ namespace jit {
 //
 class JitLogger {
  public:
-    JitLogger() : code_index_(0), marker_address_(nullptr) {}
+    JitLogger()
+        : write_lock_("JIT logger write lock", kGenericBottomLock),
+          code_index_(0),
+          marker_address_(nullptr) {}
 
     void OpenLog() {
       OpenPerfMapLog();
@@ -96,10 +99,7 @@ class JitLogger {
     }
 
     void WriteLog(const void* ptr, size_t code_size, ArtMethod* method)
-        REQUIRES_SHARED(Locks::mutator_lock_) {
-      WritePerfMapLog(ptr, code_size, method);
-      WriteJitDumpLog(ptr, code_size, method);
-    }
+        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!write_lock_);
 
     void CloseLog() {
       ClosePerfMapLog();
@@ -110,13 +110,13 @@ class JitLogger {
     // For perf-map profiling
     void OpenPerfMapLog();
     void WritePerfMapLog(const void* ptr, size_t code_size, ArtMethod* method)
-        REQUIRES_SHARED(Locks::mutator_lock_);
+        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(write_lock_);
     void ClosePerfMapLog();
 
     // For perf-inject profiling
     void OpenJitDumpLog();
     void WriteJitDumpLog(const void* ptr, size_t code_size, ArtMethod* method)
-        REQUIRES_SHARED(Locks::mutator_lock_);
+        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(write_lock_);
     void CloseJitDumpLog();
 
     void OpenMarkerFile();
@@ -124,6 +124,7 @@ class JitLogger {
     void WriteJitDumpHeader();
     void WriteJitDumpDebugInfo();
 
+    Mutex write_lock_;
     std::unique_ptr<File> perf_file_;
     std::unique_ptr<File> jit_dump_file_;
     uint64_t code_index_;
@@ -442,7 +442,7 @@ bool HBasicBlockBuilder::Build() {
   ConnectBasicBlocks();
   InsertTryBoundaryBlocks();
 
-  if (graph_->IsCompilingOsr()) {
+  if (graph_->HasOsrEntries()) {
     InsertSynthesizedLoopsForOsr();
   }
 
@@ -21,6 +21,7 @@
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 #include "induction_var_range.h"
+#include "jit/profiling_info.h"
 #include "nodes.h"
 #include "side_effects_analysis.h"
 
@@ -525,6 +526,7 @@ class BCEVisitor final : public HGraphVisitor {
                          allocator_.Adapter(kArenaAllocBoundsCheckElimination)),
         finite_loop_(allocator_.Adapter(kArenaAllocBoundsCheckElimination)),
         has_dom_based_dynamic_bce_(false),
+        allow_dynamic_bce_(!HasFailedDynamicBCE(graph)),
         initial_block_size_(graph->GetBlocks().size()),
         side_effects_(side_effects),
         induction_range_(induction_analysis),
@@ -550,7 +552,7 @@ class BCEVisitor final : public HGraphVisitor {
     }
     // We should never deoptimize from an osr method, otherwise we might wrongly optimize
     // code dominated by the deoptimization.
-    if (!GetGraph()->IsCompilingOsr()) {
+    if (!GetGraph()->HasOsrEntries()) {
       AddComparesWithDeoptimization(block);
     }
   }
@@ -840,7 +842,7 @@ class BCEVisitor final : public HGraphVisitor {
     DCHECK(array_length->IsIntConstant() ||
            array_length->IsArrayLength() ||
            array_length->IsPhi());
-    bool try_dynamic_bce = true;
+    bool try_dynamic_bce = allow_dynamic_bce_;
     // Analyze index range.
     if (!index->IsIntConstant()) {
       // Non-constant index.
@@ -1670,6 +1672,15 @@ class BCEVisitor final : public HGraphVisitor {
     }
   }
 
+  /**
+   * Returns true if the JIT compiled code of the method already deoptimized several times
+   * because of dynamic bce, in which case we only eliminate the bounds checks we can prove.
+   */
+  static bool HasFailedDynamicBCE(HGraph* graph) {
+    ProfilingInfo* info = graph->GetProfilingInfo();
+    return info != nullptr && info->HasFailedDynamicBCE();
+  }
+
   /**
    * Returns true if heuristics indicate that dynamic bce may be profitable.
    */
@@ -1682,7 +1693,7 @@ class BCEVisitor final : public HGraphVisitor {
       }
       // We should never deoptimize from an osr method, otherwise we might wrongly optimize
       // code dominated by the deoptimization.
-      if (GetGraph()->IsCompilingOsr()) {
+      if (GetGraph()->HasOsrEntries()) {
         return false;
       }
       // A try boundary preheader is hard to handle.
@@ -2049,6 +2060,9 @@ class BCEVisitor final : public HGraphVisitor {
   // Flag that denotes whether dominator-based dynamic elimination has occurred.
   bool has_dom_based_dynamic_bce_;
 
+  // Flag that denotes whether dynamic elimination may be used at all.
+  const bool allow_dynamic_bce_;
+
   // Initial number of blocks.
   uint32_t initial_block_size_;
 
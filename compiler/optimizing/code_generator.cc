@@ -329,7 +329,8 @@ void CodeGenerator::Compile() {
                                    GetGraph()->GetNumberOfVRegs(),
                                    GetGraph()->IsCompilingBaseline(),
                                    GetGraph()->IsDebuggable(),
-                                   GetGraph()->HasShouldDeoptimizeFlag());
+                                   GetGraph()->HasShouldDeoptimizeFlag(),
+                                   GetGraph()->HasOsrEntries());
 
   size_t frame_start = GetAssembler()->CodeSize();
   GenerateFrameEntry();
@@ -1019,7 +1020,7 @@ CodeGenerator::CodeGenerator(HGraph* graph,
       requires_current_method_(false),
       code_generation_data_(),
       unimplemented_intrinsics_(unimplemented_intrinsics) {
-  if (GetGraph()->IsCompilingOsr()) {
+  if (GetGraph()->HasOsrEntries()) {
     // Make OSR methods have all registers spilled, this simplifies the logic of
     // jumping to the compiled code directly.
     for (size_t i = 0; i < number_of_core_registers_; ++i) {
@@ -1054,7 +1055,7 @@ static void CheckCovers(uint32_t dex_pc,
                         ArenaVector<size_t>* covered) {
   for (size_t i = 0; i < loop_headers.size(); ++i) {
     if (loop_headers[i]->GetDexPc() == dex_pc) {
-      if (graph.IsCompilingOsr()) {
+      if (graph.HasOsrEntries()) {
         DCHECK(code_info.GetOsrStackMapForDexPc(dex_pc).IsValid());
       }
       ++(*covered)[i];
@@ -1216,7 +1217,7 @@ void CodeGenerator::RecordPcInfo(HInstruction* instruction,
   bool osr =
       instruction->IsSuspendCheck() &&
       (info != nullptr) &&
-      graph_->IsCompilingOsr() &&
+      graph_->HasOsrEntries() &&
       (inlining_depth == 0);
   StackMap::Kind kind = native_debug_info
       ? StackMap::Kind::Debug
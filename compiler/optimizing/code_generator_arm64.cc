@@ -6566,7 +6566,7 @@ void LocationsBuilderARM64::VisitReturn(HReturn* instruction) {
 }
 
 void InstructionCodeGeneratorARM64::VisitReturn(HReturn* ret) {
-  if (GetGraph()->IsCompilingOsr()) {
+  if (GetGraph()->HasOsrEntries()) {
     // To simplify callers of an OSR method, we put the return value in both
     // floating point and core register.
     switch (ret->InputAt(0)->GetType()) {
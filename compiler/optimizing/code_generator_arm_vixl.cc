@@ -3583,7 +3583,7 @@ void LocationsBuilderARMVIXL::VisitReturn(HReturn* ret) {
 }
 
 void InstructionCodeGeneratorARMVIXL::VisitReturn(HReturn* ret) {
-  if (GetGraph()->IsCompilingOsr()) {
+  if (GetGraph()->HasOsrEntries()) {
     // To simplify callers of an OSR method, we put the return value in both
     // floating point and core registers.
     switch (ret->InputAt(0)->GetType()) {
@@ -5001,7 +5001,7 @@ void LocationsBuilderRISCV64::VisitReturn(HReturn* instruction) {
 }
 
 void InstructionCodeGeneratorRISCV64::VisitReturn(HReturn* instruction) {
-  if (GetGraph()->IsCompilingOsr()) {
+  if (GetGraph()->HasOsrEntries()) {
     // To simplify callers of an OSR method, we put a floating point return value
     // in both floating point and core return registers.
     DataType::Type type = instruction->InputAt(0)->GetType();
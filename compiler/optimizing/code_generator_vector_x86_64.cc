@@ -25,6 +25,12 @@ namespace x86_64 {
 // NOLINT on __ macro to suppress wrong warning/fix (misc-macro-parentheses) from clang-tidy.
 #define __ down_cast<X86_64Assembler*>(GetAssembler())->  // NOLINT
 
+// With AVX2 the vectorizer may use full 256-bit YMM registers (see GetSIMDRegisterWidth()).
+// The code below then uses VEX.256 encoded instructions and always unaligned memory accesses.
+static bool IsYmmVector(HVecOperation* instruction) {
+  return instruction->GetVectorNumberOfBytes() == 32u;
+}
+
 void LocationsBuilderX86_64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
   HInstruction* input = instruction->InputAt(0);
@@ -65,6 +71,43 @@ void InstructionCodeGeneratorX86_64::VisitVecReplicateScalar(HVecReplicateScalar
     return;
   }
 
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+        __ vpbroadcastb(ymm_dst, dst);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+        __ vpbroadcastw(ymm_dst, dst);
+        break;
+      case DataType::Type::kInt32:
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+        __ vpbroadcastd(ymm_dst, dst);
+        break;
+      case DataType::Type::kInt64:
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ true);
+        __ vpbroadcastq(ymm_dst, dst);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK(locations->InAt(0).Equals(locations->Out()));
+        __ vbroadcastss(ymm_dst, dst);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK(locations->InAt(0).Equals(locations->Out()));
+        __ vbroadcastsd(ymm_dst, dst);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
+
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -144,17 +187,17 @@ void InstructionCodeGeneratorX86_64::VisitVecExtractScalar(HVecExtractScalar* in
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
       UNREACHABLE();
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmVector(instruction) ? 8u : 4u, instruction->GetVectorLength());
       __ movd(locations->Out().AsRegister<CpuRegister>(), src, /*64-bit*/ false);
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmVector(instruction) ? 4u : 2u, instruction->GetVectorLength());
       __ movd(locations->Out().AsRegister<CpuRegister>(), src, /*64-bit*/ true);
       break;
     case DataType::Type::kFloat32:
     case DataType::Type::kFloat64:
       DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 4u);
+      DCHECK_LE(instruction->GetVectorLength(), 8u);
       DCHECK(locations->InAt(0).Equals(locations->Out()));  // no code required
       break;
     default:
@@ -187,8 +230,9 @@ static void CreateVecUnOpLocations(ArenaAllocator* allocator, HVecUnaryOperation
 
 void LocationsBuilderX86_64::VisitVecReduce(HVecReduce* instruction) {
   CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
-  // Long reduction or min/max require a temporary.
+  // Long reduction, 256-bit reduction or min/max require a temporary.
   if (instruction->GetPackedType() == DataType::Type::kInt64 ||
+      IsYmmVector(instruction) ||
       instruction->GetReductionKind() == HVecReduce::kMin ||
       instruction->GetReductionKind() == HVecReduce::kMax) {
     instruction->GetLocations()->AddTemp(Location::RequiresFpuRegister());
@@ -199,6 +243,31 @@ void InstructionCodeGeneratorX86_64::VisitVecReduce(HVecReduce* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    DCHECK_EQ(instruction->GetReductionKind(), HVecReduce::kSum);
+    // Fold the upper 128 bits onto the lower ones, then reduce as for XMM vectors.
+    XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+    __ vextracti128(tmp, YmmRegister(src), Immediate(1));
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpaddd(dst, src, tmp);
+        __ phaddd(dst, dst);
+        __ phaddd(dst, dst);
+        break;
+      case DataType::Type::kInt64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vpaddq(dst, src, tmp);
+        __ movaps(tmp, dst);
+        __ punpckhqdq(tmp, tmp);
+        __ paddq(dst, tmp);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt32:
       DCHECK_EQ(4u, instruction->GetVectorLength());
@@ -247,7 +316,11 @@ void InstructionCodeGeneratorX86_64::VisitVecCnv(HVecCnv* instruction) {
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DataType::Type from = instruction->GetInputType();
   DataType::Type to = instruction->GetResultType();
-  if (from == DataType::Type::kInt32 && to == DataType::Type::kFloat32) {
+  if (from == DataType::Type::kInt32 && to == DataType::Type::kFloat32 &&
+      IsYmmVector(instruction)) {
+    DCHECK_EQ(8u, instruction->GetVectorLength());
+    __ vcvtdq2ps(YmmRegister(dst), YmmRegister(src));
+  } else if (from == DataType::Type::kInt32 && to == DataType::Type::kFloat32) {
     DCHECK_EQ(4u, instruction->GetVectorLength());
     __ cvtdq2ps(dst, src);
   } else {
@@ -263,6 +336,42 @@ void InstructionCodeGeneratorX86_64::VisitVecNeg(HVecNeg* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        __ vpxor(ymm_dst, ymm_dst, ymm_dst);
+        __ vpsubb(ymm_dst, ymm_dst, ymm_src);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpxor(ymm_dst, ymm_dst, ymm_dst);
+        __ vpsubw(ymm_dst, ymm_dst, ymm_src);
+        break;
+      case DataType::Type::kInt32:
+        __ vpxor(ymm_dst, ymm_dst, ymm_dst);
+        __ vpsubd(ymm_dst, ymm_dst, ymm_src);
+        break;
+      case DataType::Type::kInt64:
+        __ vpxor(ymm_dst, ymm_dst, ymm_dst);
+        __ vpsubq(ymm_dst, ymm_dst, ymm_src);
+        break;
+      case DataType::Type::kFloat32:
+        __ vxorps(ymm_dst, ymm_dst, ymm_dst);
+        __ vsubps(ymm_dst, ymm_dst, ymm_src);
+        break;
+      case DataType::Type::kFloat64:
+        __ vxorpd(ymm_dst, ymm_dst, ymm_dst);
+        __ vsubpd(ymm_dst, ymm_dst, ymm_src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
@@ -314,6 +423,29 @@ void InstructionCodeGeneratorX86_64::VisitVecAbs(HVecAbs* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kInt32:
+        __ vpabsd(ymm_dst, ymm_src);
+        break;
+      case DataType::Type::kFloat32:
+        __ vpcmpeqb(ymm_dst, ymm_dst, ymm_dst);  // all ones
+        __ vpsrld(ymm_dst, ymm_dst, Immediate(1));
+        __ vandps(ymm_dst, ymm_dst, ymm_src);
+        break;
+      case DataType::Type::kFloat64:
+        __ vpcmpeqb(ymm_dst, ymm_dst, ymm_dst);  // all ones
+        __ vpsrlq(ymm_dst, ymm_dst, Immediate(1));
+        __ vandpd(ymm_dst, ymm_dst, ymm_src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt32: {
       DCHECK_EQ(4u, instruction->GetVectorLength());
@@ -355,6 +487,41 @@ void InstructionCodeGeneratorX86_64::VisitVecNot(HVecNot* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool: {  // special case boolean-not
+        YmmRegister ymm_tmp(locations->GetTemp(0).AsFpuRegister<XmmRegister>());
+        __ vpxor(ymm_dst, ymm_dst, ymm_dst);
+        __ vpcmpeqb(ymm_tmp, ymm_tmp, ymm_tmp);  // all ones
+        __ vpsubb(ymm_dst, ymm_dst, ymm_tmp);  // 32 x one
+        __ vpxor(ymm_dst, ymm_dst, ymm_src);
+        break;
+      }
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpcmpeqb(ymm_dst, ymm_dst, ymm_dst);  // all ones
+        __ vpxor(ymm_dst, ymm_dst, ymm_src);
+        break;
+      case DataType::Type::kFloat32:
+        __ vpcmpeqb(ymm_dst, ymm_dst, ymm_dst);  // all ones
+        __ vxorps(ymm_dst, ymm_dst, ymm_src);
+        break;
+      case DataType::Type::kFloat64:
+        __ vpcmpeqb(ymm_dst, ymm_dst, ymm_dst);  // all ones
+        __ vxorpd(ymm_dst, ymm_dst, ymm_src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool: {  // special case boolean-not
       DCHECK_EQ(16u, instruction->GetVectorLength());
@@ -452,6 +619,37 @@ void InstructionCodeGeneratorX86_64::VisitVecAdd(HVecAdd* instruction) {
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_dst(dst);
+    YmmRegister ymm_src1(other_src);
+    YmmRegister ymm_src2(src);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        __ vpaddb(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpaddw(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kInt32:
+        __ vpaddd(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kInt64:
+        __ vpaddq(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kFloat32:
+        __ vaddps(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kFloat64:
+        __ vaddpd(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
@@ -490,6 +688,7 @@ void LocationsBuilderX86_64::VisitVecSaturationAdd(HVecSaturationAdd* instructio
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecSaturationAdd(HVecSaturationAdd* instruction) {
+  DCHECK(!IsYmmVector(instruction));
   LocationSummary* locations = instruction->GetLocations();
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
@@ -529,6 +728,23 @@ void InstructionCodeGeneratorX86_64::VisitVecHalvingAdd(HVecHalvingAdd* instruct
 
   DCHECK(instruction->IsRounded());
 
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+        __ vpavgb(ymm_dst, ymm_dst, ymm_src);
+        break;
+      case DataType::Type::kUint16:
+        __ vpavgw(ymm_dst, ymm_dst, ymm_src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
+
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
       DCHECK_EQ(16u, instruction->GetVectorLength());
@@ -559,6 +775,37 @@ void InstructionCodeGeneratorX86_64::VisitVecSub(HVecSub* instruction) {
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_dst(dst);
+    YmmRegister ymm_src1(other_src);
+    YmmRegister ymm_src2(src);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        __ vpsubb(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpsubw(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kInt32:
+        __ vpsubd(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kInt64:
+        __ vpsubq(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kFloat32:
+        __ vsubps(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kFloat64:
+        __ vsubpd(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
@@ -597,6 +844,7 @@ void LocationsBuilderX86_64::VisitVecSaturationSub(HVecSaturationSub* instructio
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecSaturationSub(HVecSaturationSub* instruction) {
+  DCHECK(!IsYmmVector(instruction));
   LocationSummary* locations = instruction->GetLocations();
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
@@ -639,6 +887,30 @@ void InstructionCodeGeneratorX86_64::VisitVecMul(HVecMul* instruction) {
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_dst(dst);
+    YmmRegister ymm_src1(other_src);
+    YmmRegister ymm_src2(src);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpmullw(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kInt32:
+        __ vpmulld(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kFloat32:
+        __ vmulps(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kFloat64:
+        __ vmulpd(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -678,6 +950,23 @@ void InstructionCodeGeneratorX86_64::VisitVecDiv(HVecDiv* instruction) {
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_dst(dst);
+    YmmRegister ymm_src1(other_src);
+    YmmRegister ymm_src2(src);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kFloat32:
+        __ vdivps(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kFloat64:
+        __ vdivpd(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kFloat32:
       DCHECK_EQ(4u, instruction->GetVectorLength());
@@ -698,6 +987,7 @@ void LocationsBuilderX86_64::VisitVecMin(HVecMin* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecMin(HVecMin* instruction) {
+  DCHECK(!IsYmmVector(instruction));
   LocationSummary* locations = instruction->GetLocations();
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
@@ -747,6 +1037,7 @@ void LocationsBuilderX86_64::VisitVecMax(HVecMax* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecMax(HVecMax* instruction) {
+  DCHECK(!IsYmmVector(instruction));
   LocationSummary* locations = instruction->GetLocations();
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
@@ -806,6 +1097,32 @@ void InstructionCodeGeneratorX86_64::VisitVecAnd(HVecAnd* instruction) {
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_dst(dst);
+    YmmRegister ymm_src1(other_src);
+    YmmRegister ymm_src2(src);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpand(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kFloat32:
+        __ vandps(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kFloat64:
+        __ vandpd(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -847,6 +1164,32 @@ void InstructionCodeGeneratorX86_64::VisitVecAndNot(HVecAndNot* instruction) {
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_dst(dst);
+    YmmRegister ymm_src1(other_src);
+    YmmRegister ymm_src2(src);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpandn(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kFloat32:
+        __ vandnps(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kFloat64:
+        __ vandnpd(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -888,6 +1231,32 @@ void InstructionCodeGeneratorX86_64::VisitVecOr(HVecOr* instruction) {
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_dst(dst);
+    YmmRegister ymm_src1(other_src);
+    YmmRegister ymm_src2(src);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpor(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kFloat32:
+        __ vorps(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kFloat64:
+        __ vorpd(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -929,6 +1298,32 @@ void InstructionCodeGeneratorX86_64::VisitVecXor(HVecXor* instruction) {
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_dst(dst);
+    YmmRegister ymm_src1(other_src);
+    YmmRegister ymm_src2(src);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpxor(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kFloat32:
+        __ vxorps(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      case DataType::Type::kFloat64:
+        __ vxorpd(ymm_dst, ymm_src1, ymm_src2);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -982,6 +1377,25 @@ void InstructionCodeGeneratorX86_64::VisitVecShl(HVecShl* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpsllw(ymm_dst, ymm_dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt32:
+        __ vpslld(ymm_dst, ymm_dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt64:
+        __ vpsllq(ymm_dst, ymm_dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -1011,6 +1425,22 @@ void InstructionCodeGeneratorX86_64::VisitVecShr(HVecShr* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpsraw(ymm_dst, ymm_dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt32:
+        __ vpsrad(ymm_dst, ymm_dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -1036,6 +1466,25 @@ void InstructionCodeGeneratorX86_64::VisitVecUShr(HVecUShr* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpsrlw(ymm_dst, ymm_dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt32:
+        __ vpsrld(ymm_dst, ymm_dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt64:
+        __ vpsrlq(ymm_dst, ymm_dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -1094,8 +1543,10 @@ void InstructionCodeGeneratorX86_64::VisitVecSetScalars(HVecSetScalars* instruct
 
   DCHECK_EQ(1u, instruction->InputCount());  // only one input currently implemented
 
-  // Zero out all other elements first.
+  // Zero out all other elements first. For YMM vectors this relies on the
+  // VEX encoding, which also clears the upper 128 bits.
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
+  DCHECK_IMPLIES(IsYmmVector(instruction), cpu_has_avx);
   cpu_has_avx ? __ vxorps(dst, dst, dst) : __ xorps(dst, dst);
 
   // Shorthand for any type of zero.
@@ -1113,19 +1564,19 @@ void InstructionCodeGeneratorX86_64::VisitVecSetScalars(HVecSetScalars* instruct
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
       UNREACHABLE();
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmVector(instruction) ? 8u : 4u, instruction->GetVectorLength());
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>());
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmVector(instruction) ? 4u : 2u, instruction->GetVectorLength());
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>());  // is 64-bit
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmVector(instruction) ? 8u : 4u, instruction->GetVectorLength());
       __ movss(dst, locations->InAt(0).AsFpuRegister<XmmRegister>());
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmVector(instruction) ? 4u : 2u, instruction->GetVectorLength());
       __ movsd(dst, locations->InAt(0).AsFpuRegister<XmmRegister>());
       break;
     default:
@@ -1160,6 +1611,7 @@ void LocationsBuilderX86_64::VisitVecMultiplyAccumulate(HVecMultiplyAccumulate*
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecMultiplyAccumulate(HVecMultiplyAccumulate* instruction) {
+  DCHECK(!IsYmmVector(instruction));
   // TODO: pmaddwd?
   LOG(FATAL) << "No SIMD for " << instruction->GetId();
 }
@@ -1169,6 +1621,7 @@ void LocationsBuilderX86_64::VisitVecSADAccumulate(HVecSADAccumulate* instructio
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecSADAccumulate(HVecSADAccumulate* instruction) {
+  DCHECK(!IsYmmVector(instruction));
   // TODO: psadbw for unsigned?
   LOG(FATAL) << "No SIMD for " << instruction->GetId();
 }
@@ -1190,8 +1643,14 @@ void InstructionCodeGeneratorX86_64::VisitVecDotProd(HVecDotProd* instruction) {
   XmmRegister right = locations->InAt(2).AsFpuRegister<XmmRegister>();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt32: {
-      DCHECK_EQ(4u, instruction->GetVectorLength());
       XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+      if (IsYmmVector(instruction)) {
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpmaddwd(YmmRegister(tmp), YmmRegister(left), YmmRegister(right));
+        __ vpaddd(YmmRegister(acc), YmmRegister(acc), YmmRegister(tmp));
+        break;
+      }
+      DCHECK_EQ(4u, instruction->GetVectorLength());
       if (!cpu_has_avx) {
         __ movaps(tmp, right);
         __ pmaddwd(tmp, left);
@@ -1268,6 +1727,48 @@ void InstructionCodeGeneratorX86_64::VisitVecLoad(HVecLoad* instruction) {
   size_t size = DataType::Size(instruction->GetPackedType());
   Address address = VecAddress(locations, size, instruction->IsStringCharAt());
   XmmRegister reg = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_reg(reg);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kInt16:  // (short) s.charAt(.) can yield HVecLoad/Int16/StringCharAt.
+      case DataType::Type::kUint16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        // Special handling of compressed/uncompressed string load.
+        if (mirror::kUseStringCompression && instruction->IsStringCharAt()) {
+          NearLabel done, not_compressed;
+          uint32_t count_offset = mirror::String::CountOffset().Uint32Value();
+          __ testb(Address(locations->InAt(0).AsRegister<CpuRegister>(), count_offset),
+                   Immediate(1));
+          __ j(kNotZero, &not_compressed);
+          // Zero extend 16 compressed bytes into 16 chars.
+          __ vpmovzxbw(ymm_reg, VecAddress(locations, 1, instruction->IsStringCharAt()));
+          __ jmp(&done);
+          // Load 16 direct uncompressed chars.
+          __ Bind(&not_compressed);
+          __ vmovdqu(ymm_reg, address);
+          __ Bind(&done);
+          return;
+        }
+        FALLTHROUGH_INTENDED;
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vmovdqu(ymm_reg, address);
+        break;
+      case DataType::Type::kFloat32:
+        __ vmovups(ymm_reg, address);
+        break;
+      case DataType::Type::kFloat64:
+        __ vmovupd(ymm_reg, address);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   bool is_aligned16 = instruction->GetAlignment().IsAlignedAt(16);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt16:  // (short) s.charAt(.) can yield HVecLoad/Int16/StringCharAt.
@@ -1327,6 +1828,30 @@ void InstructionCodeGeneratorX86_64::VisitVecStore(HVecStore* instruction) {
   size_t size = DataType::Size(instruction->GetPackedType());
   Address address = VecAddress(locations, size, /*is_string_char_at*/ false);
   XmmRegister reg = locations->InAt(2).AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_reg(reg);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vmovdqu(address, ymm_reg);
+        break;
+      case DataType::Type::kFloat32:
+        __ vmovups(address, ymm_reg);
+        break;
+      case DataType::Type::kFloat64:
+        __ vmovupd(address, ymm_reg);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   bool is_aligned16 = instruction->GetAlignment().IsAlignedAt(16);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
@@ -2718,7 +2718,7 @@ void InstructionCodeGeneratorX86::VisitReturn(HReturn* ret) {
 
     case DataType::Type::kFloat32:
       DCHECK_EQ(ret->GetLocations()->InAt(0).AsFpuRegister<XmmRegister>(), XMM0);
-      if (GetGraph()->IsCompilingOsr()) {
+      if (GetGraph()->HasOsrEntries()) {
         // To simplify callers of an OSR method, we put the return value in both
         // floating point and core registers.
         __ movd(EAX, XMM0);
@@ -2727,7 +2727,7 @@ void InstructionCodeGeneratorX86::VisitReturn(HReturn* ret) {
 
     case DataType::Type::kFloat64:
       DCHECK_EQ(ret->GetLocations()->InAt(0).AsFpuRegister<XmmRegister>(), XMM0);
-      if (GetGraph()->IsCompilingOsr()) {
+      if (GetGraph()->HasOsrEntries()) {
         // To simplify callers of an OSR method, we put the return value in both
         // floating point and core registers.
         __ movd(EAX, XMM0);
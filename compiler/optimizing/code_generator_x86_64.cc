@@ -1205,6 +1205,7 @@ void CodeGeneratorX86_64::GenerateStaticOrDirectCall(
     }
   }
 
+  MaybeEmitVzeroupper();
   switch (invoke->GetCodePtrLocation()) {
     case CodePtrLocation::kCallSelf:
       DCHECK(!GetGraph()->HasShouldDeoptimizeFlag());
@@ -1297,6 +1298,7 @@ void CodeGeneratorX86_64::GenerateVirtualCall(
 
   // temp = temp->GetMethodAt(method_offset);
   __ movq(temp, Address(temp, method_offset));
+  MaybeEmitVzeroupper();
   // call temp->GetEntryPoint();
   __ call(Address(temp, ArtMethod::EntryPointFromQuickCompiledCodeOffset(
       kX86_64PointerSize).SizeValue()));
@@ -1543,7 +1545,9 @@ size_t CodeGeneratorX86_64::RestoreCoreRegister(size_t stack_index, uint32_t reg
 }
 
 size_t CodeGeneratorX86_64::SaveFloatingPointRegister(size_t stack_index, uint32_t reg_id) {
-  if (GetGraph()->HasSIMD()) {
+  if (HasYmmSIMD()) {
+    __ vmovups(Address(CpuRegister(RSP), stack_index), YmmRegister(XmmRegister(reg_id)));
+  } else if (GetGraph()->HasSIMD()) {
     __ movups(Address(CpuRegister(RSP), stack_index), XmmRegister(reg_id));
   } else {
     __ movsd(Address(CpuRegister(RSP), stack_index), XmmRegister(reg_id));
@@ -1552,7 +1556,9 @@ size_t CodeGeneratorX86_64::SaveFloatingPointRegister(size_t stack_index, uint32
 }
 
 size_t CodeGeneratorX86_64::RestoreFloatingPointRegister(size_t stack_index, uint32_t reg_id) {
-  if (GetGraph()->HasSIMD()) {
+  if (HasYmmSIMD()) {
+    __ vmovups(YmmRegister(XmmRegister(reg_id)), Address(CpuRegister(RSP), stack_index));
+  } else if (GetGraph()->HasSIMD()) {
     __ movups(XmmRegister(reg_id), Address(CpuRegister(RSP), stack_index));
   } else {
     __ movsd(XmmRegister(reg_id), Address(CpuRegister(RSP), stack_index));
@@ -1579,9 +1585,17 @@ void CodeGeneratorX86_64::InvokeRuntimeWithoutRecordingPcInfo(int32_t entry_poin
 }
 
 void CodeGeneratorX86_64::GenerateInvokeRuntime(int32_t entry_point_offset) {
+  MaybeEmitVzeroupper();
   __ gs()->call(Address::Absolute(entry_point_offset, /* no_rip= */ true));
 }
 
+void CodeGeneratorX86_64::MaybeEmitVzeroupper() {
+  // Live SIMD values are saved around calls, so the upper halves can be dropped here.
+  if (HasYmmSIMD()) {
+    __ vzeroupper();
+  }
+}
+
 namespace detail {
 
 // Mark which intrinsics we don't have handcrafted code for.
@@ -1965,6 +1979,7 @@ void CodeGeneratorX86_64::GenerateFrameExit() {
       }
     }
   }
+  MaybeEmitVzeroupper();
   __ ret();
   __ cfi().RestoreState();
   __ cfi().DefCFAOffset(GetFrameSize());
@@ -2947,7 +2962,7 @@ void InstructionCodeGeneratorX86_64::VisitReturn(HReturn* ret) {
                 XMM0);
       // To simplify callers of an OSR method, we put the return value in both
       // floating point and core register.
-      if (GetGraph()->IsCompilingOsr()) {
+      if (GetGraph()->HasOsrEntries()) {
         __ movd(CpuRegister(RAX), XmmRegister(XMM0), /* is64bit= */ false);
       }
       break;
@@ -2957,7 +2972,7 @@ void InstructionCodeGeneratorX86_64::VisitReturn(HReturn* ret) {
                 XMM0);
       // To simplify callers of an OSR method, we put the return value in both
       // floating point and core register.
-      if (GetGraph()->IsCompilingOsr()) {
+      if (GetGraph()->HasOsrEntries()) {
         __ movd(CpuRegister(RAX), XmmRegister(XMM0), /* is64bit= */ true);
       }
       break;
@@ -3265,6 +3280,7 @@ void InstructionCodeGeneratorX86_64::VisitInvokeInterface(HInvokeInterface* invo
     Location hidden_reg = locations->GetTemp(1);
     __ movq(hidden_reg.AsRegister<CpuRegister>(), temp);
   }
+  codegen_->MaybeEmitVzeroupper();
   // call temp->GetEntryPoint();
   __ call(Address(
       temp, ArtMethod::EntryPointFromQuickCompiledCodeOffset(kX86_64PointerSize).SizeValue()));
@@ -6463,15 +6479,22 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
     }
   } else if (source.IsSIMDStackSlot()) {
     if (destination.IsFpuRegister()) {
-      __ movups(destination.AsFpuRegister<XmmRegister>(),
-                Address(CpuRegister(RSP), source.GetStackIndex()));
+      if (codegen_->HasYmmSIMD()) {
+        __ vmovups(YmmRegister(destination.AsFpuRegister<XmmRegister>()),
+                   Address(CpuRegister(RSP), source.GetStackIndex()));
+      } else {
+        __ movups(destination.AsFpuRegister<XmmRegister>(),
+                  Address(CpuRegister(RSP), source.GetStackIndex()));
+      }
     } else {
       DCHECK(destination.IsSIMDStackSlot());
-      size_t high = kX86_64WordSize;
-      __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex()));
-      __ movq(Address(CpuRegister(RSP), destination.GetStackIndex()), CpuRegister(TMP));
-      __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex() + high));
-      __ movq(Address(CpuRegister(RSP), destination.GetStackIndex() + high), CpuRegister(TMP));
+      for (size_t offset = 0;
+           offset < codegen_->GetSIMDRegisterWidth();
+           offset += kX86_64WordSize) {
+        __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex() + offset));
+        __ movq(Address(CpuRegister(RSP), destination.GetStackIndex() + offset),
+                CpuRegister(TMP));
+      }
     }
   } else if (source.IsConstant()) {
     HConstant* constant = source.GetConstant();
@@ -6519,7 +6542,13 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
     }
   } else if (source.IsFpuRegister()) {
     if (destination.IsFpuRegister()) {
-      __ movaps(destination.AsFpuRegister<XmmRegister>(), source.AsFpuRegister<XmmRegister>());
+      if (codegen_->HasYmmSIMD()) {
+        // SIMD values and scalars share the same location kind, so copy the full register.
+        __ vmovaps(YmmRegister(destination.AsFpuRegister<XmmRegister>()),
+                   YmmRegister(source.AsFpuRegister<XmmRegister>()));
+      } else {
+        __ movaps(destination.AsFpuRegister<XmmRegister>(), source.AsFpuRegister<XmmRegister>());
+      }
     } else if (destination.IsStackSlot()) {
       __ movss(Address(CpuRegister(RSP), destination.GetStackIndex()),
                source.AsFpuRegister<XmmRegister>());
@@ -6528,8 +6557,13 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
                source.AsFpuRegister<XmmRegister>());
     } else {
        DCHECK(destination.IsSIMDStackSlot());
-      __ movups(Address(CpuRegister(RSP), destination.GetStackIndex()),
-                source.AsFpuRegister<XmmRegister>());
+      if (codegen_->HasYmmSIMD()) {
+        __ vmovups(Address(CpuRegister(RSP), destination.GetStackIndex()),
+                   YmmRegister(source.AsFpuRegister<XmmRegister>()));
+      } else {
+        __ movups(Address(CpuRegister(RSP), destination.GetStackIndex()),
+                  source.AsFpuRegister<XmmRegister>());
+      }
     }
   }
 }
@@ -6564,12 +6598,20 @@ void ParallelMoveResolverX86_64::Exchange64(XmmRegister reg, int mem) {
   __ movd(reg, CpuRegister(TMP));
 }
 
-void ParallelMoveResolverX86_64::Exchange128(XmmRegister reg, int mem) {
-  size_t extra_slot = 2 * kX86_64WordSize;
+void ParallelMoveResolverX86_64::ExchangeSIMD(XmmRegister reg, int mem) {
+  size_t extra_slot = codegen_->GetSIMDRegisterWidth();
   __ subq(CpuRegister(RSP), Immediate(extra_slot));
-  __ movups(Address(CpuRegister(RSP), 0), XmmRegister(reg));
-  ExchangeMemory64(0, mem + extra_slot, 2);
-  __ movups(XmmRegister(reg), Address(CpuRegister(RSP), 0));
+  if (codegen_->HasYmmSIMD()) {
+    __ vmovups(Address(CpuRegister(RSP), 0), YmmRegister(reg));
+  } else {
+    __ movups(Address(CpuRegister(RSP), 0), XmmRegister(reg));
+  }
+  ExchangeMemory64(0, mem + extra_slot, extra_slot / kX86_64WordSize);
+  if (codegen_->HasYmmSIMD()) {
+    __ vmovups(YmmRegister(reg), Address(CpuRegister(RSP), 0));
+  } else {
+    __ movups(XmmRegister(reg), Address(CpuRegister(RSP), 0));
+  }
   __ addq(CpuRegister(RSP), Immediate(extra_slot));
 }
 
@@ -6625,6 +6667,13 @@ void ParallelMoveResolverX86_64::EmitSwap(size_t index) {
     Exchange64(destination.AsRegister<CpuRegister>(), source.GetStackIndex());
   } else if (source.IsDoubleStackSlot() && destination.IsDoubleStackSlot()) {
     ExchangeMemory64(destination.GetStackIndex(), source.GetStackIndex(), 1);
+  } else if (source.IsFpuRegister() && destination.IsFpuRegister() && codegen_->HasYmmSIMD()) {
+    // Swap the full YMM registers without a temporary.
+    YmmRegister reg1(source.AsFpuRegister<XmmRegister>());
+    YmmRegister reg2(destination.AsFpuRegister<XmmRegister>());
+    __ vxorps(reg1, reg1, reg2);
+    __ vxorps(reg2, reg2, reg1);
+    __ vxorps(reg1, reg1, reg2);
   } else if (source.IsFpuRegister() && destination.IsFpuRegister()) {
     __ movd(CpuRegister(TMP), source.AsFpuRegister<XmmRegister>());
     __ movaps(source.AsFpuRegister<XmmRegister>(), destination.AsFpuRegister<XmmRegister>());
@@ -6638,11 +6687,13 @@ void ParallelMoveResolverX86_64::EmitSwap(size_t index) {
   } else if (source.IsDoubleStackSlot() && destination.IsFpuRegister()) {
     Exchange64(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
   } else if (source.IsSIMDStackSlot() && destination.IsSIMDStackSlot()) {
-    ExchangeMemory64(destination.GetStackIndex(), source.GetStackIndex(), 2);
+    ExchangeMemory64(destination.GetStackIndex(),
+                     source.GetStackIndex(),
+                     codegen_->GetSIMDRegisterWidth() / kX86_64WordSize);
   } else if (source.IsFpuRegister() && destination.IsSIMDStackSlot()) {
-    Exchange128(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
+    ExchangeSIMD(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
   } else if (destination.IsFpuRegister() && source.IsSIMDStackSlot()) {
-    Exchange128(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
+    ExchangeSIMD(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
   } else {
     LOG(FATAL) << "Unimplemented swap between " << source << " and " << destination;
   }
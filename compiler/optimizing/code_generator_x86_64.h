@@ -214,7 +214,7 @@ class ParallelMoveResolverX86_64 : public ParallelMoveResolverWithSwap {
   void Exchange64(CpuRegister reg1, CpuRegister reg2);
   void Exchange64(CpuRegister reg, int mem);
   void Exchange64(XmmRegister reg, int mem);
-  void Exchange128(XmmRegister reg, int mem);
+  void ExchangeSIMD(XmmRegister reg, int mem);
   void ExchangeMemory32(int mem1, int mem2);
   void ExchangeMemory64(int mem1, int mem2, int num_of_qwords);
 
@@ -440,10 +440,22 @@ class CodeGeneratorX86_64 : public CodeGenerator {
     return 1 * kX86_64WordSize;
   }
 
+  // With AVX2 the vectorizer uses the full 256-bit YMM registers, otherwise 128-bit XMM ones.
   size_t GetSIMDRegisterWidth() const override {
-    return 2 * kX86_64WordSize;
+    return (GetInstructionSetFeatures().HasAVX() && GetInstructionSetFeatures().HasAVX2())
+        ? 4 * kX86_64WordSize
+        : 2 * kX86_64WordSize;
   }
 
+  // Whether SIMD values in this graph live in YMM registers.
+  bool HasYmmSIMD() const {
+    return GetGraph()->HasSIMD() && GetSIMDRegisterWidth() == 4 * kX86_64WordSize;
+  }
+
+  // Clear the upper YMM halves before leaving code that used them, to avoid the
+  // AVX-SSE transition penalty in the callee or caller.
+  void MaybeEmitVzeroupper();
+
   HGraphVisitor* GetLocationBuilder() override {
     return &location_builder_;
   }
@@ -454,7 +454,7 @@ void CodeSinking::SinkCodeToUncommonBranch(HBasicBlock* end_block) {
           if (graph_->IsDebuggable() ||
               user->IsDeoptimize() ||
               user->CanThrowIntoCatchBlock() ||
-              (user->IsSuspendCheck() && graph_->IsCompilingOsr())) {
+              (user->IsSuspendCheck() && graph_->HasOsrEntries())) {
             can_move = false;
             break;
           }
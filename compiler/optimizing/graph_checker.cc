@@ -433,7 +433,7 @@ void GraphChecker::VisitBoundsCheck(HBoundsCheck* check) {
 
 void GraphChecker::VisitDeoptimize(HDeoptimize* deopt) {
   VisitInstruction(deopt);
-  if (GetGraph()->IsCompilingOsr()) {
+  if (GetGraph()->HasOsrEntries()) {
     AddError(StringPrintf("A graph compiled OSR cannot have a HDeoptimize instruction"));
   }
 }
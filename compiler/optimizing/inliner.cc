@@ -70,6 +70,10 @@ static constexpr size_t kMaximumNumberOfRecursiveCalls = 4;
 // recursive calls at all.
 static constexpr size_t kMaximumNumberOfPolymorphicRecursiveCalls = 0;
 
+// Limit the number of receivers of a megamorphic call that get a guarded direct call,
+// as every guard is paid by the receivers falling through to the generic dispatch.
+static constexpr size_t kMaximumNumberOfMegamorphicDispatchTargets = 3;
+
 // Controls the use of inline caches in AOT mode.
 static constexpr bool kUseAOTInlineCaches = true;
 
@@ -371,7 +375,7 @@ ArtMethod* HInliner::FindMethodFromCHA(ArtMethod* resolved_method) {
     // offline information.
     return nullptr;
   }
-  if (outermost_graph_->IsCompilingOsr()) {
+  if (outermost_graph_->HasOsrEntries()) {
     // We do not support HDeoptimize in OSR methods.
     return nullptr;
   }
@@ -621,7 +625,18 @@ bool HInliner::UseOnlyPolymorphicInliningWithNoDeopt() {
   //
   // For OSR:
   //     We may come from the interpreter and it may have seen different receiver types.
-  return Runtime::Current()->IsAotCompiler() || outermost_graph_->IsCompilingOsr();
+  return Runtime::Current()->IsAotCompiler() || outermost_graph_->HasOsrEntries();
+}
+
+bool HInliner::HasFailedSpeculationJIT(HInvoke* invoke_instruction) {
+  // If the optimized code of the method already deoptimized at this call site several times, the
+  // receiver types keep changing and guarding the inlined code with a deoptimization would only
+  // send us back to the interpreter again. The JIT then recompiles the method without it.
+  if (!codegen_->GetCompilerOptions().IsJitCompiler()) {
+    return false;
+  }
+  InlineCache* cache = FindInlineCacheJIT(invoke_instruction);
+  return cache != nullptr && cache->HasFailedSpeculation();
 }
 bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
     REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -655,7 +670,7 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
 
     case kInlineCacheMonomorphic: {
       MaybeRecordStat(stats_, MethodCompilationStat::kMonomorphicCall);
-      if (UseOnlyPolymorphicInliningWithNoDeopt()) {
+      if (UseOnlyPolymorphicInliningWithNoDeopt() || HasFailedSpeculationJIT(invoke_instruction)) {
         return TryInlinePolymorphicCall(invoke_instruction, classes);
       } else {
         return TryInlineMonomorphicCall(invoke_instruction, classes);
@@ -673,7 +688,7 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
           << invoke_instruction->GetMethodReference().PrettyMethod()
           << " is megamorphic and not inlined";
       MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
-      return false;
+      return TryDispatchMegamorphicCall(invoke_instruction, classes);
     }
 
     case kInlineCacheMissingTypes: {
@@ -686,9 +701,7 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
   }
 }
 
-HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
-    HInvoke* invoke_instruction,
-    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
+InlineCache* HInliner::FindInlineCacheJIT(HInvoke* invoke_instruction) {
   DCHECK(codegen_->GetCompilerOptions().IsJitCompiler());
 
   ArtMethod* caller = graph_->GetArtMethod();
@@ -713,13 +726,17 @@ HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
   if (cache == nullptr) {
     // Check the current graph profiling info.
     profiling_info = graph_->GetProfilingInfo();
-    if (profiling_info == nullptr) {
-      return kInlineCacheNoData;
+    if (profiling_info != nullptr) {
+      cache = profiling_info->GetInlineCache(invoke_instruction->GetDexPc());
     }
-
-    cache = profiling_info->GetInlineCache(invoke_instruction->GetDexPc());
   }
+  return cache;
+}
 
+HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
+    HInvoke* invoke_instruction,
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
+  InlineCache* cache = FindInlineCacheJIT(invoke_instruction);
   if (cache == nullptr) {
     // Either we never hit this invoke and we never compiled the callee,
     // or the method wasn't resolved when we performed baseline compilation.
@@ -1056,10 +1073,13 @@ bool HInliner::TryInlinePolymorphicCall(
     dex::TypeIndex class_index = FindClassIndexIn(handle.Get(), caller_compilation_unit_);
     HInstruction* return_replacement = nullptr;
 
-    // In monomorphic cases when UseOnlyPolymorphicInliningWithNoDeopt() is true, we call
-    // `TryInlinePolymorphicCall` even though we are monomorphic.
+    // In monomorphic cases when UseOnlyPolymorphicInliningWithNoDeopt() or
+    // HasFailedSpeculationJIT() is true, we call `TryInlinePolymorphicCall` even though we are
+    // monomorphic.
+    const bool no_deopt =
+        UseOnlyPolymorphicInliningWithNoDeopt() || HasFailedSpeculationJIT(invoke_instruction);
     const bool actually_monomorphic = number_of_types == 1;
-    DCHECK_IMPLIES(actually_monomorphic, UseOnlyPolymorphicInliningWithNoDeopt());
+    DCHECK_IMPLIES(actually_monomorphic, no_deopt);
 
     // We only want to limit recursive polymorphic cases, not monomorphic ones.
     const bool too_many_polymorphic_recursive_calls =
@@ -1090,7 +1110,7 @@ bool HInliner::TryInlinePolymorphicCall(
 
       // If we have inlined all targets before, and this receiver is the last seen,
       // we deoptimize instead of keeping the original invoke instruction.
-      bool deoptimize = !UseOnlyPolymorphicInliningWithNoDeopt() &&
+      bool deoptimize = !no_deopt &&
           all_targets_inlined &&
           (i + 1 == number_of_types);
 
@@ -1124,6 +1144,77 @@ bool HInliner::TryInlinePolymorphicCall(
   return true;
 }
 
+bool HInliner::TryDispatchMegamorphicCall(
+    HInvoke* invoke_instruction,
+    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes) {
+  // Only the JIT inline caches record the receivers of a megamorphic call. Virtual calls
+  // are not worth guarding, as a vtable dispatch is as cheap as a guarded direct call.
+  if (!codegen_->GetCompilerOptions().IsJitCompiler() ||
+      !invoke_instruction->IsInvokeInterface()) {
+    return false;
+  }
+
+  ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
+  PointerSize pointer_size = class_linker->GetImagePointerSize();
+  uint32_t imt_index = invoke_instruction->AsInvokeInterface()->GetImtIndex();
+
+  size_t number_of_targets = 0;
+  DCHECK_EQ(classes.Capacity(), InlineCache::kIndividualCacheSize);
+  uint8_t number_of_types = classes.Size();
+  for (size_t i = 0;
+       i != number_of_types && number_of_targets != kMaximumNumberOfMegamorphicDispatchTargets;
+       ++i) {
+    DCHECK(classes.GetReference(i) != nullptr);
+    ObjPtr<mirror::Class> klass = classes.GetReference(i)->AsClass();
+    ArtMethod* imt_method = klass->GetImt(pointer_size)->Get(imt_index, pointer_size);
+    if (!imt_method->IsRuntimeMethod() || imt_method->IsImtUnimplementedMethod()) {
+      // The IMT dispatches this receiver without a conflict table walk, a guard would not help.
+      continue;
+    }
+
+    Handle<mirror::Class> handle = graph_->GetHandleCache()->NewHandle(klass);
+    ArtMethod* method = ResolveMethodFromInlineCache(handle, invoke_instruction, pointer_size);
+    dex::TypeIndex class_index = FindClassIndexIn(handle.Get(), caller_compilation_unit_);
+    if (method == nullptr || method->IsAbstract() || !class_index.IsValid()) {
+      continue;
+    }
+    HInvokeStaticOrDirect* direct_invoke = BuildDirectInvoke(invoke_instruction, method);
+    if (direct_invoke == nullptr) {
+      continue;
+    }
+
+    HInstruction* compare = AddTypeGuard(invoke_instruction->InputAt(0),
+                                         invoke_instruction->GetPrevious(),
+                                         invoke_instruction->GetBlock(),
+                                         class_index,
+                                         handle,
+                                         invoke_instruction,
+                                         /* with_deoptimization= */ false);
+    invoke_instruction->GetBlock()->InsertInstructionBefore(direct_invoke, invoke_instruction);
+    direct_invoke->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
+    HInstruction* return_replacement = nullptr;
+    if (invoke_instruction->GetType() != DataType::Type::kVoid) {
+      return_replacement = direct_invoke;
+    }
+    CreateDiamondPatternForPolymorphicInline(compare, return_replacement, invoke_instruction);
+    ++number_of_targets;
+
+    LOG_NOTE() << "Megamorphic call to "
+               << invoke_instruction->GetMethodReference().PrettyMethod()
+               << " dispatches directly to " << method->PrettyMethod();
+  }
+
+  if (number_of_targets == 0u) {
+    return false;
+  }
+
+  MaybeRecordStat(stats_, MethodCompilationStat::kDispatchedMegamorphicCall);
+
+  // Lazily run type propagation to get the guards typed.
+  run_extra_type_propagation_ = true;
+  return true;
+}
+
 void HInliner::CreateDiamondPatternForPolymorphicInline(HInstruction* compare,
                                                         HInstruction* return_replacement,
                                                         HInstruction* invoke_instruction) {
@@ -1293,7 +1384,7 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(
   bb_cursor->InsertInstructionAfter(class_table_get, receiver_class);
   bb_cursor->InsertInstructionAfter(compare, class_table_get);
 
-  if (outermost_graph_->IsCompilingOsr()) {
+  if (outermost_graph_->HasOsrEntries() || HasFailedSpeculationJIT(invoke_instruction)) {
     CreateDiamondPatternForPolymorphicInline(compare, return_replacement, invoke_instruction);
   } else {
     HDeoptimize* deoptimize = new (graph_->GetAllocator()) HDeoptimize(
@@ -1328,33 +1419,27 @@ void HInliner::MaybeRunReferenceTypePropagation(HInstruction* replacement,
   }
 }
 
-bool HInliner::TryDevirtualize(HInvoke* invoke_instruction,
-                               ArtMethod* method,
-                               HInvoke** replacement) {
-  DCHECK(invoke_instruction != *replacement);
-  if (!invoke_instruction->IsInvokeInterface() && !invoke_instruction->IsInvokeVirtual()) {
-    return false;
-  }
-
+HInvokeStaticOrDirect* HInliner::BuildDirectInvoke(HInvoke* invoke_instruction,
+                                                   ArtMethod* method) {
   // Don't try to devirtualize intrinsics as it breaks pattern matching from later phases.
   // TODO(solanes): This `if` could be removed if we update optimizations like
   // TryReplaceStringBuilderAppend.
   if (invoke_instruction->IsIntrinsic()) {
-    return false;
+    return nullptr;
   }
 
   // Don't devirtualize to an intrinsic invalid after the builder phase. The ArtMethod might be an
   // intrinsic even when the HInvoke isn't e.g. java.lang.CharSequence.isEmpty (not an intrinsic)
   // can get devirtualized into java.lang.String.isEmpty (which is an intrinsic).
   if (method->IsIntrinsic() && !IsValidIntrinsicAfterBuilder(method->GetIntrinsic())) {
-    return false;
+    return nullptr;
   }
 
   // Don't bother trying to call directly a default conflict method. It
   // doesn't have a proper MethodReference, but also `GetCanonicalMethod`
   // will return an actual default implementation.
   if (method->IsDefaultConflicting()) {
-    return false;
+    return nullptr;
   }
   DCHECK(!method->IsProxyMethod());
   ClassLinker* cl = Runtime::Current()->GetClassLinker();
@@ -1366,7 +1451,7 @@ bool HInliner::TryDevirtualize(HInvoke* invoke_instruction,
       *invoke_instruction->GetMethodReference().dex_file,
       invoke_instruction->GetMethodReference().index);
   if (dex_method_index == dex::kDexNoIndex) {
-    return false;
+    return nullptr;
   }
   HInvokeStaticOrDirect::DispatchInfo dispatch_info =
       HSharpening::SharpenLoadMethod(method,
@@ -1379,7 +1464,7 @@ bool HInliner::TryDevirtualize(HInvoke* invoke_instruction,
     // the virtual/interface call which will be faster.
     // Also, the entrypoints for runtime calls do not handle devirtualized
     // calls.
-    return false;
+    return nullptr;
   }
 
   HInvokeStaticOrDirect* new_invoke = new (graph_->GetAllocator()) HInvokeStaticOrDirect(
@@ -1403,11 +1488,26 @@ bool HInliner::TryDevirtualize(HInvoke* invoke_instruction,
     new_invoke->SetRawInputAt(new_invoke->GetCurrentMethodIndexUnchecked(),
                               graph_->GetCurrentMethod());
   }
-  invoke_instruction->GetBlock()->InsertInstructionBefore(new_invoke, invoke_instruction);
-  new_invoke->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
   if (invoke_instruction->GetType() == DataType::Type::kReference) {
     new_invoke->SetReferenceTypeInfoIfValid(invoke_instruction->GetReferenceTypeInfo());
   }
+  return new_invoke;
+}
+
+bool HInliner::TryDevirtualize(HInvoke* invoke_instruction,
+                               ArtMethod* method,
+                               HInvoke** replacement) {
+  DCHECK(invoke_instruction != *replacement);
+  if (!invoke_instruction->IsInvokeInterface() && !invoke_instruction->IsInvokeVirtual()) {
+    return false;
+  }
+
+  HInvokeStaticOrDirect* new_invoke = BuildDirectInvoke(invoke_instruction, method);
+  if (new_invoke == nullptr) {
+    return false;
+  }
+  invoke_instruction->GetBlock()->InsertInstructionBefore(new_invoke, invoke_instruction);
+  new_invoke->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
   *replacement = new_invoke;
 
   MaybeReplaceAndRemove(*replacement, invoke_instruction);
@@ -191,6 +191,15 @@ class HInliner : public HOptimization {
                        HInvoke** replacement)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Build, but do not insert, a direct call to `method` with the same arguments as
+  // `invoke_instruction`. Returns null if `method` cannot be called directly.
+  HInvokeStaticOrDirect* BuildDirectInvoke(HInvoke* invoke_instruction, ArtMethod* method)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Return the JIT inline cache of `invoke_instruction`, or null if there is none.
+  InlineCache* FindInlineCacheJIT(HInvoke* invoke_instruction)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Try getting the inline cache from JIT code cache.
   // Return true if the inline cache was successfully allocated and the
   // invoke info was found in the profile info.
@@ -230,9 +239,25 @@ class HInliner : public HOptimization {
       const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // For a megamorphic interface call, dispatch the receivers in the inline cache whose
+  // IMT slot is a conflict through class guards and direct calls, keeping
+  // `invoke_instruction` as the fallback for all other receivers:
+  // if (receiver.getClass() == ic.classes[0]) target0(...)
+  // else if (receiver.getClass() == ic.classes[1]) target1(...)
+  // else invoke_instruction
+  bool TryDispatchMegamorphicCall(
+      HInvoke* invoke_instruction,
+      const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Returns whether or not we should use only polymorphic inlining with no deoptimizations.
   bool UseOnlyPolymorphicInliningWithNoDeopt();
 
+  // Returns whether JIT compiled code already deoptimized at `invoke_instruction` often enough
+  // that the JIT should no longer guard inlined targets with a deoptimization there.
+  bool HasFailedSpeculationJIT(HInvoke* invoke_instruction)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Try CHA-based devirtualization to change virtual method calls into
   // direct calls.
   // Returns the actual method that resolved_method can be devirtualized to.
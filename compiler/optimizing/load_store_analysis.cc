@@ -21,10 +21,6 @@
 
 namespace art HIDDEN {
 
-// A cap for the number of heap locations to prevent pathological time/space consumption.
-// The number of heap locations for most of the methods stays below this threshold.
-constexpr size_t kMaxNumberOfHeapLocations = 32;
-
 // Test if two integer ranges [l1,h1] and [l2,h2] overlap.
 // Note that the ranges are inclusive on both ends.
 //       l1|------|h1
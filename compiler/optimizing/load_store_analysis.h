@@ -570,6 +570,10 @@ class HeapLocationCollector : public HGraphVisitor {
 
 class LoadStoreAnalysis {
  public:
+  // A cap for the number of heap locations to prevent pathological time/space consumption.
+  // The number of heap locations for most of the methods stays below this threshold.
+  static constexpr size_t kMaxNumberOfHeapLocations = 32;
+
   explicit LoadStoreAnalysis(HGraph* graph,
                              OptimizingCompilerStats* stats,
                              ScopedArenaAllocator* local_allocator)
@@ -62,9 +62,29 @@
  *  - In phase 4, we commit the changes, replacing loads marked for elimination
  *    in previous processing and removing stores not marked for keeping. We also
  *    remove allocations that are no longer needed.
- *  - In phase 5, we move allocations which only escape along some executions
- *    closer to their escape points and fixup non-escaping paths with their actual
- *    values, creating PHIs when needed.
+ *
+ * Before phase 1, we move allocations which only escape along some executions
+ * to their escape points, see "0." below.
+ *
+ * 0. Materialize partially escaping allocations.
+ *
+ * An allocation that escapes only on some paths cannot be eliminated as a
+ * singleton. If the escaping instruction is the last use of the allocation on
+ * its path, we insert a copy of the allocation right before it, together with
+ * loads from the original object and stores of these values into the copy, and
+ * let the escaping instruction use the copy. The original allocation is then a
+ * singleton and the loads inserted for the copy are eliminated like any other
+ * load in the following phases, so the object is allocated only on the paths
+ * where it escapes. This applies to instances and to arrays of small constant
+ * length whose elements are accessed with constant indexes.
+ *
+ * Since the original object must be dead once the copy escapes, we never need
+ * to merge the materialized copy with the scalar-replaced values. Allocations
+ * used again after an escape are left for the regular singleton analysis.
+ *
+ * The copies add heap locations of their own. We materialize only after the
+ * load-store analysis succeeded and only as long as the added locations keep
+ * it within its limit, otherwise LSE would not run and remove the originals.
  *
  * 1. Walk over blocks and their instructions.
  *
@@ -2668,6 +2688,304 @@ void LSEVisitor::FinishFullLSE() {
   }
 }
 
+// Moves allocations that escape only along some executions to their escape points,
+// see "0. Materialize partially escaping allocations." above.
+class PartialEscapeMaterializer : public ValueObject {
+ public:
+  PartialEscapeMaterializer(HGraph* graph,
+                            OptimizingCompilerStats* stats,
+                            size_t max_new_heap_locations)
+      : graph_(graph), stats_(stats), max_new_heap_locations_(max_new_heap_locations) {}
+
+  // Returns true if any allocation was materialized.
+  bool Run();
+
+ private:
+  // Do not materialize a single allocation at more escapes than this, the copies are
+  // not free in code size.
+  static constexpr size_t kMaxMaterializations = 4u;
+  // Do not materialize arrays longer than this, each element needs a load and a store.
+  static constexpr int32_t kMaxArrayLength = 4;
+
+  static bool IsCandidate(HInstruction* instruction);
+
+  // Collect the escapes of `allocation`. Returns false if there is none or if any of them
+  // is not an invoke with an environment that we could use for the materialized copy.
+  bool CollectEscapes(HInstruction* allocation,
+                      /*out*/ ScopedArenaVector<HInstruction*>* escapes) const;
+
+  // Collect the field stores defining the state to copy to a materialized object and the
+  // type of stored array elements. Returns false if a use other than `escapes` would keep
+  // the original allocation alive, i.e. the LSEVisitor would not be able to eliminate it.
+  static bool CollectStoresToCopy(HInstruction* allocation,
+                                  ArrayRef<HInstruction* const> escapes,
+                                  /*out*/ ScopedArenaVector<HInstanceFieldSet*>* field_stores,
+                                  /*out*/ DataType::Type* component_type);
+
+  // Returns true if no other use of `allocation` can execute after `escape` without
+  // executing `allocation` again first.
+  bool IsTerminalEscape(HInstruction* allocation, HInstruction* escape) const;
+
+  void Materialize(HInstruction* allocation,
+                   HInstruction* escape,
+                   ArrayRef<HInstanceFieldSet* const> field_stores,
+                   DataType::Type component_type);
+
+  HGraph* const graph_;
+  OptimizingCompilerStats* const stats_;
+  // Upper bound on the number of heap locations that the copies may add.
+  size_t max_new_heap_locations_;
+
+  DISALLOW_COPY_AND_ASSIGN(PartialEscapeMaterializer);
+};
+
+bool PartialEscapeMaterializer::IsCandidate(HInstruction* instruction) {
+  if (instruction->IsNewInstance()) {
+    HNewInstance* new_instance = instruction->AsNewInstance();
+    return !new_instance->IsFinalizable() &&
+           !new_instance->NeedsChecks() &&
+           !new_instance->IsStringAlloc();
+  } else if (instruction->IsNewArray()) {
+    HInstruction* length = instruction->AsNewArray()->GetLength();
+    return length->IsIntConstant() &&
+           length->AsIntConstant()->GetValue() >= 0 &&
+           length->AsIntConstant()->GetValue() <= kMaxArrayLength;
+  } else {
+    return false;
+  }
+}
+
+bool PartialEscapeMaterializer::CollectEscapes(
+    HInstruction* allocation, /*out*/ ScopedArenaVector<HInstruction*>* escapes) const {
+  bool supported = true;
+  LambdaEscapeVisitor visitor([&](HInstruction* escape) {
+    // An escape in the allocation's block is unconditional, there is nothing to gain.
+    // Merges, heap stores, returns and deoptimizations are not supported.
+    if (!escape->IsInvoke() ||
+        !escape->HasEnvironment() ||
+        escape->GetBlock() == allocation->GetBlock()) {
+      supported = false;
+      return false;
+    }
+    if (std::find(escapes->begin(), escapes->end(), escape) == escapes->end()) {
+      if (escapes->size() == kMaxMaterializations) {
+        supported = false;
+        return false;
+      }
+      escapes->push_back(escape);
+    }
+    return true;
+  });
+  VisitEscapes(allocation, visitor);
+  return supported && !escapes->empty();
+}
+
+bool PartialEscapeMaterializer::CollectStoresToCopy(
+    HInstruction* allocation,
+    ArrayRef<HInstruction* const> escapes,
+    /*out*/ ScopedArenaVector<HInstanceFieldSet*>* field_stores,
+    /*out*/ DataType::Type* component_type) {
+  for (const HUseListNode<HInstruction*>& use : allocation->GetUses()) {
+    HInstruction* user = use.GetUser();
+    if (user->IsInstanceFieldGet() || user->IsInstanceFieldSet()) {
+      DCHECK_EQ(use.GetIndex(), 0u);
+      if (user->GetFieldInfo().IsVolatile()) {
+        return false;
+      }
+      if (user->IsInstanceFieldSet()) {
+        MemberOffset offset = user->AsInstanceFieldSet()->GetFieldOffset();
+        auto same_offset = [offset](HInstanceFieldSet* store) {
+          return store->GetFieldOffset() == offset;
+        };
+        if (std::none_of(field_stores->begin(), field_stores->end(), same_offset)) {
+          field_stores->push_back(user->AsInstanceFieldSet());
+        }
+      }
+    } else if (user->IsArrayGet() || user->IsArraySet()) {
+      DCHECK_EQ(use.GetIndex(), 0u);
+      if (!user->InputAt(1)->IsIntConstant()) {
+        return false;
+      }
+      if (user->IsArraySet()) {
+        DataType::Type type = user->AsArraySet()->GetComponentType();
+        if (*component_type != DataType::Type::kVoid && *component_type != type) {
+          return false;
+        }
+        *component_type = type;
+      }
+    } else if (!user->IsConstructorFence() &&
+               std::find(escapes.begin(), escapes.end(), user) == escapes.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PartialEscapeMaterializer::IsTerminalEscape(HInstruction* allocation,
+                                                 HInstruction* escape) const {
+  // Use local allocator to reduce peak memory usage.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  const size_t num_blocks = graph_->GetBlocks().size();
+  ArenaBitVector user_blocks(&allocator, num_blocks, /*expandable=*/ false, kArenaAllocLSE);
+  HBasicBlock* escape_block = escape->GetBlock();
+  for (const HUseListNode<HInstruction*>& use : allocation->GetUses()) {
+    HInstruction* user = use.GetUser();
+    if (user->GetBlock() == escape_block && user != escape && escape->StrictlyDominates(user)) {
+      return false;
+    }
+    user_blocks.SetBit(user->GetBlock()->GetBlockId());
+  }
+
+  // Look for uses in blocks reachable from the escape. This includes the escape itself
+  // if it is in a loop. We do not need to look past the allocation's block as any use
+  // reached through it refers to a new object.
+  ArenaBitVector visited(&allocator, num_blocks, /*expandable=*/ false, kArenaAllocLSE);
+  ScopedArenaVector<HBasicBlock*> worklist(escape_block->GetSuccessors().begin(),
+                                           escape_block->GetSuccessors().end(),
+                                           allocator.Adapter(kArenaAllocLSE));
+  while (!worklist.empty()) {
+    HBasicBlock* block = worklist.back();
+    worklist.pop_back();
+    if (visited.IsBitSet(block->GetBlockId())) {
+      continue;
+    }
+    visited.SetBit(block->GetBlockId());
+    if (block == allocation->GetBlock()) {
+      continue;
+    }
+    if (user_blocks.IsBitSet(block->GetBlockId())) {
+      return false;
+    }
+    worklist.insert(worklist.end(), block->GetSuccessors().begin(), block->GetSuccessors().end());
+  }
+  return true;
+}
+
+void PartialEscapeMaterializer::Materialize(HInstruction* allocation,
+                                            HInstruction* escape,
+                                            ArrayRef<HInstanceFieldSet* const> field_stores,
+                                            DataType::Type component_type) {
+  ArenaAllocator* arena = graph_->GetAllocator();
+  HBasicBlock* block = escape->GetBlock();
+  uint32_t dex_pc = escape->GetDexPc();
+
+  // The copy runs with the state of the escaping instruction.
+  HInstruction* materialized = allocation->Clone(arena);
+  block->InsertInstructionBefore(materialized, escape);
+  materialized->CopyEnvironmentFrom(escape->GetEnvironment());
+  if (materialized->IsNewInstance()) {
+    // Do not merge a class initialization check into the copy, it does not come
+    // from the same dex instruction.
+    materialized->AsNewInstance()->SetPartialMaterialization();
+  }
+
+  // Copy the current values. The loads from the original object shall be replaced
+  // with the known values when the LSEVisitor runs.
+  for (HInstanceFieldSet* store : field_stores) {
+    const FieldInfo& field = store->GetFieldInfo();
+    HInstanceFieldGet* load = new (arena) HInstanceFieldGet(allocation,
+                                                            field.GetField(),
+                                                            field.GetFieldType(),
+                                                            field.GetFieldOffset(),
+                                                            /*is_volatile=*/ false,
+                                                            field.GetFieldIndex(),
+                                                            field.GetDeclaringClassDefIndex(),
+                                                            field.GetDexFile(),
+                                                            dex_pc);
+    block->InsertInstructionBefore(load, escape);
+    HInstanceFieldSet* copy = new (arena) HInstanceFieldSet(materialized,
+                                                            load,
+                                                            field.GetField(),
+                                                            field.GetFieldType(),
+                                                            field.GetFieldOffset(),
+                                                            /*is_volatile=*/ false,
+                                                            field.GetFieldIndex(),
+                                                            field.GetDeclaringClassDefIndex(),
+                                                            field.GetDexFile(),
+                                                            dex_pc);
+    block->InsertInstructionBefore(copy, escape);
+  }
+  if (component_type != DataType::Type::kVoid) {
+    int32_t length = allocation->AsNewArray()->GetLength()->AsIntConstant()->GetValue();
+    for (int32_t i = 0; i != length; ++i) {
+      HInstruction* index = graph_->GetIntConstant(i);
+      HArrayGet* load = new (arena) HArrayGet(allocation, index, component_type, dex_pc);
+      block->InsertInstructionBefore(load, escape);
+      HArraySet* copy = new (arena) HArraySet(materialized, index, load, component_type, dex_pc);
+      if (component_type == DataType::Type::kReference) {
+        // The value comes from an array of the same type.
+        copy->ClearTypeCheck();
+      }
+      block->InsertInstructionBefore(copy, escape);
+    }
+  }
+  const HUseList<HInstruction*>& uses = allocation->GetUses();
+  if (std::any_of(uses.begin(), uses.end(), [](const HUseListNode<HInstruction*>& use) {
+        return use.GetUser()->IsConstructorFence();
+      })) {
+    block->InsertInstructionBefore(
+        new (arena) HConstructorFence(materialized, dex_pc, arena), escape);
+  }
+
+  for (size_t i = 0, size = escape->InputCount(); i != size; ++i) {
+    if (escape->InputAt(i) == allocation) {
+      escape->ReplaceInput(materialized, i);
+    }
+  }
+  MaybeRecordStat(stats_, MethodCompilationStat::kPartialAllocationMoved);
+}
+
+bool PartialEscapeMaterializer::Run() {
+  if (graph_->HasTryCatch()) {
+    // Exceptional edges are not taken into account when looking for uses after an escape.
+    return false;
+  }
+  // Use local allocator to reduce peak memory usage.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HInstruction*> candidates(allocator.Adapter(kArenaAllocLSE));
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      if (IsCandidate(it.Current())) {
+        candidates.push_back(it.Current());
+      }
+    }
+  }
+
+  bool materialized = false;
+  ScopedArenaVector<HInstruction*> escapes(allocator.Adapter(kArenaAllocLSE));
+  ScopedArenaVector<HInstanceFieldSet*> field_stores(allocator.Adapter(kArenaAllocLSE));
+  for (HInstruction* allocation : candidates) {
+    escapes.clear();
+    field_stores.clear();
+    DataType::Type component_type = DataType::Type::kVoid;
+    if (!CollectEscapes(allocation, &escapes) ||
+        !CollectStoresToCopy(allocation, ArrayRef<HInstruction* const>(escapes), &field_stores,
+                             &component_type) ||
+        !std::all_of(escapes.begin(), escapes.end(), [&](HInstruction* escape) {
+          return IsTerminalEscape(allocation, escape);
+        })) {
+      continue;
+    }
+    // Each copy adds a location per copied field or element. Loads of the original's fields
+    // use the locations of the stores we copy, loads of its elements may add new ones.
+    size_t length = (component_type != DataType::Type::kVoid)
+        ? dchecked_integral_cast<size_t>(
+              allocation->AsNewArray()->GetLength()->AsIntConstant()->GetValue())
+        : 0u;
+    size_t new_heap_locations = escapes.size() * (field_stores.size() + length) + length;
+    if (new_heap_locations > max_new_heap_locations_) {
+      continue;
+    }
+    max_new_heap_locations_ -= new_heap_locations;
+    for (HInstruction* escape : escapes) {
+      Materialize(allocation, escape, ArrayRef<HInstanceFieldSet* const>(field_stores),
+                  component_type);
+    }
+    materialized = true;
+  }
+  return materialized;
+}
+
 // The LSEVisitor is a ValueObject (indirectly through base classes) and therefore
 // cannot be directly allocated with an arena allocator, so we need to wrap it.
 class LSEVisitorWrapper : public DeletableArenaObject<kArenaAllocLSE> {
@@ -2692,14 +3010,24 @@ bool LoadStoreElimination::Run() {
     return false;
   }
   ScopedArenaAllocator allocator(graph_->GetArenaStack());
-  LoadStoreAnalysis lsa(graph_, stats_, &allocator);
-  lsa.Run();
-  const HeapLocationCollector& heap_location_collector = lsa.GetHeapLocationCollector();
-  if (heap_location_collector.GetNumberOfHeapLocations() == 0) {
+  std::optional<LoadStoreAnalysis> lsa;
+  lsa.emplace(graph_, stats_, &allocator);
+  lsa->Run();
+  if (lsa->GetHeapLocationCollector().GetNumberOfHeapLocations() == 0) {
     // No HeapLocation information from LSA, skip this optimization.
     return false;
   }
 
+  size_t max_new_heap_locations = LoadStoreAnalysis::kMaxNumberOfHeapLocations -
+                                  lsa->GetHeapLocationCollector().GetNumberOfHeapLocations();
+  if (PartialEscapeMaterializer(graph_, stats_, max_new_heap_locations).Run()) {
+    // Analyze again to include the materialized copies.
+    lsa.emplace(graph_, stats_, &allocator);
+    lsa->Run();
+    DCHECK_NE(lsa->GetHeapLocationCollector().GetNumberOfHeapLocations(), 0u);
+  }
+  const HeapLocationCollector& heap_location_collector = lsa->GetHeapLocationCollector();
+
   // Currently load_store analysis can't handle predicated load/stores; specifically pairs of
   // memory operations with different predicates.
   // TODO: support predicated SIMD.
@@ -2212,4 +2212,200 @@ TEST_F(LoadStoreEliminationTest, DISABLED_PartialLoadPreserved6) {
   EXPECT_INS_RETAINED(call_left);
   EXPECT_INS_RETAINED(call_entry);
 }
+
+// // ENTRY
+// obj = new Obj();
+// obj.field = 3;
+// if (parameter_value) {
+//   // LEFT
+//   // The allocation is materialized here.
+//   escape(obj);
+//   return 1;
+// } else {
+//   // RIGHT
+//   // ELIMINATE
+//   return obj.field;
+// }
+// EXIT
+TEST_F(LoadStoreEliminationTest, PartialEscapeMaterialized) {
+  CreateGraph();
+  AdjacencyListGraph blks(SetupFromAdjacencyList("entry",
+                                                 "exit",
+                                                 {{"entry", "left"},
+                                                  {"entry", "right"},
+                                                  {"left", "exit"},
+                                                  {"right", "exit"}}));
+#define GET_BLOCK(name) HBasicBlock* name = blks.Get(#name)
+  GET_BLOCK(entry);
+  GET_BLOCK(exit);
+  GET_BLOCK(left);
+  GET_BLOCK(right);
+#undef GET_BLOCK
+  HInstruction* bool_value = MakeParam(DataType::Type::kBool);
+  HInstruction* c1 = graph_->GetIntConstant(1);
+  HInstruction* c3 = graph_->GetIntConstant(3);
+
+  HInstruction* cls = MakeLoadClass(entry);
+  HInstruction* new_inst = MakeNewInstance(entry, cls);
+  HInstruction* write_entry = MakeIFieldSet(entry, new_inst, c3, MemberOffset(32));
+  MakeIf(entry, bool_value);
+
+  HInstruction* call_left = MakeInvokeStatic(left, DataType::Type::kVoid, { new_inst });
+  MakeReturn(left, c1);
+
+  HInstruction* read_right =
+      MakeIFieldGet(right, new_inst, DataType::Type::kInt32, MemberOffset(32));
+  HInstruction* return_right = MakeReturn(right, read_right);
+
+  MakeExit(exit);
+
+  PerformLSE(blks);
+
+  EXPECT_INS_REMOVED(new_inst);
+  EXPECT_INS_REMOVED(write_entry);
+  EXPECT_INS_REMOVED(read_right);
+  EXPECT_INS_EQ(return_right->InputAt(0), c3);
+  EXPECT_INS_RETAINED(call_left);
+  HInstruction* materialized = call_left->InputAt(0);
+  ASSERT_TRUE(materialized->IsNewInstance()) << *materialized;
+  EXPECT_EQ(materialized->GetBlock(), left);
+  EXPECT_TRUE(materialized->AsNewInstance()->IsPartialMaterialization());
+  HInstanceFieldSet* write_left = FindSingleInstruction<HInstanceFieldSet>(graph_, left);
+  ASSERT_NE(write_left, nullptr);
+  EXPECT_INS_EQ(write_left->InputAt(0), materialized);
+  EXPECT_INS_EQ(write_left->GetValue(), c3);
+  EXPECT_TRUE(FindSingleInstruction<HInstanceFieldGet>(graph_, left) == nullptr);
+}
+
+// // ENTRY
+// arr = new int[2];
+// arr[0] = 3;
+// if (parameter_value) {
+//   // LEFT
+//   // The allocation is materialized here.
+//   escape(arr);
+//   return 1;
+// } else {
+//   // RIGHT
+//   // ELIMINATE
+//   return arr[0] + arr[1];
+// }
+// EXIT
+TEST_F(LoadStoreEliminationTest, PartialEscapeMaterializedArray) {
+  CreateGraph();
+  AdjacencyListGraph blks(SetupFromAdjacencyList("entry",
+                                                 "exit",
+                                                 {{"entry", "left"},
+                                                  {"entry", "right"},
+                                                  {"left", "exit"},
+                                                  {"right", "exit"}}));
+#define GET_BLOCK(name) HBasicBlock* name = blks.Get(#name)
+  GET_BLOCK(entry);
+  GET_BLOCK(exit);
+  GET_BLOCK(left);
+  GET_BLOCK(right);
+#undef GET_BLOCK
+  HInstruction* bool_value = MakeParam(DataType::Type::kBool);
+  HInstruction* c0 = graph_->GetIntConstant(0);
+  HInstruction* c1 = graph_->GetIntConstant(1);
+  HInstruction* c2 = graph_->GetIntConstant(2);
+  HInstruction* c3 = graph_->GetIntConstant(3);
+
+  HInstruction* cls = MakeLoadClass(entry);
+  HInstruction* new_array = MakeNewArray(entry, cls, c2);
+  HInstruction* write_entry = MakeArraySet(entry, new_array, c0, c3);
+  MakeIf(entry, bool_value);
+
+  HInstruction* call_left = MakeInvokeStatic(left, DataType::Type::kVoid, { new_array });
+  MakeReturn(left, c1);
+
+  HInstruction* read_right_0 = MakeArrayGet(right, new_array, c0, DataType::Type::kInt32);
+  HInstruction* read_right_1 = MakeArrayGet(right, new_array, c1, DataType::Type::kInt32);
+  HInstruction* add = MakeBinOp<HAdd>(right, DataType::Type::kInt32, read_right_0, read_right_1);
+  MakeReturn(right, add);
+
+  MakeExit(exit);
+
+  PerformLSE(blks);
+
+  EXPECT_INS_REMOVED(new_array);
+  EXPECT_INS_REMOVED(write_entry);
+  EXPECT_INS_REMOVED(read_right_0);
+  EXPECT_INS_REMOVED(read_right_1);
+  EXPECT_INS_EQ(add->InputAt(0), c3);
+  EXPECT_INS_EQ(add->InputAt(1), c0);
+  HInstruction* materialized = call_left->InputAt(0);
+  ASSERT_TRUE(materialized->IsNewArray()) << *materialized;
+  EXPECT_EQ(materialized->GetBlock(), left);
+  // The copy of the default value in `arr[1]` is eliminated as well.
+  HArraySet* write_left = FindSingleInstruction<HArraySet>(graph_, left);
+  ASSERT_NE(write_left, nullptr);
+  EXPECT_INS_EQ(write_left->GetArray(), materialized);
+  EXPECT_INS_EQ(write_left->GetIndex(), c0);
+  EXPECT_INS_EQ(write_left->GetValue(), c3);
+  EXPECT_TRUE(FindSingleInstruction<HArrayGet>(graph_, left) == nullptr);
+}
+
+// // ENTRY
+// obj = new Obj();
+// obj.field = 3;
+// // Fill the load-store analysis up to its limit of heap locations.
+// param.f1 = 3;
+// ...
+// param.f31 = 3;
+// if (parameter_value) {
+//   // LEFT
+//   // Not materialized, the copy would push LSA over its limit.
+//   escape(obj);
+//   return 1;
+// } else {
+//   // RIGHT
+//   return obj.field;
+// }
+// EXIT
+TEST_F(LoadStoreEliminationTest, PartialEscapeNotMaterializedOverHeapLocationLimit) {
+  CreateGraph();
+  AdjacencyListGraph blks(SetupFromAdjacencyList("entry",
+                                                 "exit",
+                                                 {{"entry", "left"},
+                                                  {"entry", "right"},
+                                                  {"left", "exit"},
+                                                  {"right", "exit"}}));
+#define GET_BLOCK(name) HBasicBlock* name = blks.Get(#name)
+  GET_BLOCK(entry);
+  GET_BLOCK(exit);
+  GET_BLOCK(left);
+  GET_BLOCK(right);
+#undef GET_BLOCK
+  HInstruction* bool_value = MakeParam(DataType::Type::kBool);
+  HInstruction* param = MakeParam(DataType::Type::kReference);
+  HInstruction* c1 = graph_->GetIntConstant(1);
+  HInstruction* c3 = graph_->GetIntConstant(3);
+
+  HInstruction* cls = MakeLoadClass(entry);
+  HInstruction* new_inst = MakeNewInstance(entry, cls);
+  HInstruction* write_entry = MakeIFieldSet(entry, new_inst, c3, MemberOffset(32));
+  for (size_t i = 1; i != LoadStoreAnalysis::kMaxNumberOfHeapLocations; ++i) {
+    MakeIFieldSet(entry, param, c3, MemberOffset(32 + 4 * i));
+  }
+  MakeIf(entry, bool_value);
+
+  HInstruction* call_left = MakeInvokeStatic(left, DataType::Type::kVoid, { new_inst });
+  MakeReturn(left, c1);
+
+  HInstruction* read_right =
+      MakeIFieldGet(right, new_inst, DataType::Type::kInt32, MemberOffset(32));
+  MakeReturn(right, read_right);
+
+  MakeExit(exit);
+
+  PerformLSE(blks);
+
+  EXPECT_INS_RETAINED(new_inst);
+  EXPECT_INS_RETAINED(write_entry);
+  EXPECT_INS_RETAINED(call_left);
+  EXPECT_INS_EQ(call_left->InputAt(0), new_inst);
+  EXPECT_TRUE(FindSingleInstruction<HNewInstance>(graph_, left) == nullptr);
+  EXPECT_TRUE(FindSingleInstruction<HInstanceFieldSet>(graph_, left) == nullptr);
+}
 }  // namespace art
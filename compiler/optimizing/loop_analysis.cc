@@ -49,6 +49,13 @@ void LoopAnalysis::CalculateLoopBasicProperties(HLoopInformation* loop_info,
       }
     }
 
+    // Track "if" branches inside the loop on a loop-invariant condition; they can be
+    // eliminated by loop unswitching.
+    HIf* hif = block->GetLastInstruction()->AsIfOrNull();
+    if (hif != nullptr && IsLoopInvariantBranch(loop_info, hif)) {
+      analysis_results->invariant_branches_num_++;
+    }
+
     for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
       HInstruction* instruction = it.Current();
       if (it.Current()->GetType() == DataType::Type::kInt64) {
@@ -112,6 +119,8 @@ class ArchDefaultLoopHelper : public ArchNoOptsLoopHelper {
 
   bool IsLoopPeelingEnabled() const override { return true; }
 
+  bool IsLoopUnswitchingEnabled() const override { return true; }
+
   bool IsFullUnrollingBeneficial(LoopAnalysisInfo* analysis_info) const override {
     int64_t trip_count = analysis_info->GetTripCount();
     // We assume that trip count is known.
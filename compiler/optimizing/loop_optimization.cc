@@ -32,6 +32,10 @@ namespace art HIDDEN {
 // Enables vectorization (SIMDization) in the loop optimizer.
 static constexpr bool kEnableVectorization = true;
 
+// Maximum number of a != b runtime tests guarding a vector loop against aliasing of
+// array references.
+static constexpr size_t kMaxArrayRefsDisambiguationTests = 3;
+
 //
 // Static helpers.
 //
@@ -526,8 +530,7 @@ HLoopOptimization::HLoopOptimization(HGraph* graph,
       vector_refs_(nullptr),
       vector_static_peeling_factor_(0),
       vector_dynamic_peeling_candidate_(nullptr),
-      vector_runtime_test_a_(nullptr),
-      vector_runtime_test_b_(nullptr),
+      vector_runtime_tests_(nullptr),
       vector_map_(nullptr),
       vector_permanent_map_(nullptr),
       vector_external_set_(nullptr),
@@ -587,6 +590,8 @@ bool HLoopOptimization::LocalRun() {
   ScopedArenaSafeMap<HInstruction*, HInstruction*> reds(
       std::less<HInstruction*>(), loop_allocator_->Adapter(kArenaAllocLoopOptimization));
   ScopedArenaSet<ArrayReference> refs(loop_allocator_->Adapter(kArenaAllocLoopOptimization));
+  ScopedArenaVector<std::pair<HInstruction*, HInstruction*>> runtime_tests(
+      loop_allocator_->Adapter(kArenaAllocLoopOptimization));
   ScopedArenaSafeMap<HInstruction*, HInstruction*> map(
       std::less<HInstruction*>(), loop_allocator_->Adapter(kArenaAllocLoopOptimization));
   ScopedArenaSafeMap<HInstruction*, HInstruction*> perm(
@@ -598,6 +603,7 @@ bool HLoopOptimization::LocalRun() {
   iset_ = &iset;
   reductions_ = &reds;
   vector_refs_ = &refs;
+  vector_runtime_tests_ = &runtime_tests;
   vector_map_ = &map;
   vector_permanent_map_ = &perm;
   vector_external_set_ = &ext_set;
@@ -608,6 +614,7 @@ bool HLoopOptimization::LocalRun() {
   iset_ = nullptr;
   reductions_ = nullptr;
   vector_refs_ = nullptr;
+  vector_runtime_tests_ = nullptr;
   vector_map_ = nullptr;
   vector_permanent_map_ = nullptr;
   vector_external_set_ = nullptr;
@@ -1052,6 +1059,57 @@ bool HLoopOptimization::TryPeelingForLoopInvariantExitsElimination(LoopAnalysisI
   return true;
 }
 
+bool HLoopOptimization::TryUnswitchingForLoopInvariantCondition(LoopAnalysisInfo* analysis_info,
+                                                                bool generate_code) {
+  HLoopInformation* loop_info = analysis_info->GetLoopInfo();
+  if (!arch_loop_helper_->IsLoopUnswitchingEnabled()) {
+    return false;
+  }
+
+  if (analysis_info->GetNumberOfInvariantBranches() == 0) {
+    return false;
+  }
+
+  if (generate_code) {
+    // Find the first branch on a loop invariant condition; the other ones (if any) are left
+    // for a subsequent pass.
+    HIf* hif = nullptr;
+    for (HBlocksInLoopIterator it(*loop_info); !it.Done(); it.Advance()) {
+      HIf* candidate = it.Current()->GetLastInstruction()->AsIfOrNull();
+      if (candidate != nullptr && LoopAnalysis::IsLoopInvariantBranch(loop_info, candidate)) {
+        hif = candidate;
+        break;
+      }
+    }
+    DCHECK(hif != nullptr);
+    HInstruction* condition = hif->InputAt(0);
+
+    // Perform versioning. The original preheader ends with a goto to both the original loop
+    // (first successor) and its copy (second successor):
+    //
+    //                        preheader
+    //                      /               //       if (condition) {           } else {
+    //         loop: cond_1 == true       loop: cond_1 == false
+    //       }                          }
+    //
+    HBasicBlock* preheader = loop_info->GetPreHeader();
+    LoopClonerSimpleHelper helper(loop_info, &induction_range_);
+    helper.DoVersioning();
+    DCHECK(preheader->GetLastInstruction()->IsGoto());
+    DCHECK_EQ(preheader->GetSuccessors().size(), 2u);
+    preheader->RemoveInstruction(preheader->GetLastInstruction());
+    preheader->AddInstruction(new (global_allocator_) HIf(condition));
+
+    // Statically evaluate the branch in both versions of the loop.
+    HIf* copy_hif = helper.GetInstructionMap()->Get(hif)->AsIf();
+    hif->ReplaceInput(graph_->GetIntConstant(1), 0u);
+    copy_hif->ReplaceInput(graph_->GetIntConstant(0), 0u);
+    MaybeRecordStat(stats_, MethodCompilationStat::kLoopUnswitched);
+  }
+
+  return true;
+}
+
 bool HLoopOptimization::TryFullUnrolling(LoopAnalysisInfo* analysis_info, bool generate_code) {
   // Fully unroll loops with a known and small trip count.
   int64_t trip_count = analysis_info->GetTripCount();
@@ -1112,7 +1170,8 @@ bool HLoopOptimization::TryLoopScalarOpts(LoopNode* node) {
   if (!TryFullUnrolling(&analysis_info, /*generate_code*/ false) &&
       !TryPeelingForLoopInvariantExitsElimination(&analysis_info, /*generate_code*/ false) &&
       !TryUnrollingForBranchPenaltyReduction(&analysis_info, /*generate_code*/ false) &&
-      !TryToRemoveSuspendCheckFromLoopHeader(&analysis_info, /*generate_code*/ false)) {
+      !TryToRemoveSuspendCheckFromLoopHeader(&analysis_info, /*generate_code*/ false) &&
+      !TryUnswitchingForLoopInvariantCondition(&analysis_info, /*generate_code*/ false)) {
     return false;
   }
 
@@ -1128,7 +1187,9 @@ bool HLoopOptimization::TryLoopScalarOpts(LoopNode* node) {
 
   return TryFullUnrolling(&analysis_info) ||
          TryPeelingForLoopInvariantExitsElimination(&analysis_info) ||
-         TryUnrollingForBranchPenaltyReduction(&analysis_info) || removed_suspend_check;
+         TryUnrollingForBranchPenaltyReduction(&analysis_info) ||
+         TryUnswitchingForLoopInvariantCondition(&analysis_info) ||
+         removed_suspend_check;
 }
 
 //
@@ -1146,8 +1207,7 @@ bool HLoopOptimization::CanVectorizeDataFlow(LoopNode* node,
   vector_refs_->clear();
   vector_static_peeling_factor_ = 0;
   vector_dynamic_peeling_candidate_ = nullptr;
-  vector_runtime_test_a_ =
-  vector_runtime_test_b_ = nullptr;
+  vector_runtime_tests_->clear();
 
   // Traverse the data flow of the loop, in the original program order.
   for (HBlocksInLoopReversePostOrderIterator block_it(*header->GetLoopInformation());
@@ -1221,14 +1281,18 @@ bool HLoopOptimization::CanVectorizeDataFlow(LoopNode* node,
           // Conservatively assume a potential loop-carried data dependence otherwise, avoided by
           // generating an explicit a != b disambiguation runtime test on the two references.
           if (x != y) {
-            // To avoid excessive overhead, we only accept one a != b test.
-            if (vector_runtime_test_a_ == nullptr) {
-              // First test found.
-              vector_runtime_test_a_ = a;
-              vector_runtime_test_b_ = b;
-            } else if ((vector_runtime_test_a_ != a || vector_runtime_test_b_ != b) &&
-                       (vector_runtime_test_a_ != b || vector_runtime_test_b_ != a)) {
-              return false;  // second test would be needed
+            auto same_test = [a, b](const std::pair<HInstruction*, HInstruction*>& test) {
+              return (test.first == a && test.second == b) ||
+                     (test.first == b && test.second == a);
+            };
+            if (std::none_of(vector_runtime_tests_->begin(),
+                             vector_runtime_tests_->end(),
+                             same_test)) {
+              // To avoid excessive overhead, we only accept a few a != b tests.
+              if (vector_runtime_tests_->size() == kMaxArrayRefsDisambiguationTests) {
+                return false;  // another test would be needed
+              }
+              vector_runtime_tests_->emplace_back(a, b);
             }
           }
         }
@@ -1314,15 +1378,10 @@ void HLoopOptimization::VectorizePredicated(LoopNode* node,
   HInstruction* vtc = stc;
   vector_index_ = graph_->GetConstant(induc_type, 0);
   bool needs_disambiguation_test = false;
-  // Generate runtime disambiguation test:
+  // Generate runtime disambiguation tests:
   // vtc = a != b ? vtc : 0;
   if (NeedsArrayRefsDisambiguationTest()) {
-    HInstruction* rt = Insert(
-        preheader,
-        new (global_allocator_) HNotEqual(vector_runtime_test_a_, vector_runtime_test_b_));
-    vtc = Insert(preheader,
-                 new (global_allocator_)
-                 HSelect(rt, vtc, graph_->GetConstant(induc_type, 0), kNoDexPc));
+    vtc = GenerateArrayRefsDisambiguationTests(preheader, induc_type, vtc);
     needs_disambiguation_test = true;
   }
 
@@ -1463,15 +1522,10 @@ void HLoopOptimization::VectorizeTraditional(LoopNode* node,
   }
   vector_index_ = graph_->GetConstant(induc_type, 0);
 
-  // Generate runtime disambiguation test:
+  // Generate runtime disambiguation tests:
   // vtc = a != b ? vtc : 0;
   if (NeedsArrayRefsDisambiguationTest()) {
-    HInstruction* rt = Insert(
-        preheader,
-        new (global_allocator_) HNotEqual(vector_runtime_test_a_, vector_runtime_test_b_));
-    vtc = Insert(preheader,
-                 new (global_allocator_)
-                 HSelect(rt, vtc, graph_->GetConstant(induc_type, 0), kNoDexPc));
+    vtc = GenerateArrayRefsDisambiguationTests(preheader, induc_type, vtc);
     needs_cleanup = true;
   }
 
@@ -1582,6 +1636,19 @@ HPhi* HLoopOptimization::InitializeForNewLoop(HBasicBlock* new_preheader, HInstr
   return phi;
 }
 
+HInstruction* HLoopOptimization::GenerateArrayRefsDisambiguationTests(HBasicBlock* preheader,
+                                                                     DataType::Type induc_type,
+                                                                     HInstruction* vtc) {
+  for (const std::pair<HInstruction*, HInstruction*>& test : *vector_runtime_tests_) {
+    HInstruction* rt =
+        Insert(preheader, new (global_allocator_) HNotEqual(test.first, test.second));
+    vtc = Insert(preheader,
+                 new (global_allocator_)
+                 HSelect(rt, vtc, graph_->GetConstant(induc_type, 0), kNoDexPc));
+  }
+  return vtc;
+}
+
 void HLoopOptimization::GenerateNewLoopScalarOrTraditional(LoopNode* node,
                                                            HBasicBlock* new_preheader,
                                                            HInstruction* lo,
@@ -2128,7 +2195,8 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
       }
     case InstructionSet::kX86:
     case InstructionSet::kX86_64:
-      // Allow vectorization for SSE4.1-enabled X86 devices only (128-bit SIMD).
+      // Allow vectorization for SSE4.1-enabled X86 devices only (128-bit SIMD), or with
+      // AVX2 on x86-64 (256-bit SIMD, see CodeGeneratorX86_64::GetSIMDRegisterWidth()).
       *restrictions |= kNoIfCond;
       if (features->AsX86InstructionSetFeatures()->HasSSE4_1()) {
         switch (type) {
@@ -2143,7 +2211,7 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
                              kNoUnroundedHAdd |
                              kNoSAD |
                              kNoDotProd;
-            return TrySetVectorLength(type, 16);
+            return TrySetVectorLength(type, simd_register_size_ / DataType::Size(type));
           case DataType::Type::kUint16:
             *restrictions |= kNoDiv |
                              kNoAbs |
@@ -2151,26 +2219,26 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
                              kNoUnroundedHAdd |
                              kNoSAD |
                              kNoDotProd;
-            return TrySetVectorLength(type, 8);
+            return TrySetVectorLength(type, simd_register_size_ / DataType::Size(type));
           case DataType::Type::kInt16:
             *restrictions |= kNoDiv |
                              kNoAbs |
                              kNoSignedHAdd |
                              kNoUnroundedHAdd |
                              kNoSAD;
-            return TrySetVectorLength(type, 8);
+            return TrySetVectorLength(type, simd_register_size_ / DataType::Size(type));
           case DataType::Type::kInt32:
             *restrictions |= kNoDiv | kNoSAD;
-            return TrySetVectorLength(type, 4);
+            return TrySetVectorLength(type, simd_register_size_ / DataType::Size(type));
           case DataType::Type::kInt64:
             *restrictions |= kNoMul | kNoDiv | kNoShr | kNoAbs | kNoSAD;
-            return TrySetVectorLength(type, 2);
+            return TrySetVectorLength(type, simd_register_size_ / DataType::Size(type));
           case DataType::Type::kFloat32:
             *restrictions |= kNoReduction;
-            return TrySetVectorLength(type, 4);
+            return TrySetVectorLength(type, simd_register_size_ / DataType::Size(type));
           case DataType::Type::kFloat64:
             *restrictions |= kNoReduction;
-            return TrySetVectorLength(type, 2);
+            return TrySetVectorLength(type, simd_register_size_ / DataType::Size(type));
           default:
             break;
         }  // switch type
@@ -270,6 +270,13 @@ class HLoopOptimization : public HOptimization {
   bool TryPeelingForLoopInvariantExitsElimination(LoopAnalysisInfo* analysis_info,
                                                   bool generate_code = true);
 
+  // Tries to apply loop unswitching for a branch inside the loop on a loop invariant condition:
+  // the loop is versioned and the condition is hoisted to select between the two versions, in
+  // which the branch is statically evaluated. Returns whether transformation happened.
+  // 'generate_code' determines whether the optimization should be actually applied.
+  bool TryUnswitchingForLoopInvariantCondition(LoopAnalysisInfo* analysis_info,
+                                               bool generate_code = true);
+
   // Tries to perform whole loop unrolling for a small loop with a small trip count to eliminate
   // the loop check overhead and to have more opportunities for inter-iteration optimizations.
   // Returns whether transformation happened. 'generate_code' determines whether the optimization
@@ -381,7 +388,14 @@ class HLoopOptimization : public HOptimization {
                                HInstruction* step);
 
   // Returns whether the vector loop needs runtime disambiguation test for array refs.
-  bool NeedsArrayRefsDisambiguationTest() const { return vector_runtime_test_a_ != nullptr; }
+  bool NeedsArrayRefsDisambiguationTest() const { return !vector_runtime_tests_->empty(); }
+
+  // Generates the runtime disambiguation tests for array refs in the preheader, so that the
+  // vector trip count becomes zero (leaving all work to the scalar loop) if any test fails:
+  //   vtc = a != b ? vtc : 0;
+  HInstruction* GenerateArrayRefsDisambiguationTests(HBasicBlock* preheader,
+                                                     DataType::Type induc_type,
+                                                     HInstruction* vtc);
 
   bool VectorizeDef(LoopNode* node, HInstruction* instruction, bool generate_code);
   bool VectorizeUse(LoopNode* node,
@@ -531,9 +545,9 @@ class HLoopOptimization : public HOptimization {
   uint32_t vector_static_peeling_factor_;
   const ArrayReference* vector_dynamic_peeling_candidate_;
 
-  // Dynamic data dependence test of the form a != b.
-  HInstruction* vector_runtime_test_a_;
-  HInstruction* vector_runtime_test_b_;
+  // Dynamic data dependence tests of the form a != b.
+  // Contents reside in phase-local heap memory.
+  ScopedArenaVector<std::pair<HInstruction*, HInstruction*>>* vector_runtime_tests_;
 
   // Mapping used during vectorization synthesis for both the scalar peeling/cleanup
   // loop (mode is kSequential) and the actual vector loop (mode is kVector). The data
@@ -900,7 +900,7 @@ void HLoopInformation::Populate() {
     }
   }
 
-  if (!is_irreducible_loop && graph->IsCompilingOsr()) {
+  if (!is_irreducible_loop && graph->HasOsrEntries()) {
     // When compiling in OSR mode, all loops in the compiled method may be entered
     // from the interpreter. We treat this OSR entry point just like an extra entry
     // to an irreducible loop, so we need to mark the method's loops as irreducible.
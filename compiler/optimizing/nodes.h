@@ -428,6 +428,7 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
         cached_current_method_(nullptr),
         art_method_(nullptr),
         compilation_kind_(compilation_kind),
+        has_osr_entries_(false),
         useful_optimizing_(false),
         cha_single_implementation_list_(allocator->Adapter(kArenaAllocCHA)) {
     blocks_.reserve(kDefaultNumberOfBlocks);
@@ -678,6 +679,16 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
 
   bool IsCompilingOsr() const { return compilation_kind_ == CompilationKind::kOsr; }
 
+  // Whether the interpreter can jump to the compiled code at loop headers. This is the case for
+  // OSR compilations, and for optimized compilations of methods whose loops got hot in the
+  // interpreter, see `ProfilingInfo::HasHotLoops()`.
+  bool HasOsrEntries() const { return IsCompilingOsr() || has_osr_entries_; }
+
+  void SetHasOsrEntries() {
+    DCHECK_EQ(compilation_kind_, CompilationKind::kOptimized);
+    has_osr_entries_ = true;
+  }
+
   bool IsCompilingBaseline() const { return compilation_kind_ == CompilationKind::kBaseline; }
 
   CompilationKind GetCompilationKind() const { return compilation_kind_; }
@@ -690,7 +701,7 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   // function; for debuggable graphs we might deoptimize to interpreter from
   // SuspendChecks. In these cases we should always generate code for them.
   bool SuspendChecksAreAllowedToNoOp() const {
-    return !IsDebuggable() && !IsCompilingOsr();
+    return !IsDebuggable() && !HasOsrEntries();
   }
 
   void AddCHASingleImplementationDependency(ArtMethod* method) {
@@ -904,6 +915,9 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   // directly jump to.
   const CompilationKind compilation_kind_;
 
+  // Whether an optimized compilation also emits OSR entries, see `HasOsrEntries()`.
+  bool has_osr_entries_;
+
   // Whether after compiling baseline it is still useful re-optimizing this
   // method.
   bool useful_optimizing_;
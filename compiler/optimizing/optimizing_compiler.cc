@@ -18,6 +18,7 @@
 
 #include <fstream>
 #include <memory>
+#include <set>
 #include <sstream>
 
 #include <stdint.h>
@@ -31,6 +32,7 @@
 #include "base/mutex.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/systrace.h"
+#include "base/time_utils.h"
 #include "base/timing_logger.h"
 #include "builder.h"
 #include "code_generator.h"
@@ -48,6 +50,7 @@
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
 #include "jit/jit_logger.h"
+#include "jit/profiling_info.h"
 #include "jni/quick/jni_compiler.h"
 #include "linker/linker_patch.h"
 #include "nodes.h"
@@ -78,6 +81,46 @@ static constexpr const char kStringFilter[] = "";
 
 class PassScope;
 
+// Limits on the thread CPU time and arena memory used by a JIT compilation. The limits are
+// checked between passes, so a single pass can go over them.
+class CompilationBudget : public ValueObject {
+ public:
+  CompilationBudget(uint64_t time_budget_ns,
+                    size_t memory_budget,
+                    ArenaAllocator* allocator,
+                    ArenaStack* arena_stack)
+      : start_time_ns_(ThreadCpuNanoTime()),
+        time_budget_ns_(time_budget_ns),
+        memory_budget_(memory_budget),
+        allocator_(allocator),
+        arena_stack_(arena_stack),
+        exceeded_(false) {}
+
+  bool IsExceeded() {
+    if (!exceeded_) {
+      exceeded_ =
+          (time_budget_ns_ != 0u && ThreadCpuNanoTime() - start_time_ns_ > time_budget_ns_) ||
+          (memory_budget_ != 0u && GetArenaBytes() > memory_budget_);
+    }
+    return exceeded_;
+  }
+
+  // Arena memory used so far, including the peak usage of the arena stack.
+  size_t GetArenaBytes() const {
+    return allocator_->BytesUsed() + arena_stack_->ApproximatePeakBytes();
+  }
+
+ private:
+  const uint64_t start_time_ns_;
+  const uint64_t time_budget_ns_;
+  const size_t memory_budget_;
+  ArenaAllocator* const allocator_;
+  ArenaStack* const arena_stack_;
+  bool exceeded_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompilationBudget);
+};
+
 class PassObserver : public ValueObject {
  public:
   PassObserver(HGraph* graph,
@@ -95,6 +138,7 @@ class PassObserver : public ValueObject {
         visualizer_enabled_(!compiler_options.GetDumpCfgFileName().empty()),
         visualizer_(&visualizer_oss_, graph, codegen),
         codegen_(codegen),
+        budget_(nullptr),
         graph_in_bad_state_(false) {
     if (timing_logger_enabled_ || visualizer_enabled_) {
       if (!IsVerboseMethod(compiler_options, GetMethodName())) {
@@ -127,6 +171,10 @@ class PassObserver : public ValueObject {
 
   void SetGraphInBadState() { graph_in_bad_state_ = true; }
 
+  void SetBudget(CompilationBudget* budget) { budget_ = budget; }
+
+  bool IsOverBudget() { return budget_ != nullptr && budget_->IsExceeded(); }
+
   const char* GetMethodName() {
     // PrettyMethod() is expensive, so we delay calling it until we actually have to.
     if (cached_method_name_.empty()) {
@@ -213,6 +261,7 @@ class PassObserver : public ValueObject {
   bool visualizer_enabled_;
   HGraphVisualizer visualizer_;
   CodeGenerator* codegen_;
+  CompilationBudget* budget_;
 
   // Flag to be set by the compiler if the pass failed and the graph is not
   // expected to validate.
@@ -306,6 +355,10 @@ class OptimizingCompiler final : public Compiler {
     pass_changes[static_cast<size_t>(OptimizationPass::kNone)] = true;
     bool change = false;
     for (size_t i = 0; i < length; ++i) {
+      if (pass_observer->IsOverBudget()) {
+        // The compilation is abandoned, see TryCompile().
+        break;
+      }
       if (pass_changes[static_cast<size_t>(definitions[i].depends_on)]) {
         // Execute the pass and record whether it changed anything.
         PassScope scope(optimizations[i]->GetPassName(), pass_observer);
@@ -351,12 +404,14 @@ class OptimizingCompiler final : public Compiler {
   // 1) Builds the graph. Returns null if it failed to build it.
   // 2) Transforms the graph to SSA. Returns null if it failed.
   // 3) Runs optimizations on the graph, including register allocator.
+  // Returns null if `budget` is not null and the compilation goes over it.
   CodeGenerator* TryCompile(ArenaAllocator* allocator,
                             ArenaStack* arena_stack,
                             const DexCompilationUnit& dex_compilation_unit,
                             ArtMethod* method,
                             CompilationKind compilation_kind,
-                            VariableSizedHandleScope* handles) const;
+                            VariableSizedHandleScope* handles,
+                            CompilationBudget* budget) const;
 
   CodeGenerator* TryCompileIntrinsic(ArenaAllocator* allocator,
                                      ArenaStack* arena_stack,
@@ -539,7 +594,8 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
           OptDef(OptimizationPass::kInstructionSimplifierRiscv64),
           OptDef(OptimizationPass::kSideEffectsAnalysis),
           OptDef(OptimizationPass::kGlobalValueNumbering, "GVN$after_arch"),
-          OptDef(OptimizationPass::kCriticalNativeAbiFixupRiscv64)
+          OptDef(OptimizationPass::kCriticalNativeAbiFixupRiscv64),
+          OptDef(OptimizationPass::kScheduling)
       };
       return RunOptimizations(graph,
                               codegen,
@@ -570,6 +626,9 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
           OptDef(OptimizationPass::kInstructionSimplifierX86_64),
           OptDef(OptimizationPass::kSideEffectsAnalysis),
           OptDef(OptimizationPass::kGlobalValueNumbering, "GVN$after_arch"),
+          // Schedule before generating memory operands, which places an `HArrayLength`
+          // right before the `HBoundsCheck` using it.
+          OptDef(OptimizationPass::kScheduling),
           OptDef(OptimizationPass::kX86MemoryOperandGeneration)
       };
       return RunOptimizations(graph,
@@ -608,7 +667,11 @@ static void AllocateRegisters(HGraph* graph,
   {
     PassScope scope(RegisterAllocator::kRegisterAllocatorPassName, pass_observer);
     std::unique_ptr<RegisterAllocator> register_allocator =
-        RegisterAllocator::Create(&local_allocator, codegen, liveness);
+        RegisterAllocator::Create(&local_allocator,
+                                  codegen,
+                                  liveness,
+                                  codegen->GetCompilerOptions().GetRegisterAllocationStrategy(),
+                                  stats);
     register_allocator->AllocateRegisters();
   }
 }
@@ -765,7 +828,8 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
                                               const DexCompilationUnit& dex_compilation_unit,
                                               ArtMethod* method,
                                               CompilationKind compilation_kind,
-                                              VariableSizedHandleScope* handles) const {
+                                              VariableSizedHandleScope* handles,
+                                              CompilationBudget* budget) const {
   MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kAttemptBytecodeCompilation);
   const CompilerOptions& compiler_options = GetCompilerOptions();
   InstructionSet instruction_set = compiler_options.GetInstructionSet();
@@ -843,6 +907,9 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
   if (jit != nullptr) {
     ProfilingInfo* info = jit->GetCodeCache()->GetProfilingInfo(method, Thread::Current());
     graph->SetProfilingInfo(info);
+    if (compilation_kind == CompilationKind::kOptimized && info != nullptr && info->HasHotLoops()) {
+      graph->SetHasOsrEntries();
+    }
   }
 
   std::unique_ptr<CodeGenerator> codegen(
@@ -859,6 +926,7 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
                              codegen.get(),
                              visualizer_output_.get(),
                              compiler_options);
+  pass_observer.SetBudget(budget);
 
   {
     VLOG(compiler) << "Building " << pass_observer.GetMethodName();
@@ -871,8 +939,12 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
                           compilation_stats_.get());
     GraphAnalysisResult result = builder.BuildGraph();
     if (result != kAnalysisSuccess) {
-      // Don't try recompiling this method again.
-      if (method != nullptr) {
+      if (result == kAnalysisFailPhiEquivalentInOsr && !graph->IsCompilingOsr()) {
+        // Only the OSR entries prevent compiling the method. Compile it without them next time.
+        DCHECK(graph->HasOsrEntries());
+        graph->GetProfilingInfo()->SetFailedOsrEntries();
+      } else if (method != nullptr) {
+        // Don't try recompiling this method again.
         ScopedObjectAccess soa(Thread::Current());
         method->SetDontCompile();
       }
@@ -923,6 +995,11 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
     RunRequiredPasses(graph, codegen.get(), dex_compilation_unit, &pass_observer);
   } else {
     RunOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer);
+    if (pass_observer.IsOverBudget()) {
+      SCOPED_TRACE << "Not compiling because of the compilation budget";
+      MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kNotCompiledOverBudget);
+      return nullptr;
+    }
     PassScope scope(WriteBarrierElimination::kWBEPassName, &pass_observer);
     WriteBarrierElimination(graph, compilation_stats_.get()).Run();
   }
@@ -950,6 +1027,12 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
                     &pass_observer,
                     compilation_stats_.get());
 
+  if (pass_observer.IsOverBudget()) {
+    SCOPED_TRACE << "Not compiling because of the compilation budget";
+    MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kNotCompiledOverBudget);
+    return nullptr;
+  }
+
   if (UNLIKELY(codegen->GetFrameSize() > codegen->GetMaximumFrameSize())) {
     SCOPED_TRACE << "Not compiling because of stack frame too large";
     LOG(WARNING) << "Stack frame size is " << codegen->GetFrameSize()
@@ -1130,7 +1213,8 @@ CompiledMethod* OptimizingCompiler::Compile(const dex::CodeItem* code_item,
                      compiler_options.IsBaseline()
                         ? CompilationKind::kBaseline
                         : CompilationKind::kOptimized,
-                     &handles));
+                     &handles,
+                     /*budget=*/ nullptr));
     }
   }
   if (codegen.get() != nullptr) {
@@ -1263,6 +1347,82 @@ bool EncodeArtMethodInInlineInfo([[maybe_unused]] ArtMethod* method) {
   return Runtime::Current() == nullptr || !Runtime::Current()->IsAotCompiler();
 }
 
+// Returns whether the optimized code generated for `codegen`'s graph can be reused by another
+// process running on the same boot image, i.e. whether it only embeds boot image methods and
+// classes. If so, `initialized_classes` receives the descriptors of the classes the code assumes
+// to be initialized.
+static bool CanPersistJitCode(CodeGenerator* codegen,
+                              /*out*/ std::vector<std::string>* initialized_classes)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  HGraph* graph = codegen->GetGraph();
+  if (graph->IsCompilingBaseline() ||
+      graph->IsDebuggable() ||
+      codegen->GetNumberOfJitRoots() != 0u ||
+      !graph->GetCHASingleImplementationList().empty()) {
+    return false;
+  }
+  gc::Heap* heap = Runtime::Current()->GetHeap();
+  auto is_boot_image_method = [heap](ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
+    return method != nullptr && heap->ObjectIsInBootImageSpace(method->GetDeclaringClass());
+  };
+  std::set<std::string> descriptors;
+  auto add_initialized_class = [&descriptors](ObjPtr<mirror::Class> klass)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (klass != nullptr && klass->IsInitialized()) {
+      std::string temp;
+      descriptors.insert(klass->GetDescriptor(&temp));
+    }
+  };
+  for (HBasicBlock* block : graph->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (instruction->IsMethodEntryHook() || instruction->IsMethodExitHook()) {
+        return false;
+      }
+      if (instruction->IsInvokeStaticOrDirect() &&
+          instruction->AsInvokeStaticOrDirect()->GetMethodLoadKind() ==
+              MethodLoadKind::kJitDirectAddress &&
+          !is_boot_image_method(instruction->AsInvoke()->GetResolvedMethod())) {
+        return false;
+      }
+      if (instruction->IsInvokeInterface() &&
+          instruction->AsInvokeInterface()->GetHiddenArgumentLoadKind() ==
+              MethodLoadKind::kJitDirectAddress &&
+          !is_boot_image_method(instruction->AsInvoke()->GetResolvedMethod())) {
+        return false;
+      }
+      // Type check bitstrings of classes outside the boot image are assigned at run time.
+      if ((instruction->IsInstanceOf() &&
+           instruction->AsInstanceOf()->GetTypeCheckKind() == TypeCheckKind::kBitstringCheck &&
+           !heap->ObjectIsInBootImageSpace(instruction->AsInstanceOf()->GetClass().Get())) ||
+          (instruction->IsCheckCast() &&
+           instruction->AsCheckCast()->GetTypeCheckKind() == TypeCheckKind::kBitstringCheck &&
+           !heap->ObjectIsInBootImageSpace(instruction->AsCheckCast()->GetClass().Get()))) {
+        return false;
+      }
+      // Initialization checks are omitted for classes already initialized at compile time.
+      if (instruction->IsLoadClass()) {
+        Handle<mirror::Class> klass = instruction->AsLoadClass()->GetClass();
+        if (klass != nullptr) {
+          add_initialized_class(klass.Get());
+        }
+      }
+      // Inlined frames are described by their ArtMethod in the stack maps, and inlining a
+      // static method relies on its class being initialized.
+      for (HEnvironment* environment = instruction->GetEnvironment();
+           environment != nullptr && environment->GetParent() != nullptr;
+           environment = environment->GetParent()) {
+        if (!is_boot_image_method(environment->GetMethod())) {
+          return false;
+        }
+        add_initialized_class(environment->GetMethod()->GetDeclaringClass());
+      }
+    }
+  }
+  initialized_classes->assign(descriptors.begin(), descriptors.end());
+  return true;
+}
+
 bool OptimizingCompiler::JitCompile(Thread* self,
                                     jit::JitCodeCache* code_cache,
                                     jit::JitMemoryRegion* region,
@@ -1379,6 +1539,12 @@ bool OptimizingCompiler::JitCompile(Thread* self,
 
   ArenaStack arena_stack(runtime->GetJitArenaPool());
   VariableSizedHandleScope handles(self);
+  const jit::JitOptions* jit_options = runtime->GetJITOptions();
+  const bool has_budget = compilation_kind != CompilationKind::kBaseline;
+  CompilationBudget budget(has_budget ? MsToNs(jit_options->GetCompileTimeBudgetMs()) : 0u,
+                           has_budget ? jit_options->GetCompileMemoryBudget() : 0u,
+                           &allocator,
+                           &arena_stack);
 
   std::unique_ptr<CodeGenerator> codegen;
   {
@@ -1403,7 +1569,34 @@ bool OptimizingCompiler::JitCompile(Thread* self,
                    dex_compilation_unit,
                    method,
                    compilation_kind,
-                   &handles));
+                   &handles,
+                   &budget));
+    if (codegen.get() == nullptr && budget.IsExceeded()) {
+      VLOG(jit) << "Compilation of " << method->PrettyMethod() << " (kind=" << compilation_kind
+                << ") went over the compilation budget";
+      if (compilation_kind == CompilationKind::kOptimized &&
+          !code_cache->ContainsPc(method->GetEntryPointFromQuickCompiledCode()) &&
+          code_cache->CanAllocateProfilingInfo()) {
+        // There is no compiled code to keep running, fall back to baseline code, which is
+        // much cheaper to compile.
+        compilation_kind = CompilationKind::kBaseline;
+        codegen.reset(
+            TryCompile(&allocator,
+                       &arena_stack,
+                       dex_compilation_unit,
+                       method,
+                       compilation_kind,
+                       &handles,
+                       /*budget=*/ nullptr));
+      }
+      // Don't try optimizing this method again. Without a ProfilingInfo to record it, the method
+      // stays compilable and is retried the next time it gets hot.
+      ProfilingInfo* info = code_cache->GetProfilingInfo(method, self);
+      if (info != nullptr) {
+        info->SetCompileBudgetExceeded();
+      }
+    }
+    runtime->GetMetrics()->JitMethodCompileArenaPeakBytes()->Add(budget.GetArenaBytes());
     if (codegen.get() == nullptr) {
       return false;
     }
@@ -1489,6 +1682,17 @@ bool OptimizingCompiler::JitCompile(Thread* self,
     jit_logger->WriteLog(code, codegen->GetAssembler()->CodeSize(), method);
   }
 
+  jit::JitPersistentCache* persistent_cache = Runtime::Current()->GetJit()->GetPersistentCache();
+  if (persistent_cache != nullptr && compilation_kind == CompilationKind::kOptimized) {
+    std::vector<std::string> initialized_classes;
+    if (CanPersistJitCode(codegen.get(), &initialized_classes)) {
+      persistent_cache->Record(method,
+                               codegen->GetCode(),
+                               ArrayRef<const uint8_t>(stack_map),
+                               std::move(initialized_classes));
+    }
+  }
+
   if (kArenaAllocatorCountAllocations) {
     codegen.reset();  // Release codegen's ScopedArenaAllocator for memory accounting.
     size_t total_allocated = allocator.BytesAllocated() + arena_stack.PeakBytesAllocated();
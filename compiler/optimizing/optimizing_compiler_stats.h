@@ -69,16 +69,19 @@ enum class MethodCompilationStat {
   kNotCompiledIrreducibleLoopAndStringInit,
   kNotCompiledPhiEquivalentInOsr,
   kNotCompiledFrameTooBig,
+  kNotCompiledOverBudget,
   kInlinedMonomorphicCall,
   kInlinedPolymorphicCall,
   kMonomorphicCall,
   kPolymorphicCall,
   kMegamorphicCall,
+  kDispatchedMegamorphicCall,
   kBooleanSimplified,
   kIntrinsicRecognized,
   kLoopInvariantMoved,
   kLoopVectorized,
   kLoopVectorizedIdiom,
+  kLoopUnswitched,
   kSelectGenerated,
   kRemovedInstanceOf,
   kPropagatedIfValue,
@@ -136,6 +139,8 @@ enum class MethodCompilationStat {
   kPartialStoreRemoved,
   kPartialAllocationMoved,
   kDevirtualized,
+  kRegisterSpill,
+  kRegisterFill,
   kLastStat
 };
 std::ostream& operator<<(std::ostream& os, MethodCompilationStat rhs);
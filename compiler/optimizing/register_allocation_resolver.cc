@@ -19,15 +19,18 @@
 #include "base/bit_vector-inl.h"
 #include "code_generator.h"
 #include "linear_order.h"
+#include "optimizing_compiler_stats.h"
 #include "ssa_liveness_analysis.h"
 
 namespace art HIDDEN {
 
 RegisterAllocationResolver::RegisterAllocationResolver(CodeGenerator* codegen,
-                                                       const SsaLivenessAnalysis& liveness)
+                                                       const SsaLivenessAnalysis& liveness,
+                                                       OptimizingCompilerStats* stats)
       : allocator_(codegen->GetGraph()->GetAllocator()),
         codegen_(codegen),
-        liveness_(liveness) {}
+        liveness_(liveness),
+        stats_(stats) {}
 
 void RegisterAllocationResolver::Resolve(ArrayRef<HInstruction* const> safepoints,
                                          size_t reserved_out_slots,
@@ -505,11 +508,20 @@ static bool IsValidDestination(Location destination) {
       || destination.IsSIMDStackSlot();
 }
 
+static bool IsStackLocation(Location location) {
+  return location.IsStackSlot() || location.IsDoubleStackSlot() || location.IsSIMDStackSlot();
+}
+
 void RegisterAllocationResolver::AddMove(HParallelMove* move,
                                          Location source,
                                          Location destination,
                                          HInstruction* instruction,
                                          DataType::Type type) const {
+  if (source.IsRegisterKind() && IsStackLocation(destination)) {
+    MaybeRecordStat(stats_, MethodCompilationStat::kRegisterSpill);
+  } else if (IsStackLocation(source) && destination.IsRegisterKind()) {
+    MaybeRecordStat(stats_, MethodCompilationStat::kRegisterFill);
+  }
   if (type == DataType::Type::kInt64
       && codegen_->ShouldSplitLongMoves()
       // The parallel move resolver knows how to deal with long constants.
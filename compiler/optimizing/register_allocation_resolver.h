@@ -31,6 +31,7 @@ class HInstruction;
 class HParallelMove;
 class LiveInterval;
 class Location;
+class OptimizingCompilerStats;
 class SsaLivenessAnalysis;
 
 /**
@@ -40,7 +41,9 @@ class SsaLivenessAnalysis;
  */
 class RegisterAllocationResolver : ValueObject {
  public:
-  RegisterAllocationResolver(CodeGenerator* codegen, const SsaLivenessAnalysis& liveness);
+  RegisterAllocationResolver(CodeGenerator* codegen,
+                             const SsaLivenessAnalysis& liveness,
+                             OptimizingCompilerStats* stats = nullptr);
 
   void Resolve(ArrayRef<HInstruction* const> safepoints,
                size_t reserved_out_slots,  // Includes slot(s) for the art method.
@@ -91,6 +94,7 @@ class RegisterAllocationResolver : ValueObject {
   ArenaAllocator* const allocator_;
   CodeGenerator* const codegen_;
   const SsaLivenessAnalysis& liveness_;
+  OptimizingCompilerStats* const stats_;
 
   DISALLOW_COPY_AND_ASSIGN(RegisterAllocationResolver);
 };
@@ -24,6 +24,7 @@
 #include "base/bit_utils_iterator.h"
 #include "base/bit_vector-inl.h"
 #include "code_generator.h"
+#include "register_allocator_graph_color.h"
 #include "register_allocator_linear_scan.h"
 #include "ssa_liveness_analysis.h"
 
@@ -53,10 +54,12 @@ static uint32_t GetBlockedFpRegistersForCall(size_t num_registers, const CodeGen
 
 RegisterAllocator::RegisterAllocator(ScopedArenaAllocator* allocator,
                                      CodeGenerator* codegen,
-                                     const SsaLivenessAnalysis& liveness)
+                                     const SsaLivenessAnalysis& liveness,
+                                     OptimizingCompilerStats* stats)
     : allocator_(allocator),
       codegen_(codegen),
       liveness_(liveness),
+      stats_(stats),
       num_core_registers_(codegen_->GetNumberOfCoreRegisters()),
       num_fp_registers_(codegen_->GetNumberOfFloatingPointRegisters()),
       core_registers_blocked_for_call_(
@@ -65,9 +68,19 @@ RegisterAllocator::RegisterAllocator(ScopedArenaAllocator* allocator,
 
 std::unique_ptr<RegisterAllocator> RegisterAllocator::Create(ScopedArenaAllocator* allocator,
                                                              CodeGenerator* codegen,
-                                                             const SsaLivenessAnalysis& analysis) {
-  return std::unique_ptr<RegisterAllocator>(
-      new (allocator) RegisterAllocatorLinearScan(allocator, codegen, analysis));
+                                                             const SsaLivenessAnalysis& analysis,
+                                                             Strategy strategy,
+                                                             OptimizingCompilerStats* stats) {
+  switch (strategy) {
+    case kRegisterAllocatorLinearScan:
+      return std::unique_ptr<RegisterAllocator>(
+          new (allocator) RegisterAllocatorLinearScan(allocator, codegen, analysis, stats));
+    case kRegisterAllocatorGraphColor:
+      return std::unique_ptr<RegisterAllocator>(
+          new (allocator) RegisterAllocatorGraphColor(allocator, codegen, analysis, stats));
+  }
+  LOG(FATAL) << "Invalid register allocation strategy: " << strategy;
+  UNREACHABLE();
 }
 
 RegisterAllocator::~RegisterAllocator() {
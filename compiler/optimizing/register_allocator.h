@@ -31,6 +31,7 @@ class HInstruction;
 class HParallelMove;
 class LiveInterval;
 class Location;
+class OptimizingCompilerStats;
 class SsaLivenessAnalysis;
 
 /**
@@ -43,9 +44,18 @@ class RegisterAllocator : public DeletableArenaObject<kArenaAllocRegisterAllocat
     kFpRegister
   };
 
+  enum Strategy {
+    kRegisterAllocatorLinearScan,
+    kRegisterAllocatorGraphColor
+  };
+
+  static constexpr Strategy kRegisterAllocatorDefault = kRegisterAllocatorLinearScan;
+
   static std::unique_ptr<RegisterAllocator> Create(ScopedArenaAllocator* allocator,
                                                    CodeGenerator* codegen,
-                                                   const SsaLivenessAnalysis& analysis);
+                                                   const SsaLivenessAnalysis& analysis,
+                                                   Strategy strategy = kRegisterAllocatorDefault,
+                                                   OptimizingCompilerStats* stats = nullptr);
 
   virtual ~RegisterAllocator();
 
@@ -71,7 +81,8 @@ class RegisterAllocator : public DeletableArenaObject<kArenaAllocRegisterAllocat
  protected:
   RegisterAllocator(ScopedArenaAllocator* allocator,
                     CodeGenerator* codegen,
-                    const SsaLivenessAnalysis& analysis);
+                    const SsaLivenessAnalysis& analysis,
+                    OptimizingCompilerStats* stats);
 
   // Split `interval` at the position `position`. The new interval starts at `position`.
   // If `position` is at the start of `interval`, returns `interval` with its
@@ -98,6 +109,7 @@ class RegisterAllocator : public DeletableArenaObject<kArenaAllocRegisterAllocat
   ScopedArenaAllocator* const allocator_;
   CodeGenerator* const codegen_;
   const SsaLivenessAnalysis& liveness_;
+  OptimizingCompilerStats* const stats_;
 
   // Cached values calculated from codegen data.
   const size_t num_core_registers_;
@@ -0,0 +1,1232 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "register_allocator_graph_color.h"
+
+#include <algorithm>
+
+#include "base/arena_object.h"
+#include "base/bit_utils.h"
+#include "base/bit_utils_iterator.h"
+#include "base/pointer_size.h"
+#include "code_generator.h"
+#include "register_allocation_resolver.h"
+#include "ssa_liveness_analysis.h"
+
+namespace art HIDDEN {
+
+static constexpr size_t kMaxLifetimePosition = -1;
+static constexpr size_t kDefaultNumberOfSpillSlots = 4;
+
+// Number of times the interference graph is colored, splitting the nodes which did not get a
+// register each time, before all intervals are split around each of their register uses and
+// colored greedily.
+static constexpr size_t kMaxGraphColoringAttempts = 4;
+
+// Register uses in a loop are weighted by this factor per loop depth, up to a maximum depth,
+// when deciding which values to spill.
+static constexpr float kLoopSpillWeightFactor = 10.0f;
+static constexpr size_t kMaxLoopDepthForSpillWeight = 8;
+
+// For simplicity, we implement register pairs as (reg, reg + 1), as in the linear scan
+// allocator. Note that this is a requirement for double registers on ARM, since we
+// allocate SRegister.
+static int GetHighForLowRegister(int reg) { return reg + 1; }
+static constexpr uint32_t kLowRegistersMask = 0x55555555u;
+
+struct RegisterAllocatorGraphColor::InterferenceNode
+    : public ArenaObject<kArenaAllocRegisterAllocator> {
+  InterferenceNode(LiveInterval* interval_in, bool is_minimal_in, ScopedArenaAllocator* allocator)
+      : interval(interval_in),
+        adjacent(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        forbidden(0u),
+        degree(0u),
+        spill_weight(0.0f),
+        is_pair(interval_in->HasHighInterval()),
+        is_minimal(is_minimal_in),
+        in_simplify_worklist(false),
+        removed(false) {}
+
+  // Weight of `other` in the degree of this node: the number of candidate registers (or
+  // register pairs for a pair node) it can take away from this node.
+  size_t GetWeightOf(const InterferenceNode* other) const {
+    return (!is_pair && other->is_pair) ? 2u : 1u;
+  }
+
+  // Returns the registers allocated to this node.
+  uint32_t GetRegisters() const {
+    DCHECK(interval->HasRegister());
+    uint32_t mask = 1u << interval->GetRegister();
+    if (is_pair) {
+      mask |= 1u << interval->GetHighInterval()->GetRegister();
+    }
+    return mask;
+  }
+
+  LiveInterval* const interval;
+  ScopedArenaVector<InterferenceNode*> adjacent;
+  // Registers this node cannot use, because of fixed or precolored intervals.
+  uint32_t forbidden;
+  // Sum of the weights of the neighbors still in the graph during simplification.
+  size_t degree;
+  // Loop-weighted number of register uses, the cost of not giving this node a register.
+  float spill_weight;
+  const bool is_pair;
+  // Whether the interval cannot be split further.
+  const bool is_minimal;
+  bool in_simplify_worklist;
+  bool removed;
+};
+
+RegisterAllocatorGraphColor::RegisterAllocatorGraphColor(ScopedArenaAllocator* allocator,
+                                                         CodeGenerator* codegen,
+                                                         const SsaLivenessAnalysis& liveness,
+                                                         OptimizingCompilerStats* stats)
+      : RegisterAllocator(allocator, codegen, liveness, stats),
+        core_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        fp_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        physical_core_register_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        physical_fp_register_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        block_registers_for_call_interval_(
+            LiveInterval::MakeFixedInterval(allocator, kNoRegister, DataType::Type::kVoid)),
+        block_registers_special_interval_(
+            LiveInterval::MakeFixedInterval(allocator, kNoRegister, DataType::Type::kVoid)),
+        temp_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        blocked_positions_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        split_levels_(std::less<LiveInterval*>(),
+                      allocator->Adapter(kArenaAllocRegisterAllocator)),
+        int_spill_slots_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        long_spill_slots_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        float_spill_slots_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        double_spill_slots_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        catch_phi_spill_slots_(0),
+        safepoints_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        current_register_type_(RegisterType::kCoreRegister),
+        number_of_registers_(-1),
+        registers_array_(nullptr),
+        blocked_core_registers_(codegen->GetBlockedCoreRegisters()),
+        blocked_fp_registers_(codegen->GetBlockedFloatingPointRegisters()),
+        reserved_out_slots_(0) {
+  temp_intervals_.reserve(4);
+  int_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
+  long_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
+  float_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
+  double_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
+
+  codegen->SetupBlockedRegisters();
+  physical_core_register_intervals_.resize(codegen->GetNumberOfCoreRegisters(), nullptr);
+  physical_fp_register_intervals_.resize(codegen->GetNumberOfFloatingPointRegisters(), nullptr);
+  // Always reserve for the current method and the graph's max out registers.
+  // ArtMethod* takes 2 vregs for 64 bits.
+  size_t ptr_size = static_cast<size_t>(InstructionSetPointerSize(codegen->GetInstructionSet()));
+  reserved_out_slots_ = ptr_size / kVRegSize + codegen->GetGraph()->GetMaximumNumberOfOutVRegs();
+}
+
+RegisterAllocatorGraphColor::~RegisterAllocatorGraphColor() {}
+
+void RegisterAllocatorGraphColor::AllocateRegisters() {
+  ProcessInstructions();
+
+  current_register_type_ = RegisterType::kCoreRegister;
+  number_of_registers_ = num_core_registers_;
+  registers_array_ = allocator_->AllocArray<size_t>(number_of_registers_,
+                                                    kArenaAllocRegisterAllocator);
+  ColorIntervals(&core_intervals_);
+
+  current_register_type_ = RegisterType::kFpRegister;
+  number_of_registers_ = num_fp_registers_;
+  registers_array_ = allocator_->AllocArray<size_t>(number_of_registers_,
+                                                    kArenaAllocRegisterAllocator);
+  ColorIntervals(&fp_intervals_);
+
+  // Values which are not in a register for their whole lifetime need a spill slot. Allocate
+  // them in order of definition, so that slots of values which are dead can be reused.
+  for (size_t i = 0, e = liveness_.GetNumberOfSsaValues(); i < e; ++i) {
+    LiveInterval* interval = liveness_.GetInstructionFromSsaIndex(i)->GetLiveInterval();
+    for (LiveInterval* sibling = interval;
+         sibling != nullptr;
+         sibling = sibling->GetNextSibling()) {
+      if (!sibling->HasRegister()) {
+        AllocateSpillSlotFor(sibling);
+        break;
+      }
+    }
+  }
+
+  RegisterAllocationResolver(codegen_, liveness_, stats_)
+      .Resolve(ArrayRef<HInstruction* const>(safepoints_),
+               reserved_out_slots_,
+               int_spill_slots_.size(),
+               long_spill_slots_.size(),
+               float_spill_slots_.size(),
+               double_spill_slots_.size(),
+               catch_phi_spill_slots_,
+               ArrayRef<LiveInterval* const>(temp_intervals_));
+
+  if (kIsDebugBuild) {
+    current_register_type_ = RegisterType::kCoreRegister;
+    ValidateInternal(true);
+    current_register_type_ = RegisterType::kFpRegister;
+    ValidateInternal(true);
+  }
+}
+
+void RegisterAllocatorGraphColor::ProcessInstructions() {
+  for (HBasicBlock* block : codegen_->GetGraph()->GetLinearPostOrder()) {
+    for (HBackwardInstructionIterator back_it(block->GetInstructions()); !back_it.Done();
+         back_it.Advance()) {
+      ProcessInstruction(back_it.Current());
+    }
+    for (HInstructionIterator inst_it(block->GetPhis()); !inst_it.Done(); inst_it.Advance()) {
+      ProcessInstruction(inst_it.Current());
+    }
+
+    if (block->IsCatchBlock() ||
+        (block->IsLoopHeader() && block->GetLoopInformation()->IsIrreducible())) {
+      // By blocking all registers at the top of each catch block or irreducible loop, we force
+      // intervals belonging to the live-in set of the catch/header block to be spilled.
+      size_t position = block->GetLifetimeStart();
+      DCHECK_EQ(liveness_.GetInstructionFromPosition(position / 2u), nullptr);
+      block_registers_special_interval_->AddRange(position, position + 1u);
+    }
+  }
+}
+
+void RegisterAllocatorGraphColor::ProcessInstruction(HInstruction* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+
+  // Check for early returns.
+  if (locations == nullptr) {
+    return;
+  }
+  if (TryRemoveSuspendCheckEntry(instruction)) {
+    return;
+  }
+
+  bool will_call = locations->WillCall();
+  if (will_call) {
+    // If a call will happen, add the range to a fixed interval that represents all the
+    // caller-save registers blocked at call sites.
+    const size_t position = instruction->GetLifetimePosition();
+    DCHECK_NE(liveness_.GetInstructionFromPosition(position / 2u), nullptr);
+    block_registers_for_call_interval_->AddRange(position, position + 1u);
+  }
+  CheckForTempLiveIntervals(instruction, will_call);
+  CheckForSafepoint(instruction);
+  CheckForFixedInputs(instruction, will_call);
+
+  LiveInterval* current = instruction->GetLiveInterval();
+  if (current == nullptr) {
+    return;
+  }
+
+  const bool core_register = !DataType::IsFloatingPointType(instruction->GetType());
+  ScopedArenaVector<LiveInterval*>& intervals = core_register ? core_intervals_ : fp_intervals_;
+
+  if (codegen_->NeedsTwoRegisters(current->GetType())) {
+    current->AddHighInterval();
+  }
+
+  AddSafepointsFor(instruction);
+  current->ResetSearchCache();
+  CheckForFixedOutput(instruction, will_call);
+
+  if (instruction->IsPhi() && instruction->AsPhi()->IsCatchPhi()) {
+    AllocateSpillSlotForCatchPhi(instruction->AsPhi());
+  }
+
+  if (current->HasSpillSlot() || instruction->IsConstant()) {
+    // Split just before first register use.
+    size_t first_register_use = current->FirstRegisterUse();
+    if (first_register_use != kNoLifetime) {
+      intervals.push_back(SplitBetween(current, current->GetStart(), first_register_use - 1));
+    } else {
+      // Nothing to do, we won't allocate a register for this value.
+    }
+  } else {
+    intervals.push_back(current);
+  }
+}
+
+bool RegisterAllocatorGraphColor::TryRemoveSuspendCheckEntry(HInstruction* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  if (instruction->IsSuspendCheckEntry() && !codegen_->NeedsSuspendCheckEntry()) {
+    // We do not want the suspend check to artificially create live registers.
+    DCHECK_EQ(locations->GetTempCount(), 0u);
+    instruction->GetBlock()->RemoveInstruction(instruction);
+    return true;
+  }
+  return false;
+}
+
+void RegisterAllocatorGraphColor::CheckForTempLiveIntervals(HInstruction* instruction,
+                                                            bool will_call) {
+  LocationSummary* locations = instruction->GetLocations();
+  size_t position = instruction->GetLifetimePosition();
+
+  // Create synthesized intervals for temporaries.
+  for (size_t i = 0; i < locations->GetTempCount(); ++i) {
+    Location temp = locations->GetTemp(i);
+    if (temp.IsRegister() || temp.IsFpuRegister()) {
+      BlockRegister(temp, position, will_call);
+      // Ensure that an explicit temporary register is marked as being allocated.
+      codegen_->AddAllocatedRegister(temp);
+    } else {
+      DCHECK(temp.IsUnallocated());
+      switch (temp.GetPolicy()) {
+        case Location::kRequiresRegister: {
+          LiveInterval* interval =
+              LiveInterval::MakeTempInterval(allocator_, DataType::Type::kInt32);
+          temp_intervals_.push_back(interval);
+          interval->AddTempUse(instruction, i);
+          core_intervals_.push_back(interval);
+          break;
+        }
+
+        case Location::kRequiresFpuRegister: {
+          LiveInterval* interval =
+              LiveInterval::MakeTempInterval(allocator_, DataType::Type::kFloat64);
+          temp_intervals_.push_back(interval);
+          interval->AddTempUse(instruction, i);
+          if (codegen_->NeedsTwoRegisters(DataType::Type::kFloat64)) {
+            interval->AddHighInterval(/* is_temp= */ true);
+            temp_intervals_.push_back(interval->GetHighInterval());
+          }
+          fp_intervals_.push_back(interval);
+          break;
+        }
+
+        default:
+          LOG(FATAL) << "Unexpected policy for temporary location " << temp.GetPolicy();
+      }
+    }
+  }
+}
+
+void RegisterAllocatorGraphColor::CheckForSafepoint(HInstruction* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  if (locations->NeedsSafepoint()) {
+    safepoints_.push_back(instruction);
+  }
+}
+
+void RegisterAllocatorGraphColor::CheckForFixedInputs(HInstruction* instruction, bool will_call) {
+  LocationSummary* locations = instruction->GetLocations();
+  size_t position = instruction->GetLifetimePosition();
+  for (size_t i = 0; i < locations->GetInputCount(); ++i) {
+    Location input = locations->InAt(i);
+    if (input.IsRegister() || input.IsFpuRegister()) {
+      BlockRegister(input, position, will_call);
+      // Ensure that an explicit input register is marked as being allocated.
+      codegen_->AddAllocatedRegister(input);
+    } else if (input.IsPair()) {
+      BlockRegister(input.ToLow(), position, will_call);
+      BlockRegister(input.ToHigh(), position, will_call);
+      // Ensure that an explicit input register pair is marked as being allocated.
+      codegen_->AddAllocatedRegister(input.ToLow());
+      codegen_->AddAllocatedRegister(input.ToHigh());
+    }
+  }
+}
+
+void RegisterAllocatorGraphColor::AddSafepointsFor(HInstruction* instruction) {
+  LiveInterval* current = instruction->GetLiveInterval();
+  for (size_t safepoint_index = safepoints_.size(); safepoint_index > 0; --safepoint_index) {
+    HInstruction* safepoint = safepoints_[safepoint_index - 1u];
+    size_t safepoint_position = SafepointPosition::ComputePosition(safepoint);
+
+    // Test that safepoints are ordered in the optimal way.
+    DCHECK(safepoint_index == safepoints_.size() ||
+           safepoints_[safepoint_index]->GetLifetimePosition() < safepoint_position);
+
+    if (safepoint_position == current->GetStart()) {
+      // The safepoint is for this instruction, so the location of the instruction
+      // does not need to be saved.
+      DCHECK_EQ(safepoint_index, safepoints_.size());
+      DCHECK_EQ(safepoint, instruction);
+      continue;
+    } else if (current->IsDeadAt(safepoint_position)) {
+      break;
+    } else if (!current->Covers(safepoint_position)) {
+      // Hole in the interval.
+      continue;
+    }
+    current->AddSafepoint(safepoint);
+  }
+}
+
+void RegisterAllocatorGraphColor::CheckForFixedOutput(HInstruction* instruction, bool will_call) {
+  LocationSummary* locations = instruction->GetLocations();
+  size_t position = instruction->GetLifetimePosition();
+  LiveInterval* current = instruction->GetLiveInterval();
+  // Some instructions define their output in fixed register/stack slot. The interval
+  // starts with that register and is split in `SplitPrecoloredIntervals()` if the
+  // register is needed by something else later.
+  Location output = locations->Out();
+  if (output.IsUnallocated() && output.GetPolicy() == Location::kSameAsFirstInput) {
+    Location first = locations->InAt(0);
+    if (first.IsRegister() || first.IsFpuRegister()) {
+      current->SetFrom(position + 1u);
+      current->SetRegister(first.reg());
+    } else if (first.IsPair()) {
+      current->SetFrom(position + 1u);
+      current->SetRegister(first.low());
+      LiveInterval* high = current->GetHighInterval();
+      high->SetRegister(first.high());
+      high->SetFrom(position + 1u);
+    }
+  } else if (output.IsRegister() || output.IsFpuRegister()) {
+    // Shift the interval's start by one to account for the blocked register.
+    current->SetFrom(position + 1u);
+    current->SetRegister(output.reg());
+    BlockRegister(output, position, will_call);
+    // Ensure that an explicit output register is marked as being allocated.
+    codegen_->AddAllocatedRegister(output);
+  } else if (output.IsPair()) {
+    current->SetFrom(position + 1u);
+    current->SetRegister(output.low());
+    LiveInterval* high = current->GetHighInterval();
+    high->SetRegister(output.high());
+    high->SetFrom(position + 1u);
+    BlockRegister(output.ToLow(), position, will_call);
+    BlockRegister(output.ToHigh(), position, will_call);
+    // Ensure that an explicit output register pair is marked as being allocated.
+    codegen_->AddAllocatedRegister(output.ToLow());
+    codegen_->AddAllocatedRegister(output.ToHigh());
+  } else if (output.IsStackSlot() || output.IsDoubleStackSlot()) {
+    current->SetSpillSlot(output.GetStackIndex());
+  } else {
+    DCHECK(output.IsUnallocated() || output.IsConstant());
+  }
+}
+
+void RegisterAllocatorGraphColor::BlockRegister(Location location,
+                                                size_t position,
+                                                bool will_call) {
+  DCHECK(location.IsRegister() || location.IsFpuRegister());
+  int reg = location.reg();
+  if (will_call) {
+    uint32_t registers_blocked_for_call =
+        location.IsRegister() ? core_registers_blocked_for_call_ : fp_registers_blocked_for_call_;
+    if ((registers_blocked_for_call & (1u << reg)) != 0u) {
+      // Register is already marked as blocked by the `block_registers_for_call_interval_`.
+      return;
+    }
+  }
+  LiveInterval* interval = location.IsRegister()
+      ? physical_core_register_intervals_[reg]
+      : physical_fp_register_intervals_[reg];
+  DataType::Type type = location.IsRegister()
+      ? DataType::Type::kInt32
+      : DataType::Type::kFloat32;
+  if (interval == nullptr) {
+    interval = LiveInterval::MakeFixedInterval(allocator_, reg, type);
+    if (location.IsRegister()) {
+      physical_core_register_intervals_[reg] = interval;
+    } else {
+      physical_fp_register_intervals_[reg] = interval;
+    }
+  }
+  DCHECK(interval->GetRegister() == reg);
+  interval->AddRange(position, position + 1u);
+}
+
+// Returns the first position from `from` covered by both `interval` and `other`,
+// or kNoLifetime if there is none.
+static size_t FirstIntersectionFrom(LiveInterval* interval, LiveInterval* other, size_t from) {
+  LiveRange* range = interval->GetFirstRange();
+  LiveRange* other_range = other->GetFirstRange();
+  while (range != nullptr && other_range != nullptr) {
+    size_t start = std::max({range->GetStart(), other_range->GetStart(), from});
+    size_t end = std::min(range->GetEnd(), other_range->GetEnd());
+    if (start < end) {
+      return start;
+    }
+    if (range->GetEnd() <= other_range->GetEnd()) {
+      range = range->GetNext();
+    } else {
+      other_range = other_range->GetNext();
+    }
+  }
+  return kNoLifetime;
+}
+
+static LiveInterval* GetPreviousSibling(LiveInterval* interval) {
+  LiveInterval* previous = nullptr;
+  for (LiveInterval* sibling = interval->GetParent();
+       sibling != interval;
+       sibling = sibling->GetNextSibling()) {
+    previous = sibling;
+  }
+  return previous;
+}
+
+uint32_t RegisterAllocatorGraphColor::GetAllocatableRegisters() const {
+  uint32_t registers = 0u;
+  const bool* blocked = (current_register_type_ == RegisterType::kCoreRegister)
+      ? blocked_core_registers_
+      : blocked_fp_registers_;
+  for (size_t reg = 0; reg != number_of_registers_; ++reg) {
+    if (!blocked[reg]) {
+      registers |= 1u << reg;
+    }
+  }
+  return registers;
+}
+
+bool RegisterAllocatorGraphColor::IsCallerSaveRegister(int reg) const {
+  uint32_t registers_blocked_for_call = (current_register_type_ == RegisterType::kCoreRegister)
+      ? core_registers_blocked_for_call_
+      : fp_registers_blocked_for_call_;
+  DCHECK_LT(static_cast<size_t>(reg), BitSizeOf<uint32_t>());
+  return (registers_blocked_for_call & (1u << reg)) != 0u;
+}
+
+void RegisterAllocatorGraphColor::ColorIntervals(ScopedArenaVector<LiveInterval*>* intervals) {
+  ComputeBlockedPositions();
+
+  // Intervals with a fixed register keep it until something else needs that register. The
+  // other intervals are the nodes of the interference graph.
+  ScopedArenaVector<LiveInterval*> precolored(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  ScopedArenaVector<LiveInterval*> candidates(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  for (LiveInterval* interval : *intervals) {
+    (interval->HasRegister() ? precolored : candidates).push_back(interval);
+  }
+  SplitPrecoloredIntervals(precolored, &candidates);
+  // An interval split at its start lost its register and is a candidate now.
+  precolored.erase(
+      std::remove_if(precolored.begin(),
+                     precolored.end(),
+                     [](LiveInterval* interval) { return !interval->HasRegister(); }),
+      precolored.end());
+
+  for (size_t attempt = 0; ; ++attempt) {
+    bool last_attempt = (attempt == kMaxGraphColoringAttempts);
+    if (last_attempt) {
+      // Give every register use its own piece. Such pieces interfere with little more than the
+      // operands of the same instruction, which greedy coloring in order of start position
+      // can always handle, as the linear scan allocator does.
+      ScopedArenaVector<LiveInterval*> pieces(allocator_->Adapter(kArenaAllocRegisterAllocator));
+      for (LiveInterval* interval : candidates) {
+        if (interval->IsTemp() || GetSplitLevel(interval) == SplitLevel::kUse) {
+          pieces.push_back(interval);
+        } else {
+          interval->ClearRegister();
+          if (interval->HasHighInterval()) {
+            interval->GetHighInterval()->ClearRegister();
+          }
+          SplitAroundRegisterUses(interval, /* per_use= */ true, &pieces);
+        }
+      }
+      candidates.swap(pieces);
+    }
+
+    ScopedArenaVector<InterferenceNode*> nodes(allocator_->Adapter(kArenaAllocRegisterAllocator));
+    BuildInterferenceGraph(precolored, candidates, &nodes);
+    bool success = last_attempt ? ColorInOrder(nodes) : ColorOptimistically(nodes);
+    if (success) {
+      bool is_core = (current_register_type_ == RegisterType::kCoreRegister);
+      for (InterferenceNode* node : nodes) {
+        for (uint32_t reg : LowToHighBits(node->GetRegisters())) {
+          codegen_->AddAllocatedRegister(is_core ? Location::RegisterLocation(reg)
+                                                 : Location::FpuRegisterLocation(reg));
+        }
+      }
+      return;
+    }
+    if (last_attempt) {
+      LOG(FATAL) << "Graph coloring register allocation failed for "
+                 << codegen_->GetGraph()->PrettyMethod();
+      UNREACHABLE();
+    }
+
+    // Split the nodes which did not get a register. The pieces without register uses stay in
+    // the spill slot, and are dropped from the intervals to color.
+    ScopedArenaVector<LiveInterval*> next_candidates(
+        allocator_->Adapter(kArenaAllocRegisterAllocator));
+    for (LiveInterval* interval : candidates) {
+      SplitLevel level = GetSplitLevel(interval);
+      if (interval->HasRegister() || interval->IsTemp() || level == SplitLevel::kUse) {
+        next_candidates.push_back(interval);
+      } else {
+        SplitAroundRegisterUses(
+            interval, /* per_use= */ level == SplitLevel::kBlock, &next_candidates);
+      }
+    }
+    candidates.swap(next_candidates);
+  }
+}
+
+void RegisterAllocatorGraphColor::ComputeBlockedPositions() {
+  blocked_positions_.clear();
+  auto add_blocked_ranges = [&](LiveInterval* interval) {
+    uint32_t registers = GetRegisterMask(interval, current_register_type_);
+    for (LiveRange* range = interval->GetFirstRange();
+         range != nullptr;
+         range = range->GetNext()) {
+      for (size_t position = range->GetStart(); position != range->GetEnd(); ++position) {
+        blocked_positions_.push_back(std::make_pair(position, registers));
+      }
+    }
+  };
+  for (LiveInterval* block_registers_interval : { block_registers_for_call_interval_,
+                                                  block_registers_special_interval_ }) {
+    if (block_registers_interval->GetFirstRange() != nullptr) {
+      add_blocked_ranges(block_registers_interval);
+    }
+  }
+  const ScopedArenaVector<LiveInterval*>& physical_register_intervals =
+      (current_register_type_ == RegisterType::kCoreRegister)
+          ? physical_core_register_intervals_
+          : physical_fp_register_intervals_;
+  for (LiveInterval* fixed : physical_register_intervals) {
+    if (fixed != nullptr) {
+      add_blocked_ranges(fixed);
+    }
+  }
+
+  // Sort by position and merge the registers blocked at the same position.
+  std::sort(blocked_positions_.begin(), blocked_positions_.end());
+  auto last = blocked_positions_.begin();
+  for (auto it = blocked_positions_.begin(); it != blocked_positions_.end(); ++it) {
+    if (it->first == last->first) {
+      last->second |= it->second;
+    } else {
+      *++last = *it;
+    }
+  }
+  if (!blocked_positions_.empty()) {
+    blocked_positions_.erase(last + 1, blocked_positions_.end());
+  }
+}
+
+uint32_t RegisterAllocatorGraphColor::GetBlockedRegistersIn(LiveInterval* interval) const {
+  uint32_t registers = 0u;
+  for (LiveRange* range = interval->GetFirstRange(); range != nullptr; range = range->GetNext()) {
+    auto it = std::lower_bound(
+        blocked_positions_.begin(),
+        blocked_positions_.end(),
+        range->GetStart(),
+        [](const std::pair<size_t, uint32_t>& entry, size_t position) {
+          return entry.first < position;
+        });
+    for (; it != blocked_positions_.end() && it->first < range->GetEnd(); ++it) {
+      registers |= it->second;
+    }
+  }
+  return registers;
+}
+
+void RegisterAllocatorGraphColor::SplitPrecoloredIntervals(
+    const ScopedArenaVector<LiveInterval*>& intervals,
+    ScopedArenaVector<LiveInterval*>* candidates) {
+  ScopedArenaVector<LiveInterval*> precolored(intervals, intervals.get_allocator());
+  std::sort(precolored.begin(), precolored.end(), [](LiveInterval* lhs, LiveInterval* rhs) {
+    return lhs->GetStart() < rhs->GetStart();
+  });
+
+  auto get_registers = [](LiveInterval* interval) {
+    uint32_t registers = 1u << interval->GetRegister();
+    if (interval->HasHighInterval()) {
+      registers |= 1u << interval->GetHighInterval()->GetRegister();
+    }
+    return registers;
+  };
+
+  for (size_t i = 0; i != precolored.size(); ++i) {
+    LiveInterval* interval = precolored[i];
+    uint32_t registers = get_registers(interval);
+    // Find the first position where the fixed register is needed by an instruction, a call,
+    // or another interval with a fixed register starting later.
+    size_t conflict = kNoLifetime;
+    for (LiveRange* range = interval->GetFirstRange();
+         range != nullptr && conflict == kNoLifetime;
+         range = range->GetNext()) {
+      for (auto it = std::lower_bound(
+               blocked_positions_.begin(),
+               blocked_positions_.end(),
+               range->GetStart(),
+               [](const std::pair<size_t, uint32_t>& entry, size_t position) {
+                 return entry.first < position;
+               });
+           it != blocked_positions_.end() && it->first < range->GetEnd();
+           ++it) {
+        if ((it->second & registers) != 0u) {
+          conflict = it->first;
+          break;
+        }
+      }
+    }
+    for (size_t j = i + 1; j != precolored.size(); ++j) {
+      LiveInterval* other = precolored[j];
+      if (other->GetStart() >= std::min(conflict, interval->GetEnd())) {
+        break;
+      }
+      if ((get_registers(other) & registers) != 0u && other->GetStart() > interval->GetStart()) {
+        conflict = std::min(conflict, FirstIntersectionFrom(interval, other, 0u));
+      }
+    }
+    if (conflict != kNoLifetime) {
+      DCHECK_GT(conflict, interval->GetStart());
+      LiveInterval* split = SplitBetween(interval, interval->GetStart(), conflict);
+      DCHECK(!split->HasRegister());
+      candidates->push_back(split);
+    }
+  }
+}
+
+RegisterAllocatorGraphColor::SplitLevel RegisterAllocatorGraphColor::GetSplitLevel(
+    LiveInterval* interval) const {
+  auto it = split_levels_.find(interval);
+  return (it != split_levels_.end()) ? it->second : SplitLevel::kNone;
+}
+
+bool RegisterAllocatorGraphColor::Interferes(LiveInterval* interval, LiveInterval* other) const {
+  size_t position = FirstIntersectionFrom(interval, other, 0u);
+  if (position == kNoLifetime) {
+    return false;
+  }
+  // An interval that starts an instruction may re-use the register of an input of that
+  // instruction which dies there, based on the location summary. See also
+  // `LiveInterval::CanUseInputRegister()`.
+  auto can_use_input_register = [position](LiveInterval* output, LiveInterval* input) {
+    HInstruction* defined_by = output->GetDefinedBy();
+    if (defined_by == nullptr ||
+        output->IsSplit() ||
+        output->IsHighInterval() ||
+        defined_by->GetLifetimePosition() != position) {
+      return false;
+    }
+    LocationSummary* locations = defined_by->GetLocations();
+    if (locations->OutputCanOverlapWithInputs() || !locations->Out().IsUnallocated()) {
+      return false;
+    }
+    HInputsRef inputs = defined_by->GetInputs();
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      if (locations->InAt(i).IsValid() && inputs[i]->GetLiveInterval() == input->GetParent()) {
+        return true;
+      }
+    }
+    return false;
+  };
+  if (can_use_input_register(interval, other) || can_use_input_register(other, interval)) {
+    return FirstIntersectionFrom(interval, other, position + 1u) != kNoLifetime;
+  }
+  return true;
+}
+
+void RegisterAllocatorGraphColor::BuildInterferenceGraph(
+    const ScopedArenaVector<LiveInterval*>& precolored,
+    const ScopedArenaVector<LiveInterval*>& candidates,
+    ScopedArenaVector<InterferenceNode*>* nodes) {
+  uint32_t allocatable_registers = GetAllocatableRegisters();
+
+  // Each candidate is a node of the graph. Registers from a previous attempt are cleared so
+  // that they are not used as hints.
+  ScopedArenaVector<std::pair<LiveInterval*, InterferenceNode*>> sorted(
+      allocator_->Adapter(kArenaAllocRegisterAllocator));
+  sorted.reserve(precolored.size() + candidates.size());
+  for (LiveInterval* interval : precolored) {
+    sorted.push_back(std::make_pair(interval, nullptr));
+  }
+  for (LiveInterval* interval : candidates) {
+    DCHECK(!interval->IsHighInterval());
+    interval->ClearRegister();
+    if (interval->HasHighInterval()) {
+      interval->GetHighInterval()->ClearRegister();
+    }
+    bool is_minimal = interval->IsTemp() || GetSplitLevel(interval) == SplitLevel::kUse;
+    InterferenceNode* node = new (allocator_) InterferenceNode(interval, is_minimal, allocator_);
+    node->forbidden = ~allocatable_registers | GetBlockedRegistersIn(interval);
+    node->spill_weight = ComputeSpillWeight(interval);
+    nodes->push_back(node);
+    sorted.push_back(std::make_pair(interval, node));
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.first->GetStart() < rhs.first->GetStart();
+  });
+
+  // Sweep over the intervals in order of start position, checking each interval against the
+  // intervals which are still live at its start.
+  ScopedArenaVector<std::pair<LiveInterval*, InterferenceNode*>> live(
+      allocator_->Adapter(kArenaAllocRegisterAllocator));
+  for (const std::pair<LiveInterval*, InterferenceNode*>& entry : sorted) {
+    LiveInterval* interval = entry.first;
+    InterferenceNode* node = entry.second;
+    size_t start = interval->GetStart();
+    live.erase(std::remove_if(live.begin(),
+                              live.end(),
+                              [start](const auto& other) { return other.first->IsDeadAt(start); }),
+               live.end());
+    for (const std::pair<LiveInterval*, InterferenceNode*>& other_entry : live) {
+      LiveInterval* other = other_entry.first;
+      InterferenceNode* other_node = other_entry.second;
+      if ((node == nullptr && other_node == nullptr) || !Interferes(interval, other)) {
+        continue;
+      }
+      if (node == nullptr) {
+        other_node->forbidden |= 1u << interval->GetRegister();
+        if (interval->HasHighInterval()) {
+          other_node->forbidden |= 1u << interval->GetHighInterval()->GetRegister();
+        }
+      } else if (other_node == nullptr) {
+        node->forbidden |= 1u << other->GetRegister();
+        if (other->HasHighInterval()) {
+          node->forbidden |= 1u << other->GetHighInterval()->GetRegister();
+        }
+      } else {
+        node->adjacent.push_back(other_node);
+        other_node->adjacent.push_back(node);
+      }
+    }
+    live.push_back(entry);
+  }
+}
+
+float RegisterAllocatorGraphColor::ComputeSpillWeight(LiveInterval* interval) const {
+  auto get_use_weight = [&](size_t position) {
+    HBasicBlock* block = liveness_.GetBlockFromPosition(position / 2);
+    float weight = 1.0f;
+    size_t depth = 0;
+    for (HLoopInformationOutwardIterator it(*block);
+         !it.Done() && depth != kMaxLoopDepthForSpillWeight;
+         it.Advance(), ++depth) {
+      weight *= kLoopSpillWeightFactor;
+    }
+    return weight;
+  };
+
+  if (interval->IsTemp()) {
+    return get_use_weight(interval->GetStart());
+  }
+  float weight = 0.0f;
+  size_t start = interval->GetStart();
+  size_t end = interval->GetEnd();
+  if (interval->IsParent() && interval->DefinitionRequiresRegister()) {
+    weight += get_use_weight(start);
+  }
+  for (const UsePosition& use : interval->GetUses()) {
+    size_t use_position = use.GetPosition();
+    if (use_position > end) {
+      break;
+    }
+    if (use_position >= start && use.RequiresRegister()) {
+      weight += get_use_weight(use_position);
+    }
+  }
+  return weight;
+}
+
+bool RegisterAllocatorGraphColor::ColorOptimistically(
+    const ScopedArenaVector<InterferenceNode*>& nodes) {
+  auto is_colorable = [](const InterferenceNode* node) {
+    uint32_t available = ~node->forbidden;
+    if (node->is_pair) {
+      available &= (available >> 1) & kLowRegistersMask;
+    }
+    return node->degree < static_cast<size_t>(POPCOUNT(available));
+  };
+
+  // Nodes which cannot be split further are spilled last, and pairs are spilled after other
+  // nodes as they are harder to color. Otherwise the cheapest nodes to spill are those with
+  // few register uses and many neighbors.
+  struct SpillCandidate {
+    InterferenceNode* node;
+    float priority;
+  };
+  auto get_spill_priority = [](const InterferenceNode* node) {
+    return node->spill_weight / static_cast<float>(node->degree + 1u);
+  };
+  auto spill_comparator = [](const SpillCandidate& lhs, const SpillCandidate& rhs) {
+    if (lhs.node->is_minimal != rhs.node->is_minimal) {
+      return lhs.node->is_minimal;
+    }
+    if (lhs.node->is_pair != rhs.node->is_pair) {
+      return lhs.node->is_pair;
+    }
+    return lhs.priority > rhs.priority;
+  };
+  ScopedArenaPriorityQueue<SpillCandidate, decltype(spill_comparator)> spill_worklist(
+      spill_comparator, allocator_->Adapter(kArenaAllocRegisterAllocator));
+  ScopedArenaVector<InterferenceNode*> simplify_worklist(
+      allocator_->Adapter(kArenaAllocRegisterAllocator));
+  ScopedArenaVector<InterferenceNode*> stack(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  stack.reserve(nodes.size());
+
+  for (InterferenceNode* node : nodes) {
+    for (InterferenceNode* adjacent : node->adjacent) {
+      node->degree += node->GetWeightOf(adjacent);
+    }
+    if (is_colorable(node)) {
+      node->in_simplify_worklist = true;
+      simplify_worklist.push_back(node);
+    } else {
+      spill_worklist.push({node, get_spill_priority(node)});
+    }
+  }
+
+  // Remove nodes from the graph, preferably those which are guaranteed to get a color.
+  while (stack.size() != nodes.size()) {
+    InterferenceNode* node = nullptr;
+    if (!simplify_worklist.empty()) {
+      node = simplify_worklist.back();
+      simplify_worklist.pop_back();
+    } else {
+      DCHECK(!spill_worklist.empty());
+      SpillCandidate candidate = spill_worklist.top();
+      spill_worklist.pop();
+      if (candidate.node->removed) {
+        continue;
+      }
+      // The degree only decreases, so an outdated priority is too low. Try again with the
+      // current priority.
+      float priority = get_spill_priority(candidate.node);
+      if (priority != candidate.priority) {
+        spill_worklist.push({candidate.node, priority});
+        continue;
+      }
+      node = candidate.node;
+    }
+    DCHECK(!node->removed);
+    node->removed = true;
+    stack.push_back(node);
+    for (InterferenceNode* adjacent : node->adjacent) {
+      if (!adjacent->removed) {
+        DCHECK_GE(adjacent->degree, adjacent->GetWeightOf(node));
+        adjacent->degree -= adjacent->GetWeightOf(node);
+        if (!adjacent->in_simplify_worklist && is_colorable(adjacent)) {
+          adjacent->in_simplify_worklist = true;
+          simplify_worklist.push_back(adjacent);
+        }
+      }
+    }
+  }
+
+  // Color the nodes in reverse order of removal. Nodes removed as spill candidates may still
+  // find a register if their neighbors share registers.
+  bool success = true;
+  for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+    if (!TryColor(*it)) {
+      success = false;
+    }
+  }
+  return success;
+}
+
+bool RegisterAllocatorGraphColor::ColorInOrder(
+    const ScopedArenaVector<InterferenceNode*>& nodes) {
+  ScopedArenaVector<InterferenceNode*> sorted(nodes, nodes.get_allocator());
+  std::sort(sorted.begin(), sorted.end(), [](InterferenceNode* lhs, InterferenceNode* rhs) {
+    if (lhs->interval->GetStart() != rhs->interval->GetStart()) {
+      return lhs->interval->GetStart() < rhs->interval->GetStart();
+    }
+    return lhs->is_pair && !rhs->is_pair;
+  });
+  for (InterferenceNode* node : sorted) {
+    if (!TryColor(node)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool RegisterAllocatorGraphColor::TryColor(InterferenceNode* node) {
+  uint32_t used = node->forbidden;
+  for (InterferenceNode* adjacent : node->adjacent) {
+    if (adjacent->interval->HasRegister()) {
+      used |= adjacent->GetRegisters();
+    }
+  }
+  uint32_t candidates = ~used & MaxInt<uint32_t>(number_of_registers_);
+  if (node->is_pair) {
+    // Keep the low registers of the available pairs.
+    candidates &= (candidates >> 1) & kLowRegistersMask;
+  }
+  if (candidates == 0u) {
+    return false;
+  }
+
+  LiveInterval* interval = node->interval;
+  int reg = FindRegisterHint(interval, candidates);
+  if (reg == kNoRegister) {
+    // Caller-save registers do not need to be saved in the frame. The registers available to
+    // an interval live across a call are all callee-save.
+    uint32_t caller_save_candidates = 0u;
+    for (uint32_t candidate : LowToHighBits(candidates)) {
+      if (IsCallerSaveRegister(candidate)) {
+        caller_save_candidates |= 1u << candidate;
+      }
+    }
+    reg = CTZ(caller_save_candidates != 0u ? caller_save_candidates : candidates);
+  }
+  interval->SetRegister(reg);
+  if (node->is_pair) {
+    interval->GetHighInterval()->SetRegister(GetHighForLowRegister(reg));
+  }
+  return true;
+}
+
+int RegisterAllocatorGraphColor::FindRegisterHint(LiveInterval* interval, uint32_t candidates) {
+  size_t* free_until = registers_array_;
+  for (size_t i = 0; i < number_of_registers_; ++i) {
+    free_until[i] = ((candidates & (1u << i)) != 0u) ? kMaxLifetimePosition : 0u;
+  }
+  int hint = interval->FindFirstRegisterHint(free_until, liveness_);
+  if (hint != kNoRegister && (candidates & (1u << hint)) != 0u) {
+    return hint;
+  }
+  if (interval->IsTemp()) {
+    return kNoRegister;
+  }
+
+  // Keep the register of an adjacent sibling to avoid a move between them.
+  LiveInterval* previous = GetPreviousSibling(interval);
+  if (previous != nullptr &&
+      previous->GetEnd() == interval->GetStart() &&
+      previous->HasRegister() &&
+      (candidates & (1u << previous->GetRegister())) != 0u) {
+    return previous->GetRegister();
+  }
+  LiveInterval* next = interval->GetNextSibling();
+  if (next != nullptr &&
+      next->GetStart() == interval->GetEnd() &&
+      next->HasRegister() &&
+      (candidates & (1u << next->GetRegister())) != 0u) {
+    return next->GetRegister();
+  }
+  return kNoRegister;
+}
+
+void RegisterAllocatorGraphColor::SplitAroundRegisterUses(
+    LiveInterval* interval, bool per_use, ScopedArenaVector<LiveInterval*>* pieces) {
+  DCHECK(!interval->IsTemp());
+  DCHECK(!interval->IsHighInterval());
+  DCHECK(!interval->HasRegister());
+  size_t start = interval->GetStart();
+  size_t end = interval->GetEnd();
+
+  // A use at the start of a split interval belongs to the previous sibling if that
+  // sibling ends there.
+  LiveInterval* previous = GetPreviousSibling(interval);
+  bool owns_use_at_start = (previous == nullptr) || (previous->GetEnd() != start);
+
+  ScopedArenaVector<size_t> register_uses(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  if (interval->IsParent() && interval->DefinitionRequiresRegister()) {
+    register_uses.push_back(start);
+  }
+  for (const UsePosition& use : interval->GetUses()) {
+    size_t use_position = use.GetPosition();
+    if (use_position > end) {
+      break;
+    }
+    if ((use_position > start || (use_position == start && owns_use_at_start)) &&
+        use.RequiresRegister() &&
+        (register_uses.empty() || register_uses.back() != use_position)) {
+      register_uses.push_back(use_position);
+    }
+  }
+
+  SplitLevel level = per_use ? SplitLevel::kUse : SplitLevel::kBlock;
+  LiveInterval* current = interval;
+  for (size_t i = 0; i != register_uses.size() && current != nullptr;) {
+    // A register use at `position` needs a register in [position - 1, position), or in
+    // [position, position + 1) for the definition and a use at the start.
+    size_t first = register_uses[i];
+    size_t piece_start = (first == start) ? start : first - 1u;
+    size_t piece_end = (first == start) ? start + 1u : first;
+    HBasicBlock* block = liveness_.GetBlockFromPosition(first / 2);
+    for (++i; i != register_uses.size(); ++i) {
+      size_t use_position = register_uses[i];
+      if (use_position - 1u > piece_end &&
+          (per_use || liveness_.GetBlockFromPosition(use_position / 2) != block)) {
+        break;
+      }
+      piece_end = std::max(piece_end, use_position);
+    }
+
+    // The part before the piece stays in the spill slot. When grouping uses by block, let
+    // `SplitBetween()` move the reload out of loops and to a block boundary.
+    if (piece_start > current->GetStart()) {
+      current = per_use
+          ? Split(current, piece_start)
+          : SplitBetween(current, current->GetStart(), piece_start);
+    }
+    LiveInterval* piece = current;
+    current = (piece_end < piece->GetEnd()) ? Split(piece, piece_end) : nullptr;
+    split_levels_.Overwrite(piece, level);
+    pieces->push_back(piece);
+  }
+}
+
+void RegisterAllocatorGraphColor::AllocateSpillSlotFor(LiveInterval* interval) {
+  DCHECK(!interval->IsHighInterval());
+  LiveInterval* parent = interval->GetParent();
+
+  // An instruction gets a spill slot for its entire lifetime. If the parent
+  // of this interval already has a spill slot, there is nothing to do.
+  if (parent->HasSpillSlot()) {
+    return;
+  }
+
+  HInstruction* defined_by = parent->GetDefinedBy();
+  DCHECK_IMPLIES(defined_by->IsPhi(), !defined_by->AsPhi()->IsCatchPhi());
+
+  if (defined_by->IsParameterValue()) {
+    // Parameters have their own stack slot.
+    parent->SetSpillSlot(codegen_->GetStackSlotOfParameter(defined_by->AsParameterValue()));
+    return;
+  }
+
+  if (defined_by->IsCurrentMethod()) {
+    parent->SetSpillSlot(0);
+    return;
+  }
+
+  if (defined_by->IsConstant()) {
+    // Constants don't need a spill slot.
+    return;
+  }
+
+  ScopedArenaVector<size_t>* spill_slots = nullptr;
+  switch (interval->GetType()) {
+    case DataType::Type::kFloat64:
+      spill_slots = &double_spill_slots_;
+      break;
+    case DataType::Type::kInt64:
+      spill_slots = &long_spill_slots_;
+      break;
+    case DataType::Type::kFloat32:
+      spill_slots = &float_spill_slots_;
+      break;
+    case DataType::Type::kReference:
+    case DataType::Type::kInt32:
+    case DataType::Type::kUint16:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kBool:
+    case DataType::Type::kInt16:
+      spill_slots = &int_spill_slots_;
+      break;
+    case DataType::Type::kUint32:
+    case DataType::Type::kUint64:
+    case DataType::Type::kVoid:
+      LOG(FATAL) << "Unexpected type for interval " << interval->GetType();
+  }
+
+  // Find first available spill slots.
+  size_t number_of_spill_slots_needed = parent->NumberOfSpillSlotsNeeded();
+  size_t slot = 0;
+  for (size_t e = spill_slots->size(); slot < e; ++slot) {
+    bool found = true;
+    for (size_t s = slot, u = std::min(slot + number_of_spill_slots_needed, e); s < u; s++) {
+      if ((*spill_slots)[s] > parent->GetStart()) {
+        found = false;  // failure
+        break;
+      }
+    }
+    if (found) {
+      break;  // success
+    }
+  }
+
+  // Need new spill slots?
+  size_t upper = slot + number_of_spill_slots_needed;
+  if (upper > spill_slots->size()) {
+    spill_slots->resize(upper);
+  }
+  // Set slots to end.
+  size_t end = interval->GetLastSibling()->GetEnd();
+  for (size_t s = slot; s < upper; s++) {
+    (*spill_slots)[s] = end;
+  }
+
+  // Note that the exact spill slot location will be computed when we resolve,
+  // that is when we know the number of spill slots for each type.
+  parent->SetSpillSlot(slot);
+}
+
+void RegisterAllocatorGraphColor::AllocateSpillSlotForCatchPhi(HPhi* phi) {
+  LiveInterval* interval = phi->GetLiveInterval();
+
+  HInstruction* previous_phi = phi->GetPrevious();
+  DCHECK(previous_phi == nullptr || previous_phi->AsPhi()->GetRegNumber() <= phi->GetRegNumber())
+      << "Phis expected to be sorted by vreg number, so that equivalent phis are adjacent.";
+
+  if (phi->IsVRegEquivalentOf(previous_phi)) {
+    // This is an equivalent of the previous phi. We need to assign the same
+    // catch phi slot.
+    DCHECK(previous_phi->GetLiveInterval()->HasSpillSlot());
+    interval->SetSpillSlot(previous_phi->GetLiveInterval()->GetSpillSlot());
+  } else {
+    // Allocate a new spill slot for this catch phi.
+    interval->SetSpillSlot(catch_phi_spill_slots_);
+    catch_phi_spill_slots_ += interval->NumberOfSpillSlotsNeeded();
+  }
+}
+
+bool RegisterAllocatorGraphColor::ValidateInternal(bool log_fatal_on_failure) const {
+  auto should_process = [](RegisterType current_register_type, LiveInterval* interval) {
+    if (interval == nullptr) {
+      return false;
+    }
+    RegisterType register_type = DataType::IsFloatingPointType(interval->GetType())
+        ? RegisterType::kFpRegister
+        : RegisterType::kCoreRegister;
+    return register_type == current_register_type;
+  };
+
+  ScopedArenaAllocator allocator(allocator_->GetArenaStack());
+  ScopedArenaVector<LiveInterval*> intervals(
+      allocator.Adapter(kArenaAllocRegisterAllocatorValidate));
+  for (size_t i = 0; i < liveness_.GetNumberOfSsaValues(); ++i) {
+    HInstruction* instruction = liveness_.GetInstructionFromSsaIndex(i);
+    if (should_process(current_register_type_, instruction->GetLiveInterval())) {
+      intervals.push_back(instruction->GetLiveInterval());
+    }
+  }
+
+  for (LiveInterval* block_registers_interval : { block_registers_for_call_interval_,
+                                                  block_registers_special_interval_ }) {
+    if (block_registers_interval->GetFirstRange() != nullptr) {
+      intervals.push_back(block_registers_interval);
+    }
+  }
+  const ScopedArenaVector<LiveInterval*>* physical_register_intervals =
+      (current_register_type_ == RegisterType::kCoreRegister)
+          ? &physical_core_register_intervals_
+          : &physical_fp_register_intervals_;
+  for (LiveInterval* fixed : *physical_register_intervals) {
+    if (fixed != nullptr) {
+      intervals.push_back(fixed);
+    }
+  }
+
+  for (LiveInterval* temp : temp_intervals_) {
+    if (should_process(current_register_type_, temp)) {
+      intervals.push_back(temp);
+    }
+  }
+
+  return ValidateIntervals(ArrayRef<LiveInterval* const>(intervals),
+                           GetNumberOfSpillSlots(),
+                           reserved_out_slots_,
+                           *codegen_,
+                           &liveness_,
+                           current_register_type_,
+                           log_fatal_on_failure);
+}
+
+}  // namespace art
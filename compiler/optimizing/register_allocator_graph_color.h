@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_GRAPH_COLOR_H_
+#define ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_GRAPH_COLOR_H_
+
+#include <utility>
+
+#include "arch/instruction_set.h"
+#include "base/macros.h"
+#include "base/scoped_arena_containers.h"
+#include "register_allocator.h"
+
+namespace art HIDDEN {
+
+class CodeGenerator;
+class HBasicBlock;
+class HGraph;
+class HInstruction;
+class HParallelMove;
+class HPhi;
+class LiveInterval;
+class Location;
+class SsaLivenessAnalysis;
+
+/**
+ * A graph coloring register allocator on an `HGraph` with SSA form.
+ *
+ * The live intervals of each register kind are the nodes of an interference graph, which is
+ * colored with Chaitin-Briggs optimistic simplification. Registers required by instructions,
+ * calls, catch blocks and irreducible loop headers are modeled as registers forbidden to the
+ * nodes live at those positions. Instead of merging nodes, moves are coalesced by biasing the
+ * color of a node towards the register of a related interval: a phi input, the first input of
+ * a same-as-first-input instruction, or a split sibling.
+ *
+ * Nodes which cannot be colored are split around their register uses, first with one piece per
+ * block (reloads are hoisted out of loops by `SplitBetween`), then with one piece per use, and
+ * the graph is colored again. The parts of an interval without register uses stay in its spill
+ * slot. The values picked for spilling are those with the lowest loop-weighted number of
+ * register uses, which makes the allocator slower than linear scan but better at keeping loop
+ * values in registers.
+ */
+class RegisterAllocatorGraphColor : public RegisterAllocator {
+ public:
+  RegisterAllocatorGraphColor(ScopedArenaAllocator* allocator,
+                              CodeGenerator* codegen,
+                              const SsaLivenessAnalysis& analysis,
+                              OptimizingCompilerStats* stats = nullptr);
+  ~RegisterAllocatorGraphColor() override;
+
+  void AllocateRegisters() override;
+
+  bool Validate(bool log_fatal_on_failure) override {
+    current_register_type_ = RegisterType::kCoreRegister;
+    if (!ValidateInternal(log_fatal_on_failure)) {
+      return false;
+    }
+    current_register_type_ = RegisterType::kFpRegister;
+    return ValidateInternal(log_fatal_on_failure);
+  }
+
+  size_t GetNumberOfSpillSlots() const {
+    return int_spill_slots_.size()
+        + long_spill_slots_.size()
+        + float_spill_slots_.size()
+        + double_spill_slots_.size()
+        + catch_phi_spill_slots_;
+  }
+
+ private:
+  struct InterferenceNode;
+
+  // How finely an interval has been split after failing to be colored.
+  enum class SplitLevel : uint8_t {
+    kNone,   // The interval has not been split by the coloring.
+    kBlock,  // One piece for the register uses in each block.
+    kUse,    // One piece for each register use. Cannot be split further.
+  };
+
+  // Collect the live intervals and register constraints of all instructions. Same as in the
+  // linear scan allocator.
+  void ProcessInstructions();
+  void ProcessInstruction(HInstruction* instruction);
+  bool TryRemoveSuspendCheckEntry(HInstruction* instruction);
+  void CheckForTempLiveIntervals(HInstruction* instruction, bool will_call);
+  void CheckForSafepoint(HInstruction* instruction);
+  void CheckForFixedInputs(HInstruction* instruction, bool will_call);
+  void AddSafepointsFor(HInstruction* instruction);
+  void CheckForFixedOutput(HInstruction* instruction, bool will_call);
+
+  // Update the interval for the register in `location` to cover [position, position + 1).
+  void BlockRegister(Location location, size_t position, bool will_call);
+
+  // Allocate registers to the intervals of the current register type.
+  void ColorIntervals(ScopedArenaVector<LiveInterval*>* intervals);
+
+  // Collect the positions where registers of the current type are blocked.
+  void ComputeBlockedPositions();
+
+  // Returns the registers blocked at any position covered by `interval`.
+  uint32_t GetBlockedRegistersIn(LiveInterval* interval) const;
+
+  // Split the `precolored` intervals where their fixed register is needed by something else.
+  // The parts after the split are added to `candidates`.
+  void SplitPrecoloredIntervals(const ScopedArenaVector<LiveInterval*>& precolored,
+                                ScopedArenaVector<LiveInterval*>* candidates);
+
+  // Build the interference graph of `candidates`. Precolored intervals are not nodes, their
+  // registers are forbidden to the nodes they interfere with instead.
+  void BuildInterferenceGraph(const ScopedArenaVector<LiveInterval*>& precolored,
+                              const ScopedArenaVector<LiveInterval*>& candidates,
+                              ScopedArenaVector<InterferenceNode*>* nodes);
+
+  // Returns whether `interval` and `other` cannot share a register.
+  bool Interferes(LiveInterval* interval, LiveInterval* other) const;
+
+  // Color `nodes` with optimistic simplification. Returns whether all nodes got a register.
+  bool ColorOptimistically(const ScopedArenaVector<InterferenceNode*>& nodes);
+
+  // Color `nodes` greedily in order of start position. Returns whether all nodes got a register.
+  bool ColorInOrder(const ScopedArenaVector<InterferenceNode*>& nodes);
+
+  // Try to find a register for `node` which is not used by its colored neighbors.
+  bool TryColor(InterferenceNode* node);
+
+  // Returns a register of `candidates` which avoids a move for `interval`, or kNoRegister.
+  int FindRegisterHint(LiveInterval* interval, uint32_t candidates);
+
+  // Returns the loop-weighted number of register uses of `interval`.
+  float ComputeSpillWeight(LiveInterval* interval) const;
+
+  // Split `interval` so that its register uses are covered by pieces which are added to
+  // `pieces`, with one piece per use or one piece per block. The parts in between stay in the
+  // spill slot.
+  void SplitAroundRegisterUses(LiveInterval* interval,
+                               bool per_use,
+                               ScopedArenaVector<LiveInterval*>* pieces);
+
+  SplitLevel GetSplitLevel(LiveInterval* interval) const;
+
+  // Allocate a spill slot for the given interval. Same as in the linear scan allocator.
+  void AllocateSpillSlotFor(LiveInterval* interval);
+
+  // Allocate a spill slot for the given catch phi. Same as in the linear scan allocator.
+  void AllocateSpillSlotForCatchPhi(HPhi* phi);
+
+  bool ValidateInternal(bool log_fatal_on_failure) const;
+  bool IsCallerSaveRegister(int reg) const;
+  uint32_t GetAllocatableRegisters() const;
+
+  // Intervals to color for each register kind: the intervals of values and temporaries, and
+  // the parts of intervals with a spill slot or of constants which need a register.
+  ScopedArenaVector<LiveInterval*> core_intervals_;
+  ScopedArenaVector<LiveInterval*> fp_intervals_;
+
+  // Fixed intervals for physical registers. Such intervals cover the positions
+  // where an instruction requires a specific register.
+  ScopedArenaVector<LiveInterval*> physical_core_register_intervals_;
+  ScopedArenaVector<LiveInterval*> physical_fp_register_intervals_;
+  LiveInterval* block_registers_for_call_interval_;
+  LiveInterval* block_registers_special_interval_;  // For catch block or irreducible loop header.
+
+  // Intervals for temporaries. Such intervals cover the positions
+  // where an instruction requires a temporary.
+  ScopedArenaVector<LiveInterval*> temp_intervals_;
+
+  // Positions where registers of the current type are blocked, with the blocked registers,
+  // sorted by position.
+  ScopedArenaVector<std::pair<size_t, uint32_t>> blocked_positions_;
+
+  // Intervals split by the coloring, with how finely they were split.
+  ScopedArenaSafeMap<LiveInterval*, SplitLevel> split_levels_;
+
+  // The spill slots allocated for live intervals. As in the linear scan allocator,
+  // spill slots are typed.
+  ScopedArenaVector<size_t> int_spill_slots_;
+  ScopedArenaVector<size_t> long_spill_slots_;
+  ScopedArenaVector<size_t> float_spill_slots_;
+  ScopedArenaVector<size_t> double_spill_slots_;
+
+  // Spill slots allocated to catch phis.
+  size_t catch_phi_spill_slots_;
+
+  // Instructions that need a safepoint.
+  ScopedArenaVector<HInstruction*> safepoints_;
+
+  // The register type we're currently processing.
+  RegisterType current_register_type_;
+
+  // Number of registers for the current register kind (core or floating point).
+  size_t number_of_registers_;
+
+  // Temporary array for register hints, allocated ahead of time for simplicity.
+  size_t* registers_array_;
+
+  // Blocked registers, as decided by the code generator.
+  bool* const blocked_core_registers_;
+  bool* const blocked_fp_registers_;
+
+  // Slots reserved for out arguments.
+  size_t reserved_out_slots_;
+
+  DISALLOW_COPY_AND_ASSIGN(RegisterAllocatorGraphColor);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_GRAPH_COLOR_H_
@@ -43,8 +43,9 @@ static bool IsLowOfUnalignedPairInterval(LiveInterval* low) {
 
 RegisterAllocatorLinearScan::RegisterAllocatorLinearScan(ScopedArenaAllocator* allocator,
                                                          CodeGenerator* codegen,
-                                                         const SsaLivenessAnalysis& liveness)
-      : RegisterAllocator(allocator, codegen, liveness),
+                                                         const SsaLivenessAnalysis& liveness,
+                                                         OptimizingCompilerStats* stats)
+      : RegisterAllocator(allocator, codegen, liveness, stats),
         unhandled_core_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
         unhandled_fp_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
         unhandled_(nullptr),
@@ -90,7 +91,7 @@ RegisterAllocatorLinearScan::~RegisterAllocatorLinearScan() {}
 
 void RegisterAllocatorLinearScan::AllocateRegisters() {
   AllocateRegistersInternal();
-  RegisterAllocationResolver(codegen_, liveness_)
+  RegisterAllocationResolver(codegen_, liveness_, stats_)
       .Resolve(ArrayRef<HInstruction* const>(safepoints_),
                reserved_out_slots_,
                int_spill_slots_.size(),
@@ -41,7 +41,8 @@ class RegisterAllocatorLinearScan : public RegisterAllocator {
  public:
   RegisterAllocatorLinearScan(ScopedArenaAllocator* allocator,
                               CodeGenerator* codegen,
-                              const SsaLivenessAnalysis& analysis);
+                              const SsaLivenessAnalysis& analysis,
+                              OptimizingCompilerStats* stats = nullptr);
   ~RegisterAllocatorLinearScan() override;
 
   void AllocateRegisters() override;
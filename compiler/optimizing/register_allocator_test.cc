@@ -27,6 +27,7 @@
 #include "dex/dex_instruction.h"
 #include "driver/compiler_options.h"
 #include "nodes.h"
+#include "optimizing_compiler_stats.h"
 #include "optimizing_unit_test.h"
 #include "register_allocator_linear_scan.h"
 #include "ssa_liveness_analysis.h"
@@ -46,11 +47,13 @@ class RegisterAllocatorTest : public CommonCompilerTest, public OptimizingUnitTe
   }
 
   // Helper functions that make use of the OptimizingUnitTest's members.
-  bool Check(const std::vector<uint16_t>& data);
+  bool Check(const std::vector<uint16_t>& data,
+             RegisterAllocator::Strategy strategy = RegisterAllocator::kRegisterAllocatorDefault);
   HGraph* BuildIfElseWithPhi(HPhi** phi, HInstruction** input1, HInstruction** input2);
   HGraph* BuildFieldReturn(HInstruction** field, HInstruction** ret);
   HGraph* BuildTwoSubs(HInstruction** first_sub, HInstruction** second_sub);
   HGraph* BuildDiv(HInstruction** div);
+  HGraph* BuildManyLiveValues();
 
   bool ValidateIntervals(const ScopedArenaVector<LiveInterval*>& intervals,
                          const CodeGenerator& codegen) {
@@ -66,13 +69,14 @@ class RegisterAllocatorTest : public CommonCompilerTest, public OptimizingUnitTe
   std::unique_ptr<CompilerOptions> compiler_options_;
 };
 
-bool RegisterAllocatorTest::Check(const std::vector<uint16_t>& data) {
+bool RegisterAllocatorTest::Check(const std::vector<uint16_t>& data,
+                                  RegisterAllocator::Strategy strategy) {
   HGraph* graph = CreateCFG(data);
   x86::CodeGeneratorX86 codegen(graph, *compiler_options_);
   SsaLivenessAnalysis liveness(graph, &codegen, GetScopedAllocator());
   liveness.Analyze();
   std::unique_ptr<RegisterAllocator> register_allocator =
-      RegisterAllocator::Create(GetScopedAllocator(), &codegen, liveness);
+      RegisterAllocator::Create(GetScopedAllocator(), &codegen, liveness, strategy);
   register_allocator->AllocateRegisters();
   return register_allocator->Validate(false);
 }
@@ -173,6 +177,7 @@ TEST_F(RegisterAllocatorTest, CFG1) {
     Instruction::RETURN);
 
   ASSERT_TRUE(Check(data));
+  ASSERT_TRUE(Check(data, RegisterAllocator::kRegisterAllocatorGraphColor));
 }
 
 TEST_F(RegisterAllocatorTest, Loop1) {
@@ -212,6 +217,7 @@ TEST_F(RegisterAllocatorTest, Loop1) {
     Instruction::RETURN | 1 << 8);
 
   ASSERT_TRUE(Check(data));
+  ASSERT_TRUE(Check(data, RegisterAllocator::kRegisterAllocatorGraphColor));
 }
 
 TEST_F(RegisterAllocatorTest, Loop2) {
@@ -261,6 +267,7 @@ TEST_F(RegisterAllocatorTest, Loop2) {
     Instruction::RETURN | 1 << 8);
 
   ASSERT_TRUE(Check(data));
+  ASSERT_TRUE(Check(data, RegisterAllocator::kRegisterAllocatorGraphColor));
 }
 
 TEST_F(RegisterAllocatorTest, Loop3) {
@@ -381,15 +388,18 @@ TEST_F(RegisterAllocatorTest, DeadPhi) {
     Instruction::GOTO | 0xFD00,
     Instruction::RETURN_VOID);
 
-  HGraph* graph = CreateCFG(data);
-  SsaDeadPhiElimination(graph).Run();
-  x86::CodeGeneratorX86 codegen(graph, *compiler_options_);
-  SsaLivenessAnalysis liveness(graph, &codegen, GetScopedAllocator());
-  liveness.Analyze();
-  std::unique_ptr<RegisterAllocator> register_allocator =
-      RegisterAllocator::Create(GetScopedAllocator(), &codegen, liveness);
-  register_allocator->AllocateRegisters();
-  ASSERT_TRUE(register_allocator->Validate(false));
+  for (RegisterAllocator::Strategy strategy : {RegisterAllocator::kRegisterAllocatorLinearScan,
+                                                RegisterAllocator::kRegisterAllocatorGraphColor}) {
+    HGraph* graph = CreateCFG(data);
+    SsaDeadPhiElimination(graph).Run();
+    x86::CodeGeneratorX86 codegen(graph, *compiler_options_);
+    SsaLivenessAnalysis liveness(graph, &codegen, GetScopedAllocator());
+    liveness.Analyze();
+    std::unique_ptr<RegisterAllocator> register_allocator =
+        RegisterAllocator::Create(GetScopedAllocator(), &codegen, liveness, strategy);
+    register_allocator->AllocateRegisters();
+    ASSERT_TRUE(register_allocator->Validate(false));
+  }
 }
 
 /**
@@ -729,6 +739,49 @@ TEST_F(RegisterAllocatorTest, ExpectedExactInRegisterAndSameOutputHint) {
   ASSERT_EQ(div->GetLiveInterval()->GetRegister(), 0);
 }
 
+HGraph* RegisterAllocatorTest::BuildManyLiveValues() {
+  HBasicBlock* block = InitEntryMainExitGraph();
+  HInstruction* parameter = MakeParam(DataType::Type::kInt32);
+
+  // Define more values than x86 has core registers, and keep them all alive.
+  static constexpr int32_t kNumberOfValues = 16;
+  std::vector<HInstruction*> values;
+  for (int32_t i = 0; i != kNumberOfValues; ++i) {
+    values.push_back(MakeBinOp<HAdd>(
+        block, DataType::Type::kInt32, parameter, graph_->GetIntConstant(i)));
+  }
+  // Use them as the first input of an add, which x86 requires in a register.
+  HInstruction* sum = values.back();
+  for (int32_t i = kNumberOfValues - 1; i != 0; --i) {
+    sum = MakeBinOp<HAdd>(block, DataType::Type::kInt32, values[i - 1], sum);
+  }
+  MakeReturn(block, sum);
+
+  graph_->BuildDominatorTree();
+  return graph_;
+}
+
+TEST_F(RegisterAllocatorTest, RecordSpillsAndFills) {
+  for (RegisterAllocator::Strategy strategy : {RegisterAllocator::kRegisterAllocatorLinearScan,
+                                                RegisterAllocator::kRegisterAllocatorGraphColor}) {
+    HGraph* graph = BuildManyLiveValues();
+    x86::CodeGeneratorX86 codegen(graph, *compiler_options_);
+    SsaLivenessAnalysis liveness(graph, &codegen, GetScopedAllocator());
+    liveness.Analyze();
+
+    OptimizingCompilerStats stats;
+    std::unique_ptr<RegisterAllocator> register_allocator =
+        RegisterAllocator::Create(GetScopedAllocator(), &codegen, liveness, strategy, &stats);
+    register_allocator->AllocateRegisters();
+    ASSERT_TRUE(register_allocator->Validate(false));
+
+    // The values which do not fit in registers are stored to the stack after their definition,
+    // and loaded back for their use.
+    ASSERT_NE(stats.GetStat(MethodCompilationStat::kRegisterSpill), 0u);
+    ASSERT_NE(stats.GetStat(MethodCompilationStat::kRegisterFill), 0u);
+  }
+}
+
 // Test a bug in the register allocator, where allocating a blocked
 // register would lead to spilling an inactive interval at the wrong
 // position.
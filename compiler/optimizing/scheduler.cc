@@ -32,6 +32,14 @@
 #include "scheduler_arm.h"
 #endif
 
+#ifdef ART_ENABLE_CODEGEN_riscv64
+#include "scheduler_riscv64.h"
+#endif
+
+#ifdef ART_ENABLE_CODEGEN_x86_64
+#include "scheduler_x86_64.h"
+#endif
+
 namespace art HIDDEN {
 
 void SchedulingGraph::AddDependency(SchedulingNode* node,
@@ -762,7 +770,8 @@ bool HScheduler::IsSchedulingBarrier(const HInstruction* instr) const {
 
 bool HInstructionScheduling::Run(bool only_optimize_loop_blocks,
                                  bool schedule_randomly) {
-#if defined(ART_ENABLE_CODEGEN_arm64) || defined(ART_ENABLE_CODEGEN_arm)
+#if defined(ART_ENABLE_CODEGEN_arm64) || defined(ART_ENABLE_CODEGEN_arm) || \
+    defined(ART_ENABLE_CODEGEN_riscv64) || defined(ART_ENABLE_CODEGEN_x86_64)
   // Phase-local allocator that allocates scheduler internal data structures like
   // scheduling nodes, internel nodes map, dependencies, etc.
   CriticalPathSchedulingNodeSelector critical_path_selector;
@@ -798,6 +807,22 @@ bool HInstructionScheduling::Run(bool only_optimize_loop_blocks,
       scheduler.Schedule(graph_);
       break;
     }
+#endif
+#ifdef ART_ENABLE_CODEGEN_riscv64
+    case InstructionSet::kRiscv64: {
+      riscv64::HSchedulerRISCV64 scheduler(selector);
+      scheduler.SetOnlyOptimizeLoopBlocks(only_optimize_loop_blocks);
+      scheduler.Schedule(graph_);
+      break;
+    }
+#endif
+#ifdef ART_ENABLE_CODEGEN_x86_64
+    case InstructionSet::kX86_64: {
+      x86_64::HSchedulerX86_64 scheduler(selector);
+      scheduler.SetOnlyOptimizeLoopBlocks(only_optimize_loop_blocks);
+      scheduler.Schedule(graph_);
+      break;
+    }
 #endif
     default:
       break;
@@ -588,7 +588,7 @@ GraphAnalysisResult SsaBuilder::BuildSsa() {
   // other optimizations.
   RemoveRedundantUninitializedStrings();
 
-  if (graph_->IsCompilingOsr() && HasPhiEquivalentAtLoopEntry(graph_)) {
+  if (graph_->HasOsrEntries() && HasPhiEquivalentAtLoopEntry(graph_)) {
     return kAnalysisFailPhiEquivalentInOsr;
   }
 
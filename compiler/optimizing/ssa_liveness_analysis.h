@@ -1285,7 +1285,7 @@ class SsaLivenessAnalysis : public ValueObject {
     if (graph->IsDebuggable()) return true;
     // When compiling in OSR mode, all loops in the compiled method may be entered
     // from the interpreter via SuspendCheck; thus we need to preserve the environment.
-    if (env_holder->IsSuspendCheck() && graph->IsCompilingOsr()) return true;
+    if (env_holder->IsSuspendCheck() && graph->HasOsrEntries()) return true;
     if (graph -> IsDeadReferenceSafe()) return false;
     return instruction->GetType() == DataType::Type::kReference;
   }
@@ -52,7 +52,8 @@ void StackMapStream::BeginMethod(size_t frame_size_in_bytes,
                                  uint32_t num_dex_registers,
                                  bool baseline,
                                  bool debuggable,
-                                 bool has_should_deoptimize_flag) {
+                                 bool has_should_deoptimize_flag,
+                                 bool has_osr_entries) {
   DCHECK(!in_method_) << "Mismatched Begin/End calls";
   in_method_ = true;
   DCHECK_EQ(packed_frame_size_, 0u) << "BeginMethod was already called";
@@ -65,6 +66,7 @@ void StackMapStream::BeginMethod(size_t frame_size_in_bytes,
   baseline_ = baseline;
   debuggable_ = debuggable;
   has_should_deoptimize_flag_ = has_should_deoptimize_flag;
+  has_osr_entries_ = has_osr_entries;
 
   if (kVerifyStackMaps) {
     dchecks_.emplace_back([=](const CodeInfo& code_info) {
@@ -383,6 +385,7 @@ ScopedArenaVector<uint8_t> StackMapStream::Encode() {
   flags |= baseline_ ? CodeInfo::kIsBaseline : 0;
   flags |= debuggable_ ? CodeInfo::kIsDebuggable : 0;
   flags |= has_should_deoptimize_flag_ ? CodeInfo::kHasShouldDeoptimizeFlag : 0;
+  flags |= has_osr_entries_ ? CodeInfo::kHasOsrEntries : 0;
 
   uint32_t bit_table_flags = 0;
   ForEachBitTable([&bit_table_flags](size_t i, auto bit_table) {
@@ -417,6 +420,7 @@ ScopedArenaVector<uint8_t> StackMapStream::Encode() {
   CHECK_EQ(CodeInfo::IsBaseline(buffer.data()), baseline_);
   CHECK_EQ(CodeInfo::IsDebuggable(buffer.data()), debuggable_);
   CHECK_EQ(CodeInfo::HasShouldDeoptimizeFlag(buffer.data()), has_should_deoptimize_flag_);
+  CHECK_EQ(CodeInfo::HasOsrEntries(buffer.data()), has_osr_entries_);
 
   // Verify all written data (usually only in debug builds).
   if (kVerifyStackMaps) {
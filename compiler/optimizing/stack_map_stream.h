@@ -67,7 +67,8 @@ class StackMapStream : public DeletableArenaObject<kArenaAllocStackMapStream> {
                    uint32_t num_dex_registers,
                    bool baseline,
                    bool debuggable,
-                   bool has_should_deoptimize_flag = false);
+                   bool has_should_deoptimize_flag = false,
+                   bool has_osr_entries = false);
   void EndMethod(size_t code_size);
 
   void BeginStackMapEntry(
@@ -133,6 +134,7 @@ class StackMapStream : public DeletableArenaObject<kArenaAllocStackMapStream> {
   bool baseline_ = false;
   bool debuggable_ = false;
   bool has_should_deoptimize_flag_ = false;
+  bool has_osr_entries_ = false;
   BitTableBuilder<StackMap> stack_maps_;
   BitTableBuilder<RegisterMask> register_masks_;
   BitmapTableBuilder stack_masks_;
@@ -749,6 +749,76 @@ class X86_64Assembler final : public Assembler {
   void psrlq(XmmRegister reg, const Immediate& shift_count);
   void psrldq(XmmRegister reg, const Immediate& shift_count);
 
+  // 256-bit AVX/AVX2 vector instructions (VEX.256 encoding).
+  void vmovaps(YmmRegister dst, YmmRegister src);
+  void vmovups(YmmRegister dst, const Address& src);  // load unaligned
+  void vmovups(const Address& dst, YmmRegister src);  // store unaligned
+  void vmovupd(YmmRegister dst, const Address& src);  // load unaligned
+  void vmovupd(const Address& dst, YmmRegister src);  // store unaligned
+  void vmovdqu(YmmRegister dst, const Address& src);  // load unaligned
+  void vmovdqu(const Address& dst, YmmRegister src);  // store unaligned
+
+  void vpmovzxbw(YmmRegister dst, const Address& src);
+
+  void vpbroadcastb(YmmRegister dst, XmmRegister src);
+  void vpbroadcastw(YmmRegister dst, XmmRegister src);
+  void vpbroadcastd(YmmRegister dst, XmmRegister src);
+  void vpbroadcastq(YmmRegister dst, XmmRegister src);
+  void vbroadcastss(YmmRegister dst, XmmRegister src);
+  void vbroadcastsd(YmmRegister dst, XmmRegister src);
+  void vextracti128(XmmRegister dst, YmmRegister src, const Immediate& imm);
+
+  void vpaddb(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpaddw(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpaddd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpaddq(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpsubb(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpsubw(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpsubd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpsubq(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpmullw(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpmulld(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpmaddwd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpavgb(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpavgw(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpabsd(YmmRegister dst, YmmRegister src);
+  void vpcmpeqb(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+
+  void vpand(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpandn(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpor(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpxor(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+
+  void vaddps(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vaddpd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vsubps(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vsubpd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vmulps(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vmulpd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vdivps(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vdivpd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vandps(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vandpd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vandnps(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vandnpd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vorps(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vorpd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vxorps(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vxorpd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vcvtdq2ps(YmmRegister dst, YmmRegister src);
+
+  void vpsllw(YmmRegister dst, YmmRegister src, const Immediate& shift_count);
+  void vpslld(YmmRegister dst, YmmRegister src, const Immediate& shift_count);
+  void vpsllq(YmmRegister dst, YmmRegister src, const Immediate& shift_count);
+  void vpsraw(YmmRegister dst, YmmRegister src, const Immediate& shift_count);
+  void vpsrad(YmmRegister dst, YmmRegister src, const Immediate& shift_count);
+  void vpsrlw(YmmRegister dst, YmmRegister src, const Immediate& shift_count);
+  void vpsrld(YmmRegister dst, YmmRegister src, const Immediate& shift_count);
+  void vpsrlq(YmmRegister dst, YmmRegister src, const Immediate& shift_count);
+
+  // Zero the upper 128 bits of all YMM registers, to avoid AVX-SSE transition penalties.
+  void vzeroupper();
+
   void flds(const Address& src);
   void fstps(const Address& dst);
   void fsts(const Address& dst);
@@ -1179,6 +1249,38 @@ class X86_64Assembler final : public Assembler {
                                int SET_VEX_L,
                                int SET_VEX_PP);
 
+  // Helpers for the VEX.256 (W0) instructions on YMM registers. `reg` goes to the ModRM.reg
+  // field (a register or an opcode extension), `vvvv` is the extra source register, if any.
+  void EmitVex256Prefix(FloatRegister reg,
+                        X86_64ManagedRegister vvvv,
+                        bool rm_x,
+                        bool rm_b,
+                        int SET_VEX_M,
+                        int SET_VEX_PP);
+  void EmitVex256RegisterInstruction(uint8_t opcode,
+                                     int SET_VEX_M,
+                                     int SET_VEX_PP,
+                                     FloatRegister reg,
+                                     X86_64ManagedRegister vvvv,
+                                     FloatRegister rm);
+  void EmitVex256MemoryInstruction(uint8_t opcode,
+                                   int SET_VEX_M,
+                                   int SET_VEX_PP,
+                                   FloatRegister reg,
+                                   const Address& address);
+  void EmitVex256ArithmeticInstruction(uint8_t opcode,
+                                       int SET_VEX_M,
+                                       int SET_VEX_PP,
+                                       YmmRegister dst,
+                                       YmmRegister src1,
+                                       YmmRegister src2,
+                                       bool is_commutative);
+  void EmitVex256ShiftInstruction(uint8_t opcode,
+                                  uint8_t opcode_extension,
+                                  YmmRegister dst,
+                                  YmmRegister src,
+                                  const Immediate& shift_count);
+
   // Helper function to emit a shorter variant of XCHG if at least one operand is RAX/EAX/AX.
   bool try_xchg_rax(CpuRegister dst,
                     CpuRegister src,
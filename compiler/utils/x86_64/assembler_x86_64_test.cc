@@ -1891,6 +1891,60 @@ TEST_F(AssemblerX86_64AVXTest, VPmaddwd) {
                       "vpmaddwd %{reg3}, %{reg2}, %{reg1}"), "vpmaddwd");
 }
 
+TEST_F(AssemblerX86_64AVXTest, Ymm256Arithmetic) {
+  GetAssembler()->vpaddd(x86_64::YmmRegister(x86_64::XMM1),
+                         x86_64::YmmRegister(x86_64::XMM9),
+                         x86_64::YmmRegister(x86_64::XMM2));
+  GetAssembler()->vpsubw(x86_64::YmmRegister(x86_64::XMM12),
+                         x86_64::YmmRegister(x86_64::XMM3),
+                         x86_64::YmmRegister(x86_64::XMM10));
+  GetAssembler()->vpmulld(x86_64::YmmRegister(x86_64::XMM0),
+                          x86_64::YmmRegister(x86_64::XMM1),
+                          x86_64::YmmRegister(x86_64::XMM2));
+  GetAssembler()->vmulps(x86_64::YmmRegister(x86_64::XMM5),
+                         x86_64::YmmRegister(x86_64::XMM6),
+                         x86_64::YmmRegister(x86_64::XMM7));
+  GetAssembler()->vdivpd(x86_64::YmmRegister(x86_64::XMM8),
+                         x86_64::YmmRegister(x86_64::XMM11),
+                         x86_64::YmmRegister(x86_64::XMM4));
+  GetAssembler()->vpsrld(x86_64::YmmRegister(x86_64::XMM8),
+                         x86_64::YmmRegister(x86_64::XMM4),
+                         x86_64::Immediate(3));
+  GetAssembler()->vpabsd(x86_64::YmmRegister(x86_64::XMM2), x86_64::YmmRegister(x86_64::XMM13));
+  const char* expected = "vpaddd %ymm2, %ymm9, %ymm1\n"
+                         "vpsubw %ymm10, %ymm3, %ymm12\n"
+                         "vpmulld %ymm2, %ymm1, %ymm0\n"
+                         "vmulps %ymm7, %ymm6, %ymm5\n"
+                         "vdivpd %ymm4, %ymm11, %ymm8\n"
+                         "vpsrld $3, %ymm4, %ymm8\n"
+                         "vpabsd %ymm13, %ymm2\n";
+  DriverStr(expected, "ymm_arithmetic");
+}
+
+TEST_F(AssemblerX86_64AVXTest, Ymm256Moves) {
+  GetAssembler()->vmovdqu(x86_64::YmmRegister(x86_64::XMM3),
+                          x86_64::Address(x86_64::CpuRegister(x86_64::RAX),
+                                          x86_64::CpuRegister(x86_64::R9),
+                                          TIMES_4,
+                                          8));
+  GetAssembler()->vmovups(x86_64::Address(x86_64::CpuRegister(x86_64::RSP), 16),
+                          x86_64::YmmRegister(x86_64::XMM10));
+  GetAssembler()->vmovaps(x86_64::YmmRegister(x86_64::XMM1), x86_64::YmmRegister(x86_64::XMM2));
+  GetAssembler()->vpbroadcastd(x86_64::YmmRegister(x86_64::XMM11),
+                               x86_64::XmmRegister(x86_64::XMM3));
+  GetAssembler()->vextracti128(x86_64::XmmRegister(x86_64::XMM2),
+                               x86_64::YmmRegister(x86_64::XMM9),
+                               x86_64::Immediate(1));
+  GetAssembler()->vzeroupper();
+  const char* expected = "vmovdqu 8(%RAX,%R9,4), %ymm3\n"
+                         "vmovups %ymm10, 16(%RSP)\n"
+                         "vmovaps %ymm2, %ymm1\n"
+                         "vpbroadcastd %xmm3, %ymm11\n"
+                         "vextracti128 $1, %ymm9, %xmm2\n"
+                         "vzeroupper\n";
+  DriverStr(expected, "ymm_moves");
+}
+
 TEST_F(AssemblerX86_64AVXTest, VFmadd213ss) {
   DriverStr(RepeatFFF(&x86_64::X86_64Assembler::vfmadd213ss,
                       "vfmadd213ss %{reg3}, %{reg2}, %{reg1}"), "vfmadd213ss");
@@ -286,6 +286,15 @@ size_t DisassemblerX86::DumpInstruction(std::ostream& os, const uint8_t* instr)
     return nop_size;
   }
 
+  // VEX.128.0F.WIG 77 VZEROUPPER, emitted before calls and returns in code using YMM registers.
+  static constexpr uint8_t kVzeroupper[] = { TWO_BYTE_VEX, 0xF8, 0x77 };
+  if (memcmp(instr, kVzeroupper, sizeof(kVzeroupper)) == 0) {
+    os << FormatInstructionPointer(instr)
+       << StringPrintf(": %22s    \t       vzeroupper \n",
+                       DumpCodeHex(instr, instr + sizeof(kVzeroupper)).c_str());
+    return sizeof(kVzeroupper);
+  }
+
   const uint8_t* begin_instr = instr;
   bool have_prefixes = true;
   uint8_t prefix[4] = {0, 0, 0, 0};
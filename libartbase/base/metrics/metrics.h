@@ -19,6 +19,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <optional>
@@ -55,6 +56,8 @@
   METRIC(FullGcTracingThroughputAvg, MetricsAverage)                \
   METRIC(JitMethodCompileTotalTime, MetricsCounter)                 \
   METRIC(JitMethodCompileCount, MetricsCounter)                     \
+  METRIC(JitMethodCompileArenaPeakBytes,                            \
+         MetricsAccumulator, uint64_t, std::max)                    \
   METRIC(YoungGcCollectionTime, MetricsHistogram, 15, 0, 60'000)    \
   METRIC(FullGcCollectionTime, MetricsHistogram, 15, 0, 60'000)     \
   METRIC(YoungGcThroughput, MetricsHistogram, 15, 0, 10'000)        \
@@ -537,6 +540,12 @@ class MetricsAccumulator final : MetricsBase<T> {
     backend->ReportCounter(datum_id, static_cast<uint64_t>(Value()));
   }
 
+  void Report(const std::vector<MetricsBackend*>& backends) const {
+    for (MetricsBackend* backend : backends) {
+      Report(backend);
+    }
+  }
+
  protected:
   void Reset() {
     value_ = 0;
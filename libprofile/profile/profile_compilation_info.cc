@@ -380,6 +380,17 @@ class ProfileCompilationInfo::ProfileSource {
     return new ProfileSource(fd, MemMap::Invalid());
   }
 
+  /**
+   * Create a profile source for a profile stored at `base_offset` in the given fd,
+   * such as a record of a delta log. Offsets passed to `Seek` are relative to
+   * `base_offset`.
+   */
+  static ProfileSource* Create(int32_t fd, int64_t base_offset) {
+    DCHECK_GT(fd, -1);
+    DCHECK_GE(base_offset, 0);
+    return new ProfileSource(fd, MemMap::Invalid(), base_offset);
+  }
+
   /**
    * Create a profile source backed by a memory map. The map can be null in
    * which case it will the treated as an empty source.
@@ -405,8 +416,8 @@ class ProfileCompilationInfo::ProfileSource {
   bool HasEmptyContent() const;
 
  private:
-  ProfileSource(int32_t fd, MemMap&& mem_map)
-      : fd_(fd), mem_map_(std::move(mem_map)), mem_map_cur_(0) {}
+  ProfileSource(int32_t fd, MemMap&& mem_map, int64_t base_offset = 0)
+      : fd_(fd), mem_map_(std::move(mem_map)), mem_map_cur_(0), base_offset_(base_offset) {}
 
   bool IsMemMap() const {
     return fd_ == -1;
@@ -415,6 +426,7 @@ class ProfileCompilationInfo::ProfileSource {
   int32_t fd_;  // The fd is not owned by this class.
   MemMap mem_map_;
   size_t mem_map_cur_;  // Current position in the map to read from.
+  int64_t base_offset_;  // Offset of the profile in the fd.
 };
 
 // A helper structure to make sure we don't read past our buffers in the loops.
@@ -570,7 +582,10 @@ ProfileCompilationInfo::ProfileCompilationInfo(ArenaPool* custom_arena_pool, boo
       profile_key_map_(std::less<const std::string_view>(), allocator_.Adapter(kArenaAllocProfile)),
       extra_descriptors_(),
       extra_descriptors_indexes_(ExtraDescriptorHash(&extra_descriptors_),
-                                 ExtraDescriptorEquals(&extra_descriptors_)) {
+                                 ExtraDescriptorEquals(&extra_descriptors_)),
+      delta_log_replayed_bytes_(0),
+      delta_log_dev_(0),
+      delta_log_ino_(0) {
   memcpy(version_,
          for_boot_image ? kProfileVersionForBootImage : kProfileVersion,
          kProfileVersionSize);
@@ -769,6 +784,73 @@ bool ProfileCompilationInfo::MergeWith(const std::string& filename) {
   return false;
 }
 
+std::string ProfileCompilationInfo::GetDeltaLogFilename(const std::string& filename) {
+  return filename + ".delta";
+}
+
+bool ProfileCompilationInfo::MergeDeltaLog(const std::string& delta_filename) {
+  ScopedTrace trace(__PRETTY_FUNCTION__);
+  delta_log_replayed_bytes_ = 0;
+  std::string error;
+#ifdef _WIN32
+  int flags = O_RDONLY;
+#else
+  int flags = O_RDONLY | O_NOFOLLOW | O_CLOEXEC;
+#endif
+  ScopedFlock delta_file =
+      LockedFile::Open(delta_filename.c_str(), flags, /*block=*/false, &error);
+  if (delta_file.get() == nullptr) {
+    if (errno == ENOENT) {
+      return true;
+    }
+    LOG(WARNING) << "Couldn't lock the profile delta log " << delta_filename << ": " << error;
+    return false;
+  }
+
+  int fd = delta_file->Fd();
+  int64_t file_size = delta_file->GetLength();
+  struct stat delta_stat;
+  if (file_size < 0 || fstat(fd, &delta_stat) != 0) {
+    PLOG(WARNING) << "Couldn't get the size of the profile delta log " << delta_filename;
+    return false;
+  }
+  int64_t offset = 0;
+  while (file_size - offset >= static_cast<int64_t>(sizeof(uint32_t))) {
+    uint32_t record_size;
+    if (!android::base::ReadFullyAtOffset(fd, &record_size, sizeof(record_size), offset)) {
+      PLOG(WARNING) << "Couldn't read the profile delta log " << delta_filename;
+      return false;
+    }
+    int64_t record_offset = offset + sizeof(uint32_t);
+    if (record_size == 0u || record_size > file_size - record_offset) {
+      // A record torn by an interrupted append, as appends hold the lock. It is the last one
+      // in the log and can be dropped with the replayed records.
+      offset = file_size;
+      break;
+    }
+
+    std::unique_ptr<ProfileSource> source(ProfileSource::Create(fd, record_offset));
+    ProfileCompilationInfo delta(allocator_.GetArenaPool(), IsForBootImage());
+    ProfileLoadStatus status = source->Seek(0)
+        ? delta.LoadFromSource(*source, &error)
+        : ProfileLoadStatus::kIOError;
+    if (status != ProfileLoadStatus::kSuccess) {
+      LOG(WARNING) << "Could not load profile delta from " << delta_filename << ": " << error;
+      return false;
+    }
+    if (!MergeWith(delta)) {
+      LOG(WARNING) << "Could not merge profile delta from " << delta_filename;
+      return false;
+    }
+    offset = record_offset + record_size;
+  }
+  // Remember what we replayed, see `RemoveDeltaLog`.
+  delta_log_replayed_bytes_ = offset;
+  delta_log_dev_ = delta_stat.st_dev;
+  delta_log_ino_ = delta_stat.st_ino;
+  return true;
+}
+
 bool ProfileCompilationInfo::Load(const std::string& filename, bool clear_if_invalid) {
   ScopedTrace trace(__PRETTY_FUNCTION__);
   std::string error;
@@ -790,7 +872,8 @@ bool ProfileCompilationInfo::Load(const std::string& filename, bool clear_if_inv
 
   if (profile_file.get() == nullptr) {
     if (clear_if_invalid && errno == ENOENT) {
-      return true;
+      // Deltas may have been appended before the profile was first saved.
+      return LoadDeltaLog(filename, clear_if_invalid);
     }
     LOG(WARNING) << "Couldn't lock the profile file " << filename << ": " << error;
     return false;
@@ -800,7 +883,7 @@ bool ProfileCompilationInfo::Load(const std::string& filename, bool clear_if_inv
 
   ProfileLoadStatus status = LoadInternal(fd, &error);
   if (status == ProfileLoadStatus::kSuccess) {
-    return true;
+    return LoadDeltaLog(filename, clear_if_invalid);
   }
 
   if (clear_if_invalid &&
@@ -812,7 +895,7 @@ bool ProfileCompilationInfo::Load(const std::string& filename, bool clear_if_inv
     // When ART Service is enabled, this is the only place where we mutate a profile in place.
     // TODO(jiakaiz): Get rid of this.
     if (profile_file->ClearContent()) {
-      return true;
+      return LoadDeltaLog(filename, clear_if_invalid);
     } else {
       PLOG(WARNING) << "Could not clear profile file: " << filename;
       return false;
@@ -823,6 +906,79 @@ bool ProfileCompilationInfo::Load(const std::string& filename, bool clear_if_inv
   return false;
 }
 
+bool ProfileCompilationInfo::LoadDeltaLog(const std::string& filename, bool clear_if_invalid) {
+  std::string delta_filename = GetDeltaLogFilename(filename);
+  if (MergeDeltaLog(delta_filename)) {
+    return true;
+  }
+  if (clear_if_invalid) {
+    LOG(WARNING) << "Removing bad or obsolete profile delta log " << delta_filename;
+    if (unlink(delta_filename.c_str()) == 0 || errno == ENOENT) {
+      return true;
+    }
+    PLOG(WARNING) << "Could not remove profile delta log: " << delta_filename;
+  }
+  return false;
+}
+
+void ProfileCompilationInfo::RemoveDeltaLog(const std::string& filename) {
+  int64_t replayed_bytes = delta_log_replayed_bytes_;
+  delta_log_replayed_bytes_ = 0;
+  if (replayed_bytes == 0) {
+    // The profile holds none of the deltas, leave them for the next load.
+    return;
+  }
+
+  // Hold the lock of the delta log until it is updated, so that no record appended by
+  // another process after we replayed the log is dropped. Appends are short, so block.
+  std::string delta_filename = GetDeltaLogFilename(filename);
+  std::string error;
+#ifdef _WIN32
+  int flags = O_RDWR;
+#else
+  int flags = O_RDWR | O_NOFOLLOW | O_CLOEXEC;
+#endif
+  ScopedFlock delta_file =
+      LockedFile::Open(delta_filename.c_str(), flags, /*block=*/true, &error);
+  if (delta_file.get() == nullptr) {
+    if (errno != ENOENT) {
+      LOG(WARNING) << "Couldn't lock the profile delta log " << delta_filename << ": " << error;
+    }
+    return;
+  }
+  struct stat delta_stat;
+  if (fstat(delta_file->Fd(), &delta_stat) != 0 ||
+      delta_stat.st_dev != delta_log_dev_ ||
+      delta_stat.st_ino != delta_log_ino_) {
+    // Another process compacted the log we replayed and started a new one.
+    return;
+  }
+  int64_t file_size = delta_file->GetLength();
+  if (file_size < replayed_bytes) {
+    LOG(WARNING) << "Profile delta log " << delta_filename << " shrank since it was replayed";
+    return;
+  }
+  if (file_size == replayed_bytes) {
+    // The profile now holds all the records, the log is obsolete.
+    if (unlink(delta_filename.c_str()) != 0) {
+      PLOG(WARNING) << "Failed to remove profile delta log " << delta_filename;
+    }
+    return;
+  }
+
+  // Keep the records appended since we replayed the log.
+  std::vector<uint8_t> new_records(dchecked_integral_cast<size_t>(file_size - replayed_bytes));
+  if (!android::base::ReadFullyAtOffset(
+          delta_file->Fd(), new_records.data(), new_records.size(), replayed_bytes) ||
+      delta_file->Write(reinterpret_cast<const char*>(new_records.data()),
+                        new_records.size(),
+                        /*offset=*/ 0) != static_cast<int64_t>(new_records.size()) ||
+      delta_file->SetLength(new_records.size()) != 0) {
+    PLOG(WARNING) << "Failed to drop the compacted records of profile delta log "
+                  << delta_filename;
+  }
+}
+
 bool ProfileCompilationInfo::Save(const std::string& filename, uint64_t* bytes_written) {
   ScopedTrace trace(__PRETTY_FUNCTION__);
 
@@ -870,6 +1026,7 @@ bool ProfileCompilationInfo::Save(const std::string& filename, uint64_t* bytes_w
   }
 
   remove_tmp_file.Disable();
+  RemoveDeltaLog(filename);
 
   int64_t size = OS::GetFileSizeBytes(filename.c_str());
   if (size != -1) {
@@ -915,6 +1072,7 @@ bool ProfileCompilationInfo::SaveFallback(const std::string& filename, uint64_t*
   // access and fail immediately if we can't.
   bool result = Save(fd);
   if (result) {
+    RemoveDeltaLog(filename);
     int64_t size = OS::GetFileSizeBytes(filename.c_str());
     if (size != -1) {
       VLOG(profiler)
@@ -1001,6 +1159,13 @@ static bool WriteBuffer(int fd, const void* buffer, size_t byte_count) {
  *    type_index_diff[dex_map_size]
  * where `M` stands for special encodings indicating missing types (kIsMissingTypesEncoding)
  * or memamorphic call (kIsMegamorphicEncoding) which both imply `dex_map_size == 0`.
+ *
+ * A delta log, see `AppendToDeltaLog`, is a sequence of records:
+ *    (record_size, profile)[]
+ * where `profile` is serialized as above, with section offsets relative to its start,
+ * and `record_size` is a `uint32_t` holding its size. A record is first written with
+ * a zero `record_size`, which is filled in once the profile is complete, so that the
+ * readers ignore a record torn by an interrupted append.
  **/
 bool ProfileCompilationInfo::Save(int fd) {
   uint64_t start = NanoTime();
@@ -1059,8 +1224,13 @@ bool ProfileCompilationInfo::Save(int fd) {
     return false;
   }
 
-  // Start with an invalid file header and section infos.
-  DCHECK_EQ(lseek(fd, 0, SEEK_CUR), 0);
+  // Start with an invalid file header and section infos. Offsets in the section infos are
+  // relative to the start of the profile, which is the start of the file unless we are
+  // appending to a delta log.
+  int64_t base_offset = lseek64(fd, 0, SEEK_CUR);
+  if (base_offset == -1) {
+    return false;
+  }
   constexpr uint32_t kMaxNumberOfSections = enum_cast<uint32_t>(FileSectionType::kNumberOfSections);
   constexpr uint64_t kMaxHeaderAndInfosSize =
       sizeof(FileHeader) + kMaxNumberOfSections * sizeof(FileSectionInfo);
@@ -1155,7 +1325,8 @@ bool ProfileCompilationInfo::Save(int fd) {
   }
 
   // Write section infos.
-  if (lseek64(fd, sizeof(FileHeader), SEEK_SET) != sizeof(FileHeader)) {
+  if (lseek64(fd, base_offset + sizeof(FileHeader), SEEK_SET) !=
+          base_offset + static_cast<int64_t>(sizeof(FileHeader))) {
     return false;
   }
   SafeBuffer section_infos_buffer(section_index * 4u * sizeof(uint32_t));
@@ -1173,7 +1344,7 @@ bool ProfileCompilationInfo::Save(int fd) {
 
   // Write header.
   FileHeader header(version_, section_index);
-  if (lseek(fd, 0, SEEK_SET) != 0) {
+  if (lseek64(fd, base_offset, SEEK_SET) != base_offset) {
     return false;
   }
   if (!WriteBuffer(fd, &header, sizeof(FileHeader))) {
@@ -1189,6 +1360,62 @@ bool ProfileCompilationInfo::Save(int fd) {
   return true;
 }
 
+bool ProfileCompilationInfo::AppendToDeltaLog(const std::string& delta_filename,
+                                              uint64_t* bytes_written) {
+  ScopedTrace trace(__PRETTY_FUNCTION__);
+  std::string error;
+#ifdef _WIN32
+  int flags = O_RDWR | O_CREAT;
+#else
+  int flags = O_RDWR | O_NOFOLLOW | O_CLOEXEC | O_CREAT;
+#endif
+  // As for the profile itself, there's no need to fsync the delta log right away.
+  ScopedFlock delta_file =
+      LockedFile::Open(delta_filename.c_str(), flags, /*block=*/false, &error);
+  if (delta_file.get() == nullptr) {
+    LOG(WARNING) << "Couldn't lock the profile delta log " << delta_filename << ": " << error;
+    return false;
+  }
+
+  int fd = delta_file->Fd();
+  int64_t record_start = lseek64(fd, 0, SEEK_END);
+  if (record_start == -1) {
+    PLOG(WARNING) << "Couldn't seek to the end of the profile delta log " << delta_filename;
+    return false;
+  }
+
+  // Write the record with a zero size until the profile is complete, see `MergeDeltaLog`.
+  uint32_t record_size = 0u;
+  int64_t record_end = -1;
+  bool result = WriteBuffer(fd, &record_size, sizeof(record_size)) && Save(fd);
+  if (result) {
+    record_end = lseek64(fd, 0, SEEK_END);
+    int64_t profile_size = record_end - record_start - static_cast<int64_t>(sizeof(uint32_t));
+    result = record_end != -1 &&
+             IsUint<32>(profile_size) &&
+             lseek64(fd, record_start, SEEK_SET) == record_start;
+    if (result) {
+      record_size = dchecked_integral_cast<uint32_t>(profile_size);
+      result = WriteBuffer(fd, &record_size, sizeof(record_size));
+    }
+  }
+  if (!result) {
+    VLOG(profiler) << "Failed to append profile delta to " << delta_filename;
+    // Drop the partial record so that later appends are not hidden behind it.
+    if (delta_file->SetLength(record_start) != 0) {
+      PLOG(WARNING) << "Could not truncate profile delta log " << delta_filename;
+    }
+    return false;
+  }
+
+  VLOG(profiler) << "Successfully appended profile delta to " << delta_filename
+                 << " Size: " << (record_end - record_start);
+  if (bytes_written != nullptr) {
+    *bytes_written = static_cast<uint64_t>(record_end - record_start);
+  }
+  return true;
+}
+
 ProfileCompilationInfo::DexFileData* ProfileCompilationInfo::GetOrAddDexFileData(
     const std::string& profile_key,
     uint32_t checksum,
@@ -1527,7 +1754,7 @@ bool ProfileCompilationInfo::ProfileSource::Seek(off_t offset) {
     mem_map_cur_ = offset;
     return true;
   } else {
-    if (lseek64(fd_, offset, SEEK_SET) != offset) {
+    if (lseek64(fd_, base_offset_ + offset, SEEK_SET) != base_offset_ + offset) {
       return false;
     }
     return true;
@@ -1813,9 +2040,18 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::LoadInternal(
     return ProfileLoadStatus::kSuccess;
   }
 
+  return LoadFromSource(*source, error, merge_classes, filter_fn);
+}
+
+ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::LoadFromSource(
+    ProfileSource& source,
+    std::string* error,
+    bool merge_classes,
+    const ProfileLoadFilterFn& filter_fn) {
   // Read file header.
   FileHeader header;
-  status = source->Read(&header, sizeof(FileHeader), "ReadProfileHeader", error);
+  ProfileLoadStatus status =
+      source.Read(&header, sizeof(FileHeader), "ReadProfileHeader", error);
   if (status != ProfileLoadStatus::kSuccess) {
     return status;
   }
@@ -1839,7 +2075,7 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::LoadInternal(
 
   // Read section infos.
   dchecked_vector<FileSectionInfo> section_infos(section_count);
-  status = source->Read(
+  status = source.Read(
       section_infos.data(), section_count * sizeof(FileSectionInfo), "ReadSectionInfos", error);
   if (status != ProfileLoadStatus::kSuccess) {
     return status;
@@ -1878,7 +2114,7 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::LoadInternal(
   }
   dchecked_vector<ProfileIndexType> dex_profile_index_remap;
   status = ReadDexFilesSection(
-      *source, dex_files_section_info, filter_fn, &dex_profile_index_remap, error);
+      source, dex_files_section_info, filter_fn, &dex_profile_index_remap, error);
   if (status != ProfileLoadStatus::kSuccess) {
     DCHECK(!error->empty());
     return status;
@@ -1896,20 +2132,20 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::LoadInternal(
         break;
       case FileSectionType::kExtraDescriptors:
         status = ReadExtraDescriptorsSection(
-            *source, section_info, &extra_descriptors_remap, error);
+            source, section_info, &extra_descriptors_remap, error);
         break;
       case FileSectionType::kClasses:
         // Skip if all dex files were filtered out.
         if (!info_.empty() && merge_classes) {
           status = ReadClassesSection(
-              *source, section_info, dex_profile_index_remap, extra_descriptors_remap, error);
+              source, section_info, dex_profile_index_remap, extra_descriptors_remap, error);
         }
         break;
       case FileSectionType::kMethods:
         // Skip if all dex files were filtered out.
         if (!info_.empty()) {
           status = ReadMethodsSection(
-              *source, section_info, dex_profile_index_remap, extra_descriptors_remap, error);
+              source, section_info, dex_profile_index_remap, extra_descriptors_remap, error);
         }
         break;
       case FileSectionType::kAggregationCounts:
@@ -2059,6 +2295,83 @@ bool ProfileCompilationInfo::MergeWith(const ProfileCompilationInfo& other,
   return true;
 }
 
+void ProfileCompilationInfo::RemoveDataIn(const ProfileCompilationInfo& other) {
+  for (const std::unique_ptr<DexFileData>& dex_data : info_) {
+    const DexFileData* other_dex_data = other.FindDexData(dex_data->profile_key,
+                                                          dex_data->checksum);
+    if (other_dex_data == nullptr ||
+        other_dex_data->num_type_ids != dex_data->num_type_ids ||
+        other_dex_data->num_method_ids != dex_data->num_method_ids ||
+        other_dex_data->bitmap_storage.size() != dex_data->bitmap_storage.size()) {
+      continue;
+    }
+
+    // Types using extra descriptors have different indexes in `other`.
+    uint32_t num_type_ids = dex_data->num_type_ids;
+    auto other_contains = [&](const ArenaSet<dex::TypeIndex>& other_classes,
+                              dex::TypeIndex type_index) {
+      if (type_index.index_ >= num_type_ids) {
+        std::string_view descriptor = extra_descriptors_[type_index.index_ - num_type_ids];
+        auto it = other.extra_descriptors_indexes_.find(descriptor);
+        if (it == other.extra_descriptors_indexes_.end() ||
+            *it >= DexFile::kDexNoIndex16 - num_type_ids) {
+          return false;
+        }
+        type_index = dex::TypeIndex(num_type_ids + *it);
+      }
+      return other_classes.find(type_index) != other_classes.end();
+    };
+
+    // Remove the classes.
+    for (auto it = dex_data->class_set.begin(); it != dex_data->class_set.end(); ) {
+      it = other_contains(other_dex_data->class_set, *it) ? dex_data->class_set.erase(it)
+                                                           : std::next(it);
+    }
+
+    // Remove the inline caches that `other` knows at least as well, and the hot
+    // methods left without inline caches that are hot in `other` too.
+    for (auto method_it = dex_data->method_map.begin();
+         method_it != dex_data->method_map.end(); ) {
+      auto other_method_it = other_dex_data->method_map.find(method_it->first);
+      if (other_method_it == other_dex_data->method_map.end()) {
+        ++method_it;
+        continue;
+      }
+      InlineCacheMap* inline_cache = &method_it->second;
+      for (auto ic_it = inline_cache->begin(); ic_it != inline_cache->end(); ) {
+        auto other_ic_it = other_method_it->second.find(ic_it->first);
+        bool covered = false;
+        if (other_ic_it != other_method_it->second.end()) {
+          const DexPcData& dex_pc_data = ic_it->second;
+          const DexPcData& other_dex_pc_data = other_ic_it->second;
+          if (other_dex_pc_data.is_missing_types) {
+            covered = true;
+          } else if (dex_pc_data.is_missing_types) {
+            covered = false;
+          } else if (other_dex_pc_data.is_megamorphic) {
+            covered = true;
+          } else {
+            covered = !dex_pc_data.is_megamorphic &&
+                      std::all_of(dex_pc_data.classes.begin(),
+                                  dex_pc_data.classes.end(),
+                                  [&](dex::TypeIndex type_index) {
+                                    return other_contains(other_dex_pc_data.classes, type_index);
+                                  });
+          }
+        }
+        ic_it = covered ? inline_cache->erase(ic_it) : std::next(ic_it);
+      }
+      method_it = inline_cache->empty() ? dex_data->method_map.erase(method_it)
+                                        : std::next(method_it);
+    }
+
+    // Remove the method flags.
+    for (size_t i = 0; i < dex_data->bitmap_storage.size(); ++i) {
+      dex_data->bitmap_storage[i] &= ~other_dex_data->bitmap_storage[i];
+    }
+  }
+}
+
 ProfileCompilationInfo::MethodHotness ProfileCompilationInfo::GetMethodHotness(
     const MethodReference& method_ref,
     const ProfileSampleAnnotation& annotation) const {
@@ -2589,6 +2902,8 @@ void ProfileCompilationInfo::ClearData() {
   info_.clear();
   extra_descriptors_indexes_.clear();
   extra_descriptors_.clear();
+  // The replayed deltas are no longer part of the profile.
+  delta_log_replayed_bytes_ = 0;
 }
 
 void ProfileCompilationInfo::ClearDataAndAdjustVersion(bool for_boot_image) {
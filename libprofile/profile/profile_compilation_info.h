@@ -457,12 +457,14 @@ class ProfileCompilationInfo {
   //   the dex_file they are in.
   bool VerifyProfileData(const std::vector<const DexFile*>& dex_files);
 
-  // Loads profile information from the given file.
+  // Loads profile information from the given file, followed by the records of
+  // its delta log (see `GetDeltaLogFilename`), if any.
   // Returns true on success, false otherwise.
   // If the current profile is non-empty the load will fail.
   // If clear_if_invalid is true:
   // - If the file is invalid, the method clears the file and returns true.
   // - If the file doesn't exist, the method returns true.
+  // - If the delta log is invalid, the method removes it and returns true.
   bool Load(const std::string& filename, bool clear_if_invalid);
 
   // Merge the data from another ProfileCompilationInfo into the current object. Only merges
@@ -473,12 +475,31 @@ class ProfileCompilationInfo {
   // Merge profile information from the given file descriptor.
   bool MergeWith(const std::string& filename);
 
-  // Save the profile data to the given file descriptor.
+  // Remove the data that is also present in `other`, leaving only what `other` is missing.
+  // This is used to append only the new data to a delta log. Data of dex files with a
+  // different checksum or size in `other` is kept.
+  void RemoveDataIn(const ProfileCompilationInfo& other);
+
+  // Save the profile data to the given file descriptor, starting at its current offset.
   bool Save(int fd);
 
-  // Save the current profile into the given file. Overwrites any existing data.
+  // Save the current profile into the given file. Overwrites any existing data,
+  // including the delta log of the file.
   bool Save(const std::string& filename, uint64_t* bytes_written);
 
+  // Return the name of the append-only delta log kept next to the profile `filename`.
+  static std::string GetDeltaLogFilename(const std::string& filename);
+
+  // Append the current profile data as a new record at the end of the delta log
+  // `delta_filename`. This avoids loading and rewriting the whole profile. The
+  // records are merged back when the profile is loaded with `Load(filename, ...)`,
+  // and dropped when it is saved with `Save(filename, ...)`.
+  bool AppendToDeltaLog(const std::string& delta_filename, /*out*/ uint64_t* bytes_written);
+
+  // Merge all the complete records of the delta log `delta_filename` into the
+  // current profile. A missing delta log is treated as an empty one.
+  bool MergeDeltaLog(const std::string& delta_filename);
+
   // A fallback implementation of `Save` that uses a flock.
   bool SaveFallback(const std::string& filename, uint64_t* bytes_written);
 
@@ -1026,6 +1047,21 @@ class ProfileCompilationInfo {
       bool merge_classes = true,
       const ProfileLoadFilterFn& filter_fn = ProfileFilterFnAcceptAll);
 
+  // Merge the delta log of the profile `filename` into the current profile. If
+  // `clear_if_invalid` is true, an invalid delta log is removed instead.
+  bool LoadDeltaLog(const std::string& filename, bool clear_if_invalid);
+
+  // Remove the records of the delta log of the profile `filename` that were replayed into
+  // this profile, after the profile has been saved. Records appended since are kept.
+  void RemoveDeltaLog(const std::string& filename);
+
+  // Load the profile data from an opened source.
+  ProfileLoadStatus LoadFromSource(
+      ProfileSource& source,
+      std::string* error,
+      bool merge_classes = true,
+      const ProfileLoadFilterFn& filter_fn = ProfileFilterFnAcceptAll);
+
   // Find the data for the dex_pc in the inline cache. Adds an empty entry
   // if no previous data exists.
   static DexPcData* FindOrAddDexPc(InlineCacheMap* inline_cache, uint32_t dex_pc);
@@ -1082,6 +1118,11 @@ class ProfileCompilationInfo {
 
   // The version of the profile.
   uint8_t version_[kProfileVersionSize];
+
+  // The size and identity of the delta log prefix replayed by `Load(filename, ...)`.
+  int64_t delta_log_replayed_bytes_;
+  uint64_t delta_log_dev_;
+  uint64_t delta_log_ino_;
 };
 
 /**
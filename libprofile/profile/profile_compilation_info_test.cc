@@ -316,6 +316,101 @@ TEST_F(ProfileCompilationInfoTest, SaveFd) {
   ASSERT_TRUE(loaded_info2.Equals(saved_info));
 }
 
+TEST_F(ProfileCompilationInfoTest, DeltaLog) {
+  ScratchFile profile;
+
+  ProfileCompilationInfo saved_info;
+  for (uint16_t i = 0; i < 10; i++) {
+    ASSERT_TRUE(AddMethod(&saved_info, dex1, /*method_idx=*/ i));
+  }
+  ASSERT_TRUE(saved_info.Save(profile.GetFilename(), /*bytes_written=*/ nullptr));
+
+  // Append two deltas, the second one overlapping with the profile.
+  std::string delta_filename = ProfileCompilationInfo::GetDeltaLogFilename(profile.GetFilename());
+  ProfileCompilationInfo delta1;
+  ProfileCompilationInfo delta2;
+  for (uint16_t i = 0; i < 20; i++) {
+    ASSERT_TRUE(AddMethod(&delta1, dex2, /*method_idx=*/ i));
+    ASSERT_TRUE(AddMethod(&delta2, dex1, /*method_idx=*/ i + 5));
+  }
+  uint64_t bytes_written = 0u;
+  ASSERT_TRUE(delta1.AppendToDeltaLog(delta_filename, &bytes_written));
+  ASSERT_GT(bytes_written, 0u);
+  ASSERT_TRUE(delta2.AppendToDeltaLog(delta_filename, &bytes_written));
+  ASSERT_TRUE(saved_info.MergeWith(delta1));
+  ASSERT_TRUE(saved_info.MergeWith(delta2));
+
+  // Simulate an append interrupted before its record was complete.
+  std::unique_ptr<File> delta_file(OS::OpenFileReadWrite(delta_filename.c_str()));
+  ASSERT_TRUE(delta_file != nullptr);
+  const char torn_record[] = {0, 0, 0, 0, 'p', 'r', 'o'};
+  ASSERT_EQ(static_cast<int64_t>(sizeof(torn_record)),
+            delta_file->Write(torn_record, sizeof(torn_record), delta_file->GetLength()));
+  ASSERT_EQ(0, delta_file->FlushCloseOrErase());
+
+  // Loading the profile replays the complete deltas.
+  ProfileCompilationInfo loaded_info;
+  ASSERT_TRUE(loaded_info.Load(profile.GetFilename(), /*clear_if_invalid=*/ false));
+  ASSERT_TRUE(loaded_info.Equals(saved_info));
+
+  // Saving the profile compacts the deltas into it.
+  ASSERT_TRUE(loaded_info.Save(profile.GetFilename(), /*bytes_written=*/ nullptr));
+  ASSERT_FALSE(OS::FileExists(delta_filename.c_str()));
+  ProfileCompilationInfo compacted_info;
+  ASSERT_TRUE(compacted_info.Load(profile.GetFilename(), /*clear_if_invalid=*/ false));
+  ASSERT_TRUE(compacted_info.Equals(saved_info));
+
+  // A delta appended after the log was replayed survives the compaction.
+  ProfileCompilationInfo delta3;
+  for (uint16_t i = 0; i < 20; i++) {
+    ASSERT_TRUE(AddMethod(&delta3, dex2, /*method_idx=*/ i + 20));
+  }
+  ASSERT_TRUE(delta3.AppendToDeltaLog(delta_filename, &bytes_written));
+  ASSERT_TRUE(saved_info.MergeWith(delta3));
+  ProfileCompilationInfo loaded_info2;
+  ASSERT_TRUE(loaded_info2.Load(profile.GetFilename(), /*clear_if_invalid=*/ false));
+  ProfileCompilationInfo delta4;
+  for (uint16_t i = 0; i < 20; i++) {
+    ASSERT_TRUE(AddMethod(&delta4, dex3, /*method_idx=*/ i));
+  }
+  ASSERT_TRUE(delta4.AppendToDeltaLog(delta_filename, &bytes_written));
+  ASSERT_TRUE(loaded_info2.Equals(saved_info));
+  ASSERT_TRUE(loaded_info2.Save(profile.GetFilename(), /*bytes_written=*/ nullptr));
+  ASSERT_TRUE(OS::FileExists(delta_filename.c_str()));
+  ASSERT_TRUE(saved_info.MergeWith(delta4));
+  ProfileCompilationInfo compacted_info2;
+  ASSERT_TRUE(compacted_info2.Load(profile.GetFilename(), /*clear_if_invalid=*/ false));
+  ASSERT_TRUE(compacted_info2.Equals(saved_info));
+}
+
+TEST_F(ProfileCompilationInfoTest, RemoveDataIn) {
+  ProfileCompilationInfo info;
+  ProfileCompilationInfo last_info;
+  // Add the classes in a different order, so that they get different artificial type indexes.
+  for (uint16_t i = 0; i < 10; i++) {
+    ASSERT_TRUE(AddMethod(&info, dex1, /*method_idx=*/ i));
+    ASSERT_TRUE(info.AddClass(*dex1, "LX" + std::to_string(i) + ";"));
+    if (i % 2 == 0) {
+      ASSERT_TRUE(AddMethod(&last_info, dex1, /*method_idx=*/ 8 - i));
+      ASSERT_TRUE(last_info.AddClass(*dex1, "LX" + std::to_string(8 - i) + ";"));
+    }
+  }
+  ASSERT_TRUE(AddMethod(&last_info, dex2, /*method_idx=*/ 0));
+
+  info.RemoveDataIn(last_info);
+
+  ProfileCompilationInfo expected;
+  for (uint16_t i = 1; i < 10; i += 2) {
+    ASSERT_TRUE(AddMethod(&expected, dex1, /*method_idx=*/ i));
+    ASSERT_TRUE(expected.AddClass(*dex1, "LX" + std::to_string(i) + ";"));
+  }
+  ASSERT_EQ(expected.GetNumberOfMethods(), info.GetNumberOfMethods());
+  ASSERT_EQ(expected.GetNumberOfResolvedClasses(), info.GetNumberOfResolvedClasses());
+  for (uint16_t i = 0; i < 10; i++) {
+    ASSERT_EQ(i % 2 != 0, GetMethod(info, dex1, /*method_idx=*/ i).IsHot());
+  }
+}
+
 TEST_F(ProfileCompilationInfoTest, AddMethodsAndClassesFail) {
   ScratchFile profile;
 
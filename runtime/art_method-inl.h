@@ -31,6 +31,7 @@
 #include "dex/signature.h"
 #include "gc_root-inl.h"
 #include "imtable-inl.h"
+#include "interpreter/mterp/nterp.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache-inl.h"
 #include "jit/jit_options.h"
@@ -758,7 +759,13 @@ inline void ArtMethod::UpdateCounter(int32_t new_samples) {
     return;
   }
   uint16_t old_hotness_count = hotness_count_;
-  uint16_t new_count = (old_hotness_count <= new_samples) ? 0u : old_hotness_count - new_samples;
+  uint16_t new_count;
+  if (old_hotness_count >= interpreter::kNterpHotnessParkedValue) {
+    // Like nterp, only record that the method was executed, see `kNterpHotnessParkedValue`.
+    new_count = interpreter::kNterpHotnessParkedValue;
+  } else {
+    new_count = (old_hotness_count <= new_samples) ? 0u : old_hotness_count - new_samples;
+  }
   // Avoid dirtying the value if possible.
   if (old_hotness_count != new_count) {
     hotness_count_ = new_count;
@@ -122,6 +122,29 @@ class AtomicStack {
     return true;
   }
 
+  // Atomically append the `count` references starting at `values`, provided that at least
+  // `headroom` slots remain free below the growth limit (or below the capacity if
+  // `ignore_growth_limit` is set) afterwards. Returns false, pushing nothing, otherwise.
+  bool AtomicPushBackBatch(const StackReference<T>* values,
+                           size_t count,
+                           size_t headroom,
+                           bool ignore_growth_limit) REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (kIsDebugBuild) {
+      debug_is_sorted_ = false;
+    }
+    const size_t limit = ignore_growth_limit ? capacity_ : growth_limit_;
+    int32_t index;
+    do {
+      index = back_index_.load(std::memory_order_relaxed);
+      if (UNLIKELY(static_cast<size_t>(index) + count + headroom > limit)) {
+        // Stack overflow.
+        return false;
+      }
+    } while (!back_index_.CompareAndSetWeakRelaxed(index, index + count));
+    std::copy(values, values + count, begin_ + index);
+    return true;
+  }
+
   void AssertAllZero() REQUIRES_SHARED(Locks::mutator_lock_) {
     if (kIsDebugBuild) {
       for (size_t i = 0; i < capacity_; ++i) {
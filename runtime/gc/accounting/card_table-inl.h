@@ -19,6 +19,14 @@
 
 #include "card_table.h"
 
+#include <algorithm>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #include <android-base/logging.h>
 
 #include "base/atomic.h"
@@ -51,6 +59,86 @@ static inline bool byte_cas(uint8_t old_value, uint8_t new_value, uint8_t* addre
 #endif
 }
 
+inline uint8_t* CardTable::FindNonCleanCard(uint8_t* card_begin, uint8_t* card_end) {
+  static_assert(kCardClean == 0);
+#if defined(__AVX2__)
+  static constexpr size_t kVectorSize = sizeof(__m256i);
+#elif defined(__SSE2__) || defined(__aarch64__)
+  static constexpr size_t kVectorSize = 16;
+#else
+  static constexpr size_t kVectorSize = sizeof(uintptr_t);
+#endif
+  // Check four vectors per iteration; long runs of clean cards are the common case.
+  static constexpr size_t kBlockSize = 4 * kVectorSize;
+  uint8_t* card_cur = card_begin;
+  // Handle any unaligned cards at the start.
+  while (!IsAligned<kVectorSize>(card_cur) && card_cur < card_end) {
+    if (*card_cur != kCardClean) {
+      return card_cur;
+    }
+    ++card_cur;
+  }
+  while (card_cur + kBlockSize <= card_end) {
+#if defined(__AVX2__)
+    const __m256i* v = reinterpret_cast<const __m256i*>(card_cur);
+    const __m256i any = _mm256_or_si256(_mm256_or_si256(_mm256_load_si256(v),
+                                                        _mm256_load_si256(v + 1)),
+                                        _mm256_or_si256(_mm256_load_si256(v + 2),
+                                                        _mm256_load_si256(v + 3)));
+    const bool all_clean = _mm256_testz_si256(any, any) != 0;
+#elif defined(__SSE2__)
+    const __m128i* v = reinterpret_cast<const __m128i*>(card_cur);
+    const __m128i any = _mm_or_si128(_mm_or_si128(_mm_load_si128(v), _mm_load_si128(v + 1)),
+                                     _mm_or_si128(_mm_load_si128(v + 2), _mm_load_si128(v + 3)));
+    const bool all_clean =
+        _mm_movemask_epi8(_mm_cmpeq_epi8(any, _mm_setzero_si128())) == 0xFFFF;
+#elif defined(__aarch64__)
+    const uint8x16_t any = vorrq_u8(vorrq_u8(vld1q_u8(card_cur), vld1q_u8(card_cur + 16)),
+                                    vorrq_u8(vld1q_u8(card_cur + 32), vld1q_u8(card_cur + 48)));
+    const bool all_clean = vmaxvq_u8(any) == 0;
+#else
+    const uintptr_t* v = reinterpret_cast<const uintptr_t*>(card_cur);
+    const bool all_clean = (v[0] | v[1] | v[2] | v[3]) == 0;
+#endif
+    if (!all_clean) {
+      break;
+    }
+    card_cur += kBlockSize;
+  }
+  // Find the exact card within the block, or handle the cards at the end.
+  for (; card_cur < card_end; ++card_cur) {
+    if (*card_cur != kCardClean) {
+      return card_cur;
+    }
+  }
+  return card_end;
+}
+
+template <typename Visitor>
+inline size_t CardTable::ScanCards(ContinuousSpaceBitmap* bitmap,
+                                   uint8_t* const card_begin,
+                                   uint8_t* const card_end,
+                                   const Visitor& visitor,
+                                   const uint8_t minimum_age) {
+  size_t cards_scanned = 0;
+  uint8_t* card_cur = card_begin;
+  while (true) {
+    card_cur = FindNonCleanCard(card_cur, card_end);
+    if (card_cur == card_end) {
+      break;
+    }
+    if (*card_cur >= minimum_age) {
+      // TODO: Investigate if processing continuous runs of dirty cards with
+      // a single bitmap visit is more efficient.
+      uintptr_t start = reinterpret_cast<uintptr_t>(AddrFromCard(card_cur));
+      bitmap->VisitMarkedRange(start, start + kCardSize, visitor);
+      ++cards_scanned;
+    }
+    ++card_cur;
+  }
+  return cards_scanned;
+}
+
 template <bool kClearCard, typename Visitor>
 inline size_t CardTable::Scan(ContinuousSpaceBitmap* bitmap,
                               uint8_t* const scan_begin,
@@ -62,74 +150,69 @@ inline size_t CardTable::Scan(ContinuousSpaceBitmap* bitmap,
   DCHECK_LE(scan_end, reinterpret_cast<uint8_t*>(bitmap->HeapLimit()));
   uint8_t* const card_begin = CardFromAddr(scan_begin);
   uint8_t* const card_end = CardFromAddr(AlignUp(scan_end, kCardSize));
-  uint8_t* card_cur = card_begin;
-  CheckCardValid(card_cur);
+  CheckCardValid(card_begin);
   CheckCardValid(card_end);
-  size_t cards_scanned = 0;
+  size_t cards_scanned = ScanCards(bitmap, card_begin, card_end, visitor, minimum_age);
 
-  // Handle any unaligned cards at the start.
-  while (!IsAligned<sizeof(intptr_t)>(card_cur) && card_cur < card_end) {
-    if (*card_cur >= minimum_age) {
-      uintptr_t start = reinterpret_cast<uintptr_t>(AddrFromCard(card_cur));
-      bitmap->VisitMarkedRange(start, start + kCardSize, visitor);
-      ++cards_scanned;
-    }
-    ++card_cur;
+  if (kClearCard) {
+    ClearCardRange(scan_begin, scan_end);
   }
 
-  if (card_cur < card_end) {
-    DCHECK_ALIGNED(card_cur, sizeof(intptr_t));
-    uint8_t* aligned_end = card_end -
-        (reinterpret_cast<uintptr_t>(card_end) & (sizeof(uintptr_t) - 1));
-    DCHECK_LE(card_cur, aligned_end);
-
-    uintptr_t* word_end = reinterpret_cast<uintptr_t*>(aligned_end);
-    for (uintptr_t* word_cur = reinterpret_cast<uintptr_t*>(card_cur); word_cur < word_end;
-        ++word_cur) {
-      while (LIKELY(*word_cur == 0)) {
-        ++word_cur;
-        if (UNLIKELY(word_cur >= word_end)) {
-          goto exit_for;
-        }
-      }
+  return cards_scanned;
+}
 
-      // Find the first dirty card.
-      uintptr_t start_word = *word_cur;
-      uintptr_t start =
-          reinterpret_cast<uintptr_t>(AddrFromCard(reinterpret_cast<uint8_t*>(word_cur)));
-      // TODO: Investigate if processing continuous runs of dirty cards with
-      // a single bitmap visit is more efficient.
-      for (size_t i = 0; i < sizeof(uintptr_t); ++i) {
-        if (static_cast<uint8_t>(start_word) >= minimum_age) {
-          auto* card = reinterpret_cast<uint8_t*>(word_cur) + i;
-          DCHECK(*card == static_cast<uint8_t>(start_word) || *card == kCardDirty)
-              << "card " << static_cast<size_t>(*card) << " intptr_t " << (start_word & 0xFF);
-          bitmap->VisitMarkedRange(start, start + kCardSize, visitor);
-          ++cards_scanned;
-        }
-        start_word >>= 8;
-        start += kCardSize;
-      }
+template <typename Visitor>
+inline size_t CardTable::ScanAgedCards(ContinuousSpaceBitmap* bitmap,
+                                       uint8_t* const scan_begin,
+                                       uint8_t* const scan_end,
+                                       const Visitor& visitor,
+                                       const uint8_t minimum_age) {
+  DCHECK_GE(scan_begin, reinterpret_cast<uint8_t*>(bitmap->HeapBegin()));
+  DCHECK_LE(scan_end, reinterpret_cast<uint8_t*>(bitmap->HeapLimit()));
+  DCHECK_LT(minimum_age, kCardDirty);
+  uint8_t* const card_begin = CardFromAddr(scan_begin);
+  uint8_t* const card_end = CardFromAddr(AlignUp(scan_end, kCardSize));
+  CheckCardValid(card_begin);
+  CheckCardValid(card_end);
+  if (card_begin == card_end) {
+    return 0;
+  }
+  size_t cards_scanned = 0;
+  const size_t end_index = SummaryIndex(card_end - 1) + 1;
+  size_t index = SummaryIndex(card_begin);
+  while (index < end_index) {
+    if (!TestSummaryBit(index)) {
+      ++index;
+      continue;
     }
-    exit_for:
-
-    // Handle any unaligned cards at the end.
-    card_cur = reinterpret_cast<uint8_t*>(word_end);
-    while (card_cur < card_end) {
-      if (*card_cur >= minimum_age) {
-        uintptr_t start = reinterpret_cast<uintptr_t>(AddrFromCard(card_cur));
-        bitmap->VisitMarkedRange(start, start + kCardSize, visitor);
-        ++cards_scanned;
-      }
-      ++card_cur;
+    // Scan a run of flagged blocks at once.
+    const size_t run_begin = index;
+    while (index < end_index && TestSummaryBit(index)) {
+      ++index;
     }
+    uint8_t* run_card_begin =
+        std::max(card_begin, CardsBegin() + run_begin * kCardsPerSummaryBit);
+    uint8_t* run_card_end = std::min(card_end, CardsBegin() + index * kCardsPerSummaryBit);
+    cards_scanned += ScanCards(bitmap, run_card_begin, run_card_end, visitor, minimum_age);
   }
+  return cards_scanned;
+}
 
-  if (kClearCard) {
-    ClearCardRange(scan_begin, scan_end);
+inline void CardTable::SetSummaryBit(const uint8_t* card) {
+  const size_t index = SummaryIndex(card);
+  DCHECK_LT(index / kBitsPerIntPtrT, aged_card_summary_words_);
+  const uintptr_t mask = static_cast<uintptr_t>(1) << (index % kBitsPerIntPtrT);
+  Atomic<uintptr_t>* word = &aged_card_summary_[index / kBitsPerIntPtrT];
+  // Avoid the read-modify-write if the bit is already set, which is the common case.
+  if ((word->load(std::memory_order_relaxed) & mask) == 0) {
+    word->fetch_or(mask, std::memory_order_relaxed);
   }
+}
 
-  return cards_scanned;
+inline bool CardTable::TestSummaryBit(size_t index) const {
+  DCHECK_LT(index / kBitsPerIntPtrT, aged_card_summary_words_);
+  const uintptr_t mask = static_cast<uintptr_t>(1) << (index % kBitsPerIntPtrT);
+  return (aged_card_summary_[index / kBitsPerIntPtrT].load(std::memory_order_relaxed) & mask) != 0;
 }
 
 template <typename Visitor, typename ModifiedVisitor>
@@ -142,6 +225,9 @@ inline void CardTable::ModifyCardsAtomic(uint8_t* scan_begin,
   CheckCardValid(card_cur);
   CheckCardValid(card_end);
   DCHECK(visitor(kCardClean) == kCardClean);
+  // Recompute the aged-card summary for the blocks we cover entirely; bits of the blocks at the
+  // ends may only be set, since other cards in them are not visited.
+  ClearSummary(card_cur, card_end);
 
   // Handle any unaligned cards at the start.
   while (!IsAligned<sizeof(intptr_t)>(card_cur) && card_cur < card_end) {
@@ -153,6 +239,9 @@ inline void CardTable::ModifyCardsAtomic(uint8_t* scan_begin,
     if (expected != new_value) {
       modified(card_cur, expected, new_value);
     }
+    if (IsAgedCardValue(new_value)) {
+      SetSummaryBit(card_cur);
+    }
     ++card_cur;
   }
 
@@ -167,6 +256,9 @@ inline void CardTable::ModifyCardsAtomic(uint8_t* scan_begin,
     if (expected != new_value) {
       modified(card_end, expected, new_value);
     }
+    if (IsAgedCardValue(new_value)) {
+      SetSummaryBit(card_end);
+    }
   }
 
   // Now we have the words, we can process words in parallel.
@@ -184,6 +276,13 @@ inline void CardTable::ModifyCardsAtomic(uint8_t* scan_begin,
 
   // TODO: Parallelize.
   while (word_cur < word_end) {
+    // Skip runs of clean cards.
+    uint8_t* next_card = FindNonCleanCard(reinterpret_cast<uint8_t*>(word_cur),
+                                          reinterpret_cast<uint8_t*>(word_end));
+    word_cur = reinterpret_cast<uintptr_t*>(AlignDown(next_card, sizeof(uintptr_t)));
+    if (word_cur >= word_end) {
+      break;
+    }
     while (true) {
       expected_word = *word_cur;
       static_assert(kCardClean == 0);
@@ -195,12 +294,20 @@ inline void CardTable::ModifyCardsAtomic(uint8_t* scan_begin,
       }
       Atomic<uintptr_t>* atomic_word = reinterpret_cast<Atomic<uintptr_t>*>(word_cur);
       if (LIKELY(atomic_word->CompareAndSetWeakRelaxed(expected_word, new_word))) {
+        bool has_aged_card = false;
         for (size_t i = 0; i < sizeof(uintptr_t); ++i) {
           const uint8_t expected_byte = expected_bytes[i];
           const uint8_t new_byte = new_bytes[i];
           if (expected_byte != new_byte) {
             modified(reinterpret_cast<uint8_t*>(word_cur) + i, expected_byte, new_byte);
           }
+          has_aged_card |= IsAgedCardValue(new_byte);
+        }
+        if (has_aged_card) {
+          // The word may straddle two summary blocks.
+          uint8_t* word_cards = reinterpret_cast<uint8_t*>(word_cur);
+          SetSummaryBit(word_cards);
+          SetSummaryBit(word_cards + sizeof(uintptr_t) - 1);
         }
         break;
       }
@@ -87,8 +87,18 @@ CardTable* CardTable::Create(const uint8_t* heap_begin, size_t heap_capacity) {
   return new CardTable(std::move(mem_map), biased_begin, offset);
 }
 
+static size_t AgedCardSummaryWords(size_t num_cards) {
+  const size_t num_bits = RoundUp(num_cards, CardTable::kCardsPerSummaryBit) /
+                          CardTable::kCardsPerSummaryBit;
+  return RoundUp(num_bits, kBitsPerIntPtrT) / kBitsPerIntPtrT;
+}
+
 CardTable::CardTable(MemMap&& mem_map, uint8_t* biased_begin, size_t offset)
-    : mem_map_(std::move(mem_map)), biased_begin_(biased_begin), offset_(offset) {
+    : mem_map_(std::move(mem_map)),
+      biased_begin_(biased_begin),
+      offset_(offset),
+      aged_card_summary_words_(AgedCardSummaryWords(mem_map_.Size() - offset_)) {
+  aged_card_summary_.reset(new Atomic<uintptr_t>[aged_card_summary_words_]());
 }
 
 CardTable::~CardTable() {
@@ -98,6 +108,9 @@ CardTable::~CardTable() {
 void CardTable::ClearCardTable() {
   static_assert(kCardClean == 0, "kCardClean must be 0");
   mem_map_.MadviseDontNeedAndZero();
+  for (size_t i = 0; i < aged_card_summary_words_; ++i) {
+    aged_card_summary_[i].store(0, std::memory_order_relaxed);
+  }
 }
 
 void CardTable::ClearCardRange(uint8_t* start, uint8_t* end) {
@@ -107,6 +120,37 @@ void CardTable::ClearCardRange(uint8_t* start, uint8_t* end) {
   uint8_t* start_card = CardFromAddr(start);
   uint8_t* end_card = CardFromAddr(end);
   ZeroAndReleaseMemory(start_card, end_card - start_card);
+  ClearSummary(start_card, end_card);
+}
+
+void CardTable::ClearSummary(const uint8_t* card_begin, const uint8_t* card_end) {
+  const uint8_t* const cards_begin = CardsBegin();
+  size_t begin_index = RoundUp(static_cast<size_t>(card_begin - cards_begin), kCardsPerSummaryBit) /
+                       kCardsPerSummaryBit;
+  // The last block may extend past the end of the table, in which case it is covered as long as
+  // the range reaches the end of the table.
+  size_t end_index = (card_end >= mem_map_.End())
+      ? SummaryIndex(card_end - 1) + 1
+      : static_cast<size_t>(card_end - cards_begin) / kCardsPerSummaryBit;
+  for (size_t index = begin_index; index < end_index; ++index) {
+    const uintptr_t mask = static_cast<uintptr_t>(1) << (index % kBitsPerIntPtrT);
+    aged_card_summary_[index / kBitsPerIntPtrT].fetch_and(~mask, std::memory_order_relaxed);
+  }
+}
+
+bool CardTable::MayHaveAgedCards(const void* start, const void* end) const {
+  const uint8_t* card_begin = CardFromAddr(start);
+  const uint8_t* card_end = CardFromAddr(AlignUp(end, kCardSize));
+  if (card_begin == card_end) {
+    return false;
+  }
+  const size_t end_index = SummaryIndex(card_end - 1);
+  for (size_t index = SummaryIndex(card_begin); index <= end_index; ++index) {
+    if (TestSummaryBit(index)) {
+      return true;
+    }
+  }
+  return false;
 }
 
 bool CardTable::AddrIsInCardTable(const void* addr) const {
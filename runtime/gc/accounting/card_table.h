@@ -19,6 +19,7 @@
 
 #include <memory>
 
+#include "base/atomic.h"
 #include "base/locks.h"
 #include "base/mem_map.h"
 #include "runtime_globals.h"
@@ -51,6 +52,12 @@ class CardTable {
   static constexpr uint8_t kCardClean = 0x0;
   static constexpr uint8_t kCardDirty = 0x70;
   static constexpr uint8_t kCardAged = kCardDirty - 1;
+  // Used by generational mark-compact for old-generation cards which have
+  // already been scanned in the current cycle, but whose objects still need
+  // their references updated during compaction.
+  static constexpr uint8_t kCardAged2 = kCardAged - 1;
+  // Number of cards covered by one bit of the aged-card summary, see ScanAgedCards().
+  static constexpr size_t kCardsPerSummaryBit = 4 * KB;
 
   static CardTable* Create(const uint8_t* heap_begin, size_t heap_capacity);
   ~CardTable();
@@ -125,6 +132,27 @@ class CardTable {
       REQUIRES(Locks::heap_bitmap_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Like Scan() without clearing, but skips blocks of `kCardsPerSummaryBit` cards which held no
+  // aged card (i.e. neither kCardClean nor kCardDirty) after the last ModifyCardsAtomic() over
+  // them. Cards dirtied by mutators since then are not tracked and may be missed in such blocks,
+  // so this is only suitable for a concurrent scan of freshly aged cards which is followed by a
+  // paused scan of kCardDirty cards.
+  template <typename Visitor>
+  size_t ScanAgedCards(SpaceBitmap<kObjectAlignment>* bitmap,
+                       uint8_t* scan_begin,
+                       uint8_t* scan_end,
+                       const Visitor& visitor,
+                       const uint8_t minimum_age = kCardAged)
+      REQUIRES(Locks::heap_bitmap_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Returns the first card in [card_begin, card_end) which is not clean, or `card_end` if there
+  // is none. Uses SIMD where available.
+  ALWAYS_INLINE static uint8_t* FindNonCleanCard(uint8_t* card_begin, uint8_t* card_end);
+
+  // Whether the summary says that any card covering [start, end) may be aged.
+  bool MayHaveAgedCards(const void* start, const void* end) const;
+
   // Assertion used to check the given address is covered by the card table
   void CheckAddrIsInCardTable(const uint8_t* addr) const;
 
@@ -150,6 +178,35 @@ class CardTable {
 
   void CheckCardValid(uint8_t* card) const ALWAYS_INLINE;
 
+  // Visit the marked objects on cards in [card_begin, card_end) whose value is at least
+  // `minimum_age`. Returns how many cards were visited.
+  template <typename Visitor>
+  size_t ScanCards(SpaceBitmap<kObjectAlignment>* bitmap,
+                   uint8_t* card_begin,
+                   uint8_t* card_end,
+                   const Visitor& visitor,
+                   const uint8_t minimum_age)
+      REQUIRES(Locks::heap_bitmap_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  static bool IsAgedCardValue(uint8_t card) {
+    return card != kCardClean && card != kCardDirty;
+  }
+
+  uint8_t* CardsBegin() const {
+    return mem_map_.Begin() + offset_;
+  }
+
+  size_t SummaryIndex(const uint8_t* card) const {
+    return static_cast<size_t>(card - CardsBegin()) / kCardsPerSummaryBit;
+  }
+
+  void SetSummaryBit(const uint8_t* card) ALWAYS_INLINE;
+  bool TestSummaryBit(size_t index) const ALWAYS_INLINE;
+  // Clear the summary bits of the blocks which lie entirely within [card_begin, card_end). Blocks
+  // only partially covered may be shared with another space and are left alone.
+  void ClearSummary(const uint8_t* card_begin, const uint8_t* card_end);
+
   // Verifies that all gray objects are on a dirty card.
   void VerifyCardTable();
 
@@ -160,6 +217,11 @@ class CardTable {
   // Card table doesn't begin at the beginning of the mem_map_, instead it is displaced by offset
   // to allow the byte value of `biased_begin_` to equal `kCardDirty`.
   const size_t offset_;
+  // One bit per `kCardsPerSummaryBit` cards, set if the block may hold an aged card. Only aged
+  // values are tracked since they are only ever written by ModifyCardsAtomic(); kCardDirty is
+  // written by compiled code which knows nothing about the summary.
+  std::unique_ptr<Atomic<uintptr_t>[]> aged_card_summary_;
+  const size_t aged_card_summary_words_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(CardTable);
 };
@@ -145,6 +145,55 @@ TEST_F(CardTableTest, TestModifyCardsAtomic) {
   }
 }
 
+TEST_F(CardTableTest, TestFindNonCleanCard) {
+  CommonSetup();
+  uint8_t* const card_begin = card_table_->CardFromAddr(HeapBegin());
+  uint8_t* const card_end = card_table_->CardFromAddr(HeapLimit());
+  EXPECT_EQ(card_end, CardTable::FindNonCleanCard(card_begin, card_end));
+  const size_t num_cards = card_end - card_begin;
+  for (size_t dirty : {size_t{0}, size_t{1}, size_t{63}, size_t{64}, size_t{100}, num_cards - 1}) {
+    card_begin[dirty] = CardTable::kCardDirty;
+    // Start at various alignments before the dirty card.
+    for (size_t start = dirty >= 70 ? dirty - 70 : 0; start <= dirty; ++start) {
+      EXPECT_EQ(card_begin + dirty, CardTable::FindNonCleanCard(card_begin + start, card_end));
+    }
+    EXPECT_EQ(card_end, CardTable::FindNonCleanCard(card_begin + dirty + 1, card_end));
+    // The end is exclusive.
+    EXPECT_EQ(card_begin + dirty, CardTable::FindNonCleanCard(card_begin, card_begin + dirty));
+    card_begin[dirty] = CardTable::kCardClean;
+  }
+}
+
+TEST_F(CardTableTest, TestAgedCardSummary) {
+  static constexpr size_t kHeapSize = 64 * MB;
+  static constexpr size_t kBlockBytes = CardTable::kCardsPerSummaryBit * CardTable::kCardSize;
+  std::unique_ptr<CardTable> card_table(CardTable::Create(HeapBegin(), kHeapSize));
+  uint8_t* const heap_end = HeapBegin() + kHeapSize;
+  EXPECT_FALSE(card_table->MayHaveAgedCards(HeapBegin(), heap_end));
+  // Mutators dirty cards without updating the summary.
+  uint8_t* const addr = HeapBegin() + 2 * kBlockBytes + 5 * CardTable::kCardSize;
+  card_table->MarkCard(addr);
+  EXPECT_FALSE(card_table->MayHaveAgedCards(HeapBegin(), heap_end));
+  // Aging records the block.
+  card_table->ModifyCardsAtomic(HeapBegin(), heap_end, AgeCardVisitor(), VoidFunctor());
+  EXPECT_TRUE(card_table->MayHaveAgedCards(addr, addr + CardTable::kCardSize));
+  EXPECT_FALSE(card_table->MayHaveAgedCards(HeapBegin(), HeapBegin() + 2 * kBlockBytes));
+  EXPECT_FALSE(card_table->MayHaveAgedCards(HeapBegin() + 3 * kBlockBytes, heap_end));
+  // Aging over a partial block must not drop its bit.
+  card_table->ModifyCardsAtomic(HeapBegin(), addr - CardTable::kCardSize, AgeCardVisitor(),
+                                VoidFunctor());
+  EXPECT_TRUE(card_table->MayHaveAgedCards(addr, addr + CardTable::kCardSize));
+  // Aging again cleans the card, and the block drops out of the summary.
+  card_table->ModifyCardsAtomic(HeapBegin(), heap_end, AgeCardVisitor(), VoidFunctor());
+  EXPECT_EQ(CardTable::kCardClean, card_table->GetCard(reinterpret_cast<mirror::Object*>(addr)));
+  EXPECT_FALSE(card_table->MayHaveAgedCards(HeapBegin(), heap_end));
+  // Clearing a range drops the blocks it covers entirely.
+  card_table->MarkCard(addr);
+  card_table->ModifyCardsAtomic(HeapBegin(), heap_end, AgeCardVisitor(), VoidFunctor());
+  card_table->ClearCardRange(HeapBegin() + 2 * kBlockBytes, HeapBegin() + 3 * kBlockBytes);
+  EXPECT_FALSE(card_table->MayHaveAgedCards(HeapBegin(), heap_end));
+}
+
 // TODO: Add test for CardTable::Scan.
 }  // namespace accounting
 }  // namespace gc
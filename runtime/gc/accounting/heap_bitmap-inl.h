@@ -28,10 +28,10 @@ namespace accounting {
 template <typename Visitor>
 inline void HeapBitmap::Visit(Visitor&& visitor) {
   for (const auto& bitmap : continuous_space_bitmaps_) {
-    bitmap->VisitMarkedRange(bitmap->HeapBegin(), bitmap->HeapLimit(), visitor);
+    bitmap->VisitMarkedRangePrefetched(bitmap->HeapBegin(), bitmap->HeapLimit(), visitor);
   }
   for (const auto& bitmap : large_object_bitmaps_) {
-    bitmap->VisitMarkedRange(bitmap->HeapBegin(), bitmap->HeapLimit(), visitor);
+    bitmap->VisitMarkedRangePrefetched(bitmap->HeapBegin(), bitmap->HeapLimit(), visitor);
   }
 }
 
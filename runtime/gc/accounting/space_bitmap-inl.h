@@ -19,6 +19,7 @@
 
 #include "space_bitmap.h"
 
+#include <algorithm>
 #include <memory>
 
 #include <android-base/logging.h>
@@ -207,25 +208,39 @@ inline void SpaceBitmap<kAlignment>::VisitMarkedRange(uintptr_t visit_begin,
 #endif
 }
 
+template<size_t kAlignment>
+template<typename Visitor>
+inline void SpaceBitmap<kAlignment>::VisitMarkedRangePrefetched(uintptr_t visit_begin,
+                                                                uintptr_t visit_end,
+                                                                Visitor&& visitor) const {
+  mirror::Object* batch[kVisitBatchSize];
+  size_t count = 0;
+  auto visit_batch = [&]() {
+    for (size_t i = 0; i < std::min(count, kVisitPrefetchDistance); ++i) {
+      __builtin_prefetch(batch[i]);
+    }
+    for (size_t i = 0; i < count; ++i) {
+      if (i + kVisitPrefetchDistance < count) {
+        __builtin_prefetch(batch[i + kVisitPrefetchDistance]);
+      }
+      visitor(batch[i]);
+    }
+    count = 0;
+  };
+  VisitMarkedRange(visit_begin, visit_end, [&](mirror::Object* obj) {
+    batch[count++] = obj;
+    if (count == kVisitBatchSize) {
+      visit_batch();
+    }
+  });
+  visit_batch();
+}
+
 template<size_t kAlignment>
 template<typename Visitor>
 void SpaceBitmap<kAlignment>::Walk(Visitor&& visitor) {
   CHECK(bitmap_begin_ != nullptr);
-
-  uintptr_t end = OffsetToIndex(HeapLimit() - heap_begin_ - 1);
-  Atomic<uintptr_t>* bitmap_begin = bitmap_begin_;
-  for (uintptr_t i = 0; i <= end; ++i) {
-    uintptr_t w = bitmap_begin[i].load(std::memory_order_relaxed);
-    if (w != 0) {
-      uintptr_t ptr_base = IndexToOffset(i) + heap_begin_;
-      do {
-        const size_t shift = CTZ(w);
-        mirror::Object* obj = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
-        visitor(obj);
-        w ^= (static_cast<uintptr_t>(1)) << shift;
-      } while (w != 0);
-    }
-  }
+  VisitMarkedRangePrefetched(HeapBegin(), HeapLimit(), visitor);
 }
 
 template<size_t kAlignment>
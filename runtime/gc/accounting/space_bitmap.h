@@ -43,6 +43,11 @@ class SpaceBitmap {
   using ScanCallback = void(mirror::Object* obj, void* finger, void* arg);
   using SweepCallback = void(size_t ptr_count, mirror::Object** ptrs, void* arg);
 
+  // Number of marked objects VisitMarkedRangePrefetched() extracts before visiting them.
+  static constexpr size_t kVisitBatchSize = 32;
+  // How many objects ahead of the visitor VisitMarkedRangePrefetched() prefetches.
+  static constexpr size_t kVisitPrefetchDistance = 4;
+
   // Initialize a space bitmap so that it points to a bitmap large enough to cover a heap at
   // heap_begin of heap_capacity bytes, where objects are guaranteed to be kAlignment-aligned.
   EXPORT static SpaceBitmap Create(const std::string& name,
@@ -147,14 +152,26 @@ class SpaceBitmap {
   void VisitMarkedRange(uintptr_t visit_begin, uintptr_t visit_end, Visitor&& visitor) const
       NO_THREAD_SAFETY_ANALYSIS;
 
+  // Like VisitMarkedRange(), but extracts the addresses of up to `kVisitBatchSize` marked objects
+  // at a time and prefetches each one `kVisitPrefetchDistance` objects ahead of the visitor, so
+  // that a visitor which reads the objects doesn't stall on every cache miss. Objects are visited
+  // in address order, but bits set by the visitor itself are not guaranteed to be seen even when
+  // they lie ahead of the object being visited.
+  // TODO: Use lock annotations when clang is fixed.
+  // REQUIRES(Locks::heap_bitmap_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
+  template <typename Visitor>
+  void VisitMarkedRangePrefetched(uintptr_t visit_begin,
+                                  uintptr_t visit_end,
+                                  Visitor&& visitor) const NO_THREAD_SAFETY_ANALYSIS;
+
   // Visit all of the set bits in HeapBegin(), HeapLimit().
   template <typename Visitor>
   void VisitAllMarked(Visitor&& visitor) const {
     VisitMarkedRange(HeapBegin(), HeapLimit(), visitor);
   }
 
-  // Visits set bits in address order.  The callback is not permitted to change the bitmap bits or
-  // max during the traversal.
+  // Visits set bits in address order, prefetching the objects ahead of the callback. The
+  // callback is not permitted to change the bitmap bits or max during the traversal.
   template <typename Visitor>
   void Walk(Visitor&& visitor)
       REQUIRES_SHARED(Locks::heap_bitmap_lock_, Locks::mutator_lock_);
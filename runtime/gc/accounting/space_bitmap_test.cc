@@ -18,6 +18,7 @@
 
 #include <stdint.h>
 #include <memory>
+#include <vector>
 
 #include "base/mutex.h"
 #include "common_runtime_test.h"
@@ -274,6 +275,29 @@ TYPED_TEST(SpaceBitmapTest, OrderAlignment) {
   RunTest<SpaceBitmap>(TypeParam::GetObjectAlignment(), order_test_fn);
 }
 
+TYPED_TEST(SpaceBitmapTest, PrefetchedVisitor) {
+  using SpaceBitmap = typename TypeParam::SpaceBitmap;
+  auto prefetched_test_fn = [](SpaceBitmap* space_bitmap,
+                               uintptr_t range_begin,
+                               uintptr_t range_end,
+                               size_t manual_count) {
+    // Must visit exactly the same objects, in the same order, as VisitMarkedRange().
+    std::vector<mirror::Object*> expected;
+    space_bitmap->VisitMarkedRange(range_begin, range_end, [&expected](mirror::Object* obj) {
+      expected.push_back(obj);
+    });
+    EXPECT_EQ(manual_count, expected.size());
+    std::vector<mirror::Object*> visited;
+    space_bitmap->VisitMarkedRangePrefetched(range_begin,
+                                             range_end,
+                                             [&visited](mirror::Object* obj) {
+                                               visited.push_back(obj);
+                                             });
+    EXPECT_EQ(expected, visited);
+  };
+  RunTest<SpaceBitmap>(TypeParam::GetObjectAlignment(), prefetched_test_fn);
+}
+
 }  // namespace accounting
 }  // namespace gc
 }  // namespace art
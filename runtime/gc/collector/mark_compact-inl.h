@@ -25,18 +25,27 @@ namespace art HIDDEN {
 namespace gc {
 namespace collector {
 
+template <bool kParallel>
 inline void MarkCompact::UpdateClassAfterObjectMap(mirror::Object* obj) {
   mirror::Class* klass = obj->GetClass<kVerifyNone, kWithoutReadBarrier>();
   if (UNLIKELY(std::less<mirror::Object*>{}(obj, klass) && HasAddress(klass))) {
-    auto [iter, success] = class_after_obj_map_.try_emplace(ObjReference::FromMirrorPtr(klass),
-                                                            ObjReference::FromMirrorPtr(obj));
-    if (!success && std::less<mirror::Object*>{}(obj, iter->second.AsMirrorPtr())) {
-      iter->second = ObjReference::FromMirrorPtr(obj);
+    auto update = [this, klass, obj]() {
+      auto [iter, success] = class_after_obj_map_.try_emplace(ObjReference::FromMirrorPtr(klass),
+                                                              ObjReference::FromMirrorPtr(obj));
+      if (!success && std::less<mirror::Object*>{}(obj, iter->second.AsMirrorPtr())) {
+        iter->second = ObjReference::FromMirrorPtr(obj);
+      }
+    };
+    if (kParallel) {
+      MutexLock mu(Thread::Current(), class_after_obj_map_lock_);
+      update();
+    } else {
+      update();
     }
   }
 }
 
-template <size_t kAlignment>
+template <size_t kAlignment> template <bool kAtomic>
 inline uintptr_t MarkCompact::LiveWordsBitmap<kAlignment>::SetLiveWords(uintptr_t begin,
                                                                         size_t size) {
   const uintptr_t begin_bit_idx = MemRangeBitmap::BitIndexFromAddr(begin);
@@ -51,7 +60,12 @@ inline uintptr_t MarkCompact::LiveWordsBitmap<kAlignment>::SetLiveWords(uintptr_
   // Bits that needs to be set in the first word, if it's not also the last word
   mask = ~(mask - 1);
   if (diff > 0) {
-    *begin_bm_address |= mask;
+    if (kAtomic) {
+      reinterpret_cast<Atomic<uintptr_t>*>(begin_bm_address)->fetch_or(mask,
+                                                                       std::memory_order_relaxed);
+    } else {
+      *begin_bm_address |= mask;
+    }
     mask = ~0;
     // Even though memset can handle the (diff == 1) case but we should avoid the
     // overhead of a function call for this, highly likely (as most of the objects
@@ -62,7 +76,13 @@ inline uintptr_t MarkCompact::LiveWordsBitmap<kAlignment>::SetLiveWords(uintptr_
     }
   }
   uintptr_t end_mask = Bitmap::BitIndexToMask(end_bit_idx);
-  *end_bm_address |= mask & (end_mask | (end_mask - 1));
+  mask &= end_mask | (end_mask - 1);
+  if (kAtomic) {
+    reinterpret_cast<Atomic<uintptr_t>*>(end_bm_address)->fetch_or(mask,
+                                                                   std::memory_order_relaxed);
+  } else {
+    *end_bm_address |= mask;
+  }
   return begin_bit_idx;
 }
 
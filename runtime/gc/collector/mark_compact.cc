@@ -28,6 +28,7 @@
 #include <sys/syscall.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <fstream>
 #include <numeric>
 #include <string>
@@ -39,6 +40,7 @@
 #include "android-base/parseint.h"
 #include "android-base/properties.h"
 #include "android-base/strings.h"
+#include "base/bounded_fifo.h"
 #include "base/file_utils.h"
 #include "base/memfd.h"
 #include "base/quasi_atomic.h"
@@ -57,6 +59,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "sigchain.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 
 #ifdef ART_TARGET_ANDROID
 #include "android-modules-utils/sdk_level.h"
@@ -326,11 +329,17 @@ namespace collector {
 // significantly.
 static constexpr bool kCheckLocks = kDebugLocking;
 static constexpr bool kVerifyRootsMarked = kIsDebugBuild;
+// Minimum number of objects on the mark-stack for which it is worth draining
+// it in parallel.
+static constexpr size_t kMinimumParallelMarkStackSize = 128;
 // Number of compaction buffers reserved for mutator threads in SIGBUS feature
 // case. It's extremely unlikely that we will ever have more than these number
 // of mutator threads trying to access the moving-space during one compaction
 // phase.
 static constexpr size_t kMutatorCompactionBufferCount = 2048;
+// Minimum number of moving-space pages to be compacted by a worker thread in
+// parallel compaction.
+static constexpr size_t kMinPagesPerCompactionTask = 1024;
 // Minimum from-space chunk to be madvised (during concurrent compaction) in one go.
 // Choose a reasonable size to avoid making too many batched ioctl and madvise calls.
 static constexpr ssize_t kMinFromSpaceMadviseSize = 8 * MB;
@@ -439,12 +448,15 @@ size_t MarkCompact::InitializeInfoMap(uint8_t* p, size_t moving_space_sz) {
   return total;
 }
 
-MarkCompact::MarkCompact(Heap* heap)
+MarkCompact::MarkCompact(Heap* heap, bool use_generational)
     : GarbageCollector(heap, "concurrent mark compact"),
       gc_barrier_(0),
       lock_("mark compact lock", kGenericBottomLock),
+      class_after_obj_map_lock_("mark compact class-after-object map lock", kGenericBottomLock),
       bump_pointer_space_(heap->GetBumpPointerSpace()),
       moving_space_bitmap_(bump_pointer_space_->GetMarkBitmap()),
+      parallel_bytes_scanned_(0),
+      parallel_moving_objects_marked_(0),
       moving_space_begin_(bump_pointer_space_->Begin()),
       moving_space_end_(bump_pointer_space_->Limit()),
       uffd_(kFdUnused),
@@ -452,7 +464,12 @@ MarkCompact::MarkCompact(Heap* heap)
       compacting_(false),
       marking_done_(false),
       uffd_initialized_(false),
-      clamp_info_map_status_(ClampInfoStatus::kClampInfoNotDone) {
+      clamp_info_map_status_(ClampInfoStatus::kClampInfoNotDone),
+      use_generational_(use_generational),
+      young_gen_(false),
+      old_gen_end_(nullptr),
+      post_compact_live_end_(nullptr),
+      old_gen_object_count_(0) {
   if (kIsDebugBuild) {
     updated_roots_.reset(new std::unordered_set<void*>());
   }
@@ -524,7 +541,8 @@ MarkCompact::MarkCompact(Heap* heap)
 
   // Initialize GC metrics.
   metrics::ArtMetrics* metrics = GetMetrics();
-  // The mark-compact collector supports only full-heap collections at the moment.
+  // Young-generation collections are reported by YoungMarkCompact, which
+  // shares all the state with this collector.
   gc_time_histogram_ = metrics->FullGcCollectionTime();
   metrics_gc_count_ = metrics->FullGcCount();
   metrics_gc_count_delta_ = metrics->FullGcCountDelta();
@@ -645,16 +663,49 @@ void MarkCompact::PrepareCardTableForMarking(bool clear_alloc_space_cards) {
     } else if (clear_alloc_space_cards) {
       CHECK(!space->IsZygoteSpace());
       CHECK(!space->IsImageSpace());
-      // The card-table corresponding to bump-pointer and non-moving space can
-      // be cleared, because we are going to traverse all the reachable objects
-      // in these spaces. This card-table will eventually be used to track
-      // mutations while concurrent marking is going on.
-      card_table->ClearCardRange(space->Begin(), space->Limit());
+      if (young_gen_) {
+        // In young-generation collections, old-generation objects are not
+        // traversed. So the cards must be aged instead of being cleared as
+        // they are the only means to find old-to-young references.
+        card_table->ModifyCardsAtomic(space->Begin(),
+                                      space->End(),
+                                      AgeCardVisitor(),
+                                      /* card modified visitor */ VoidFunctor());
+      } else {
+        // The card-table corresponding to bump-pointer and non-moving space can
+        // be cleared, because we are going to traverse all the reachable objects
+        // in these spaces. This card-table will eventually be used to track
+        // mutations while concurrent marking is going on.
+        card_table->ClearCardRange(space->Begin(), space->Limit());
+      }
       if (space != bump_pointer_space_) {
         CHECK_EQ(space, heap_->GetNonMovingSpace());
+        if (young_gen_) {
+          // Like sticky mark-sweep, bind the live bitmap to the mark bitmap so
+          // that the objects which survived the last GC are considered marked.
+          // Objects allocated since then are on the allocation stack and are
+          // swept using that in Sweep().
+          space->AsContinuousMemMapAllocSpace()->BindLiveToMarkBitmap();
+        }
         non_moving_space_ = space;
         non_moving_space_bitmap_ = space->GetMarkBitmap();
       }
+    } else if (young_gen_ && space == bump_pointer_space_) {
+      // Cards which were aged at the beginning of marking cover old-generation
+      // objects, which would need their references updated during compaction.
+      // So retain them as kCardAged2 rather than clearing them.
+      card_table->ModifyCardsAtomic(
+          space->Begin(),
+          space->End(),
+          [](uint8_t card) {
+            if (card == gc::accounting::CardTable::kCardDirty) {
+              return gc::accounting::CardTable::kCardAged;
+            } else if (card == gc::accounting::CardTable::kCardClean) {
+              return card;
+            }
+            return gc::accounting::CardTable::kCardAged2;
+          },
+          /* card modified visitor */ VoidFunctor());
     } else {
       card_table->ModifyCardsAtomic(
           space->Begin(),
@@ -691,6 +742,26 @@ void MarkCompact::MarkZygoteLargeObjects() {
   }
 }
 
+void MarkCompact::InitializeOldGenLivenessInfo() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  DCHECK(young_gen_);
+  DCHECK_NE(old_gen_end_, nullptr);
+  size_t old_gen_size = old_gen_end_ - moving_space_begin_;
+  DCHECK_ALIGNED(old_gen_size, kAlignment);
+  if (old_gen_size > 0) {
+    live_words_bitmap_->SetLiveWords(reinterpret_cast<uintptr_t>(moving_space_begin_),
+                                     old_gen_size);
+  }
+  size_t full_chunks = old_gen_size / kOffsetChunkSize;
+  std::fill_n(chunk_info_vec_, full_chunks, kOffsetChunkSize);
+  if (old_gen_size % kOffsetChunkSize > 0) {
+    chunk_info_vec_[full_chunks] = old_gen_size % kOffsetChunkSize;
+  }
+  // Old-generation objects are not discovered by marking in this cycle. So
+  // account for them here. See UpdateLivenessInfo().
+  freed_objects_ -= old_gen_object_count_;
+}
+
 void MarkCompact::InitializePhase() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
   mark_stack_ = heap_->GetMarkStack();
@@ -786,6 +857,21 @@ void MarkCompact::RunPhases() {
   thread_running_gc_ = nullptr;
 }
 
+void MarkCompact::RunYoungPhases() {
+  DCHECK(HasOldGeneration());
+  young_gen_ = true;
+  RunPhases();
+  young_gen_ = false;
+}
+
+void MarkCompact::ResetGenerationalState() {
+  if (old_gen_end_ != nullptr) {
+    old_gen_end_ = nullptr;
+    old_gen_object_count_ = 0;
+    moving_space_bitmap_->Clear();
+  }
+}
+
 void MarkCompact::InitMovingSpaceFirstObjects(const size_t vec_len) {
   // Find the first live word first.
   size_t to_space_page_idx = 0;
@@ -992,7 +1078,8 @@ void MarkCompact::PrepareForCompaction() {
   for (size_t i = vector_len; i < vector_length_; i++) {
     DCHECK_EQ(chunk_info_vec_[i], 0u);
   }
-  post_compact_end_ = AlignUp(space_begin + total, gPageSize);
+  post_compact_live_end_ = space_begin + total;
+  post_compact_end_ = AlignUp(post_compact_live_end_, gPageSize);
   CHECK_EQ(post_compact_end_, space_begin + moving_first_objs_count_ * gPageSize);
   black_objs_slide_diff_ = black_allocations_begin_ - post_compact_end_;
   // We shouldn't be consuming more space after compaction than pre-compaction.
@@ -1125,6 +1212,16 @@ void MarkCompact::Sweep(bool swap_bitmaps) {
   // Ensure that nobody inserted objects in the live stack after we swapped the
   // stacks.
   CHECK_GE(live_stack_freeze_size_, GetHeap()->GetLiveStack()->Size());
+  if (young_gen_) {
+    // Only the objects allocated since the last GC, which are all on the live
+    // stack, could have died. Large-object space is also taken care of by
+    // SweepArray().
+    TimingLogger::ScopedTiming t2("SweepArray", GetTimings());
+    std::vector<space::ContinuousSpace*> sweep_spaces = {non_moving_space_};
+    SweepArray(heap_->GetLiveStack(), swap_bitmaps, &sweep_spaces);
+    DCHECK(mark_stack_->IsEmpty());
+    return;
+  }
   {
     TimingLogger::ScopedTiming t2("MarkAllocStackAsLive", GetTimings());
     // Mark everything allocated since the last GC as live so that we can sweep
@@ -2005,6 +2102,14 @@ void MarkCompact::CompactMovingSpace(uint8_t* page) {
   cur_reclaimable_page_ = last_reclaimed_page_;
   last_checked_reclaim_page_idx_ = idx;
   class_after_obj_iter_ = class_after_obj_map_.rbegin();
+  // In young-generation collections, the pages entirely within the old
+  // generation are not compacted. See UpdateOldGenObjects().
+  const size_t identity_pages =
+      young_gen_ ? DivideByPageSize(AlignDown(old_gen_end_, gPageSize) - moving_space_begin_) : 0;
+  // Let the workers, if any, start from the bottom of the compacted portion
+  // while this thread works its way down from the top.
+  const bool parallel_compaction =
+      kMode == kCopyMode && StartParallelCompaction(identity_pages, moving_first_objs_count_);
   // Allocated-black pages
   mirror::Object* next_page_first_obj = nullptr;
   while (idx > moving_first_objs_count_) {
@@ -2041,7 +2146,7 @@ void MarkCompact::CompactMovingSpace(uint8_t* page) {
   // Reserved page to be used if we can't find any reclaimable page for processing.
   uint8_t* reserve_page = page;
   size_t end_idx_for_mapping = idx;
-  while (idx > 0) {
+  while (idx > identity_pages) {
     idx--;
     to_space_end -= gPageSize;
     if (kMode == kFallbackMode) {
@@ -2077,15 +2182,96 @@ void MarkCompact::CompactMovingSpace(uint8_t* page) {
       end_idx_for_mapping = idx;
     }
   }
-  // map one last time to finish anything left.
+  if (kMode == kFallbackMode && identity_pages > 0) {
+    // The references in these pages have been updated in from-space.
+    std::memcpy(moving_space_begin_, from_space_begin_, identity_pages * gPageSize);
+  }
+  if (parallel_compaction) {
+    FinishParallelCompaction();
+  }
+  // map one last time to finish anything left, including the old-generation
+  // pages.
   if (kMode == kCopyMode && end_idx_for_mapping > 0) {
-    MapMovingSpacePages(idx,
+    MapMovingSpacePages(/*start_idx=*/0,
                         end_idx_for_mapping,
                         /*from_fault=*/false,
                         /*return_on_contention=*/false,
                         /*tolerate_enoent=*/false);
   }
-  DCHECK_EQ(to_space_end, bump_pointer_space_->Begin());
+  DCHECK_EQ(to_space_end, moving_space_begin_ + identity_pages * gPageSize);
+}
+
+class MarkCompact::CompactionTask : public Task {
+ public:
+  CompactionTask(MarkCompact* mark_compact, size_t begin_idx, size_t end_idx)
+      : mark_compact_(mark_compact), begin_idx_(begin_idx), end_idx_(end_idx) {}
+
+  void Run([[maybe_unused]] Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    // Workers share the buffers reserved for mutators.
+    uint16_t idx = mark_compact_->compaction_buffer_counter_.fetch_add(1, std::memory_order_relaxed);
+    CHECK_LE(idx, kMutatorCompactionBufferCount);
+    uint8_t* buf = mark_compact_->compaction_buffers_map_.Begin() + idx * gPageSize;
+    mark_compact_->CompactMovingSpacePages(begin_idx_, end_idx_, buf);
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  MarkCompact* const mark_compact_;
+  const size_t begin_idx_;
+  const size_t end_idx_;
+};
+
+bool MarkCompact::StartParallelCompaction(size_t begin_idx, size_t end_idx) {
+  size_t thread_count = GetThreadCount(/*paused=*/false);
+  if (thread_count <= 1 || end_idx <= begin_idx) {
+    return false;
+  }
+  // Don't bother the workers with less than a few MBs each.
+  const size_t nr_pages = end_idx - begin_idx;
+  thread_count = std::min(thread_count, nr_pages / kMinPagesPerCompactionTask);
+  if (thread_count <= 1) {
+    return false;
+  }
+  Thread* self = Thread::Current();
+  ThreadPool* thread_pool = heap_->GetThreadPool();
+  // The GC thread takes care of the topmost slice as part of its reverse
+  // traversal. The workers get the remaining ones.
+  const size_t slice = nr_pages / thread_count;
+  for (size_t i = 0; i < thread_count - 1; i++) {
+    size_t slice_begin = begin_idx + i * slice;
+    thread_pool->AddTask(self, new CompactionTask(this, slice_begin, slice_begin + slice));
+  }
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  return true;
+}
+
+void MarkCompact::FinishParallelCompaction() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  Thread* self = Thread::Current();
+  ThreadPool* thread_pool = heap_->GetThreadPool();
+  thread_pool->Wait(self, /*do_work=*/true, /*may_hold_locks=*/true);
+  thread_pool->StopWorkers(self);
+}
+
+void MarkCompact::CompactMovingSpacePages(size_t begin_idx, size_t end_idx, uint8_t* buf) {
+  const size_t nr_moving_space_used_pages = moving_first_objs_count_ + black_page_count_;
+  // Go in the increasing order so as to stay away from the GC thread, which
+  // compacts in the reverse order, for as long as possible.
+  for (size_t idx = begin_idx; idx < end_idx; idx++) {
+    // Skip the pages claimed by others instead of waiting for them to be
+    // mapped, like a faulting mutator would.
+    if (GetMovingPageState(idx) != PageState::kUnprocessed) {
+      continue;
+    }
+    ConcurrentlyProcessMovingPage(moving_space_begin_ + idx * gPageSize,
+                                  buf,
+                                  nr_moving_space_used_pages,
+                                  /*tolerate_enoent=*/false);
+  }
 }
 
 size_t MarkCompact::MapMovingSpacePages(size_t start_idx,
@@ -2099,13 +2285,16 @@ size_t MarkCompact::MapMovingSpacePages(size_t start_idx,
   while (arr_idx < arr_len) {
     size_t map_count = 0;
     uint32_t cur_state = moving_pages_status_[arr_idx].load(std::memory_order_acquire);
-    // Find a contiguous range that can be mapped with single ioctl.
+    // Find a contiguous range that can be mapped with single ioctl. In
+    // young-generation collections, the old-generation pages are mapped from
+    // their own from-space pages, which need not be contiguous with the
+    // compacted pages that follow.
     for (size_t i = arr_idx; i < arr_len; i++, map_count++) {
       uint32_t s = moving_pages_status_[i].load(std::memory_order_acquire);
-      if (GetPageStateFromWord(s) != PageState::kProcessed) {
+      if (GetPageStateFromWord(s) != PageState::kProcessed ||
+          (cur_state & ~kPageStateMask) + (i - arr_idx) * gPageSize != (s & ~kPageStateMask)) {
         break;
       }
-      DCHECK_EQ((cur_state & ~kPageStateMask) + (i - arr_idx) * gPageSize, s & ~kPageStateMask);
     }
 
     if (map_count == 0) {
@@ -2171,7 +2360,7 @@ void MarkCompact::UpdateNonMovingPage(mirror::Object* first, uint8_t* page) {
   // TODO: Set kVisitNativeRoots to false once we implement concurrent
   // compaction
   mirror::Object* curr_obj = first;
-  non_moving_space_bitmap_->VisitMarkedRange(
+  non_moving_space_bitmap_->VisitMarkedRangePrefetched(
           reinterpret_cast<uintptr_t>(first) + mirror::kObjectHeaderSize,
           reinterpret_cast<uintptr_t>(page + gPageSize),
           [&](mirror::Object* next_obj) {
@@ -2679,6 +2868,9 @@ void MarkCompact::CompactionPause() {
     // TODO: We can reduce the time spent on this in a pause by performing one
     // round of this concurrently prior to the pause.
     UpdateMovingSpaceBlackAllocations();
+    // Objects allocated since the marking pause may still be buffered in
+    // thread-local allocation stacks. Flush them to the allocation stack.
+    heap_->RevokeAllThreadLocalAllocationStacks(thread_running_gc_);
     // Iterate over the allocation_stack_, for every object in the non-moving
     // space:
     // 1. Mark the object in live bitmap
@@ -2814,6 +3006,13 @@ void MarkCompact::CompactionPause() {
     KernelPreparation();
   }
 
+  if (use_generational_) {
+    WriterMutexLock wmu(thread_running_gc_, *Locks::heap_bitmap_lock_);
+    if (young_gen_) {
+      UpdateOldGenObjects();
+    }
+    CarryForwardMovingSpaceCards();
+  }
   UpdateNonMovingSpace();
   // fallback mode
   if (uffd_ == kFallbackMode) {
@@ -2828,6 +3027,79 @@ void MarkCompact::CompactionPause() {
   stack_low_addr_ = nullptr;
 }
 
+void MarkCompact::UpdateOldGenObjects() {
+  TimingLogger::ScopedTiming t("(Paused)UpdateOldGenObjects", GetTimings());
+  DCHECK(young_gen_);
+  // Old-generation objects don't move in young collections. Therefore, the
+  // pages which are entirely within the old generation don't need compaction.
+  // Only the references to young objects, which can only be in objects on
+  // non-clean cards, need to be updated. This is done in-place in from-space.
+  uint8_t* identity_end = AlignDown(old_gen_end_, gPageSize);
+  uint8_t* from_space_end = identity_end + from_space_slide_diff_;
+  if (identity_end > moving_space_begin_) {
+    accounting::CardTable* const card_table = heap_->GetCardTable();
+    card_table->Scan</*kClearCard*/ false>(
+        moving_space_bitmap_,
+        moving_space_begin_,
+        identity_end,
+        [this, from_space_end](mirror::Object* obj)
+            REQUIRES_SHARED(Locks::mutator_lock_, Locks::heap_bitmap_lock_) {
+          mirror::Object* from_obj = GetFromSpaceAddr(obj);
+          // References beyond identity_end are updated when the corresponding
+          // page is compacted.
+          RefsUpdateVisitor</*kCheckBegin*/ false, /*kCheckEnd*/ true> visitor(
+              this, from_obj, nullptr, from_space_end);
+          from_obj->VisitRefsForCompaction</*kFetchObjSize*/ false>(
+              visitor,
+              MemberOffset(0),
+              MemberOffset(from_space_end - reinterpret_cast<uint8_t*>(from_obj)));
+        },
+        accounting::CardTable::kCardAged2);
+  }
+  // The from-space pages now have the final contents. Let them be mapped
+  // just like the compacted pages. In fallback mode they are copied by
+  // CompactMovingSpace().
+  if (IsValidFd(uffd_)) {
+    size_t identity_pages = DivideByPageSize(identity_end - moving_space_begin_);
+    for (size_t i = 0; i < identity_pages; i++) {
+      moving_pages_status_[i].store(static_cast<uint8_t>(PageState::kProcessed) | (i * gPageSize),
+                                    std::memory_order_relaxed);
+    }
+  }
+}
+
+void MarkCompact::CarryForwardMovingSpaceCards() {
+  TimingLogger::ScopedTiming t("(Paused)CarryForwardMovingSpaceCards", GetTimings());
+  DCHECK(use_generational_);
+  // After this cycle, all the objects marked in it become part of the old
+  // generation. So the only cards of interest for the next young collection
+  // are the ones dirtied after the marking pause. Move them to the
+  // post-compact location of the objects they cover. Since objects only move
+  // towards the beginning of the space, and we process cards in ascending
+  // order, it's safe to update the card-table in-place.
+  accounting::CardTable* const card_table = heap_->GetCardTable();
+  uint8_t* card = card_table->CardFromAddr(moving_space_begin_);
+  uint8_t* card_end = card_table->CardFromAddr(black_allocations_begin_);
+  for (uint8_t* addr = moving_space_begin_; card < card_end;
+       card++, addr += accounting::CardTable::kCardSize) {
+    uint8_t value = *card;
+    if (value == accounting::CardTable::kCardClean) {
+      continue;
+    }
+    *card = accounting::CardTable::kCardClean;
+    if (value == accounting::CardTable::kCardDirty) {
+      moving_space_bitmap_->VisitMarkedRange(
+          reinterpret_cast<uintptr_t>(addr),
+          reinterpret_cast<uintptr_t>(addr + accounting::CardTable::kCardSize),
+          [this, card_table](mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+            card_table->MarkCard(PostCompactOldObjAddr(obj));
+          });
+    }
+  }
+  // Black allocations become young objects in the next cycle.
+  card_table->ClearCardRange(black_allocations_begin_, moving_space_end_);
+}
+
 void MarkCompact::KernelPrepareRangeForUffd(uint8_t* to_addr, uint8_t* from_addr, size_t map_size) {
   int mremap_flags = MREMAP_MAYMOVE | MREMAP_FIXED;
   if (gHaveMremapDontunmap) {
@@ -3673,6 +3945,12 @@ void MarkCompact::MarkNonThreadRoots(Runtime* runtime) {
 
 void MarkCompact::MarkConcurrentRoots(VisitRootFlags flags, Runtime* runtime) {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  if (young_gen_) {
+    // Visit class-loader roots as well in young-generation collections. Storing
+    // the class in an object during allocation doesn't mark the card. See
+    // StickyMarkSweep::MarkConcurrentRoots() for details.
+    flags = static_cast<VisitRootFlags>(flags | kVisitRootFlagClassLoader);
+  }
   runtime->VisitConcurrentRoots(this, flags);
 }
 
@@ -3725,10 +4003,33 @@ void MarkCompact::UpdateAndMarkModUnion() {
 
 void MarkCompact::MarkReachableObjects() {
   UpdateAndMarkModUnion();
+  if (young_gen_) {
+    ScanOldGenDirtyCards();
+  }
   // Recursively mark all the non-image bits set in the mark bitmap.
   ProcessMarkStack();
 }
 
+void MarkCompact::ScanOldGenDirtyCards() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  DCHECK(young_gen_);
+  accounting::CardTable* const card_table = heap_->GetCardTable();
+  // The cards were aged in PrepareCardTableForMarking(). Every old-to-young
+  // reference must be in an object on one of these cards. Stretches of the
+  // card-table without aged cards are skipped; cards dirtied since aging are
+  // scanned in MarkingPause() anyway.
+  card_table->ScanAgedCards(moving_space_bitmap_,
+                            moving_space_begin_,
+                            old_gen_end_,
+                            ScanObjectVisitor(this),
+                            accounting::CardTable::kCardAged);
+  card_table->ScanAgedCards(non_moving_space_bitmap_,
+                            non_moving_space_->Begin(),
+                            non_moving_space_->End(),
+                            ScanObjectVisitor(this),
+                            accounting::CardTable::kCardAged);
+}
+
 void MarkCompact::ScanDirtyObjects(bool paused, uint8_t minimum_age) {
   accounting::CardTable* card_table = heap_->GetCardTable();
   for (const auto& space : heap_->GetContinuousSpaces()) {
@@ -3745,8 +4046,22 @@ void MarkCompact::ScanDirtyObjects(bool paused, uint8_t minimum_age) {
       break;
     }
     TimingLogger::ScopedTiming t(name, GetTimings());
-    card_table->Scan</*kClearCard*/ false>(
-        space->GetMarkBitmap(), space->Begin(), space->End(), ScanObjectVisitor(this), minimum_age);
+    if (!paused && minimum_age < accounting::CardTable::kCardDirty) {
+      // Called right after aging the cards in PreCleanCards(). Cards dirtied
+      // since then are left to the paused scan, so skip the parts of the
+      // card-table without aged cards.
+      card_table->ScanAgedCards(space->GetMarkBitmap(),
+                                space->Begin(),
+                                space->End(),
+                                ScanObjectVisitor(this),
+                                minimum_age);
+    } else {
+      card_table->Scan</*kClearCard*/ false>(space->GetMarkBitmap(),
+                                             space->Begin(),
+                                             space->End(),
+                                             ScanObjectVisitor(this),
+                                             minimum_age);
+    }
   }
 }
 
@@ -3796,7 +4111,23 @@ void MarkCompact::MarkingPhase() {
   WriterMutexLock mu(thread_running_gc_, *Locks::heap_bitmap_lock_);
   MaybeClampGcStructures();
   PrepareCardTableForMarking(/*clear_alloc_space_cards*/ true);
-  MarkZygoteLargeObjects();
+  if (young_gen_) {
+    // Old-generation objects in the moving space are already marked in the
+    // mark-bitmap since the last GC cycle. Treat the large objects which
+    // survived the last cycle as marked too.
+    InitializeOldGenLivenessInfo();
+    space::LargeObjectSpace* const los = heap_->GetLargeObjectsSpace();
+    if (los != nullptr) {
+      los->CopyLiveToMarked();
+    }
+  } else {
+    if (use_generational_ && old_gen_end_ != nullptr) {
+      // The mark-bitmap retains the old-generation from the last GC cycle.
+      // Full-heap collection has to start from scratch.
+      moving_space_bitmap_->Clear();
+    }
+    MarkZygoteLargeObjects();
+  }
   MarkRoots(
         static_cast<VisitRootFlags>(kVisitRootFlagAllRoots | kVisitRootFlagStartLoggingNewRoots));
   MarkReachableObjects();
@@ -3866,26 +4197,39 @@ size_t MarkCompact::LiveWordsBitmap<kAlignment>::LiveBytesInBitmapWord(size_t ch
   return words * kAlignment;
 }
 
+template <bool kParallel>
 void MarkCompact::UpdateLivenessInfo(mirror::Object* obj, size_t obj_size) {
   DCHECK(obj != nullptr);
   DCHECK_EQ(obj_size, obj->SizeOf<kDefaultVerifyFlags>());
   uintptr_t obj_begin = reinterpret_cast<uintptr_t>(obj);
-  UpdateClassAfterObjectMap(obj);
+  UpdateClassAfterObjectMap<kParallel>(obj);
   size_t size = RoundUp(obj_size, kAlignment);
-  uintptr_t bit_index = live_words_bitmap_->SetLiveWords(obj_begin, size);
+  uintptr_t bit_index = live_words_bitmap_->SetLiveWords</*kAtomic*/ kParallel>(obj_begin, size);
   size_t chunk_idx = (obj_begin - live_words_bitmap_->Begin()) / kOffsetChunkSize;
   // Compute the bit-index within the chunk-info vector word.
   bit_index %= kBitsPerVectorWord;
   size_t first_chunk_portion = std::min(size, (kBitsPerVectorWord - bit_index) * kAlignment);
 
-  chunk_info_vec_[chunk_idx++] += first_chunk_portion;
+  // Only the first and the last chunks may be shared with other objects. The
+  // intermediate ones are entirely covered by this object.
+  auto add_to_chunk = [this](size_t idx, size_t bytes) {
+    if (kParallel) {
+      reinterpret_cast<Atomic<uint32_t>*>(chunk_info_vec_ + idx)
+          ->fetch_add(bytes, std::memory_order_relaxed);
+    } else {
+      chunk_info_vec_[idx] += bytes;
+    }
+  };
+  add_to_chunk(chunk_idx++, first_chunk_portion);
   DCHECK_LE(first_chunk_portion, size);
   for (size -= first_chunk_portion; size > kOffsetChunkSize; size -= kOffsetChunkSize) {
     DCHECK_EQ(chunk_info_vec_[chunk_idx], 0u);
     chunk_info_vec_[chunk_idx++] = kOffsetChunkSize;
   }
-  chunk_info_vec_[chunk_idx] += size;
-  freed_objects_--;
+  add_to_chunk(chunk_idx, size);
+  if (!kParallel) {
+    freed_objects_--;
+  }
 }
 
 template <bool kUpdateLiveWords>
@@ -3904,9 +4248,181 @@ void MarkCompact::ScanObject(mirror::Object* obj) {
   obj->VisitReferences(visitor, visitor);
 }
 
+class MarkCompact::MarkStackTask : public Task {
+ public:
+  MarkStackTask(ThreadPool* thread_pool,
+                MarkCompact* mark_compact,
+                size_t mark_stack_size,
+                StackReference<mirror::Object>* mark_stack)
+      : mark_compact_(mark_compact),
+        thread_pool_(thread_pool),
+        mark_stack_pos_(mark_stack_size),
+        bytes_scanned_(0),
+        moving_objects_marked_(0) {
+    // We may have to copy part of an existing mark stack when another mark stack overflows.
+    if (mark_stack_size != 0) {
+      DCHECK(mark_stack != nullptr);
+      std::copy(mark_stack, mark_stack + mark_stack_size, mark_stack_);
+    }
+  }
+
+  static constexpr size_t kMaxSize = 1 * KB;
+
+  void Finalize() override {
+    delete this;
+  }
+
+  // Scans all of the objects, publishing the counters once the local
+  // mark-stack is empty.
+  void Run([[maybe_unused]] Thread* self) override REQUIRES(Locks::heap_bitmap_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    static constexpr size_t kFifoSize = 4;
+    BoundedFifoPowerOfTwo<mirror::Object*, kFifoSize> prefetch_fifo;
+    for (;;) {
+      while (mark_stack_pos_ != 0 && prefetch_fifo.size() < kFifoSize) {
+        mirror::Object* const mark_stack_obj = mark_stack_[--mark_stack_pos_].AsMirrorPtr();
+        DCHECK(mark_stack_obj != nullptr);
+        __builtin_prefetch(mark_stack_obj);
+        prefetch_fifo.push_back(mark_stack_obj);
+      }
+      if (UNLIKELY(prefetch_fifo.empty())) {
+        break;
+      }
+      mirror::Object* obj = prefetch_fifo.front();
+      prefetch_fifo.pop_front();
+      ScanObject(obj);
+    }
+    mark_compact_->parallel_bytes_scanned_.fetch_add(bytes_scanned_, std::memory_order_relaxed);
+    mark_compact_->parallel_moving_objects_marked_.fetch_add(moving_objects_marked_,
+                                                             std::memory_order_relaxed);
+  }
+
+ private:
+  class ParallelRefFieldsVisitor {
+   public:
+    ALWAYS_INLINE explicit ParallelRefFieldsVisitor(MarkStackTask* task) : task_(task) {}
+
+    ALWAYS_INLINE void operator()(mirror::Object* obj,
+                                  MemberOffset offset,
+                                  [[maybe_unused]] bool is_static) const
+        REQUIRES(Locks::heap_bitmap_lock_) REQUIRES_SHARED(Locks::mutator_lock_) {
+      Mark(obj->GetFieldObject<mirror::Object>(offset), obj, offset);
+    }
+
+    void operator()(ObjPtr<mirror::Class> klass, ObjPtr<mirror::Reference> ref) const ALWAYS_INLINE
+        REQUIRES(Locks::heap_bitmap_lock_) REQUIRES_SHARED(Locks::mutator_lock_) {
+      task_->mark_compact_->DelayReferenceReferent(klass, ref);
+    }
+
+    void VisitRootIfNonNull(mirror::CompressedReference<mirror::Object>* root) const ALWAYS_INLINE
+        REQUIRES(Locks::heap_bitmap_lock_) REQUIRES_SHARED(Locks::mutator_lock_) {
+      if (!root->IsNull()) {
+        VisitRoot(root);
+      }
+    }
+
+    void VisitRoot(mirror::CompressedReference<mirror::Object>* root) const
+        REQUIRES(Locks::heap_bitmap_lock_) REQUIRES_SHARED(Locks::mutator_lock_) {
+      Mark(root->AsMirrorPtr(), nullptr, MemberOffset(0));
+    }
+
+   private:
+    ALWAYS_INLINE void Mark(mirror::Object* ref, mirror::Object* holder, MemberOffset offset) const
+        REQUIRES(Locks::heap_bitmap_lock_) REQUIRES_SHARED(Locks::mutator_lock_) {
+      if (ref != nullptr &&
+          task_->mark_compact_->MarkObjectNonNullNoPush</*kParallel*/ true>(ref, holder, offset)) {
+        task_->MarkStackPush(ref);
+      }
+    }
+
+    MarkStackTask* const task_;
+  };
+
+  ~MarkStackTask() {
+    // Make sure that we have cleared our mark stack.
+    DCHECK_EQ(mark_stack_pos_, 0U);
+  }
+
+  ALWAYS_INLINE void ScanObject(mirror::Object* obj) REQUIRES(Locks::heap_bitmap_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    size_t obj_size = obj->SizeOf<kDefaultVerifyFlags>();
+    bytes_scanned_ += obj_size;
+    DCHECK(mark_compact_->IsMarked(obj) != nullptr);
+    if (mark_compact_->HasAddress(obj)) {
+      mark_compact_->UpdateLivenessInfo</*kParallel*/ true>(obj, obj_size);
+      moving_objects_marked_++;
+    }
+    ParallelRefFieldsVisitor visitor(this);
+    obj->VisitReferences(visitor, visitor);
+  }
+
+  ALWAYS_INLINE void MarkStackPush(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (UNLIKELY(mark_stack_pos_ == kMaxSize)) {
+      // Mark stack overflow, give 1/2 the stack to the thread pool as a new
+      // task, which idle workers will then pick up.
+      mark_stack_pos_ /= 2;
+      auto* task = new MarkStackTask(
+          thread_pool_, mark_compact_, kMaxSize - mark_stack_pos_, mark_stack_ + mark_stack_pos_);
+      thread_pool_->AddTask(Thread::Current(), task);
+    }
+    DCHECK(obj != nullptr);
+    DCHECK_LT(mark_stack_pos_, kMaxSize);
+    mark_stack_[mark_stack_pos_++].Assign(obj);
+  }
+
+  MarkCompact* const mark_compact_;
+  ThreadPool* const thread_pool_;
+  // Thread local mark stack for this task.
+  StackReference<mirror::Object> mark_stack_[kMaxSize];
+  // Mark stack position.
+  size_t mark_stack_pos_;
+  // Task-local counters, which are published in Run() to avoid contending on
+  // shared cache-lines.
+  uint64_t bytes_scanned_;
+  uint32_t moving_objects_marked_;
+};
+
+size_t MarkCompact::GetThreadCount(bool paused) const {
+  // Use less threads if we are in a background state (non jank perceptible) since we want to leave
+  // more CPU time for the foreground apps.
+  ThreadPool* thread_pool = heap_->GetThreadPool();
+  if (thread_pool == nullptr || !Runtime::Current()->InJankPerceptibleProcessState()) {
+    return 1;
+  }
+  // The pool is sized for concurrent marking, so it may have fewer workers
+  // than ParallelGCThreads.
+  size_t workers = paused ? heap_->GetParallelGCThreadCount() : heap_->GetConcGCThreadCount();
+  return std::min(workers, thread_pool->GetThreadCount()) + 1;
+}
+
+void MarkCompact::ProcessMarkStackParallel(size_t thread_count) {
+  Thread* self = Thread::Current();
+  ThreadPool* thread_pool = heap_->GetThreadPool();
+  const size_t chunk_size = std::min(mark_stack_->Size() / thread_count + 1,
+                                     static_cast<size_t>(MarkStackTask::kMaxSize));
+  // Split the current mark stack up into work tasks.
+  for (auto* it = mark_stack_->Begin(), *end = mark_stack_->End(); it < end;) {
+    const size_t delta = std::min(static_cast<size_t>(end - it), chunk_size);
+    thread_pool->AddTask(self, new MarkStackTask(thread_pool, this, delta, it));
+    it += delta;
+  }
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ true);
+  thread_pool->StopWorkers(self);
+  mark_stack_->Reset();
+  bytes_scanned_ += parallel_bytes_scanned_.exchange(0, std::memory_order_relaxed);
+  freed_objects_ -= parallel_moving_objects_marked_.exchange(0, std::memory_order_relaxed);
+}
+
 // Scan anything that's on the mark stack.
 void MarkCompact::ProcessMarkStack() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  size_t thread_count = GetThreadCount(Locks::mutator_lock_->IsExclusiveHeld(thread_running_gc_));
+  if (thread_count > 1 && mark_stack_->Size() >= kMinimumParallelMarkStackSize) {
+    ProcessMarkStackParallel(thread_count);
+    return;
+  }
   // TODO: try prefetch like in CMS
   while (!mark_stack_->IsEmpty()) {
     mirror::Object* obj = mark_stack_->PopBack();
@@ -4092,6 +4608,29 @@ void MarkCompact::DelayReferenceReferent(ObjPtr<mirror::Class> klass,
   heap_->GetReferenceProcessor()->DelayReferenceReferent(klass, ref, this);
 }
 
+void MarkCompact::UpdateOldGenMarkBitmap() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  DCHECK(use_generational_);
+  // Objects which were already in the old generation didn't move.
+  uint8_t* begin = young_gen_ ? old_gen_end_ : moving_space_begin_;
+  size_t count = 0;
+  // Post-compact address of an object is never higher than its pre-compact
+  // address. So the bitmap can be transformed in-place in ascending order.
+  moving_space_bitmap_->VisitMarkedRange(
+      reinterpret_cast<uintptr_t>(begin),
+      reinterpret_cast<uintptr_t>(black_allocations_begin_),
+      [this, &count](mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+        moving_space_bitmap_->Clear(obj);
+        moving_space_bitmap_->Set(PostCompactOldObjAddr(obj));
+        count++;
+      });
+  // Black allocations are young objects in the next cycle.
+  moving_space_bitmap_->ClearRange(reinterpret_cast<mirror::Object*>(black_allocations_begin_),
+                                   reinterpret_cast<mirror::Object*>(moving_space_end_));
+  old_gen_object_count_ = young_gen_ ? old_gen_object_count_ + count : count;
+  old_gen_end_ = post_compact_live_end_;
+}
+
 void MarkCompact::FinishPhase() {
   GetCurrentIteration()->SetScannedBytes(bytes_scanned_);
   bool is_zygote = Runtime::Current()->IsZygote();
@@ -4099,13 +4638,22 @@ void MarkCompact::FinishPhase() {
   marking_done_ = false;
 
   ZeroAndReleaseMemory(compaction_buffers_map_.Begin(), compaction_buffers_map_.Size());
+  if (use_generational_) {
+    // Must be done before chunk-info and live-words bitmap are cleared as
+    // they are required for computing post-compact addresses.
+    ReaderMutexLock mu(thread_running_gc_, *Locks::mutator_lock_);
+    WriterMutexLock mu2(thread_running_gc_, *Locks::heap_bitmap_lock_);
+    UpdateOldGenMarkBitmap();
+  }
   info_map_.MadviseDontNeedAndZero();
   live_words_bitmap_->ClearBitmap();
-  // TODO: We can clear this bitmap right before compaction pause. But in that
-  // case we need to ensure that we don't assert on this bitmap afterwards.
-  // Also, we would still need to clear it here again as we may have to use the
-  // bitmap for black-allocations (see UpdateMovingSpaceBlackAllocations()).
-  moving_space_bitmap_->Clear();
+  if (!use_generational_) {
+    // TODO: We can clear this bitmap right before compaction pause. But in that
+    // case we need to ensure that we don't assert on this bitmap afterwards.
+    // Also, we would still need to clear it here again as we may have to use the
+    // bitmap for black-allocations (see UpdateMovingSpaceBlackAllocations()).
+    moving_space_bitmap_->Clear();
+  }
 
   if (UNLIKELY(is_zygote && IsValidFd(uffd_))) {
     // This unregisters all ranges as a side-effect.
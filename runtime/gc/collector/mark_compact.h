@@ -67,11 +67,24 @@ class MarkCompact final : public GarbageCollector {
   static constexpr SigbusCounterType kSigbusCounterCompactionDoneMask =
       1u << (BitSizeOf<SigbusCounterType>() - 1);
 
-  explicit MarkCompact(Heap* heap);
+  // 'use_generational' enables young-generation collections, driven by
+  // YoungMarkCompact, in addition to the regular full-heap ones.
+  MarkCompact(Heap* heap, bool use_generational);
 
   ~MarkCompact() {}
 
   void RunPhases() override REQUIRES(!Locks::mutator_lock_, !lock_);
+  // Run a young-generation collection, which only marks and compacts the
+  // objects allocated in the moving space since the last GC cycle. Objects
+  // which survived previous cycles (old generation) are treated as live and
+  // stay in place. Called by YoungMarkCompact.
+  void RunYoungPhases() REQUIRES(!Locks::mutator_lock_, !lock_);
+  // Returns true if a previous cycle has established an old generation in the
+  // moving space, which is a prerequisite for a young-generation collection.
+  bool HasOldGeneration() const { return use_generational_ && old_gen_end_ != nullptr; }
+  // Forget about the old generation so that the next cycle is a full-heap
+  // one. Required when the moving space is compacted by another collector.
+  void ResetGenerationalState();
 
   void ClampGrowthLimit(size_t new_capacity) REQUIRES(Locks::heap_bitmap_lock_);
   // Updated before (or in) pre-compaction pause and is accessed only in the
@@ -203,7 +216,10 @@ class MarkCompact final : public GarbageCollector {
     // Return offset (within the indexed chunk-info) of the nth live word.
     uint32_t FindNthLiveWordOffset(size_t chunk_idx, uint32_t n) const;
     // Sets all bits in the bitmap corresponding to the given range. Also
-    // returns the bit-index of the first word.
+    // returns the bit-index of the first word. If kAtomic is true, then the
+    // boundary words, which may be shared with neighboring objects, are
+    // updated atomically.
+    template <bool kAtomic = false>
     ALWAYS_INLINE uintptr_t SetLiveWords(uintptr_t begin, size_t size);
     // Count number of live words upto the given bit-index. This is to be used
     // to compute the post-compact address of an old reference.
@@ -344,6 +360,18 @@ class MarkCompact final : public GarbageCollector {
   // userfaultfd.
   template <int kMode>
   void CompactMovingSpace(uint8_t* page) REQUIRES_SHARED(Locks::mutator_lock_);
+  // Hand out disjoint ranges of [begin_idx, end_idx) moving-space pages to the
+  // heap thread-pool's workers, which compact them concurrently with the GC
+  // thread. Returns false if the pool is not used. The workers must be
+  // finished using FinishParallelCompaction().
+  bool StartParallelCompaction(size_t begin_idx, size_t end_idx)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  void FinishParallelCompaction() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Compact and map the moving-space pages in [begin_idx, end_idx) using 'buf'.
+  // Pages are claimed via moving_pages_status_ exactly like mutators do in
+  // the SIGBUS handler, so the pages already claimed by others are skipped.
+  void CompactMovingSpacePages(size_t begin_idx, size_t end_idx, uint8_t* buf)
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Compact the given page as per func and change its state. Also map/copy the
   // page, if required. Returns true if the page was compacted, else false.
@@ -432,6 +460,14 @@ class MarkCompact final : public GarbageCollector {
   // Go through all the objects in the mark-stack until it's empty.
   void ProcessMarkStack() override REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::heap_bitmap_lock_);
+  // Drain the mark-stack using 'thread_count' threads (including the calling
+  // thread) from the heap's thread-pool. Each task has its own mark-stack, and
+  // donates half of it back to the pool when it overflows.
+  void ProcessMarkStackParallel(size_t thread_count) REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_);
+  // Returns how many threads we should use for marking, based on whether we
+  // are in a pause or not.
+  size_t GetThreadCount(bool paused) const;
   void ExpandMarkStack() REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::heap_bitmap_lock_);
 
@@ -447,9 +483,11 @@ class MarkCompact final : public GarbageCollector {
 
   // Update the live-words bitmap as well as add the object size to the
   // chunk-info vector. Both are required for computation of post-compact addresses.
-  // Also updates freed_objects_ counter.
+  // Also updates freed_objects_ counter, unless kParallel is true, in which
+  // case the caller is responsible for accounting the object.
+  template <bool kParallel = false>
   void UpdateLivenessInfo(mirror::Object* obj, size_t obj_size)
-      REQUIRES_SHARED(Locks::mutator_lock_);
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!class_after_obj_map_lock_);
 
   void ProcessReferences(Thread* self)
       REQUIRES_SHARED(Locks::mutator_lock_)
@@ -535,13 +573,40 @@ class MarkCompact final : public GarbageCollector {
   }
 
   // Add/update <class, obj> pair if class > obj and obj is the lowest address
-  // object of class.
+  // object of class. If kParallel is true, then the map is updated under
+  // class_after_obj_map_lock_.
+  template <bool kParallel = false>
   ALWAYS_INLINE void UpdateClassAfterObjectMap(mirror::Object* obj)
-      REQUIRES_SHARED(Locks::mutator_lock_);
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!class_after_obj_map_lock_);
 
   void MarkZygoteLargeObjects() REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::heap_bitmap_lock_);
 
+  // Set liveness information (live-words bitmap and chunk-info vector) for the
+  // old generation in the moving space during young-generation collections.
+  // As old-gen objects are never evacuated in young collections, the entire
+  // [moving_space_begin_, old_gen_end_) range is treated as live.
+  void InitializeOldGenLivenessInfo() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Scan old-generation objects on cards aged in this cycle and mark the
+  // young objects reachable from them. Used only in young collections.
+  void ScanOldGenDirtyCards() REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_);
+  // Update references in old-generation objects, on non-clean cards, which
+  // reside in pages that are not going to be compacted. Also marks such pages
+  // as processed. Used only in young collections, during compaction pause.
+  void UpdateOldGenObjects() REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_);
+  // Move the dirty cards of the moving space to the post-compact location of
+  // the objects they cover, so that the next young collection can find the
+  // old-to-young references created during this cycle.
+  void CarryForwardMovingSpaceCards() REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_);
+  // Transform the moving-space mark-bitmap into the post-compact addresses of
+  // the marked objects so that it could be used as the old generation's
+  // live-bitmap in the next young collection.
+  void UpdateOldGenMarkBitmap() REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_);
+
   // Map zero-pages in the given range. 'tolerate_eexist' and 'tolerate_enoent'
   // help us decide if we should expect EEXIST or ENOENT back from the ioctl
   // respectively. It may return after mapping fewer pages than requested.
@@ -654,6 +719,8 @@ class MarkCompact final : public GarbageCollector {
   // map of <K, V> such that the class K (in moving space) is after its
   // objects, and its object V is the lowest object (in moving space).
   ClassAfterObjectMap class_after_obj_map_;
+  // Guards class_after_obj_map_ when marking is performed by multiple threads.
+  Mutex class_after_obj_map_lock_;
   // Since the compaction is done in reverse, we use a reverse iterator. It is maintained
   // either at the pair whose class is lower than the first page to be freed, or at the
   // pair whose object is not yet compacted.
@@ -693,6 +760,11 @@ class MarkCompact final : public GarbageCollector {
   size_t live_stack_freeze_size_;
 
   uint64_t bytes_scanned_;
+  // Bytes scanned and objects marked in moving space by parallel marking
+  // tasks. Folded into bytes_scanned_ and freed_objects_ respectively once
+  // the tasks are finished.
+  Atomic<uint64_t> parallel_bytes_scanned_;
+  Atomic<uint32_t> parallel_moving_objects_marked_;
 
   // For every page in the to-space (post-compact heap) we need to know the
   // first object from which we must compact and/or update references. This is
@@ -790,6 +862,21 @@ class MarkCompact final : public GarbageCollector {
   // is also clamped, then we set it to 'Finished'.
   ClampInfoStatus clamp_info_map_status_;
 
+  // Whether young-generation collections are enabled.
+  const bool use_generational_;
+  // True while running a young-generation collection.
+  bool young_gen_;
+  // End of the old generation in the moving space, which is the post-compact
+  // end of the objects that survived the last cycle. Null if there is no old
+  // generation, in which case the next cycle must be a full-heap one.
+  uint8_t* old_gen_end_;
+  // Post-compact end of the live objects allocated before this GC cycle.
+  // Unlike post_compact_end_, it's not page-aligned.
+  uint8_t* post_compact_live_end_;
+  // Number of objects in the old generation. Used to compute freed_objects_
+  // in young collections, where old-gen objects are not discovered.
+  size_t old_gen_object_count_;
+
   class FlipCallback;
   class ThreadFlipVisitor;
   class VerifyRootMarkedVisitor;
@@ -798,12 +885,16 @@ class MarkCompact final : public GarbageCollector {
   template <size_t kBufferSize>
   class ThreadRootsVisitor;
   class RefFieldsVisitor;
+  class MarkStackTask;
+  class CompactionTask;
   template <bool kCheckBegin, bool kCheckEnd> class RefsUpdateVisitor;
   class ArenaPoolPageUpdater;
   class ClassLoaderRootsUpdater;
   class LinearAllocPageUpdater;
   class ImmuneSpaceUpdateObjVisitor;
 
+  friend class YoungMarkCompact;
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(MarkCompact);
 };
 
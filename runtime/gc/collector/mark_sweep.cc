@@ -183,11 +183,11 @@ void MarkSweep::PausePhase() {
   {
     TimingLogger::ScopedTiming t2("SwapStacks", GetTimings());
     WriterMutexLock mu(self, *Locks::heap_bitmap_lock_);
+    // Need to revoke all the thread local allocation stacks before swapping the allocation stacks,
+    // so that the objects they buffer end up on the live stack and nobody allocates into it.
+    RevokeAllThreadLocalAllocationStacks(self);
     heap_->SwapStacks();
     live_stack_freeze_size_ = heap_->GetLiveStack()->Size();
-    // Need to revoke all the thread local allocation stacks since we just swapped the allocation
-    // stacks and don't want anybody to allocate into the live stack.
-    RevokeAllThreadLocalAllocationStacks(self);
   }
   heap_->PreSweepingGcVerification(this);
   // Disallow new system weaks to prevent a race which occurs when someone adds a new system
@@ -310,9 +310,10 @@ void MarkSweep::UpdateAndMarkModUnion() {
       mod_union_table->UpdateAndMarkReferences(this);
     } else {
       // No mod-union table, scan all the live bits. This can only occur for app images.
-      space->GetLiveBitmap()->VisitMarkedRange(reinterpret_cast<uintptr_t>(space->Begin()),
-                                               reinterpret_cast<uintptr_t>(space->End()),
-                                               ScanObjectVisitor(this));
+      space->GetLiveBitmap()->VisitMarkedRangePrefetched(
+          reinterpret_cast<uintptr_t>(space->Begin()),
+          reinterpret_cast<uintptr_t>(space->End()),
+          ScanObjectVisitor(this));
     }
   }
 }
@@ -1058,7 +1059,7 @@ void MarkSweep::RecursiveMark() {
           // This function does not handle heap end increasing, so we must use the space end.
           uintptr_t begin = reinterpret_cast<uintptr_t>(space->Begin());
           uintptr_t end = reinterpret_cast<uintptr_t>(space->End());
-          current_space_bitmap_->VisitMarkedRange(begin, end, scan_visitor);
+          current_space_bitmap_->VisitMarkedRangePrefetched(begin, end, scan_visitor);
         }
       }
     }
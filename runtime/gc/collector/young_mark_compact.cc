@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "young_mark_compact.h"
+
+#include "runtime.h"
+
+namespace art HIDDEN {
+namespace gc {
+namespace collector {
+
+YoungMarkCompact::YoungMarkCompact(Heap* heap, MarkCompact* main)
+    : GarbageCollector(heap, "young concurrent mark compact"), main_(main) {
+  // Initialize GC metrics.
+  metrics::ArtMetrics* metrics = GetMetrics();
+  gc_time_histogram_ = metrics->YoungGcCollectionTime();
+  metrics_gc_count_ = metrics->YoungGcCount();
+  metrics_gc_count_delta_ = metrics->YoungGcCountDelta();
+  gc_throughput_histogram_ = metrics->YoungGcThroughput();
+  gc_tracing_throughput_hist_ = metrics->YoungGcTracingThroughput();
+  gc_throughput_avg_ = metrics->YoungGcThroughputAvg();
+  gc_tracing_throughput_avg_ = metrics->YoungGcTracingThroughputAvg();
+  gc_scanned_bytes_ = metrics->YoungGcScannedBytes();
+  gc_scanned_bytes_delta_ = metrics->YoungGcScannedBytesDelta();
+  gc_freed_bytes_ = metrics->YoungGcFreedBytes();
+  gc_freed_bytes_delta_ = metrics->YoungGcFreedBytesDelta();
+  gc_duration_ = metrics->YoungGcDuration();
+  gc_duration_delta_ = metrics->YoungGcDurationDelta();
+  are_metrics_initialized_ = true;
+}
+
+void YoungMarkCompact::RunPhases() {
+  DCHECK(main_->HasOldGeneration());
+  main_->RunYoungPhases();
+}
+
+}  // namespace collector
+}  // namespace gc
+}  // namespace art
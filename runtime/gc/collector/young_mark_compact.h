@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_COLLECTOR_YOUNG_MARK_COMPACT_H_
+#define ART_RUNTIME_GC_COLLECTOR_YOUNG_MARK_COMPACT_H_
+
+#include "base/macros.h"
+#include "garbage_collector.h"
+#include "mark_compact.h"
+
+namespace art HIDDEN {
+namespace gc {
+
+class Heap;
+
+namespace collector {
+
+// Young-generation (sticky) collections of the concurrent mark-compact
+// collector. All the work is done by the main MarkCompact instance, with which
+// all the GC data structures are shared. This class only exists so that
+// young-generation collections have their own timings, histograms and metrics.
+class YoungMarkCompact final : public GarbageCollector {
+ public:
+  YoungMarkCompact(Heap* heap, MarkCompact* main);
+  ~YoungMarkCompact() {}
+
+  GcType GetGcType() const override {
+    return kGcTypeSticky;
+  }
+
+  CollectorType GetCollectorType() const override {
+    return kCollectorTypeCMC;
+  }
+
+  mirror::Object* MarkObject(mirror::Object* obj) override
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_) {
+    return main_->MarkObject(obj);
+  }
+
+  void MarkHeapReference(mirror::HeapReference<mirror::Object>* obj,
+                         bool do_atomic_update) override
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_) {
+    main_->MarkHeapReference(obj, do_atomic_update);
+  }
+
+  void VisitRoots(mirror::Object*** roots,
+                  size_t count,
+                  const RootInfo& info) override
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_) {
+    main_->VisitRoots(roots, count, info);
+  }
+  void VisitRoots(mirror::CompressedReference<mirror::Object>** roots,
+                  size_t count,
+                  const RootInfo& info) override
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_) {
+    main_->VisitRoots(roots, count, info);
+  }
+
+  bool IsNullOrMarkedHeapReference(mirror::HeapReference<mirror::Object>* obj,
+                                   bool do_atomic_update) override
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_) {
+    return main_->IsNullOrMarkedHeapReference(obj, do_atomic_update);
+  }
+
+  void DelayReferenceReferent(ObjPtr<mirror::Class> klass,
+                              ObjPtr<mirror::Reference> reference) override
+      REQUIRES_SHARED(Locks::mutator_lock_, Locks::heap_bitmap_lock_) {
+    main_->DelayReferenceReferent(klass, reference);
+  }
+
+  mirror::Object* IsMarked(mirror::Object* obj) override
+      REQUIRES_SHARED(Locks::mutator_lock_, Locks::heap_bitmap_lock_) {
+    return main_->IsMarked(obj);
+  }
+
+  void ProcessMarkStack() override REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_) {
+    main_->ProcessMarkStack();
+  }
+
+ protected:
+  void RunPhases() override REQUIRES(!Locks::mutator_lock_);
+
+  void RevokeAllThreadLocalBuffers() override {
+    main_->RevokeAllThreadLocalBuffers();
+  }
+
+ private:
+  MarkCompact* const main_;
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(YoungMarkCompact);
+};
+
+}  // namespace collector
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_COLLECTOR_YOUNG_MARK_COMPACT_H_
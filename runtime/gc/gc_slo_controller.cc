@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gc_slo_controller.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+
+#include <android-base/logging.h>
+
+#include "base/time_utils.h"
+
+namespace art HIDDEN {
+namespace gc {
+
+GcSloController::GcSloController(double gc_cpu_fraction_target, uint64_t pause_budget_ns)
+    : gc_cpu_fraction_target_(gc_cpu_fraction_target),
+      pause_budget_ns_(pause_budget_ns),
+      last_gc_cpu_time_ns_(0u),
+      last_process_cpu_time_ns_(0u),
+      gc_cpu_fraction_(-1.0),
+      growth_scale_(1.0),
+      concurrent_start_scale_(1.0),
+      pause_budget_misses_(0u) {
+  DCHECK_GE(gc_cpu_fraction_target, 0.0);
+  DCHECK_LT(gc_cpu_fraction_target, 1.0);
+}
+
+void GcSloController::RecordGc(uint64_t total_gc_cpu_time_ns,
+                               uint64_t process_cpu_time_ns,
+                               uint64_t max_pause_ns,
+                               bool concurrent) {
+  if (gc_cpu_fraction_target_ > 0.0) {
+    if (total_gc_cpu_time_ns >= last_gc_cpu_time_ns_ &&
+        process_cpu_time_ns > last_process_cpu_time_ns_) {
+      const uint64_t gc_cpu_delta = total_gc_cpu_time_ns - last_gc_cpu_time_ns_;
+      const uint64_t process_cpu_delta = process_cpu_time_ns - last_process_cpu_time_ns_;
+      const double sample =
+          std::min(1.0, static_cast<double>(gc_cpu_delta) / static_cast<double>(process_cpu_delta));
+      gc_cpu_fraction_ = (gc_cpu_fraction_ < 0.0)
+          ? sample
+          : kSmoothing * sample + (1.0 - kSmoothing) * gc_cpu_fraction_;
+      // GC CPU cost is roughly proportional to the number of collections, i.e. inversely
+      // proportional to the free space granted after each one. Move part of the way towards the
+      // correction and bound each step so that a single noisy cycle cannot swing the heap size.
+      const double error = std::clamp(gc_cpu_fraction_ / gc_cpu_fraction_target_, 0.5, 2.0);
+      growth_scale_ =
+          std::clamp(growth_scale_ * std::sqrt(error), kMinGrowthScale, kMaxGrowthScale);
+    }
+    // Otherwise the counters were reset; start a new window from the current values.
+    last_gc_cpu_time_ns_ = total_gc_cpu_time_ns;
+    last_process_cpu_time_ns_ = process_cpu_time_ns;
+  }
+  if (pause_budget_ns_ != 0u) {
+    if (max_pause_ns > pause_budget_ns_) {
+      ++pause_budget_misses_;
+      if (concurrent) {
+        // Usually the mutators had to wait for the GC to finish; give it more headroom.
+        concurrent_start_scale_ = std::min(concurrent_start_scale_ * 1.5, kMaxConcurrentStartScale);
+      } else {
+        // The pause covers the whole collection, whose cost grows with the heap.
+        const double cap = static_cast<double>(pause_budget_ns_) / max_pause_ns;
+        growth_scale_ = std::max(kMinGrowthScale, growth_scale_ * cap);
+      }
+    } else if (max_pause_ns < pause_budget_ns_ / 2) {
+      concurrent_start_scale_ = std::max(1.0, concurrent_start_scale_ * 0.9);
+    }
+  }
+  VLOG(heap) << "GC SLO controller: gc cpu fraction=" << gc_cpu_fraction_
+             << " max pause=" << PrettyDuration(max_pause_ns)
+             << " growth scale=" << growth_scale_
+             << " concurrent start scale=" << concurrent_start_scale_;
+}
+
+void GcSloController::Dump(std::ostream& os) const {
+  if (!IsEnabled()) {
+    return;
+  }
+  os << "GC SLO controller:";
+  if (gc_cpu_fraction_target_ > 0.0) {
+    os << " target gc cpu fraction " << gc_cpu_fraction_target_
+       << " measured " << std::max(gc_cpu_fraction_, 0.0);
+  }
+  if (pause_budget_ns_ != 0u) {
+    os << " pause budget " << PrettyDuration(pause_budget_ns_)
+       << " misses " << pause_budget_misses_;
+  }
+  os << " growth scale " << growth_scale_
+     << " concurrent start scale " << concurrent_start_scale_ << "\n";
+}
+
+}  // namespace gc
+}  // namespace art
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_GC_SLO_CONTROLLER_H_
+#define ART_RUNTIME_GC_GC_SLO_CONTROLLER_H_
+
+#include <stdint.h>
+
+#include <iosfwd>
+
+#include "base/macros.h"
+
+namespace art HIDDEN {
+namespace gc {
+
+// Online controller which adjusts heap growth so that GC stays within a CPU and pause budget.
+// The static knobs (HeapTargetUtilization, HeapMinFree, HeapMaxFree) still compute the baseline;
+// this only produces multiplicative corrections from what previous cycles actually cost:
+//  - If GC consumes more than `gc_cpu_fraction_target` of process CPU time, the heap is grown
+//    more so that collections happen less often, and vice versa.
+//  - If a pause exceeds `pause_budget_ns`, concurrent GCs are started earlier so that mutators
+//    are less likely to block on them; non-concurrent GCs cap growth since their pause scales
+//    with the heap size.
+// Not thread safe; the heap calls it with process_state_update_lock_ held.
+class GcSloController {
+ public:
+  // Bounds on the correction factors.
+  static constexpr double kMinGrowthScale = 0.5;
+  static constexpr double kMaxGrowthScale = 8.0;
+  static constexpr double kMaxConcurrentStartScale = 4.0;
+
+  // A zero target disables the corresponding goal.
+  GcSloController(double gc_cpu_fraction_target, uint64_t pause_budget_ns);
+
+  bool IsEnabled() const {
+    return gc_cpu_fraction_target_ > 0.0 || pause_budget_ns_ != 0u;
+  }
+
+  // Feed the results of a finished GC. The CPU times are cumulative; the deltas since the
+  // previous call are used, and a decrease (e.g. after ResetGcPerformanceInfo) restarts the
+  // measurement window. `max_pause_ns` is the longest mutator-visible pause of this GC.
+  void RecordGc(uint64_t total_gc_cpu_time_ns,
+                uint64_t process_cpu_time_ns,
+                uint64_t max_pause_ns,
+                bool concurrent);
+
+  // Multiplier applied to the free bytes granted after a GC.
+  double GetGrowthScale() const {
+    return growth_scale_;
+  }
+
+  // Multiplier applied to the headroom left before the next concurrent GC starts.
+  double GetConcurrentStartScale() const {
+    return concurrent_start_scale_;
+  }
+
+  // Smoothed fraction of process CPU time spent in GC, or a negative value if unknown.
+  double GetGcCpuFraction() const {
+    return gc_cpu_fraction_;
+  }
+
+  void Dump(std::ostream& os) const;
+
+ private:
+  // Weight of the newest sample in the exponential moving average of the GC CPU fraction.
+  static constexpr double kSmoothing = 0.3;
+
+  const double gc_cpu_fraction_target_;
+  const uint64_t pause_budget_ns_;
+
+  uint64_t last_gc_cpu_time_ns_;
+  uint64_t last_process_cpu_time_ns_;
+  double gc_cpu_fraction_;
+  double growth_scale_;
+  double concurrent_start_scale_;
+  uint64_t pause_budget_misses_;
+
+  DISALLOW_COPY_AND_ASSIGN(GcSloController);
+};
+
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_GC_SLO_CONTROLLER_H_
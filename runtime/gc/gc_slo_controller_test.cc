@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gc_slo_controller.h"
+
+#include "base/time_utils.h"
+#include "gtest/gtest.h"
+
+namespace art HIDDEN {
+namespace gc {
+
+TEST(GcSloControllerTest, Disabled) {
+  GcSloController controller(0.0, 0u);
+  EXPECT_FALSE(controller.IsEnabled());
+  EXPECT_DOUBLE_EQ(1.0, controller.GetGrowthScale());
+  EXPECT_DOUBLE_EQ(1.0, controller.GetConcurrentStartScale());
+}
+
+TEST(GcSloControllerTest, GrowsWhenOverCpuTarget) {
+  GcSloController controller(0.05, 0u);
+  ASSERT_TRUE(controller.IsEnabled());
+  uint64_t gc_cpu = 0;
+  uint64_t process_cpu = 0;
+  double last_scale = controller.GetGrowthScale();
+  for (size_t i = 0; i < 5; ++i) {
+    // 20% of CPU time in GC, four times the target.
+    gc_cpu += MsToNs(20);
+    process_cpu += MsToNs(100);
+    controller.RecordGc(gc_cpu, process_cpu, /*max_pause_ns=*/ 0u, /*concurrent=*/ true);
+    EXPECT_GT(controller.GetGrowthScale(), last_scale);
+    last_scale = controller.GetGrowthScale();
+  }
+  for (size_t i = 0; i < 100; ++i) {
+    gc_cpu += MsToNs(20);
+    process_cpu += MsToNs(100);
+    controller.RecordGc(gc_cpu, process_cpu, /*max_pause_ns=*/ 0u, /*concurrent=*/ true);
+  }
+  EXPECT_DOUBLE_EQ(GcSloController::kMaxGrowthScale, controller.GetGrowthScale());
+}
+
+TEST(GcSloControllerTest, ShrinksWhenUnderCpuTarget) {
+  GcSloController controller(0.2, 0u);
+  uint64_t gc_cpu = 0;
+  uint64_t process_cpu = 0;
+  for (size_t i = 0; i < 100; ++i) {
+    gc_cpu += MsToNs(1);
+    process_cpu += MsToNs(100);
+    controller.RecordGc(gc_cpu, process_cpu, /*max_pause_ns=*/ 0u, /*concurrent=*/ true);
+  }
+  EXPECT_DOUBLE_EQ(GcSloController::kMinGrowthScale, controller.GetGrowthScale());
+}
+
+TEST(GcSloControllerTest, CounterResetStartsNewWindow) {
+  GcSloController controller(0.05, 0u);
+  controller.RecordGc(MsToNs(50), MsToNs(100), 0u, /*concurrent=*/ true);
+  const double scale = controller.GetGrowthScale();
+  // Counters went backwards, e.g. after ResetGcPerformanceInfo(); no sample is taken.
+  controller.RecordGc(MsToNs(1), MsToNs(100), 0u, /*concurrent=*/ true);
+  EXPECT_DOUBLE_EQ(scale, controller.GetGrowthScale());
+}
+
+TEST(GcSloControllerTest, PauseBudget) {
+  GcSloController controller(0.0, MsToNs(4));
+  ASSERT_TRUE(controller.IsEnabled());
+  // Concurrent GC over budget starts the next GC earlier, up to a limit.
+  controller.RecordGc(0u, 0u, MsToNs(8), /*concurrent=*/ true);
+  EXPECT_GT(controller.GetConcurrentStartScale(), 1.0);
+  for (size_t i = 0; i < 10; ++i) {
+    controller.RecordGc(0u, 0u, MsToNs(8), /*concurrent=*/ true);
+  }
+  EXPECT_DOUBLE_EQ(GcSloController::kMaxConcurrentStartScale,
+                   controller.GetConcurrentStartScale());
+  // Pauses well within budget decay back to the default.
+  for (size_t i = 0; i < 100; ++i) {
+    controller.RecordGc(0u, 0u, MsToNs(1), /*concurrent=*/ true);
+  }
+  EXPECT_DOUBLE_EQ(1.0, controller.GetConcurrentStartScale());
+  // A non-concurrent GC over budget limits heap growth instead.
+  controller.RecordGc(0u, 0u, MsToNs(8), /*concurrent=*/ false);
+  EXPECT_DOUBLE_EQ(0.5, controller.GetGrowthScale());
+  EXPECT_DOUBLE_EQ(1.0, controller.GetConcurrentStartScale());
+}
+
+}  // namespace gc
+}  // namespace art
@@ -273,7 +273,7 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self,
 static constexpr size_t kThreadLocalAllocationStackSize = 128;
 
 inline void Heap::PushOnAllocationStack(Thread* self, ObjPtr<mirror::Object>* obj) {
-  if (kUseThreadLocalAllocationStack) {
+  if (UseThreadLocalAllocationStack()) {
     if (UNLIKELY(!self->PushOnThreadLocalAllocationStack(obj->Ptr()))) {
       PushOnThreadLocalAllocationStackWithInternalGC(self, obj);
     }
@@ -52,11 +52,14 @@ inline void Heap::VisitObjects(Visitor&& visitor) {
     {
       ScopedThreadSuspension sts(self, ThreadState::kWaitingForVisitObjects);
       ScopedSuspendAll ssa(__FUNCTION__);
+      RevokeAllThreadLocalAllocationStacks(self);
       VisitObjectsInternalRegionSpace(visitor);
       VisitObjectsInternal(visitor);
     }
     DecrementDisableMovingGC(self);
   } else {
+    // Objects buffered on thread-local allocation stacks are not on the allocation stack yet.
+    FlushAllThreadLocalAllocationStacks(self);
     // Since concurrent moving GC has thread suspension, also poison ObjPtr the normal case to
     // catch bugs.
     self->PoisonObjectPointers();
@@ -72,6 +75,7 @@ template <typename Visitor>
 inline void Heap::VisitObjectsPaused(Visitor&& visitor) {
   Thread* self = Thread::Current();
   Locks::mutator_lock_->AssertExclusiveHeld(self);
+  RevokeAllThreadLocalAllocationStacks(self);
   VisitObjectsInternalRegionSpace(visitor);
   VisitObjectsInternal(visitor);
 }
@@ -19,6 +19,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <limits>
 #include <memory>
 #include <random>
@@ -60,6 +61,7 @@
 #include "gc/collector/partial_mark_sweep.h"
 #include "gc/collector/semi_space.h"
 #include "gc/collector/sticky_mark_sweep.h"
+#include "gc/collector/young_mark_compact.h"
 #include "gc/racing_check.h"
 #include "gc/reference_processor.h"
 #include "gc/scoped_gc_critical_section.h"
@@ -152,8 +154,8 @@ static constexpr size_t kMaxConcurrentRemainingBytes = 512 * KB;
 // Sticky GC throughput adjustment, divided by 4. Increasing this causes sticky GC to occur more
 // relative to partial/full GC. This may be desirable since sticky GCs interfere less with mutator
 // threads (lower pauses, use less memory bandwidth).
-static double GetStickyGcThroughputAdjustment(bool use_generational_cc) {
-  return use_generational_cc ? 0.5 : 1.0;
+static double GetStickyGcThroughputAdjustment(bool use_generational) {
+  return use_generational ? 0.5 : 1.0;
 }
 // Whether or not we compact the zygote in PreZygoteFork.
 static constexpr bool kCompactZygote = kMovingCollector;
@@ -297,9 +299,13 @@ Heap::Heap(size_t initial_size,
            bool low_memory_mode,
            size_t long_pause_log_threshold,
            size_t long_gc_log_threshold,
+           double gc_cpu_fraction_target,
+           uint64_t gc_pause_budget,
            bool ignore_target_footprint,
            bool always_log_explicit_gcs,
            bool use_tlab,
+           bool use_numa_aware_tlab,
+           bool use_adaptive_tlab_sizing,
            bool verify_pre_gc_heap,
            bool verify_pre_sweeping_heap,
            bool verify_post_gc_heap,
@@ -310,6 +316,7 @@ Heap::Heap(size_t initial_size,
            bool measure_gc_performance,
            bool use_homogeneous_space_compaction_for_oom,
            bool use_generational_cc,
+           bool use_generational_cmc,
            uint64_t min_interval_homogeneous_space_compaction_by_oom,
            bool dump_region_info_before_gc,
            bool dump_region_info_after_gc)
@@ -353,6 +360,7 @@ Heap::Heap(size_t initial_size,
       process_state_update_lock_("process state update lock", kPostMonitorLock),
       min_foreground_target_footprint_(0),
       min_foreground_concurrent_start_bytes_(0),
+      gc_slo_controller_(gc_cpu_fraction_target, gc_pause_budget),
       concurrent_start_bytes_(std::numeric_limits<size_t>::max()),
       total_bytes_freed_ever_(0),
       total_objects_freed_ever_(0),
@@ -382,6 +390,10 @@ Heap::Heap(size_t initial_size,
           : (kVerifyObjectSupport > kVerifyObjectModeFast)
               ? kVerifyObjectAllocationStackSize
               : kDefaultAllocationStackSize),
+      use_thread_local_allocation_stack_(!gUseReadBarrier &&
+                                         !kGCALotMode &&
+                                         kVerifyObjectSupport <= kVerifyObjectModeFast),
+      num_thread_local_allocation_stacks_(0u),
       current_allocator_(kAllocatorTypeDlMalloc),
       current_non_moving_allocator_(kAllocatorTypeNonMoving),
       bump_pointer_space_(nullptr),
@@ -396,11 +408,13 @@ Heap::Heap(size_t initial_size,
       verify_object_mode_(kVerifyObjectModeDisabled),
       disable_moving_gc_count_(0),
       semi_space_collector_(nullptr),
+      young_mark_compact_(nullptr),
       active_concurrent_copying_collector_(nullptr),
       young_concurrent_copying_collector_(nullptr),
       concurrent_copying_collector_(nullptr),
       is_running_on_memory_tool_(Runtime::Current()->IsRunningOnMemoryTool()),
       use_tlab_(use_tlab),
+      use_adaptive_tlab_sizing_(use_adaptive_tlab_sizing),
       main_space_backup_(nullptr),
       min_interval_homogeneous_space_compaction_by_oom_(
           min_interval_homogeneous_space_compaction_by_oom),
@@ -411,6 +425,7 @@ Heap::Heap(size_t initial_size,
       pending_heap_trim_(nullptr),
       use_homogeneous_space_compaction_for_oom_(use_homogeneous_space_compaction_for_oom),
       use_generational_cc_(use_generational_cc),
+      use_generational_cmc_(use_generational_cmc),
       running_collection_is_blocking_(false),
       blocking_gc_count_(0U),
       blocking_gc_time_(0U),
@@ -432,7 +447,13 @@ Heap::Heap(size_t initial_size,
       boot_image_spaces_(),
       boot_images_start_address_(0u),
       boot_images_size_(0u),
-      pre_oome_gc_count_(0u) {
+      pre_oome_gc_count_(0u),
+      tlab_refills_(0u),
+      tlab_wasted_bytes_(0u),
+      last_gc_tlab_refills_(0u),
+      last_gc_tlab_wasted_bytes_(0u),
+      total_tlab_refills_(0u),
+      total_tlab_wasted_bytes_(0u) {
   if (VLOG_IS_ON(heap) || VLOG_IS_ON(startup)) {
     LOG(INFO) << "Heap() entering";
   }
@@ -651,8 +672,10 @@ Heap::Heap(size_t initial_size,
     MemMap region_space_mem_map =
         space::RegionSpace::CreateMemMap(kRegionSpaceName, capacity_ * 2, request_begin);
     CHECK(region_space_mem_map.IsValid()) << "No region space mem map";
-    region_space_ = space::RegionSpace::Create(
-        kRegionSpaceName, std::move(region_space_mem_map), use_generational_cc_);
+    region_space_ = space::RegionSpace::Create(kRegionSpaceName,
+                                               std::move(region_space_mem_map),
+                                               use_generational_cc_,
+                                               use_numa_aware_tlab);
     AddSpace(region_space_);
   } else if (IsMovingGc(foreground_collector_type_)) {
     // Create bump pointer spaces.
@@ -796,8 +819,12 @@ Heap::Heap(size_t initial_size,
       garbage_collectors_.push_back(semi_space_collector_);
     }
     if (MayUseCollector(kCollectorTypeCMC)) {
-      mark_compact_ = new collector::MarkCompact(this);
+      mark_compact_ = new collector::MarkCompact(this, use_generational_cmc_);
       garbage_collectors_.push_back(mark_compact_);
+      if (use_generational_cmc_) {
+        young_mark_compact_ = new collector::YoungMarkCompact(this, mark_compact_);
+        garbage_collectors_.push_back(young_mark_compact_);
+      }
     }
     if (MayUseCollector(kCollectorTypeCC)) {
       concurrent_copying_collector_ = new collector::ConcurrentCopying(this,
@@ -1307,8 +1334,16 @@ void Heap::DumpGcPerformanceInfo(std::ostream& os) {
   os << "Total blocking GC count: " << GetBlockingGcCount() << "\n";
   os << "Total blocking GC time: " << PrettyDuration(GetBlockingGcTime()) << "\n";
   os << "Total pre-OOME GC count: " << GetPreOomeGcCount() << "\n";
+  {
+    MutexLock mu(Thread::Current(), process_state_update_lock_);
+    gc_slo_controller_.Dump(os);
+  }
   {
     MutexLock mu(Thread::Current(), *gc_complete_lock_);
+    os << "Total TLAB refills: " << total_tlab_refills_
+       << " wasted: " << PrettySize(total_tlab_wasted_bytes_) << "\n";
+    os << "Last GC TLAB refills: " << last_gc_tlab_refills_
+       << " wasted: " << PrettySize(last_gc_tlab_wasted_bytes_) << "\n";
     if (gc_count_rate_histogram_.SampleSize() > 0U) {
       os << "Histogram of GC count per " << NsToMs(kGcCountRateHistogramWindowDuration) << " ms: ";
       gc_count_rate_histogram_.DumpBins(os);
@@ -1362,6 +1397,8 @@ void Heap::ResetGcPerformanceInfo() {
     MutexLock mu(Thread::Current(), *gc_complete_lock_);
     gc_count_rate_histogram_.Reset();
     blocking_gc_count_rate_histogram_.Reset();
+    total_tlab_refills_ = 0u;
+    total_tlab_wasted_bytes_ = 0u;
   }
 }
 
@@ -2325,6 +2362,9 @@ void Heap::ChangeCollector(CollectorType collector_type) {
         break;
       }
       case kCollectorTypeCMC: {
+        if (use_generational_cmc_) {
+          gc_plan_.push_back(collector::kGcTypeSticky);
+        }
         gc_plan_.push_back(collector::kGcTypeFull);
         if (use_tlab_) {
           ChangeAllocator(kAllocatorTypeTLAB);
@@ -2566,6 +2606,10 @@ void Heap::PreZygoteFork() {
         region_space_->GetMarkBitmap()->Clear();
       } else {
         bump_pointer_space_->GetMemMap()->Protect(PROT_READ | PROT_WRITE);
+        if (mark_compact_ != nullptr) {
+          // Everything has been evacuated out of the moving space.
+          mark_compact_->ResetGenerationalState();
+        }
       }
     }
     if (temp_space_ != nullptr) {
@@ -2853,7 +2897,14 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
           collector = semi_space_collector_;
           break;
         case kCollectorTypeCMC:
-          collector = mark_compact_;
+          // Young-generation collection requires an old generation to have
+          // been established by a preceding full-heap collection.
+          if (gc_type == collector::kGcTypeSticky && use_generational_cmc_ &&
+              mark_compact_->HasOldGeneration()) {
+            collector = young_mark_compact_;
+          } else {
+            collector = mark_compact_;
+          }
           break;
         case kCollectorTypeCC:
           collector::ConcurrentCopying* active_cc_collector;
@@ -2986,6 +3037,13 @@ void Heap::FinishGC(Thread* self, collector::GcType gc_type) {
     }
     // Update the gc count rate histograms if due.
     UpdateGcCountRateHistograms();
+    // Close the TLAB refill accounting window of this cycle.
+    last_gc_tlab_refills_ = tlab_refills_.exchange(0u, std::memory_order_relaxed);
+    last_gc_tlab_wasted_bytes_ = tlab_wasted_bytes_.exchange(0u, std::memory_order_relaxed);
+    total_tlab_refills_ += last_gc_tlab_refills_;
+    total_tlab_wasted_bytes_ += last_gc_tlab_wasted_bytes_;
+    VLOG(heap) << "TLAB refills since previous GC: " << last_gc_tlab_refills_
+               << " wasted: " << PrettySize(last_gc_tlab_wasted_bytes_);
   }
   // Reset.
   running_collection_is_blocking_ = false;
@@ -3263,40 +3321,104 @@ void Heap::PushOnAllocationStackWithInternalGC(Thread* self, ObjPtr<mirror::Obje
 
 void Heap::PushOnThreadLocalAllocationStackWithInternalGC(Thread* self,
                                                           ObjPtr<mirror::Object>* obj) {
-  // Slow path, the allocation stack push back must have already failed.
+  // Slow path, the thread-local allocation stack is either full or not set up yet.
   DCHECK(!self->PushOnThreadLocalAllocationStack(obj->Ptr()));
-  StackReference<mirror::Object>* start_address;
-  StackReference<mirror::Object>* end_address;
-  while (!allocation_stack_->AtomicBumpBack(kThreadLocalAllocationStackSize, &start_address,
-                                            &end_address)) {
-    // TODO: Add handle VerifyObject.
-    StackHandleScope<1> hs(self);
-    HandleWrapperObjPtr<mirror::Object> wrapper(hs.NewHandleWrapper(obj));
-    // Push our object into the reserve region of the allocaiton stack. This is only required due
-    // to heap verification requiring that roots are live (either in the live bitmap or in the
-    // allocation stack).
-    CHECK(allocation_stack_->AtomicPushBackIgnoreGrowthLimit(obj->Ptr()));
-    // Push into the reserve allocation stack.
-    CollectGarbageInternal(collector::kGcTypeSticky,
-                           kGcCauseForAlloc,
-                           false,
-                           GetCurrentGcNum() + 1);
+  StackReference<mirror::Object>* buffer = self->GetThreadLocalAllocationStackBuffer();
+  if (buffer == nullptr) {
+    self->SetThreadLocalAllocationStackBuffer(
+        std::make_unique<StackReference<mirror::Object>[]>(kThreadLocalAllocationStackSize));
+    buffer = self->GetThreadLocalAllocationStackBuffer();
+  }
+  if (!self->HasThreadLocalAllocationStack()) {
+    num_thread_local_allocation_stacks_.fetch_add(1u, std::memory_order_relaxed);
+  } else {
+    DCHECK_EQ(self->GetThreadLocalAllocationStackSize(), kThreadLocalAllocationStackSize);
+    // Flush the full buffer in one batch, leaving room for the buffers of the other threads to be
+    // flushed when they get revoked.
+    const size_t headroom = std::min(
+        num_thread_local_allocation_stacks_.load(std::memory_order_relaxed) *
+            kThreadLocalAllocationStackSize,
+        max_allocation_stack_size_ / 2);
+    while (!allocation_stack_->AtomicPushBackBatch(
+        buffer, kThreadLocalAllocationStackSize, headroom, /*ignore_growth_limit=*/ false)) {
+      // TODO: Add handle VerifyObject.
+      StackHandleScope<1> hs(self);
+      HandleWrapperObjPtr<mirror::Object> wrapper(hs.NewHandleWrapper(obj));
+      // Push our object into the reserve region of the allocation stack. This is only required due
+      // to heap verification requiring that roots are live (either in the live bitmap or in the
+      // allocation stack).
+      CHECK(allocation_stack_->AtomicPushBackIgnoreGrowthLimit(obj->Ptr()));
+      // The collection revokes, and thereby flushes, our buffer along with everybody else's.
+      CollectGarbageInternal(collector::kGcTypeSticky,
+                             kGcCauseForAlloc,
+                             false,
+                             GetCurrentGcNum() + 1);
+      if (!self->HasThreadLocalAllocationStack()) {
+        num_thread_local_allocation_stacks_.fetch_add(1u, std::memory_order_relaxed);
+        break;
+      }
+    }
+  }
+  if (kIsDebugBuild) {
+    std::fill_n(buffer, kThreadLocalAllocationStackSize, StackReference<mirror::Object>());
   }
-  self->SetThreadLocalAllocationStack(start_address, end_address);
-  // Retry on the new thread-local allocation stack.
+  self->SetThreadLocalAllocationStack(buffer, buffer + kThreadLocalAllocationStackSize);
+  // Retry on the emptied thread-local allocation stack.
   CHECK(self->PushOnThreadLocalAllocationStack(obj->Ptr()));  // Must succeed.
 }
 
+void Heap::FlushThreadLocalAllocationStack(Thread* thread) {
+  DCHECK(thread->HasThreadLocalAllocationStack());
+  const size_t count = thread->GetThreadLocalAllocationStackSize();
+  DCHECK_LE(count, kThreadLocalAllocationStackSize);
+  CHECK(allocation_stack_->AtomicPushBackBatch(thread->GetThreadLocalAllocationStackBuffer(),
+                                               count,
+                                               /*headroom=*/ 0u,
+                                               /*ignore_growth_limit=*/ true))
+      << "Allocation stack reserve exhausted while flushing " << count << " objects of "
+      << num_thread_local_allocation_stacks_.load(std::memory_order_relaxed)
+      << " thread-local allocation stacks";
+  num_thread_local_allocation_stacks_.fetch_sub(1u, std::memory_order_relaxed);
+}
+
+class FlushThreadLocalAllocationStackClosure : public Closure {
+ public:
+  explicit FlushThreadLocalAllocationStackClosure(Barrier* barrier) : barrier_(barrier) {
+  }
+  void Run(Thread* thread) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    thread->RevokeThreadLocalAllocationStack();
+    // If thread is a running mutator, then act on behalf of the requesting thread.
+    // See the code in ThreadList::RunCheckpoint.
+    barrier_->Pass(Thread::Current());
+  }
+
+ private:
+  Barrier* const barrier_;
+};
+
+void Heap::FlushAllThreadLocalAllocationStacks(Thread* self) {
+  if (!UseThreadLocalAllocationStack()) {
+    return;
+  }
+  Barrier barrier(0);
+  FlushThreadLocalAllocationStackClosure closure(&barrier);
+  size_t barrier_count = Runtime::Current()->GetThreadList()->RunCheckpoint(&closure);
+  ScopedThreadStateChange tsc(self, ThreadState::kWaitingForCheckPointsToRun);
+  if (barrier_count != 0) {
+    barrier.Increment(self, barrier_count);
+  }
+}
+
 // Must do this with mutators suspended since we are directly accessing the allocation stacks.
 size_t Heap::VerifyHeapReferences(bool verify_referents) {
   Thread* self = Thread::Current();
   Locks::mutator_lock_->AssertExclusiveHeld(self);
+  // Flush the thread-local allocation stacks first, so that the allocation stack holds every
+  // allocated object and stays sorted.
+  RevokeAllThreadLocalAllocationStacks(self);
   // Lets sort our allocation stacks so that we can efficiently binary search them.
   allocation_stack_->Sort();
   live_stack_->Sort();
-  // Since we sorted the allocation stack content, need to revoke all
-  // thread-local allocation stacks.
-  RevokeAllThreadLocalAllocationStacks(self);
   size_t fail_count = 0;
   VerifyObjectVisitor visitor(self, this, &fail_count, verify_referents);
   // Verify objects in the allocation stack since these will be objects which were:
@@ -3422,11 +3544,10 @@ class VerifyLiveStackReferences {
 bool Heap::VerifyMissingCardMarks() {
   Thread* self = Thread::Current();
   Locks::mutator_lock_->AssertExclusiveHeld(self);
+  // Flush the thread-local allocation stacks so that no mutator pushes happen behind our back.
+  RevokeAllThreadLocalAllocationStacks(self);
   // We need to sort the live stack since we binary search it.
   live_stack_->Sort();
-  // Since we sorted the allocation stack content, need to revoke all
-  // thread-local allocation stacks.
-  RevokeAllThreadLocalAllocationStacks(self);
   VerifyLiveStackReferences visitor(this);
   GetLiveBitmap()->Visit(visitor);
   // We can verify objects in the live stack since none of these should reference dead objects.
@@ -3439,7 +3560,7 @@ bool Heap::VerifyMissingCardMarks() {
 }
 
 void Heap::SwapStacks() {
-  if (kUseThreadLocalAllocationStack) {
+  if (UseThreadLocalAllocationStack()) {
     live_stack_->AssertAllZero();
   }
   allocation_stack_.swap(live_stack_);
@@ -3782,6 +3903,23 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
   MutexLock mu(Thread::Current(), process_state_update_lock_);
   // Use the multiplier to grow more for foreground.
   const double multiplier = HeapGrowthMultiplier();
+  double slo_growth_scale = 1.0;
+  double slo_concurrent_start_scale = 1.0;
+  if (gc_slo_controller_.IsEnabled()) {
+    uint64_t max_pause_ns = 0;
+    if (current_gc_iteration_.GetGcCause() == kGcCauseForAlloc) {
+      // Mutators were blocked for the whole GC, same as in LogGC().
+      max_pause_ns = current_gc_iteration_.GetDurationNs();
+    } else {
+      for (uint64_t pause : current_gc_iteration_.GetPauseTimes()) {
+        max_pause_ns = std::max(max_pause_ns, pause);
+      }
+    }
+    gc_slo_controller_.RecordGc(GetTotalGcCpuTime(), ProcessCpuNanoTime(), max_pause_ns,
+                                IsGcConcurrent());
+    slo_growth_scale = gc_slo_controller_.GetGrowthScale();
+    slo_concurrent_start_scale = gc_slo_controller_.GetConcurrentStartScale();
+  }
   if (gc_type != collector::kGcTypeSticky) {
     // Grow the heap for non sticky GC.
     uint64_t delta = bytes_allocated * (1.0 / GetTargetHeapUtilization() - 1.0);
@@ -3789,19 +3927,24 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
         << " target_utilization_=" << target_utilization_;
     grow_bytes = std::min(delta, static_cast<uint64_t>(max_free_));
     grow_bytes = std::max(grow_bytes, static_cast<uint64_t>(min_free_));
+    grow_bytes = static_cast<uint64_t>(grow_bytes * slo_growth_scale);
     target_size = bytes_allocated + static_cast<uint64_t>(grow_bytes * multiplier);
     next_gc_type_ = collector::kGcTypeSticky;
   } else {
     collector::GcType non_sticky_gc_type = NonStickyGcType();
     // Find what the next non sticky collector will be.
     collector::GarbageCollector* non_sticky_collector = FindCollectorByGcType(non_sticky_gc_type);
-    if (use_generational_cc_) {
+    if (use_generational_cc_ || use_generational_cmc_) {
       if (non_sticky_collector == nullptr) {
         non_sticky_collector = FindCollectorByGcType(collector::kGcTypePartial);
       }
+      if (non_sticky_collector == nullptr) {
+        non_sticky_collector = FindCollectorByGcType(collector::kGcTypeFull);
+      }
       CHECK(non_sticky_collector != nullptr);
     }
-    double sticky_gc_throughput_adjustment = GetStickyGcThroughputAdjustment(use_generational_cc_);
+    double sticky_gc_throughput_adjustment =
+        GetStickyGcThroughputAdjustment(use_generational_cc_ || use_generational_cmc_);
 
     // If the throughput of the current sticky GC >= throughput of the non sticky collector, then
     // do another sticky collection next.
@@ -3819,10 +3962,11 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
       next_gc_type_ = non_sticky_gc_type;
     }
     // If we have freed enough memory, shrink the heap back down.
-    const size_t adjusted_max_free = static_cast<size_t>(max_free_ * multiplier);
+    const size_t scaled_max_free = static_cast<size_t>(max_free_ * slo_growth_scale);
+    const size_t adjusted_max_free = static_cast<size_t>(scaled_max_free * multiplier);
     if (bytes_allocated + adjusted_max_free < target_footprint) {
       target_size = bytes_allocated + adjusted_max_free;
-      grow_bytes = max_free_;
+      grow_bytes = scaled_max_free;
     } else {
       target_size = std::max(bytes_allocated, target_footprint);
       // The same whether jank perceptible or not; just avoid the adjustment.
@@ -3863,6 +4007,8 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
       size_t remaining_bytes = bytes_allocated_during_gc;
       remaining_bytes = std::min(remaining_bytes, kMaxConcurrentRemainingBytes);
       remaining_bytes = std::max(remaining_bytes, kMinConcurrentRemainingBytes);
+      // Leave more headroom if previous GCs blew the pause budget.
+      remaining_bytes = static_cast<size_t>(remaining_bytes * slo_concurrent_start_scale);
       size_t target_footprint = target_footprint_.load(std::memory_order_relaxed);
       if (UNLIKELY(remaining_bytes > target_footprint)) {
         // A never going to happen situation that from the estimated allocation rate we will exceed
@@ -4154,6 +4300,9 @@ void Heap::RevokeThreadLocalBuffers(Thread* thread) {
   if (region_space_ != nullptr) {
     CHECK_EQ(region_space_->RevokeThreadLocalBuffers(thread), 0U);
   }
+  if (thread->HasThreadLocalAllocationStack()) {
+    thread->RevokeThreadLocalAllocationStack();
+  }
 }
 
 void Heap::RevokeRosAllocThreadLocalBuffers(Thread* thread) {
@@ -4467,6 +4616,38 @@ void Heap::AdjustSampleOffset(size_t adjustment) {
   GetHeapSampler().AdjustSampleOffset(adjustment);
 }
 
+size_t Heap::ComputeAdaptiveTlabSize(Thread* self, size_t default_size) {
+  if (!use_adaptive_tlab_sizing_) {
+    return default_size;
+  }
+  const uint32_t gc_num = GetCurrentGcNum();
+  size_t size = self->GetAdaptiveTlabSize();
+  if (size == 0) {
+    // First TLAB of this thread.
+    size = default_size;
+    self->SetAdaptiveTlabSize(size, gc_num);
+  } else if (gc_num != self->GetAdaptiveTlabGcNum()) {
+    size = NextAdaptiveTlabSize(
+        size, self->GetTlabBytesSinceResize(), gc_num - self->GetAdaptiveTlabGcNum());
+    self->SetAdaptiveTlabSize(size, gc_num);
+  }
+  return size;
+}
+
+size_t Heap::NextAdaptiveTlabSize(size_t current_size,
+                                  size_t bytes_since_resize,
+                                  uint32_t gcs_elapsed) {
+  DCHECK_NE(gcs_elapsed, 0u);
+  const size_t min_size = std::max(kMinAdaptiveTlabSize, gPageSize);
+  // Aim for a fixed number of refills per GC at the rate observed, averaging over the GCs the
+  // thread may have slept through so that idle threads shrink back towards the minimum.
+  const size_t bytes_per_gc = bytes_since_resize / gcs_elapsed;
+  const size_t target = bytes_per_gc / kAdaptiveTlabRefillsPerGc;
+  // Move half way towards the target to damp oscillation between cycles.
+  const size_t size = RoundUp(current_size / 2 + target / 2, kObjectAlignment);
+  return std::clamp(size, min_size, kMaxAdaptiveTlabSize);
+}
+
 void Heap::CheckGcStressMode(Thread* self, ObjPtr<mirror::Object>* obj) {
   DCHECK(gc_stress_mode_);
   auto* const runtime = Runtime::Current();
@@ -4566,10 +4747,11 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
     // There is enough space if we grow the TLAB. Lets do that. This increases the
     // TLAB bytes.
     const size_t min_expand_size = alloc_size - self->TlabSize();
+    const size_t partial_tlab_size = ComputeAdaptiveTlabSize(self, kPartialTlabSize);
     size_t next_tlab_size =
         jhp_enabled ? JHPCalculateNextTlabSize(
-                          self, kPartialTlabSize, alloc_size, &take_sample, &bytes_until_sample) :
-                      kPartialTlabSize;
+                          self, partial_tlab_size, alloc_size, &take_sample, &bytes_until_sample) :
+                      partial_tlab_size;
     const size_t expand_bytes = std::max(
         min_expand_size,
         std::min(self->TlabRemainingCapacity() - self->TlabSize(), next_tlab_size));
@@ -4581,11 +4763,15 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
     DCHECK_LE(alloc_size, self->TlabSize());
   } else if (allocator_type == kAllocatorTypeTLAB) {
     DCHECK(bump_pointer_space_ != nullptr);
+    // The tail of the current TLAB is abandoned.
+    tlab_wasted_bytes_.fetch_add(self->TlabSize(), std::memory_order_relaxed);
     // Try to allocate a page-aligned TLAB (not necessary though).
     // TODO: for large allocations, which are rare, maybe we should allocate
     // that object and return. There is no need to revoke the current TLAB,
     // particularly if it's mostly unutilized.
-    size_t next_tlab_size = RoundDown(alloc_size + kDefaultTLABSize, gPageSize) - alloc_size;
+    size_t next_tlab_size =
+        RoundDown(alloc_size + ComputeAdaptiveTlabSize(self, kDefaultTLABSize), gPageSize) -
+        alloc_size;
     if (jhp_enabled) {
       next_tlab_size = JHPCalculateNextTlabSize(
           self, next_tlab_size, alloc_size, &take_sample, &bytes_until_sample);
@@ -4610,8 +4796,15 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
       if (LIKELY(!IsOutOfMemoryOnAllocation(allocator_type,
                                             space::RegionSpace::kRegionSize,
                                             grow))) {
-        size_t next_pr_tlab_size =
-            kUsePartialTlabs ? kPartialTlabSize : gc::space::RegionSpace::kRegionSize;
+        // The rest of the current TLAB's region is lost unless it is large enough to be reused
+        // as a partial TLAB (see RegionSpace::RevokeThreadLocalBuffersLocked()).
+        if (!kUsePartialTlabs || self->TlabRemainingCapacity() < kPartialTlabSize) {
+          tlab_wasted_bytes_.fetch_add(self->TlabRemainingCapacity(), std::memory_order_relaxed);
+        }
+        size_t next_pr_tlab_size = kUsePartialTlabs
+            ? std::min(ComputeAdaptiveTlabSize(self, kPartialTlabSize),
+                       gc::space::RegionSpace::kRegionSize)
+            : gc::space::RegionSpace::kRegionSize;
         if (jhp_enabled) {
           next_pr_tlab_size = JHPCalculateNextTlabSize(
               self, next_pr_tlab_size, alloc_size, &take_sample, &bytes_until_sample);
@@ -4663,6 +4856,7 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
     }
   }
   // Refilled TLAB, return.
+  tlab_refills_.fetch_add(1u, std::memory_order_relaxed);
   ret = self->AllocTlab(alloc_size);
   DCHECK(ret != nullptr);
   *bytes_allocated = alloc_size;
@@ -38,6 +38,7 @@
 #include "gc/collector/mark_compact.h"
 #include "gc/collector_type.h"
 #include "gc/gc_cause.h"
+#include "gc/gc_slo_controller.h"
 #include "gc/space/large_object_space.h"
 #include "gc/space/space.h"
 #include "handle.h"
@@ -93,6 +94,7 @@ class ConcurrentCopying;
 class GarbageCollector;
 class MarkSweep;
 class SemiSpace;
+class YoungMarkCompact;
 }  // namespace collector
 
 namespace allocator {
@@ -128,14 +130,22 @@ enum HomogeneousSpaceCompactResult {
 // If true, use rosalloc/RosAllocSpace instead of dlmalloc/DlMallocSpace
 static constexpr bool kUseRosAlloc = true;
 
-// If true, use thread-local allocation stack.
-static constexpr bool kUseThreadLocalAllocationStack = false;
+// If true, use thread-local allocation stacks: objects are buffered per thread and flushed to
+// the allocation stack in batches. See Heap::UseThreadLocalAllocationStack() for the
+// configurations where this is turned off at runtime.
+static constexpr bool kUseThreadLocalAllocationStack = true;
 
 class Heap {
  public:
   // How much we grow the TLAB if we can do it.
   static constexpr size_t kPartialTlabSize = 16 * KB;
   static constexpr bool kUsePartialTlabs = true;
+  // Bounds for adaptive TLAB sizes. The upper bound matches the region size so that a region TLAB
+  // never needs more than one region.
+  static constexpr size_t kMinAdaptiveTlabSize = 4 * KB;
+  static constexpr size_t kMaxAdaptiveTlabSize = 256 * KB;
+  // Number of TLAB refills a thread allocating at a steady rate should need between two GCs.
+  static constexpr size_t kAdaptiveTlabRefillsPerGc = 32;
 
   static constexpr size_t kDefaultInitialSize = 2 * MB;
   static constexpr size_t kDefaultMaximumSize = 256 * MB;
@@ -225,9 +235,13 @@ class Heap {
        bool low_memory_mode,
        size_t long_pause_threshold,
        size_t long_gc_threshold,
+       double gc_cpu_fraction_target,
+       uint64_t gc_pause_budget,
        bool ignore_target_footprint,
        bool always_log_explicit_gcs,
        bool use_tlab,
+       bool use_numa_aware_tlab,
+       bool use_adaptive_tlab_sizing,
        bool verify_pre_gc_heap,
        bool verify_pre_sweeping_heap,
        bool verify_post_gc_heap,
@@ -238,6 +252,7 @@ class Heap {
        bool measure_gc_performance,
        bool use_homogeneous_space_compaction,
        bool use_generational_cc,
+       bool use_generational_cmc,
        uint64_t min_interval_homogeneous_space_compaction_by_oom,
        bool dump_region_info_before_gc,
        bool dump_region_info_after_gc);
@@ -574,6 +589,10 @@ class Heap {
     return use_generational_cc_;
   }
 
+  bool GetUseGenerationalCMC() const {
+    return use_generational_cmc_;
+  }
+
   // Returns the number of objects currently allocated.
   size_t GetObjectsAllocated() const
       REQUIRES(!Locks::heap_bitmap_lock_);
@@ -651,7 +670,8 @@ class Heap {
   std::string DumpSpaceNameFromAddress(const void* addr) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  void DumpForSigQuit(std::ostream& os) REQUIRES(!*gc_complete_lock_);
+  void DumpForSigQuit(std::ostream& os)
+      REQUIRES(!*gc_complete_lock_, !process_state_update_lock_);
 
   // Do a pending collector transition.
   void DoPendingCollectorTransition()
@@ -660,7 +680,7 @@ class Heap {
   // Deflate monitors, ... and trim the spaces.
   EXPORT void Trim(Thread* self) REQUIRES(!*gc_complete_lock_);
 
-  void RevokeThreadLocalBuffers(Thread* thread);
+  void RevokeThreadLocalBuffers(Thread* thread) REQUIRES_SHARED(Locks::mutator_lock_);
   void RevokeRosAllocThreadLocalBuffers(Thread* thread);
   void RevokeAllThreadLocalBuffers();
   void AssertThreadLocalBuffersAreRevoked(Thread* thread);
@@ -694,6 +714,17 @@ class Heap {
   EXPORT void RevokeAllThreadLocalAllocationStacks(Thread* self)
       REQUIRES(Locks::mutator_lock_, !Locks::runtime_shutdown_lock_, !Locks::thread_list_lock_);
 
+  // Flush the thread-local allocation stacks of all threads with a checkpoint, so that the
+  // allocation stack holds every object allocated before the call.
+  void FlushAllThreadLocalAllocationStacks(Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!Locks::runtime_shutdown_lock_, !Locks::thread_list_lock_);
+
+  // Move the objects buffered on `thread`'s thread-local allocation stack to the allocation stack.
+  // Called when the thread-local allocation stack is revoked, at which point `thread` cannot
+  // allocate, so this may use the allocation stack's reserve.
+  void FlushThreadLocalAllocationStack(Thread* thread) REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Mark all the objects in the allocation stack in the specified bitmap.
   // TODO: Refactor?
   void MarkAllocStack(accounting::ContinuousSpaceBitmap* bitmap1,
@@ -781,7 +812,7 @@ class Heap {
 
   // GC performance measuring
   void DumpGcPerformanceInfo(std::ostream& os)
-      REQUIRES(!*gc_complete_lock_);
+      REQUIRES(!*gc_complete_lock_, !process_state_update_lock_);
   void ResetGcPerformanceInfo() REQUIRES(!*gc_complete_lock_);
 
   // Thread pool. Create either the given number of threads, or as per the
@@ -930,6 +961,16 @@ class Heap {
   // Reduce the number of bytes to the next sample position by this adjustment.
   void AdjustSampleOffset(size_t adjustment);
 
+  // Returns the size to use for the next TLAB of `self`, starting from `default_size` and scaled by
+  // how many bytes the thread allocated in TLABs between the previous GCs.
+  size_t ComputeAdaptiveTlabSize(Thread* self, size_t default_size);
+
+  // Adaptive TLAB sizing policy: returns the TLAB size that follows `current_size` for a thread
+  // that allocated `bytes_since_resize` bytes in TLABs over the last `gcs_elapsed` GCs.
+  static size_t NextAdaptiveTlabSize(size_t current_size,
+                                     size_t bytes_since_resize,
+                                     uint32_t gcs_elapsed);
+
   // Allocation tracking support
   // Callers to this function use double-checked locking to ensure safety on allocation_records_
   bool IsAllocTrackingEnabled() const {
@@ -1069,6 +1110,10 @@ class Heap {
     return x + y >= x ? x + y : std::numeric_limits<size_t>::max();
   }
 
+  bool UseThreadLocalAllocationStack() const {
+    return kUseThreadLocalAllocationStack && use_thread_local_allocation_stack_;
+  }
+
   static ALWAYS_INLINE bool AllocatorHasAllocationStack(AllocatorType allocator_type) {
     return
         allocator_type != kAllocatorTypeRegionTLAB &&
@@ -1492,6 +1537,10 @@ class Heap {
   size_t min_foreground_target_footprint_ GUARDED_BY(process_state_update_lock_);
   size_t min_foreground_concurrent_start_bytes_ GUARDED_BY(process_state_update_lock_);
 
+  // Optional online adjustment of heap growth towards a GC CPU / pause budget, applied on top of
+  // the static utilization and free-bytes settings in GrowForUtilization().
+  GcSloController gc_slo_controller_ GUARDED_BY(process_state_update_lock_);
+
   // When num_bytes_allocated_ exceeds this amount then a concurrent GC should be requested so that
   // it completes ahead of an allocation failing.
   // A multiple of this is also used to determine when to trigger a GC in response to native
@@ -1594,6 +1643,17 @@ class Heap {
   // Second allocation stack so that we can process allocation with the heap unlocked.
   std::unique_ptr<accounting::ObjectStack> live_stack_;
 
+  // Whether non-TLAB allocations are buffered on thread-local allocation stacks. Off for
+  // concurrent copying, which looks objects up on the allocation stack while mutators run, and
+  // for the small allocation stacks used by heap verification modes, which cannot leave room for
+  // the per-thread buffers.
+  const bool use_thread_local_allocation_stack_;
+
+  // Number of threads which currently have a thread-local allocation stack set up. Each of them
+  // may flush up to kThreadLocalAllocationStackSize objects when revoked in a pause, so threads
+  // flushing a full buffer leave that much room below the allocation stack's growth limit.
+  Atomic<size_t> num_thread_local_allocation_stacks_;
+
   // Allocator type.
   AllocatorType current_allocator_;
   const AllocatorType current_non_moving_allocator_;
@@ -1641,12 +1701,16 @@ class Heap {
   std::vector<collector::GarbageCollector*> garbage_collectors_;
   collector::SemiSpace* semi_space_collector_;
   collector::MarkCompact* mark_compact_;
+  collector::YoungMarkCompact* young_mark_compact_;
   Atomic<collector::ConcurrentCopying*> active_concurrent_copying_collector_;
   collector::ConcurrentCopying* young_concurrent_copying_collector_;
   collector::ConcurrentCopying* concurrent_copying_collector_;
 
   const bool is_running_on_memory_tool_;
   const bool use_tlab_;
+  // If true, the size of a thread's next TLAB follows how much it allocated between the last GCs
+  // instead of being fixed at kDefaultTLABSize / kPartialTlabSize.
+  const bool use_adaptive_tlab_sizing_;
 
   // Pointer to the space which becomes the new main space when we do homogeneous space compaction.
   // Use unique_ptr since the space is only added during the homogeneous compaction phase.
@@ -1693,6 +1757,11 @@ class Heap {
   // for major collections. Set in Heap constructor.
   const bool use_generational_cc_;
 
+  // If true, enable generational collection when using the Concurrent
+  // Mark-Compact (CMC) collector, i.e. use young-generation CMC for minor
+  // collections and (full) CMC for major collections. Set in Heap constructor.
+  const bool use_generational_cmc_;
+
   // True if the currently running collection has made some thread wait.
   bool running_collection_is_blocking_ GUARDED_BY(gc_complete_lock_);
   // The number of blocking GC runs.
@@ -1752,6 +1821,15 @@ class Heap {
   // The number of times we initiated a GC of last resort to try to avoid an OOME.
   Atomic<uint64_t> pre_oome_gc_count_;
 
+  // TLAB refills, and bytes left unused at the tail of retired TLABs, since the last GC.
+  Atomic<uint64_t> tlab_refills_;
+  Atomic<uint64_t> tlab_wasted_bytes_;
+  // Values of the counters above for the last completed GC, and accumulated over all GCs.
+  uint64_t last_gc_tlab_refills_ GUARDED_BY(gc_complete_lock_);
+  uint64_t last_gc_tlab_wasted_bytes_ GUARDED_BY(gc_complete_lock_);
+  uint64_t total_tlab_refills_ GUARDED_BY(gc_complete_lock_);
+  uint64_t total_tlab_wasted_bytes_ GUARDED_BY(gc_complete_lock_);
+
   // An installed allocation listener.
   Atomic<AllocationListener*> alloc_listener_;
   // An installed GC Pause listener.
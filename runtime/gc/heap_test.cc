@@ -106,6 +106,31 @@ TEST_F(HeapTest, DumpGCPerformanceOnShutdown) {
   Runtime::Current()->SetDumpGCPerformanceOnShutdown(true);
 }
 
+TEST_F(HeapTest, NextAdaptiveTlabSize) {
+  const size_t min_size = std::max(Heap::kMinAdaptiveTlabSize, gPageSize);
+  const size_t refills = Heap::kAdaptiveTlabRefillsPerGc;
+  // A steady allocation rate converges to the size giving the target number of refills per GC.
+  const size_t steady_target = 64 * KB;
+  size_t size = 16 * KB;
+  for (int i = 0; i < 20; ++i) {
+    size = Heap::NextAdaptiveTlabSize(size, steady_target * refills, /*gcs_elapsed=*/ 1u);
+    EXPECT_LE(size, steady_target);
+  }
+  EXPECT_GE(size, steady_target - kObjectAlignment * 2);
+  // Each step moves half way towards the target.
+  EXPECT_EQ(24 * KB, Heap::NextAdaptiveTlabSize(16 * KB, 32 * KB * refills, 1u));
+  EXPECT_EQ(24 * KB, Heap::NextAdaptiveTlabSize(32 * KB, 16 * KB * refills, 1u));
+  // The rate is averaged over all the GCs since the last resize, so idle threads shrink.
+  EXPECT_EQ(Heap::NextAdaptiveTlabSize(32 * KB, 64 * KB * refills, 4u),
+            Heap::NextAdaptiveTlabSize(32 * KB, 16 * KB * refills, 1u));
+  EXPECT_EQ(min_size, Heap::NextAdaptiveTlabSize(min_size, 0u, 1u));
+  EXPECT_EQ(min_size, Heap::NextAdaptiveTlabSize(min_size, 0u, 100u));
+  // Sizes stay within bounds.
+  EXPECT_EQ(Heap::kMaxAdaptiveTlabSize,
+            Heap::NextAdaptiveTlabSize(Heap::kMaxAdaptiveTlabSize, 64 * MB * refills, 1u));
+  EXPECT_EQ(min_size, Heap::NextAdaptiveTlabSize(0u, 0u, 1u));
+}
+
 bool AnyIsFalse(bool x, bool y) { return !x || !y; }
 
 TEST_F(HeapTest, GCMetrics) {
@@ -43,6 +43,7 @@ static constexpr bool kAsyncReferenceQueueAdd = false;
 
 ReferenceProcessor::ReferenceProcessor()
     : collector_(nullptr),
+      marked_referent_epoch_(0u),
       condition_("reference processor condition", *Locks::reference_processor_lock_) ,
       soft_reference_queue_(Locks::reference_queue_soft_references_lock_),
       weak_reference_queue_(Locks::reference_queue_weak_references_lock_),
@@ -87,6 +88,43 @@ void ReferenceProcessor::BroadcastForSlowPath(Thread* self) {
   condition_.Broadcast(self);
 }
 
+void ReferenceProcessor::OpenMarkedReferentWindow() {
+  DCHECK_EQ(marked_referent_epoch_.load(std::memory_order_relaxed) & 1u, 0u);
+  // Publishes collector_ to GetMarkedReferentLockFree().
+  marked_referent_epoch_.fetch_add(1u, std::memory_order_release);
+}
+
+void ReferenceProcessor::CloseMarkedReferentWindow() {
+  DCHECK_EQ(marked_referent_epoch_.load(std::memory_order_relaxed) & 1u, 1u);
+  marked_referent_epoch_.fetch_add(1u, std::memory_order_relaxed);
+  // Order the epoch update before any marking we do from here on, in particular marking through
+  // finalizers. Pairs with the acquire fence in GetMarkedReferentLockFree().
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+ObjPtr<mirror::Object> ReferenceProcessor::GetMarkedReferentLockFree(
+    ObjPtr<mirror::Reference> reference) {
+  const uint32_t epoch = marked_referent_epoch_.load(std::memory_order_acquire);
+  if ((epoch & 1u) == 0u) {
+    return nullptr;
+  }
+  // Marking may still be in progress, so an unmarked referent tells us nothing; but anything
+  // marked before soft and weak references are cleared is strongly reachable and stays so.
+  // A read barrier may be unsafe here, and we use the result only when it's marked.
+  ObjPtr<mirror::Object> referent = reference->GetReferent<kWithoutReadBarrier>();
+  if (referent.IsNull()) {
+    return nullptr;
+  }
+  ObjPtr<mirror::Object> forwarded_ref = collector_->IsMarked(referent.Ptr());
+  // If the window closed meanwhile, the referent may have been marked through a finalizer after
+  // its reference was cleared. Let the caller take the lock and decide.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (marked_referent_epoch_.load(std::memory_order_relaxed) != epoch) {
+    return nullptr;
+  }
+  return forwarded_ref;
+}
+
 ObjPtr<mirror::Object> ReferenceProcessor::GetReferent(Thread* self,
                                                        ObjPtr<mirror::Reference> reference) {
   auto slow_path_required = [this, self]() REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -102,6 +140,16 @@ ObjPtr<mirror::Object> ReferenceProcessor::GetReferent(Thread* self,
   if (referent.IsNull()) {
     return referent;
   }
+  const bool other_read_barrier = !kUseBakerReadBarrier && gUseReadBarrier;
+  if (LIKELY(!reference->IsFinalizerReferenceInstance() &&
+             !(other_read_barrier && reference->IsPhantomReferenceInstance()))) {
+    // A referent that is already marked can be returned right away, even while marking is still
+    // in progress. Only unmarked referents need to wait for the outcome of reference processing.
+    ObjPtr<mirror::Object> marked_referent = GetMarkedReferentLockFree(reference);
+    if (marked_referent != nullptr) {
+      return marked_referent;
+    }
+  }
 
   bool started_trace = false;
   uint64_t start_millis;
@@ -118,7 +166,6 @@ ObjPtr<mirror::Object> ReferenceProcessor::GetReferent(Thread* self,
   // Keeping reference_processor_lock_ blocks the broadcast when we try to reenable the fast path.
   while (slow_path_required()) {
     DCHECK(collector_ != nullptr);
-    const bool other_read_barrier = !kUseBakerReadBarrier && gUseReadBarrier;
     if (UNLIKELY(reference->IsFinalizerReferenceInstance()
                  || rp_state_ == RpState::kStarting /* too early to determine mark state */
                  || (other_read_barrier && reference->IsPhantomReferenceInstance()))) {
@@ -195,6 +242,9 @@ void ReferenceProcessor::Setup(Thread* self,
   rp_state_ = RpState::kStarting;
   concurrent_ = concurrent;
   clear_soft_references_ = clear_soft_references;
+  if (concurrent) {
+    OpenMarkedReferentWindow();
+  }
 }
 
 // Process reference class instances and schedule finalizations.
@@ -239,6 +289,9 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
     // marked below, that is no longer guaranteed.
     MutexLock mu(self, *Locks::reference_processor_lock_);
     rp_state_ = RpState::kInitClearingDone;
+    if (concurrent_) {
+      CloseMarkedReferentWindow();
+    }
     // At this point, all mutator-accessible data is marked (black). Objects enqueued for
     // finalization will only be made available to the mutator via CollectClearedReferences after
     // we're fully done marking. Soft and WeakReferences accessible to the mutator have been
@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_GC_REFERENCE_PROCESSOR_H_
 #define ART_RUNTIME_GC_REFERENCE_PROCESSOR_H_
 
+#include "base/atomic.h"
 #include "base/macros.h"
 #include "base/locks.h"
 #include "jni.h"
@@ -94,6 +95,13 @@ class ReferenceProcessor {
 
  private:
   bool SlowPathEnabled() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Return the marked (and possibly forwarded) referent without acquiring
+  // reference_processor_lock_, or null if that cannot be decided without the lock.
+  ObjPtr<mirror::Object> GetMarkedReferentLockFree(ObjPtr<mirror::Reference> reference)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  // Open or close the window in which GetMarkedReferentLockFree() may answer.
+  void OpenMarkedReferentWindow() REQUIRES(Locks::reference_processor_lock_);
+  void CloseMarkedReferentWindow() REQUIRES(Locks::reference_processor_lock_);
   // Called by ProcessReferences.
   void DisableSlowPath(Thread* self) REQUIRES(Locks::reference_processor_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -110,6 +118,12 @@ class ReferenceProcessor {
   // Used by GetReferent and friends to return early.
   enum class RpState : uint8_t { kStarting, kInitMarkingDone, kInitClearingDone };
   RpState rp_state_ GUARDED_BY(Locks::reference_processor_lock_);
+  // Odd while a concurrent reference processing pass is between Setup() and clearing of
+  // soft and weak references, i.e. while a marked referent is known to be strongly reachable
+  // and may be returned without waiting. Incremented on every transition, so that a reader can
+  // detect that the window closed (and finalizer marking may have started) while it was checking
+  // the mark state, seqlock style. Written with reference_processor_lock_ held.
+  Atomic<uint32_t> marked_referent_epoch_;
   bool concurrent_;  // Running concurrently with mutator? Only used by GC thread.
   bool clear_soft_references_;  // Only used by GC thread.
 
@@ -15,6 +15,11 @@
  */
 #include <deque>
 
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include "bump_pointer_space-inl.h"
 #include "bump_pointer_space.h"
 #include "base/dumpable.h"
@@ -94,12 +99,17 @@ MemMap RegionSpace::CreateMemMap(const std::string& name,
   return mem_map;
 }
 
-RegionSpace* RegionSpace::Create(
-    const std::string& name, MemMap&& mem_map, bool use_generational_cc) {
-  return new RegionSpace(name, std::move(mem_map), use_generational_cc);
+RegionSpace* RegionSpace::Create(const std::string& name,
+                                 MemMap&& mem_map,
+                                 bool use_generational_cc,
+                                 bool use_numa_aware_tlab) {
+  return new RegionSpace(name, std::move(mem_map), use_generational_cc, use_numa_aware_tlab);
 }
 
-RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_generational_cc)
+RegionSpace::RegionSpace(const std::string& name,
+                         MemMap&& mem_map,
+                         bool use_generational_cc,
+                         bool use_numa_aware_tlab)
     : ContinuousMemMapAllocSpace(name,
                                  std::move(mem_map),
                                  mem_map.Begin(),
@@ -108,6 +118,7 @@ RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_gen
                                  kGcRetentionPolicyAlwaysCollect),
       region_lock_("Region lock", kRegionSpaceRegionLock),
       use_generational_cc_(use_generational_cc),
+      use_numa_aware_tlab_(use_numa_aware_tlab),
       time_(1U),
       num_regions_(mem_map_.Size() / kRegionSize),
       madvise_time_(0U),
@@ -407,6 +418,7 @@ void RegionSpace::ReleaseFreeRegions() {
 
   for (size_t i = 0u; i < num_regions_; ++i) {
     if (regions_[i].IsFree()) {
+      regions_[i].numa_node_ = kNoNumaNode;
       if (release_block_begin == nullptr) {
         release_block_begin = regions_[i].Begin();
         DCHECK_ALIGNED_PARAM(release_block_begin, gPageSize);
@@ -461,7 +473,12 @@ void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
     // (see b/62194020).
     uint8_t* clear_block_begin = nullptr;
     uint8_t* clear_block_end = nullptr;
-    auto expand_madvise_range = [&madvise_list, &clear_block_begin, &clear_block_end] (Region* r) {
+    auto expand_madvise_range =
+        [&madvise_list, &clear_block_begin, &clear_block_end, release_eagerly](Region* r) {
+      if (release_eagerly) {
+        // The pages are going to be given back to the kernel.
+        r->numa_node_ = kNoNumaNode;
+      }
       if (clear_block_end != r->Begin()) {
         if (clear_block_begin != nullptr) {
           DCHECK(clear_block_end != nullptr);
@@ -644,6 +661,26 @@ void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
   evac_region_ = nullptr;
   num_non_free_regions_ += num_evac_regions_;
   num_evac_regions_ = 0;
+  if (use_numa_aware_tlab_) {
+    // Hand the evacuated regions back to the nodes their pages are on.
+    RebuildNumaFreeRegionLists();
+  }
+}
+
+void RegionSpace::RebuildNumaFreeRegionLists() {
+  for (auto& list : numa_free_regions_) {
+    list.clear();
+  }
+  for (size_t i = 0; i < num_regions_; ++i) {
+    Region* r = &regions_[i];
+    if (r->IsFree() && r->numa_node_ != kNoNumaNode) {
+      size_t node = static_cast<size_t>(r->numa_node_);
+      if (node >= numa_free_regions_.size()) {
+        numa_free_regions_.resize(node + 1);
+      }
+      numa_free_regions_[node].push_back(r);
+    }
+  }
 }
 
 void RegionSpace::CheckLiveBytesAgainstRegionBitmap(Region* r) {
@@ -895,7 +932,8 @@ bool RegionSpace::AllocNewTlab(Thread* self,
   }
   if (r == nullptr) {
     // Fallback to allocating an entire region as TLAB.
-    r = AllocateRegion(/*for_evac=*/ false);
+    r = AllocateRegion(/*for_evac=*/ false,
+                       use_numa_aware_tlab_ ? GetCurrentNumaNode() : kNoNumaNode);
   }
   if (r != nullptr) {
     uint8_t* start = pos != nullptr ? pos : r->Begin();
@@ -1042,6 +1080,7 @@ void RegionSpace::Region::Clear(bool zero_and_release_pages) {
   live_bytes_ = static_cast<size_t>(-1);
   if (zero_and_release_pages) {
     ZeroAndProtectRegion(begin_, end_, /* release_eagerly= */ true);
+    numa_node_ = kNoNumaNode;
   }
   is_newly_allocated_ = false;
   is_a_tlab_ = false;
@@ -1053,11 +1092,44 @@ void RegionSpace::TraceHeapSize() {
   heap->TraceHeapSize(heap->GetBytesAllocated() + EvacBytes());
 }
 
-RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac) {
+int32_t RegionSpace::GetCurrentNumaNode() {
+#if defined(__linux__)
+  unsigned int cpu;
+  unsigned int node;
+  if (syscall(__NR_getcpu, &cpu, &node, nullptr) == 0) {
+    return static_cast<int32_t>(node);
+  }
+#endif
+  return kNoNumaNode;
+}
+
+RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac, int32_t numa_node) {
   if (!for_evac && (num_non_free_regions_ + 1) * 2 > num_regions_) {
     return nullptr;
   }
-  for (size_t i = 0; i < num_regions_; ++i) {
+  Region* found = nullptr;
+  if (numa_node != kNoNumaNode) {
+    // First try a region whose pages are already resident on the given node.
+    if (static_cast<size_t>(numa_node) < numa_free_regions_.size()) {
+      std::vector<Region*>& list = numa_free_regions_[numa_node];
+      while (!list.empty() && found == nullptr) {
+        Region* r = list.back();
+        list.pop_back();
+        if (r->IsFree() && r->numa_node_ == numa_node && r->Idx() < num_regions_) {
+          found = r;
+        }
+      }
+    }
+    // Then a region which will be first-touched by the allocating thread.
+    // Failing that, fall back to any free region below.
+    for (size_t i = 0; found == nullptr && i < num_regions_; ++i) {
+      Region* r = &regions_[i];
+      if (r->IsFree() && r->numa_node_ == kNoNumaNode) {
+        found = r;
+      }
+    }
+  }
+  for (size_t i = 0; found == nullptr && i < num_regions_; ++i) {
     // When using the cyclic region allocation strategy, try to
     // allocate a region starting from the last cyclic allocated
     // region marker. Otherwise, try to allocate a region starting
@@ -1067,28 +1139,36 @@ RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac) {
         : i;
     Region* r = &regions_[region_index];
     if (r->IsFree()) {
-      r->Unfree(this, time_);
-      if (use_generational_cc_) {
-        // TODO: Add an explanation for this assertion.
-        DCHECK_IMPLIES(for_evac, !r->is_newly_allocated_);
-      }
-      if (for_evac) {
-        ++num_evac_regions_;
-        TraceHeapSize();
-        // Evac doesn't count as newly allocated.
-      } else {
-        r->SetNewlyAllocated();
-        ++num_non_free_regions_;
-      }
-      if (kCyclicRegionAllocation) {
-        // Move the cyclic allocation region marker to the region
-        // following the one that was just allocated.
-        cyclic_alloc_region_index_ = (region_index + 1) % num_regions_;
-      }
-      return r;
+      found = r;
     }
   }
-  return nullptr;
+  if (found == nullptr) {
+    return nullptr;
+  }
+  Region* r = found;
+  r->Unfree(this, time_);
+  if (use_generational_cc_) {
+    // TODO: Add an explanation for this assertion.
+    DCHECK_IMPLIES(for_evac, !r->is_newly_allocated_);
+  }
+  if (for_evac) {
+    ++num_evac_regions_;
+    TraceHeapSize();
+    // Evac doesn't count as newly allocated.
+  } else {
+    r->SetNewlyAllocated();
+    ++num_non_free_regions_;
+  }
+  if (use_numa_aware_tlab_ && r->numa_node_ == kNoNumaNode) {
+    // The pages will be first touched by the allocating thread.
+    r->numa_node_ = numa_node != kNoNumaNode ? numa_node : GetCurrentNumaNode();
+  }
+  if (kCyclicRegionAllocation) {
+    // Move the cyclic allocation region marker to the region
+    // following the one that was just allocated.
+    cyclic_alloc_region_index_ = (r->Idx() + 1) % num_regions_;
+  }
+  return r;
 }
 
 void RegionSpace::Region::MarkAsAllocated(RegionSpace* region_space, uint32_t alloc_time) {
@@ -24,6 +24,7 @@
 
 #include <functional>
 #include <map>
+#include <vector>
 
 namespace art HIDDEN {
 namespace gc {
@@ -62,7 +63,10 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // guaranteed to be granted, if it is required, the caller should call Begin on the returned
   // space to confirm the request was granted.
   static MemMap CreateMemMap(const std::string& name, size_t capacity, uint8_t* requested_begin);
-  static RegionSpace* Create(const std::string& name, MemMap&& mem_map, bool use_generational_cc);
+  static RegionSpace* Create(const std::string& name,
+                             MemMap&& mem_map,
+                             bool use_generational_cc,
+                             bool use_numa_aware_tlab);
 
   // Allocate `num_bytes`, returns null if the space is full.
   mirror::Object* Alloc(Thread* self,
@@ -388,7 +392,14 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   void ReleaseFreeRegions();
 
  private:
-  RegionSpace(const std::string& name, MemMap&& mem_map, bool use_generational_cc);
+  // Value of `Region::numa_node_` for regions whose pages are not known to be
+  // resident on any particular NUMA node.
+  static constexpr int32_t kNoNumaNode = -1;
+
+  RegionSpace(const std::string& name,
+              MemMap&& mem_map,
+              bool use_generational_cc,
+              bool use_numa_aware_tlab);
 
   class Region {
    public:
@@ -403,6 +414,7 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
           alloc_time_(0),
           is_newly_allocated_(false),
           is_a_tlab_(false),
+          numa_node_(kNoNumaNode),
           state_(RegionState::kRegionStateAllocated),
           type_(RegionType::kRegionTypeToSpace) {}
 
@@ -418,6 +430,7 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       live_bytes_ = static_cast<size_t>(-1);
       is_newly_allocated_ = false;
       is_a_tlab_ = false;
+      numa_node_ = kNoNumaNode;
       thread_ = nullptr;
       DCHECK_LT(begin, end);
       DCHECK_EQ(static_cast<size_t>(end - begin), kRegionSize);
@@ -639,6 +652,10 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     // special value for `live_bytes_`.
     bool is_newly_allocated_;           // True if it's allocated after the last collection.
     bool is_a_tlab_;                    // True if it's a tlab.
+    // The NUMA node on which the region's pages were first touched, or
+    // kNoNumaNode if they were never touched or have since been released.
+    // Only maintained when NUMA-aware TLABs are enabled.
+    int32_t numa_node_;
     RegionState state_;                 // The region state (see RegionState).
     RegionType type_;                   // The region type (see RegionType).
 
@@ -715,7 +732,17 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     }
   }
 
-  EXPORT Region* AllocateRegion(bool for_evac) REQUIRES(region_lock_);
+  // Allocate a free region. If `numa_node` is not kNoNumaNode, then prefer a
+  // region whose pages are resident on that node, followed by one whose pages
+  // are not resident anywhere.
+  EXPORT Region* AllocateRegion(bool for_evac, int32_t numa_node = kNoNumaNode)
+      REQUIRES(region_lock_);
+  // Return the NUMA node of the CPU the calling thread is running on, or
+  // kNoNumaNode if it cannot be determined.
+  static int32_t GetCurrentNumaNode();
+  // Rebuild `numa_free_regions_` from the free regions which have a known
+  // NUMA node.
+  void RebuildNumaFreeRegionLists() REQUIRES(region_lock_);
   void RevokeThreadLocalBuffersLocked(Thread* thread, bool reuse) REQUIRES(region_lock_);
 
   // Scan region range [`begin`, `end`) in increasing order to try to
@@ -749,6 +776,9 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
 
   // Cached version of Heap::use_generational_cc_.
   const bool use_generational_cc_;
+  // If true, TLAB regions are preferably allocated from the regions whose
+  // pages are resident on the allocating thread's NUMA node.
+  const bool use_numa_aware_tlab_;
   uint32_t time_;                  // The time as the number of collections since the startup.
   size_t num_regions_;             // The number of regions in this space.
   uint64_t madvise_time_;          // The amount of time spent in madvise for purging pages.
@@ -769,6 +799,11 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // To hold partially used TLABs which can be reassigned to threads later for
   // utilizing the un-used portion.
   std::multimap<size_t, Region*, std::greater<size_t>> partial_tlabs_ GUARDED_BY(region_lock_);
+  // Per NUMA node list of free regions whose pages are resident on that node,
+  // rebuilt at the end of every collection. An entry may be stale if the
+  // region has since been allocated by other means, in which case it is
+  // skipped when popped.
+  std::vector<std::vector<Region*>> numa_free_regions_ GUARDED_BY(region_lock_);
   // The upper-bound index of the non-free regions. Used to avoid scanning all regions in
   // RegionSpace::SetFromSpace and RegionSpace::ClearFromSpace.
   //
@@ -40,6 +40,11 @@ ArrayRef<const uint8_t> NterpImpl();
 
 constexpr uint16_t kNterpHotnessValue = 0;
 
+// Hotness value that nterp does not update. While the JIT samples threads, hotness counters start
+// right above it, so that the profile saver can tell which methods were executed, and then stay
+// parked until the sampler sets them to `kNterpHotnessValue`. Warmup thresholds are kept below it.
+constexpr uint16_t kNterpHotnessParkedValue = 0xfffe;
+
 // The maximum we allow an nterp frame to be.
 constexpr size_t kNterpMaxFrame = 3 * KB;
 
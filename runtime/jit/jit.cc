@@ -69,6 +69,15 @@ JitCompilerInterface* Jit::jit_compiler_ = nullptr;
 
 void Jit::DumpInfo(std::ostream& os) {
   code_cache_->Dump(os);
+  if (thread_pool_ != nullptr) {
+    thread_pool_->DumpInfo(os);
+  }
+  if (persistent_cache_ != nullptr) {
+    persistent_cache_->DumpInfo(os);
+  }
+  if (sampler_ != nullptr) {
+    sampler_->DumpInfo(os);
+  }
   cumulative_timings_.Dump(os);
   MutexLock mu(Thread::Current(), lock_);
   memory_use_.PrintMemoryUse(os);
@@ -129,6 +138,11 @@ std::unique_ptr<Jit> Jit::Create(JitCodeCache* code_cache, JitOptions* options)
   // Notify native debugger about the classes already loaded before the creation of the jit.
   jit->DumpTypeInfoForLoadedTypes(Runtime::Current()->GetClassLinker());
 
+  // The zygote's code would be shared by all its children, which cannot write to a common file.
+  if (!options->GetPersistentCachePath().empty() && !Runtime::Current()->IsZygote()) {
+    jit->persistent_cache_ = JitPersistentCache::Create(options->GetPersistentCachePath());
+  }
+
   return jit;
 }
 
@@ -222,6 +236,15 @@ bool Jit::CompileMethodInternal(ArtMethod* method,
     return false;
   }
 
+  // Code from a previous run is already optimized, so use it for baseline requests too.
+  if (persistent_cache_ != nullptr &&
+      compilation_kind != CompilationKind::kOsr &&
+      !GetCodeCache()->IsSharedRegion(*region) &&
+      persistent_cache_->Install(self, code_cache_, region, method_to_compile)) {
+    code_cache_->DoneCompiling(method_to_compile, self);
+    return true;
+  }
+
   VLOG(jit) << "Compiling method "
             << ArtMethod::PrettyMethod(method_to_compile)
             << " kind=" << compilation_kind;
@@ -252,6 +275,8 @@ void Jit::WaitForWorkersToBeCreated() {
 
 void Jit::DeleteThreadPool() {
   Thread* self = Thread::Current();
+  // Stop sampling first, as samples lead to compilation requests.
+  sampler_.reset();
   if (thread_pool_ != nullptr) {
     std::unique_ptr<JitThreadPool> pool;
     {
@@ -291,6 +316,16 @@ void Jit::StopProfileSaver() {
   }
 }
 
+void Jit::StartSampler() {
+  if (options_->GetSamplingIntervalUs() == 0 || !options_->UseJitCompilation()) {
+    return;
+  }
+  DCHECK(sampler_ == nullptr);
+  sampler_ = JitSampler::Create(options_->GetSamplingIntervalUs(),
+                                options_->GetSampleWeight(),
+                                options_->GetSampleThreshold());
+}
+
 bool Jit::JitAtFirstUse() {
   return HotMethodThreshold() == 0;
 }
@@ -299,6 +334,12 @@ bool Jit::CanInvokeCompiledCode(ArtMethod* method) {
   return code_cache_->ContainsPc(method->GetEntryPointFromQuickCompiledCode());
 }
 
+void Jit::SavePersistentCache() {
+  if (persistent_cache_ != nullptr) {
+    persistent_cache_->Save();
+  }
+}
+
 Jit::~Jit() {
   DCHECK_IMPLIES(options_->GetSaveProfilingInfo(), !ProfileSaver::IsStarted());
   if (options_->DumpJitInfoOnShutdown()) {
@@ -306,6 +347,8 @@ Jit::~Jit() {
     Runtime::Current()->DumpDeoptimizations(LOG_STREAM(INFO));
   }
   DeleteThreadPool();
+  // After the workers are gone, so that no compilation is recorded concurrently.
+  SavePersistentCache();
   if (jit_compiler_ != nullptr) {
     delete jit_compiler_;
     jit_compiler_ = nullptr;
@@ -1086,7 +1129,7 @@ void Jit::CreateThreadPool() {
   // There is a DCHECK in the 'AddSamples' method to ensure the tread pool
   // is not null when we instrument.
 
-  thread_pool_.reset(JitThreadPool::Create("Jit thread pool", 1));
+  thread_pool_.reset(JitThreadPool::Create("Jit thread pool", options_->GetThreadPoolSize()));
 
   Runtime* runtime = Runtime::Current();
   thread_pool_->SetPthreadPriority(
@@ -1094,6 +1137,9 @@ void Jit::CreateThreadPool() {
           ? options_->GetZygoteThreadPoolPthreadPriority()
           : options_->GetThreadPoolPthreadPriority());
   Start();
+  if (!runtime->IsZygote()) {
+    StartSampler();
+  }
 
   if (runtime->IsZygote()) {
     // To speed up class lookups, generate a type lookup table for
@@ -1418,6 +1464,13 @@ void Jit::EnqueueOptimizedCompilation(ArtMethod* method, Thread* self) {
   }
 }
 
+void Jit::EnqueueRecompilation(ArtMethod* method, Thread* self) {
+  if (thread_pool_ == nullptr || options_->UseBaselineCompiler()) {
+    return;
+  }
+  AddCompileTask(self, method, CompilationKind::kOptimized);
+}
+
 class ScopedSetRuntimeThread {
  public:
   explicit ScopedSetRuntimeThread(Thread* self)
@@ -1568,6 +1621,8 @@ void Jit::PostForkChildAction(bool is_system_server, bool is_zygote) {
   // We do this here instead of PostZygoteFork, as NativeDebugInfoPostFork only
   // applies to a child.
   NativeDebugInfoPostFork();
+
+  StartSampler();
 }
 
 void Jit::PreZygoteFork() {
@@ -1697,9 +1752,14 @@ void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self) {
 
   if (GetCodeCache()->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
     if (!method->IsNative() && !code_cache_->IsOsrCompiled(method)) {
-      // If we already have compiled code for it, nterp may be stuck in a loop.
-      // Compile OSR.
-      AddCompileTask(self, method, CompilationKind::kOsr);
+      // If we already have compiled code for it, nterp may be stuck in a loop. If that code is
+      // baseline, compile the method with optimizations and OSR entries, so that nterp can jump
+      // into the optimized code. Otherwise compile OSR.
+      if (code_cache_->MaybeRequestOsrEntries(self, method)) {
+        AddCompileTask(self, method, CompilationKind::kOptimized);
+      } else {
+        AddCompileTask(self, method, CompilationKind::kOsr);
+      }
     }
     return;
   }
@@ -1807,27 +1867,31 @@ void JitThreadPool::AddTask(Thread* self, ArtMethod* method, CompilationKind kin
   if (!started_) {
     return;
   }
+  const uint64_t now = NanoTime();
   switch (kind) {
     case CompilationKind::kOsr:
       if (ContainsElement(osr_enqueued_methods_, method)) {
         return;
       }
       osr_enqueued_methods_.insert(method);
-      osr_queue_.push_back(method);
+      osr_queue_.push_back({method, now});
+      osr_stats_.max_depth = std::max(osr_stats_.max_depth, osr_queue_.size());
       break;
     case CompilationKind::kBaseline:
       if (ContainsElement(baseline_enqueued_methods_, method)) {
         return;
       }
       baseline_enqueued_methods_.insert(method);
-      baseline_queue_.push_back(method);
+      baseline_queue_.push_back({method, now});
+      baseline_stats_.max_depth = std::max(baseline_stats_.max_depth, baseline_queue_.size());
       break;
     case CompilationKind::kOptimized:
       if (ContainsElement(optimized_enqueued_methods_, method)) {
         return;
       }
       optimized_enqueued_methods_.insert(method);
-      optimized_queue_.push_back(method);
+      optimized_queue_.push_back({method, now});
+      optimized_stats_.max_depth = std::max(optimized_stats_.max_depth, optimized_queue_.size());
       break;
   }
   // If we have any waiters, signal one.
@@ -1848,21 +1912,55 @@ Task* JitThreadPool::TryGetTaskLocked() {
     return task;
   }
 
-  // OSR requests second, then baseline and finally optimized.
-  Task* task = FetchFrom(osr_queue_, CompilationKind::kOsr);
+  // OSR requests second: a thread is spinning in the interpreter waiting for
+  // them, so they may use any idle worker.
+  Task* task = FetchFrom(osr_queue_, CompilationKind::kOsr, &osr_stats_);
+  if (task != nullptr) {
+    return task;
+  }
+
+  // Then optimized and finally baseline, on as many workers as the backlog justifies.
+  if (current_compilations_.size() >= GetMaxConcurrentCompilations()) {
+    return nullptr;
+  }
+  task = FetchFrom(optimized_queue_, CompilationKind::kOptimized, &optimized_stats_);
   if (task == nullptr) {
-    task = FetchFrom(baseline_queue_, CompilationKind::kBaseline);
-    if (task == nullptr) {
-      task = FetchFrom(optimized_queue_, CompilationKind::kOptimized);
-    }
+    task = FetchFrom(baseline_queue_, CompilationKind::kBaseline, &baseline_stats_);
   }
   return task;
 }
 
-Task* JitThreadPool::FetchFrom(std::deque<ArtMethod*>& methods, CompilationKind kind) {
-  if (!methods.empty()) {
-    ArtMethod* method = methods.front();
-    methods.pop_front();
+size_t JitThreadPool::GetMaxConcurrentCompilations() const {
+  const size_t queued = osr_queue_.size() + baseline_queue_.size() + optimized_queue_.size();
+  return std::min(GetThreadCount(), 1u + queued / kQueuedMethodsPerExtraWorker);
+}
+
+bool JitThreadPool::IsBeingCompiled(ArtMethod* method) const {
+  // There are at most as many entries as workers, a linear search is fine.
+  for (JitCompileTask* task : current_compilations_) {
+    if (task->GetArtMethod() == method) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Task* JitThreadPool::FetchFrom(std::deque<QueuedMethod>& methods,
+                               CompilationKind kind,
+                               QueueStats* stats) {
+  // Take the oldest method which no other worker is compiling. Compiling the
+  // same method concurrently, even for different kinds, would only waste
+  // cycles: one of the results would be dropped or immediately replaced.
+  for (auto it = methods.begin(); it != methods.end(); ++it) {
+    if (IsBeingCompiled(it->method)) {
+      continue;
+    }
+    ArtMethod* method = it->method;
+    const uint64_t wait_ns = NanoTime() - it->enqueue_time_ns;
+    methods.erase(it);
+    ++stats->fetched;
+    stats->total_wait_ns += wait_ns;
+    stats->max_wait_ns = std::max(stats->max_wait_ns, wait_ns);
     JitCompileTask* task = new JitCompileTask(method, JitCompileTask::TaskKind::kCompile, kind);
     current_compilations_.insert(task);
     return task;
@@ -1887,6 +1985,38 @@ void JitThreadPool::Remove(JitCompileTask* task) {
       break;
     }
   }
+  // Another worker may have been waiting for this method to be compiled, or
+  // for a compilation slot to free up.
+  if (waiting_count_ != 0 && HasOutstandingTasks()) {
+    task_queue_condition_.Signal(Thread::Current());
+  }
+}
+
+void JitThreadPool::DumpQueueInfo(std::ostream& os,
+                                  const char* name,
+                                  const std::deque<QueuedMethod>& methods,
+                                  const QueueStats& stats) const {
+  os << name << " queue: depth=" << methods.size()
+     << " max depth=" << stats.max_depth
+     << " compiled=" << stats.fetched;
+  if (stats.fetched != 0) {
+    os << " mean wait=" << PrettyDuration(stats.total_wait_ns / stats.fetched)
+       << " max wait=" << PrettyDuration(stats.max_wait_ns);
+  }
+  if (!methods.empty()) {
+    os << " oldest waiting=" << PrettyDuration(NanoTime() - methods.front().enqueue_time_ns);
+  }
+  os << "\n";
+}
+
+void JitThreadPool::DumpInfo(std::ostream& os) {
+  MutexLock mu(Thread::Current(), task_queue_lock_);
+  os << "JIT thread pool: workers=" << GetThreadCount()
+     << " compiling=" << current_compilations_.size()
+     << " generic tasks=" << generic_queue_.size() << "\n";
+  DumpQueueInfo(os, "JIT OSR", osr_queue_, osr_stats_);
+  DumpQueueInfo(os, "JIT optimized", optimized_queue_, optimized_stats_);
+  DumpQueueInfo(os, "JIT baseline", baseline_queue_, baseline_stats_);
 }
 
 void Jit::VisitRoots(RootVisitor* visitor) {
@@ -1910,9 +2040,15 @@ void JitThreadPool::VisitRoots(RootVisitor* visitor) {
     // - Generic tasks like `ZygoteVerificationTask` which don't hold any root.
     // - `JitCompileTask` for precompiled methods, which we know are live, being
     //   part of the boot classpath or system server classpath.
-    methods.insert(methods.end(), osr_queue_.begin(), osr_queue_.end());
-    methods.insert(methods.end(), baseline_queue_.begin(), baseline_queue_.end());
-    methods.insert(methods.end(), optimized_queue_.begin(), optimized_queue_.end());
+    for (const QueuedMethod& entry : osr_queue_) {
+      methods.push_back(entry.method);
+    }
+    for (const QueuedMethod& entry : baseline_queue_) {
+      methods.push_back(entry.method);
+    }
+    for (const QueuedMethod& entry : optimized_queue_) {
+      methods.push_back(entry.method);
+    }
     for (JitCompileTask* task : current_compilations_) {
       methods.push_back(task->GetArtMethod());
     }
@@ -30,6 +30,8 @@
 #include "offsets.h"
 #include "interpreter/mterp/nterp.h"
 #include "jit/debugger_interface.h"
+#include "jit/jit_persistent_cache.h"
+#include "jit/jit_sampler.h"
 #include "jit_options.h"
 #include "obj_ptr.h"
 #include "thread_pool.h"
@@ -137,6 +139,9 @@ class JitThreadPool : public AbstractThreadPool {
   // Visit the ArtMethods stored in the various queues.
   void VisitRoots(RootVisitor* visitor);
 
+  // Print the queue depths and how long methods waited to be compiled.
+  void DumpInfo(std::ostream& os) REQUIRES(!task_queue_lock_);
+
  protected:
   Task* TryGetTaskLocked() REQUIRES(task_queue_lock_) override;
 
@@ -149,20 +154,57 @@ class JitThreadPool : public AbstractThreadPool {
   }
 
  private:
+  // Number of methods waiting in the compilation queues for each worker beyond
+  // the first one that may compile them. Extra workers only pick up method
+  // compilations when the queues back up, so that a short burst of requests
+  // doesn't steal CPU time from the application on several cores.
+  static constexpr size_t kQueuedMethodsPerExtraWorker = 8;
+
+  // A method waiting in one of the compilation queues.
+  struct QueuedMethod {
+    ArtMethod* method;
+    uint64_t enqueue_time_ns;
+  };
+
+  // Statistics about one of the compilation queues.
+  struct QueueStats {
+    size_t max_depth = 0;
+    size_t fetched = 0;
+    uint64_t total_wait_ns = 0;
+    uint64_t max_wait_ns = 0;
+  };
+
   JitThreadPool(const char* name,
                 size_t num_threads,
                 size_t worker_stack_size)
       // We need peers as we may report the JIT thread, e.g., in the debugger.
       : AbstractThreadPool(name, num_threads, /* create_peers= */ true, worker_stack_size) {}
 
-  // Try to fetch an entry from `methods`. Return null if `methods` is empty.
-  Task* FetchFrom(std::deque<ArtMethod*>& methods, CompilationKind kind) REQUIRES(task_queue_lock_);
+  // Try to fetch an entry from `methods`. Return null if `methods` is empty or
+  // if all the methods in it are currently being compiled by another worker.
+  Task* FetchFrom(std::deque<QueuedMethod>& methods, CompilationKind kind, QueueStats* stats)
+      REQUIRES(task_queue_lock_);
+
+  // Return whether a worker is currently compiling `method`, for any compilation kind.
+  bool IsBeingCompiled(ArtMethod* method) const REQUIRES(task_queue_lock_);
+
+  // How many method compilations may run concurrently given the current queue depths.
+  size_t GetMaxConcurrentCompilations() const REQUIRES(task_queue_lock_);
+
+  void DumpQueueInfo(std::ostream& os,
+                     const char* name,
+                     const std::deque<QueuedMethod>& methods,
+                     const QueueStats& stats) const REQUIRES(task_queue_lock_);
 
   std::deque<Task*> generic_queue_ GUARDED_BY(task_queue_lock_);
 
-  std::deque<ArtMethod*> osr_queue_ GUARDED_BY(task_queue_lock_);
-  std::deque<ArtMethod*> baseline_queue_ GUARDED_BY(task_queue_lock_);
-  std::deque<ArtMethod*> optimized_queue_ GUARDED_BY(task_queue_lock_);
+  std::deque<QueuedMethod> osr_queue_ GUARDED_BY(task_queue_lock_);
+  std::deque<QueuedMethod> baseline_queue_ GUARDED_BY(task_queue_lock_);
+  std::deque<QueuedMethod> optimized_queue_ GUARDED_BY(task_queue_lock_);
+
+  QueueStats osr_stats_ GUARDED_BY(task_queue_lock_);
+  QueueStats baseline_stats_ GUARDED_BY(task_queue_lock_);
+  QueueStats optimized_stats_ GUARDED_BY(task_queue_lock_);
 
   // We track the methods that are currently enqueued to avoid
   // adding them to the queue multiple times, which could bloat the
@@ -207,6 +249,14 @@ class Jit {
     return jit_compiler_;
   }
 
+  // Returns the cache of code kept across runs, or null if not enabled.
+  JitPersistentCache* GetPersistentCache() const {
+    return persistent_cache_.get();
+  }
+
+  // Write newly compiled code to the persistent cache, if enabled.
+  void SavePersistentCache();
+
   void CreateThreadPool();
   void DeleteThreadPool();
   void WaitForWorkersToBeCreated();
@@ -387,6 +437,10 @@ class Jit {
 
   EXPORT void EnqueueOptimizedCompilation(ArtMethod* method, Thread* self);
 
+  // Compile `method` again with optimizations, replacing its current code. Used to move code to
+  // the hot code space, and to re-optimize it with newer profiling data.
+  void EnqueueRecompilation(ArtMethod* method, Thread* self);
+
   EXPORT void MaybeEnqueueCompilation(ArtMethod* method, Thread* self)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -413,6 +467,10 @@ class Jit {
 
   static bool BindCompilerMethods(std::string* error_msg);
 
+  // Start the sampler if `-Xjitsamplinginterval` is set. Only done in processes which JIT
+  // compile, not in the zygote.
+  void StartSampler();
+
   void AddCompileTask(Thread* self,
                       ArtMethod* method,
                       CompilationKind compilation_kind);
@@ -431,6 +489,8 @@ class Jit {
   const JitOptions* const options_;
 
   std::unique_ptr<JitThreadPool> thread_pool_;
+  std::unique_ptr<JitPersistentCache> persistent_cache_;
+  std::unique_ptr<JitSampler> sampler_;
   std::vector<std::unique_ptr<OatDexFile>> type_lookup_tables_;
 
   Mutex boot_completed_lock_;
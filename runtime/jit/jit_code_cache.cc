@@ -16,6 +16,7 @@
 
 #include "jit_code_cache.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include <android-base/logging.h>
@@ -68,6 +69,15 @@ namespace jit {
 static constexpr size_t kCodeSizeLogThreshold = 50 * KB;
 static constexpr size_t kStackMapSizeLogThreshold = 50 * KB;
 
+// Number of collections which must have found the optimized code of a method on a thread stack
+// before the code is moved to the hot code space, and how many methods are moved at most per
+// collection.
+static constexpr uint16_t kMinSamplesForHotCode = 2;
+static constexpr size_t kMaxHotCodeRelocationsPerCollection = 32;
+
+// Maximum number of methods re-optimized per collection because their inline caches changed.
+static constexpr size_t kMaxReoptimizationsPerCollection = 32;
+
 class JitCodeCache::JniStubKey {
  public:
   explicit JniStubKey(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_)
@@ -196,6 +206,13 @@ class JitCodeCache::JniStubData {
   std::vector<ArtMethod*> methods_;
 };
 
+static void MaybeInitializeHotCodeSpace(JitMemoryRegion* region) REQUIRES(Locks::jit_lock_) {
+  size_t capacity = Runtime::Current()->GetJITOptions()->GetHotCodeCapacity();
+  if (capacity != 0u && region->HasCodeMapping() && !region->InitializeHotCodeSpace(capacity)) {
+    LOG(WARNING) << "Could not create a JIT hot code space of " << PrettySize(capacity);
+  }
+}
+
 JitCodeCache* JitCodeCache::Create(bool used_only_for_profile_data,
                                    bool rwx_memory_allowed,
                                    bool is_zygote,
@@ -246,6 +263,7 @@ JitCodeCache* JitCodeCache::Create(bool used_only_for_profile_data,
     jit_code_cache->garbage_collect_code_ = false;
     jit_code_cache->shared_region_ = std::move(region);
   } else {
+    MaybeInitializeHotCodeSpace(&region);
     jit_code_cache->private_region_ = std::move(region);
   }
 
@@ -268,6 +286,10 @@ JitCodeCache::JitCodeCache()
       number_of_baseline_compilations_(0),
       number_of_optimized_compilations_(0),
       number_of_osr_compilations_(0),
+      number_of_reoptimizations_(0),
+      number_of_osr_entry_points_(0),
+      number_of_inline_cache_reoptimizations_(0),
+      number_of_disabled_speculations_(0),
       number_of_collections_(0),
       histogram_stack_map_memory_use_("Memory used for stack maps", 16),
       histogram_code_memory_use_("Memory used for compiled code", 16),
@@ -305,12 +327,11 @@ bool JitCodeCache::ContainsMethod(ArtMethod* method) {
       return true;
     }
   } else {
-    for (const auto& it : method_code_map_) {
-      if (it.second == method) {
-        return true;
-      }
-    }
-    if (zygote_map_.ContainsMethod(method)) {
+    bool found = false;
+    method_code_index_.VisitEntries([&](const JitCodeIndex::Entry& entry) {
+      found = found || entry.method == method;
+    });
+    if (found || zygote_map_.ContainsMethod(method)) {
       return true;
     }
   }
@@ -407,9 +428,10 @@ void JitCodeCache::SweepRootTables(IsMarkedVisitor* visitor) {
   ScopedDebugDisallowReadBarriers sddrb(self);
   {
     ReaderMutexLock mu(self, *Locks::jit_mutator_lock_);
-    for (const auto& entry : method_code_map_) {
+    method_code_index_.VisitEntries(
+        [&](const JitCodeIndex::Entry& entry) NO_THREAD_SAFETY_ANALYSIS {
       uint32_t number_of_roots = 0;
-      const uint8_t* root_table = GetRootTable(entry.first, &number_of_roots);
+      const uint8_t* root_table = GetRootTable(entry.code_ptr, &number_of_roots);
       uint8_t* roots_data = private_region_.IsInDataSpace(root_table)
           ? private_region_.GetWritableDataAddress(root_table)
           : shared_region_.GetWritableDataAddress(root_table);
@@ -460,7 +482,7 @@ void JitCodeCache::SweepRootTables(IsMarkedVisitor* visitor) {
           }
         }
       }
-    }
+    });
   }
   MutexLock mu(self, *Locks::jit_lock_);
   // Walk over inline caches to clear entries containing unloaded classes.
@@ -507,6 +529,13 @@ void JitCodeCache::FreeAllMethodHeaders(
         ->RemoveDependentsWithMethodHeaders(method_headers);
   }
 
+  // The code has been removed from method_code_index_, but a concurrent lock-free lookup may
+  // still be reading its header.
+  {
+    WriterMutexLock mu2(Thread::Current(), *Locks::jit_mutator_lock_);
+    method_code_index_.WaitForReaders();
+  }
+
   {
     ScopedCodeCacheWrite scc(private_region_);
     for (const OatQuickMethodHeader* method_header : method_headers) {
@@ -575,14 +604,21 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
         ++it;
       }
     }
-    for (auto it = method_code_map_.begin(); it != method_code_map_.end();) {
-      if (alloc.ContainsUnsafe(it->second)) {
-        method_headers.insert(OatQuickMethodHeader::FromCodePointer(it->first));
-        VLOG(jit) << "JIT removed " << it->second->PrettyMethod() << ": " << it->first;
-        zombie_code_.erase(it->first);
-        processed_zombie_code_.erase(it->first);
-        method_code_map_reversed_.erase(it->second);
-        it = method_code_map_.erase(it);
+    method_code_index_.RemoveIf(
+        [&](const JitCodeIndex::Entry& entry) NO_THREAD_SAFETY_ANALYSIS {
+      if (!alloc.ContainsUnsafe(entry.method)) {
+        return false;
+      }
+      method_headers.insert(OatQuickMethodHeader::FromCodePointer(entry.code_ptr));
+      VLOG(jit) << "JIT removed " << entry.method->PrettyMethod() << ": " << entry.code_ptr;
+      zombie_code_.erase(entry.code_ptr);
+      processed_zombie_code_.erase(entry.code_ptr);
+      method_code_map_reversed_.erase(entry.method);
+      return true;
+    });
+    for (auto it = methods_to_relocate_.begin(); it != methods_to_relocate_.end();) {
+      if (alloc.ContainsUnsafe(*it)) {
+        it = methods_to_relocate_.erase(it);
       } else {
         ++it;
       }
@@ -726,9 +762,22 @@ bool JitCodeCache::Commit(Thread* self,
       case CompilationKind::kBaseline:
         number_of_baseline_compilations_++;
         break;
-      case CompilationKind::kOptimized:
+      case CompilationKind::kOptimized: {
         number_of_optimized_compilations_++;
+        ScopedDebugDisallowReadBarriers sddrb(self);
+        auto it = profiling_infos_.find(method);
+        if (it != profiling_infos_.end()) {
+          ProfilingInfo* info = it->second;
+          if (info->GetOptimizedCompilationCount() != 0u) {
+            number_of_reoptimizations_++;
+          }
+          info->AddOptimizedCompilation(info->CountInlineCacheEntries());
+        }
+        if (CodeInfo::HasOsrEntries(method_header->GetOptimizedCodeInfoPtr())) {
+          number_of_osr_entry_points_++;
+        }
         break;
+      }
     }
 
     // We need to update the debug info before the entry point gets set.
@@ -788,7 +837,7 @@ bool JitCodeCache::Commit(Thread* self,
       } else {
         ScopedDebugDisallowReadBarriers sddrb(self);
         WriterMutexLock mu2(self, *Locks::jit_mutator_lock_);
-        method_code_map_.Put(code_ptr, method);
+        method_code_index_.Put(code_ptr, method);
 
         // Searching for MethodType-s in roots. They need to be treated as strongly reachable while
         // the corresponding ArtMethod is not removed.
@@ -897,16 +946,22 @@ bool JitCodeCache::RemoveMethodLocked(ArtMethod* method, bool release_memory) {
       }
     }
   } else {
-    for (auto it = method_code_map_.begin(); it != method_code_map_.end();) {
-      if (it->second == method) {
-        in_cache = true;
-        if (release_memory) {
-          FreeCodeAndData(it->first);
-        }
-        VLOG(jit) << "JIT removed " << it->second->PrettyMethod() << ": " << it->first;
-        it = method_code_map_.erase(it);
-      } else {
-        ++it;
+    std::vector<const void*> removed_code;
+    method_code_index_.RemoveIf(
+        [&](const JitCodeIndex::Entry& entry) NO_THREAD_SAFETY_ANALYSIS {
+      if (entry.method != method) {
+        return false;
+      }
+      VLOG(jit) << "JIT removed " << entry.method->PrettyMethod() << ": " << entry.code_ptr;
+      removed_code.push_back(entry.code_ptr);
+      return true;
+    });
+    in_cache = !removed_code.empty();
+    if (release_memory && in_cache) {
+      // Concurrent lock-free lookups may still be reading the headers.
+      method_code_index_.WaitForReaders();
+      for (const void* code_ptr : removed_code) {
+        FreeCodeAndData(code_ptr);
       }
     }
     method_code_map_reversed_.erase(method);
@@ -949,12 +1004,8 @@ void JitCodeCache::MoveObsoleteMethod(ArtMethod* old_method, ArtMethod* new_meth
     return;
   }
 
-  // Update method_code_map_ to point to the new method.
-  for (auto& it : method_code_map_) {
-    if (it.second == old_method) {
-      it.second = new_method;
-    }
-  }
+  // Update method_code_index_ to point to the new method.
+  method_code_index_.ReplaceMethod(old_method, new_method);
   // Update osr_code_map_ to point to the new method.
   auto code_map = osr_code_map_.find(old_method);
   if (code_map != osr_code_map_.end()) {
@@ -978,11 +1029,12 @@ void JitCodeCache::TransitionToDebuggable() {
   if (kIsDebugBuild) {
     // TODO: Check `jni_stubs_map_`?
     ReaderMutexLock mu2(self, *Locks::jit_mutator_lock_);
-    for (const auto& entry : method_code_map_) {
-      ArtMethod* method = entry.second;
+    method_code_index_.VisitEntries(
+        [&](const JitCodeIndex::Entry& entry) NO_THREAD_SAFETY_ANALYSIS {
+      ArtMethod* method = entry.method;
       DCHECK(!method->IsPreCompiled());
       DCHECK(!IsInZygoteExecSpace(method->GetEntryPointFromQuickCompiledCode()));
-    }
+    });
   }
   {
     WriterMutexLock mu(self, *Locks::jit_mutator_lock_);
@@ -1026,13 +1078,16 @@ bool JitCodeCache::Reserve(Thread* self,
 
   const uint8_t* code;
   const uint8_t* data;
+  bool hot = false;
   while (true) {
     bool at_max_capacity = false;
     {
       ScopedThreadSuspension sts(self, ThreadState::kSuspended);
       MutexLock mu(self, *Locks::jit_lock_);
       ScopedCodeCacheWrite ccw(*region);
-      code = region->AllocateCode(code_size);
+      // Methods picked by RelocateHotCode() are recompiled into the hot code space.
+      hot = (methods_to_relocate_.erase(method) != 0u) || hot;
+      code = region->AllocateCode(code_size, hot);
       data = region->AllocateData(data_size);
       at_max_capacity = IsAtMaxCapacity();
     }
@@ -1169,10 +1224,9 @@ void JitCodeCache::RemoveUnmarkedCode(Thread* self) {
       method_headers.insert(header);
       {
         WriterMutexLock mu2(self, *Locks::jit_mutator_lock_);
-        auto method_it = method_code_map_.find(header->GetCode());
+        ArtMethod* method = method_code_index_.Find(header->GetCode());
 
-        if (method_it != method_code_map_.end()) {
-          ArtMethod* method = method_it->second;
+        if (method != nullptr) {
           auto code_ptrs_it = method_code_map_reversed_.find(method);
 
           if (code_ptrs_it != method_code_map_reversed_.end()) {
@@ -1185,7 +1239,7 @@ void JitCodeCache::RemoveUnmarkedCode(Thread* self) {
           }
         }
 
-        method_code_map_.erase(header->GetCode());
+        method_code_index_.Remove(header->GetCode());
       }
       VLOG(jit) << "JIT removed " << *it;
       it = processed_zombie_code_.erase(it);
@@ -1299,7 +1353,7 @@ ProfilingInfo* JitCodeCache::GetProfilingInfo(ArtMethod* method, Thread* self) {
   return it->second;
 }
 
-void JitCodeCache::MaybeUpdateInlineCache(ArtMethod* method,
+bool JitCodeCache::MaybeUpdateInlineCache(ArtMethod* method,
                                           uint32_t dex_pc,
                                           ObjPtr<mirror::Class> cls,
                                           Thread* self) {
@@ -1307,11 +1361,30 @@ void JitCodeCache::MaybeUpdateInlineCache(ArtMethod* method,
   MutexLock mu(self, *Locks::jit_lock_);
   auto it = profiling_infos_.find(method);
   if (it == profiling_infos_.end()) {
-    return;
+    return false;
   }
   ProfilingInfo* info = it->second;
   ScopedAssertNoThreadSuspension sants("ProfilingInfo");
   info->AddInvokeInfo(dex_pc, cls.Ptr());
+  if (info->AddInlineCacheDeoptimization(dex_pc)) {
+    number_of_disabled_speculations_++;
+    return true;
+  }
+  return false;
+}
+
+bool JitCodeCache::NotifyBCEDeoptimization(ArtMethod* method, Thread* self) {
+  ScopedDebugDisallowReadBarriers sddrb(self);
+  MutexLock mu(self, *Locks::jit_lock_);
+  auto it = profiling_infos_.find(method);
+  if (it == profiling_infos_.end()) {
+    return false;
+  }
+  if (it->second->AddBCEDeoptimization()) {
+    number_of_disabled_speculations_++;
+    return true;
+  }
+  return false;
 }
 
 void JitCodeCache::DoCollection(Thread* self) {
@@ -1327,11 +1400,15 @@ void JitCodeCache::DoCollection(Thread* self) {
     }
     collection_in_progress_ = true;
     number_of_collections_++;
+    // The hot code space is at the top of the code pages and may grow during the collection, so
+    // cover all of the code pages when there is one.
+    const uint8_t* code_end = private_region_.HasHotCodeSpace()
+        ? private_region_.GetExecPages()->End()
+        : private_region_.GetExecPages()->Begin() + private_region_.GetCurrentCapacity() / 2;
     live_bitmap_.reset(CodeCacheBitmap::Create(
           "code-cache-bitmap",
           reinterpret_cast<uintptr_t>(private_region_.GetExecPages()->Begin()),
-          reinterpret_cast<uintptr_t>(
-              private_region_.GetExecPages()->Begin() + private_region_.GetCurrentCapacity() / 2)));
+          reinterpret_cast<uintptr_t>(code_end)));
     {
       WriterMutexLock mu2(self, *Locks::jit_mutator_lock_);
       processed_zombie_code_.insert(zombie_code_.begin(), zombie_code_.end());
@@ -1357,6 +1434,12 @@ void JitCodeCache::DoCollection(Thread* self) {
 
       // Remove zombie code which hasn't been marked.
       RemoveUnmarkedCode(self);
+
+      // Recompile the hottest methods into the hot code space.
+      RelocateHotCode(self);
+
+      // Recompile the methods whose inline caches changed since they were optimized.
+      ReoptimizeForInlineCacheChanges(self);
     }
 
     gc_task_scheduled_ = false;
@@ -1369,6 +1452,112 @@ void JitCodeCache::DoCollection(Thread* self) {
   Runtime::Current()->GetJit()->AddTimingLogger(logger);
 }
 
+void JitCodeCache::RelocateHotCode(Thread* self) {
+  if (!private_region_.HasHotCodeSpace()) {
+    return;
+  }
+  ScopedTrace trace(__FUNCTION__);
+  std::vector<std::pair<uint16_t, ArtMethod*>> candidates;
+  {
+    ScopedDebugDisallowReadBarriers sddrb(self);
+    MutexLock mu(self, *Locks::jit_lock_);
+    method_code_index_.VisitEntries(
+        [&](const JitCodeIndex::Entry& entry) NO_THREAD_SAFETY_ANALYSIS {
+      const void* code_ptr = entry.code_ptr;
+      ArtMethod* method = entry.method;
+      if (!private_region_.IsInExecSpace(code_ptr)) {
+        return;
+      }
+      // Only consider the optimized code that the method currently runs. Baseline code is about to
+      // be replaced, and OSR code is discarded at every collection.
+      if (!IsCurrentOptimizedCode(method, OatQuickMethodHeader::FromCodePointer(code_ptr))) {
+        return;
+      }
+      auto it = profiling_infos_.find(method);
+      if (it == profiling_infos_.end()) {
+        return;
+      }
+      // Code found on a thread stack by this collection counts as one sample.
+      ProfilingInfo* info = it->second;
+      if (GetLiveBitmap()->Test(FromCodeToAllocation(code_ptr))) {
+        info->AddSample();
+      }
+      if (!private_region_.IsInHotCodeSpace(code_ptr) &&
+          info->GetSampleCount() >= kMinSamplesForHotCode) {
+        candidates.emplace_back(info->GetSampleCount(), method);
+      }
+    });
+    SortHotCodeCandidates(&candidates, kMaxHotCodeRelocationsPerCollection);
+    for (const auto& candidate : candidates) {
+      methods_to_relocate_.insert(candidate.second);
+    }
+  }
+  if (!candidates.empty()) {
+    VLOG(jit) << "Relocating the code of " << candidates.size() << " hot methods";
+  }
+  // Enqueue the hottest methods first, so that their new code is allocated first and packed
+  // together at the start of the hot code space.
+  Jit* jit = Runtime::Current()->GetJit();
+  for (const auto& candidate : candidates) {
+    jit->EnqueueRecompilation(candidate.second, self);
+  }
+}
+
+void JitCodeCache::SortHotCodeCandidates(
+    /*inout*/ std::vector<std::pair<uint16_t, ArtMethod*>>* candidates, size_t max_candidates) {
+  // The stable sort keeps methods with the same sample count in code address order.
+  std::stable_sort(candidates->begin(),
+                   candidates->end(),
+                   [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+  if (candidates->size() > max_candidates) {
+    candidates->resize(max_candidates);
+  }
+}
+
+bool JitCodeCache::IsCurrentOptimizedCode(ArtMethod* method,
+                                          const OatQuickMethodHeader* method_header) {
+  return method_header->IsOptimized() &&
+         !CodeInfo::IsBaseline(method_header->GetOptimizedCodeInfoPtr()) &&
+         method->GetEntryPointFromQuickCompiledCode() == method_header->GetEntryPoint();
+}
+
+void JitCodeCache::ReoptimizeForInlineCacheChanges(Thread* self) {
+  ScopedTrace trace(__FUNCTION__);
+  std::vector<ArtMethod*> methods;
+  {
+    ScopedDebugDisallowReadBarriers sddrb(self);
+    MutexLock mu(self, *Locks::jit_lock_);
+    method_code_index_.VisitEntries(
+        [&](const JitCodeIndex::Entry& entry) NO_THREAD_SAFETY_ANALYSIS {
+      if (methods.size() == kMaxReoptimizationsPerCollection ||
+          !IsCurrentOptimizedCode(entry.method,
+                                  OatQuickMethodHeader::FromCodePointer(entry.code_ptr))) {
+        return;
+      }
+      auto it = profiling_infos_.find(entry.method);
+      if (it == profiling_infos_.end()) {
+        return;
+      }
+      // Receiver types seen after the method was optimized may allow more inlining. Note that
+      // optimized code does not update inline caches; new entries come from baseline code still
+      // running on a thread stack, or from deoptimizations.
+      ProfilingInfo* info = it->second;
+      size_t inline_cache_entries = info->CountInlineCacheEntries();
+      if (inline_cache_entries > info->GetOptimizedInlineCacheEntries()) {
+        // Do not ask again until the method has been compiled.
+        info->SetOptimizedInlineCacheEntries(inline_cache_entries);
+        methods.push_back(entry.method);
+      }
+    });
+    number_of_inline_cache_reoptimizations_ += methods.size();
+  }
+  Jit* jit = Runtime::Current()->GetJit();
+  for (ArtMethod* method : methods) {
+    VLOG(jit) << "Re-optimizing " << method->PrettyMethod() << " for new inline cache entries";
+    jit->EnqueueRecompilation(method, self);
+  }
+}
+
 OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod* method) {
   static_assert(kRuntimeISA != InstructionSet::kThumb2, "kThumb2 cannot be a runtime ISA");
   const void* pc_ptr = reinterpret_cast<const void*>(pc);
@@ -1411,18 +1600,16 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
       }
     }
     {
-      ReaderMutexLock mu(self, *Locks::jit_mutator_lock_);
-      auto it = method_code_map_.lower_bound(pc_ptr);
-      if ((it == method_code_map_.end() || it->first != pc_ptr) &&
-          it != method_code_map_.begin()) {
-        --it;
-      }
-      if (it != method_code_map_.end()) {
-        const void* code_ptr = it->first;
-        if (OatQuickMethodHeader::FromCodePointer(code_ptr)->Contains(pc)) {
-          method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
-          found_method = it->second;
-        }
+      // Lock-free: this is on the path of every stack walk through JIT code. The entry found
+      // may be for code being freed, so its header is checked while the lookup still holds off
+      // the free, see FreeAllMethodHeaders() and RemoveMethodLocked().
+      JitCodeIndex::Entry entry = method_code_index_.Lookup(
+          pc_ptr, [pc](const JitCodeIndex::Entry& candidate) {
+            return OatQuickMethodHeader::FromCodePointer(candidate.code_ptr)->Contains(pc);
+          });
+      if (entry.code_ptr != nullptr) {
+        method_header = OatQuickMethodHeader::FromCodePointer(entry.code_ptr);
+        found_method = entry.method;
       }
     }
     if (method_header == nullptr && method == nullptr) {
@@ -1456,10 +1643,43 @@ OatQuickMethodHeader* JitCodeCache::LookupOsrMethodHeader(ArtMethod* method) {
   ScopedDebugDisallowReadBarriers sddrb(self);
   ReaderMutexLock mu(self, *Locks::jit_mutator_lock_);
   auto it = osr_code_map_.find(method);
-  if (it == osr_code_map_.end()) {
+  if (it != osr_code_map_.end()) {
+    return OatQuickMethodHeader::FromCodePointer(it->second);
+  }
+  // Optimized code compiled with OSR entries serves as OSR code too, see
+  // `ProfilingInfo::HasHotLoops`.
+  const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+  if (!PrivateRegionContainsPc(entry_point)) {
+    return nullptr;
+  }
+  OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromEntryPoint(entry_point);
+  if (!method_header->IsOptimized() ||
+      !CodeInfo::HasOsrEntries(method_header->GetOptimizedCodeInfoPtr())) {
     return nullptr;
   }
-  return OatQuickMethodHeader::FromCodePointer(it->second);
+  return method_header;
+}
+
+bool JitCodeCache::MaybeRequestOsrEntries(Thread* self, ArtMethod* method) {
+  ScopedDebugDisallowReadBarriers sddrb(self);
+  MutexLock mu(self, *Locks::jit_lock_);
+  const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+  if (!PrivateRegionContainsPc(entry_point)) {
+    return false;
+  }
+  OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromEntryPoint(entry_point);
+  if (!method_header->IsOptimized() ||
+      !CodeInfo::IsBaseline(method_header->GetOptimizedCodeInfoPtr())) {
+    return false;
+  }
+  auto it = profiling_infos_.find(method);
+  if (it == profiling_infos_.end() ||
+      it->second->HasExceededCompileBudget() ||
+      it->second->HasFailedOsrEntries()) {
+    return false;
+  }
+  it->second->SetHasHotLoops();
+  return true;
 }
 
 ProfilingInfo* JitCodeCache::AddProfilingInfo(Thread* self,
@@ -1540,9 +1760,9 @@ void JitCodeCache::GetProfiledMethods(const std::set<std::string>& dex_base_loca
     MutexLock mu(self, *Locks::jit_lock_);
     profiling_infos = profiling_infos_;
     ReaderMutexLock mu2(self, *Locks::jit_mutator_lock_);
-    for (const auto& entry : method_code_map_) {
-      copies.push_back(entry.second);
-    }
+    method_code_index_.VisitEntries([&](const JitCodeIndex::Entry& entry) {
+      copies.push_back(entry.method);
+    });
   }
   for (ArtMethod* method : copies) {
     auto it = profiling_infos.find(method);
@@ -1632,10 +1852,7 @@ void JitCodeCache::GetProfiledMethods(const std::set<std::string>& dex_base_loca
 }
 
 bool JitCodeCache::IsOsrCompiled(ArtMethod* method) {
-  Thread* self = Thread::Current();
-  ScopedDebugDisallowReadBarriers sddrb(self);
-  ReaderMutexLock mu(self, *Locks::jit_mutator_lock_);
-  return osr_code_map_.find(method) != osr_code_map_.end();
+  return LookupOsrMethodHeader(method) != nullptr;
 }
 
 bool JitCodeCache::NotifyCompilationOf(ArtMethod* method,
@@ -1707,6 +1924,14 @@ bool JitCodeCache::NotifyCompilationOf(ArtMethod* method,
   } else {
     if (compilation_kind == CompilationKind::kBaseline) {
       DCHECK(CanAllocateProfilingInfo());
+    } else {
+      ProfilingInfo* info = GetProfilingInfo(method, self);
+      if (info != nullptr && info->HasExceededCompileBudget()) {
+        VLOG(jit) << "Not compiling "
+                  << method->PrettyMethod()
+                  << " because it went over the compilation budget before";
+        return false;
+      }
     }
   }
   return true;
@@ -1775,14 +2000,15 @@ void JitCodeCache::InvalidateAllCompiledCode() {
       }
     }
 
-    for (const auto& entry : method_code_map_) {
-      ArtMethod* meth = entry.second;
+    method_code_index_.VisitEntries(
+        [&](const JitCodeIndex::Entry& entry) NO_THREAD_SAFETY_ANALYSIS {
+      ArtMethod* meth = entry.method;
       if (UNLIKELY(meth->IsObsolete())) {
         linker->SetEntryPointsForObsoleteMethod(meth);
       } else {
         instr->InitializeMethodsCode(meth, /*aot_code=*/ nullptr);
       }
-    }
+    });
     osr_code_map_.clear();
     saved_compiled_methods_map_.clear();
   }
@@ -1846,11 +2072,18 @@ void JitCodeCache::Dump(std::ostream& os) {
   os << "Current JIT mini-debug-info size: " << PrettySize(GetJitMiniDebugInfoMemUsage()) << "\n"
      << "Current JIT capacity: " << PrettySize(GetCurrentRegion()->GetCurrentCapacity()) << "\n"
      << "Current number of JIT JNI stub entries: " << jni_stubs_map_.size() << "\n"
-     << "Current number of JIT code cache entries: " << method_code_map_.size() << "\n"
+     << "Current number of JIT code cache entries: " << method_code_index_.Size() << "\n"
      << "Total number of JIT baseline compilations: " << number_of_baseline_compilations_ << "\n"
      << "Total number of JIT optimized compilations: " << number_of_optimized_compilations_ << "\n"
      << "Total number of JIT compilations for on stack replacement: "
         << number_of_osr_compilations_ << "\n"
+     << "Total number of JIT re-optimizations: " << number_of_reoptimizations_ << "\n"
+     << "Total number of JIT optimized compilations with OSR entries: "
+        << number_of_osr_entry_points_ << "\n"
+     << "Total number of JIT re-optimizations for inline cache changes: "
+        << number_of_inline_cache_reoptimizations_ << "\n"
+     << "Total number of JIT speculations disabled after deoptimizations: "
+        << number_of_disabled_speculations_ << "\n"
      << "Total number of JIT code cache collections: " << number_of_collections_ << std::endl;
   histogram_stack_map_memory_use_.PrintMemoryUse(os);
   histogram_code_memory_use_.PrintMemoryUse(os);
@@ -1859,11 +2092,13 @@ void JitCodeCache::Dump(std::ostream& os) {
 
 void JitCodeCache::DumpAllCompiledMethods(std::ostream& os) {
   ReaderMutexLock mu(Thread::Current(), *Locks::jit_mutator_lock_);
-  for (const auto& [code_ptr, meth] : method_code_map_) {  // Includes OSR methods.
-    OatQuickMethodHeader* header = OatQuickMethodHeader::FromCodePointer(code_ptr);
-    os << meth->PrettyMethod() << "@"  << std::hex
-       << code_ptr << "-" << reinterpret_cast<uintptr_t>(code_ptr) + header->GetCodeSize() << '\n';
-  }
+  // Includes OSR methods.
+  method_code_index_.VisitEntries(
+      [&](const JitCodeIndex::Entry& entry) NO_THREAD_SAFETY_ANALYSIS {
+    OatQuickMethodHeader* header = OatQuickMethodHeader::FromCodePointer(entry.code_ptr);
+    os << entry.method->PrettyMethod() << "@"  << std::hex << entry.code_ptr << "-"
+       << reinterpret_cast<uintptr_t>(entry.code_ptr) + header->GetCodeSize() << '\n';
+  });
   os << "JNIStubs: \n";
   for (const auto& [_, data] : jni_stubs_map_) {
     const void* code_ptr = data.GetCode();
@@ -1909,6 +2144,10 @@ void JitCodeCache::PostForkChildAction(bool is_system_server, bool is_zygote) {
   number_of_baseline_compilations_ = 0;
   number_of_optimized_compilations_ = 0;
   number_of_osr_compilations_ = 0;
+  number_of_reoptimizations_ = 0;
+  number_of_osr_entry_points_ = 0;
+  number_of_inline_cache_reoptimizations_ = 0;
+  number_of_disabled_speculations_ = 0;
   number_of_collections_ = 0;
   histogram_stack_map_memory_use_.Reset();
   histogram_code_memory_use_.Reset();
@@ -1928,6 +2167,7 @@ void JitCodeCache::PostForkChildAction(bool is_system_server, bool is_zygote) {
     const MemMap* exec_pages = private_region_.GetExecPages();
     runtime->AddGeneratedCodeRange(exec_pages->Begin(), exec_pages->Size());
   }
+  MaybeInitializeHotCodeSpace(&private_region_);
 }
 
 JitMemoryRegion* JitCodeCache::GetCurrentRegion() {
@@ -1943,9 +2183,10 @@ void JitCodeCache::VisitAllMethods(const std::function<void(const void*, ArtMeth
       }
     }
   }
-  for (const auto& it : method_code_map_) {  // Includes OSR methods.
-    cb(it.first, it.second);
-  }
+  // Includes OSR methods.
+  method_code_index_.VisitEntries([&](const JitCodeIndex::Entry& entry) {
+    cb(entry.code_ptr, entry.method);
+  });
   for (const auto& it : saved_compiled_methods_map_) {
     cb(it.second, it.first);
   }
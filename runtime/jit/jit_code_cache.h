@@ -35,6 +35,7 @@
 #include "base/mutex.h"
 #include "base/safe_map.h"
 #include "compilation_kind.h"
+#include "jit_code_index.h"
 #include "jit_memory_region.h"
 #include "profiling_info.h"
 
@@ -103,7 +104,7 @@ enum class ZygoteCompilationState : uint8_t {
 // ArtMethod are compiled by the zygote, and the map acts as a communication
 // channel between the zygote and the other processes.
 // For the zygote process, this map is the only map it is placing the compiled
-// code. JitCodeCache.method_code_map_ is empty.
+// code. JitCodeCache.method_code_index_ is empty.
 //
 // This map is writable only by the zygote, and readable by all children.
 class ZygoteMap {
@@ -299,6 +300,8 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Return the code the interpreter can jump to at loop headers of `method`. This is either OSR
+  // code or, if it was compiled with OSR entries, the optimized code of the method.
   EXPORT OatQuickMethodHeader* LookupOsrMethodHeader(ArtMethod* method)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -355,7 +358,16 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  bool IsOsrCompiled(ArtMethod* method) REQUIRES(!Locks::jit_lock_);
+  bool IsOsrCompiled(ArtMethod* method)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Called when the loops of `method` keep it in the interpreter. If the method runs baseline
+  // code, request OSR entries in its optimized compilation and return true. Otherwise the caller
+  // needs to compile separate OSR code.
+  bool MaybeRequestOsrEntries(Thread* self, ArtMethod* method)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Visit GC roots (except j.l.Class and j.l.String) held by JIT-ed code.
   template<typename RootVisitorType>
@@ -420,12 +432,19 @@ class JitCodeCache {
   }
 
   ProfilingInfo* GetProfilingInfo(ArtMethod* method, Thread* self);
-  void MaybeUpdateInlineCache(ArtMethod* method,
+  // Called when optimized code of `method` deoptimized at the invoke at `dex_pc` because of the
+  // receiver class `cls`. Return whether the JIT should now stop speculating at that invoke.
+  bool MaybeUpdateInlineCache(ArtMethod* method,
                               uint32_t dex_pc,
                               ObjPtr<mirror::Class> cls,
                               Thread* self)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Called when optimized code of `method` deoptimized because of dynamic bounds check
+  // elimination. Return whether the JIT should now stop using it for `method`.
+  bool NotifyBCEDeoptimization(ArtMethod* method, Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // NO_THREAD_SAFETY_ANALYSIS because we may be called with the JIT lock held
   // or not. The implementation of this method handles the two cases.
   void AddZombieCode(ArtMethod* method, const void* code_ptr) NO_THREAD_SAFETY_ANALYSIS;
@@ -433,6 +452,11 @@ class JitCodeCache {
   EXPORT void DoCollection(Thread* self)
       REQUIRES(!Locks::jit_lock_);
 
+  // Order hot code relocation `candidates`, pairs of a sample count and a method, from the most
+  // to the least sampled, and keep at most `max_candidates` of them.
+  EXPORT static void SortHotCodeCandidates(
+      /*inout*/ std::vector<std::pair<uint16_t, ArtMethod*>>* candidates, size_t max_candidates);
+
  private:
   JitCodeCache();
 
@@ -455,7 +479,7 @@ class JitCodeCache {
   // Remove CHA dependents and underlying allocations for entries in `method_headers`.
   void FreeAllMethodHeaders(const std::unordered_set<OatQuickMethodHeader*>& method_headers)
       REQUIRES(Locks::jit_lock_)
-      REQUIRES(!Locks::cha_lock_);
+      REQUIRES(!Locks::cha_lock_, !Locks::jit_mutator_lock_);
 
   // Removes method from the cache. The caller must ensure that all threads
   // are suspended and the method should not be in any thread's stack.
@@ -494,6 +518,21 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Sample the optimized code found on thread stacks by the current collection, and recompile
+  // the hottest methods into the hot code space of the private region, if it has one.
+  void RelocateHotCode(Thread* self)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Recompile methods whose inline caches gained entries since they were last optimized.
+  void ReoptimizeForInlineCacheChanges(Thread* self)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Whether `method_header` is optimized, non-baseline code that `method` currently runs.
+  static bool IsCurrentOptimizedCode(ArtMethod* method, const OatQuickMethodHeader* method_header)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   CodeCacheBitmap* GetLiveBitmap() const {
     return live_bitmap_.get();
   }
@@ -551,9 +590,10 @@ class JitCodeCache {
   // Holds compiled code associated with the shorty for a JNI stub.
   SafeMap<JniStubKey, JniStubData> jni_stubs_map_ GUARDED_BY(Locks::jit_mutator_lock_);
 
-  // Holds compiled code associated to the ArtMethod.
-  SafeMap<const void*, ArtMethod*> method_code_map_ GUARDED_BY(Locks::jit_mutator_lock_);
-  // Subset of `method_code_map_`, but keyed by `ArtMethod*`. Used to treat certain
+  // Holds compiled code associated to the ArtMethod. Readers do not need any lock, writers must
+  // hold Locks::jit_mutator_lock_ exclusively.
+  JitCodeIndex method_code_index_;
+  // Subset of `method_code_index_`, but keyed by `ArtMethod*`. Used to treat certain
   // objects (like `MethodType`-s) as strongly reachable from the corresponding ArtMethod.
   SafeMap<ArtMethod*, std::vector<const void*>> method_code_map_reversed_
       GUARDED_BY(Locks::jit_mutator_lock_);
@@ -598,6 +638,9 @@ class JitCodeCache {
   std::set<const void*> processed_zombie_code_ GUARDED_BY(Locks::jit_lock_);
   std::set<ArtMethod*> processed_zombie_jni_code_ GUARDED_BY(Locks::jit_lock_);
 
+  // Methods whose next compiled code should be allocated in the hot code space.
+  std::set<ArtMethod*> methods_to_relocate_ GUARDED_BY(Locks::jit_lock_);
+
   // ---------------- JIT statistics -------------------------------------- //
 
   // Number of baseline compilations done throughout the lifetime of the JIT.
@@ -609,6 +652,18 @@ class JitCodeCache {
   // Number of compilations for on-stack-replacement done throughout the lifetime of the JIT.
   size_t number_of_osr_compilations_ GUARDED_BY(Locks::jit_lock_);
 
+  // Number of optimized compilations of methods which had been compiled with optimizations before.
+  size_t number_of_reoptimizations_ GUARDED_BY(Locks::jit_lock_);
+
+  // Number of optimized compilations with OSR entries, which are also used as OSR code.
+  size_t number_of_osr_entry_points_ GUARDED_BY(Locks::jit_lock_);
+
+  // Number of re-optimizations requested because inline caches changed after optimization.
+  size_t number_of_inline_cache_reoptimizations_ GUARDED_BY(Locks::jit_lock_);
+
+  // Number of speculations the JIT stopped making because they deoptimized too often.
+  size_t number_of_disabled_speculations_ GUARDED_BY(Locks::jit_lock_);
+
   // Number of code cache collections done throughout the lifetime of the JIT.
   size_t number_of_collections_ GUARDED_BY(Locks::jit_lock_);
 
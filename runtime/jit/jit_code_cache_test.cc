@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_code_cache.h"
+
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace art HIDDEN {
+namespace jit {
+
+// Sorting never dereferences the methods, so the test uses fake ones.
+static ArtMethod* Method(uintptr_t value) {
+  return reinterpret_cast<ArtMethod*>(value);
+}
+
+TEST(JitCodeCacheTest, SortHotCodeCandidates) {
+  std::vector<std::pair<uint16_t, ArtMethod*>> candidates = {
+      {2u, Method(1)}, {7u, Method(2)}, {3u, Method(3)}, {7u, Method(4)}, {5u, Method(5)}};
+  JitCodeCache::SortHotCodeCandidates(&candidates, /*max_candidates=*/ 10u);
+  std::vector<std::pair<uint16_t, ArtMethod*>> expected = {
+      {7u, Method(2)}, {7u, Method(4)}, {5u, Method(5)}, {3u, Method(3)}, {2u, Method(1)}};
+  EXPECT_EQ(expected, candidates);
+
+  // Over the limit, only the most sampled methods are kept, still hottest first.
+  candidates = {
+      {2u, Method(1)}, {7u, Method(2)}, {3u, Method(3)}, {7u, Method(4)}, {5u, Method(5)}};
+  JitCodeCache::SortHotCodeCandidates(&candidates, /*max_candidates=*/ 3u);
+  expected = {{7u, Method(2)}, {7u, Method(4)}, {5u, Method(5)}};
+  EXPECT_EQ(expected, candidates);
+}
+
+}  // namespace jit
+}  // namespace art
@@ -0,0 +1,314 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_code_index.h"
+
+#include <sched.h>
+
+#include <algorithm>
+#include <memory>
+
+#include <android-base/logging.h>
+
+namespace art HIDDEN {
+namespace jit {
+
+// Leaves built by Rebuild() are left partially empty so that the next insertions do not
+// immediately split them.
+static constexpr size_t kRebuildLeafSize = JitCodeIndex::kMaxLeafSize * 3 / 4;
+
+static inline bool CodeLess(const void* lhs, const void* rhs) {
+  return reinterpret_cast<uintptr_t>(lhs) < reinterpret_cast<uintptr_t>(rhs);
+}
+
+static inline bool EntryLess(const JitCodeIndex::Entry& lhs, const void* rhs) {
+  return CodeLess(lhs.code_ptr, rhs);
+}
+
+static inline bool EntryGreater(const void* lhs, const JitCodeIndex::Entry& rhs) {
+  return CodeLess(lhs, rhs.code_ptr);
+}
+
+JitCodeIndex::ReadScope::ReadScope(const JitCodeIndex* index) : index_(index) {
+  // The epoch must not change between choosing a counter and incrementing it, otherwise a writer
+  // could see the counter of the old epoch at zero while we are about to read an old root.
+  while (true) {
+    epoch_ = index->epoch_.load(std::memory_order_seq_cst);
+    index->readers_[epoch_].fetch_add(1u, std::memory_order_seq_cst);
+    if (LIKELY(index->epoch_.load(std::memory_order_seq_cst) == epoch_)) {
+      break;
+    }
+    index->readers_[epoch_].fetch_sub(1u, std::memory_order_seq_cst);
+  }
+  root_ = index->root_.load(std::memory_order_acquire);
+}
+
+JitCodeIndex::ReadScope::~ReadScope() {
+  index_->readers_[epoch_].fetch_sub(1u, std::memory_order_release);
+}
+
+JitCodeIndex::JitCodeIndex() : root_(new Root()), epoch_(0u) {
+  readers_[0].store(0u, std::memory_order_relaxed);
+  readers_[1].store(0u, std::memory_order_relaxed);
+}
+
+JitCodeIndex::~JitCodeIndex() {
+  DCHECK_EQ(readers_[0].load(std::memory_order_relaxed), 0u);
+  DCHECK_EQ(readers_[1].load(std::memory_order_relaxed), 0u);
+  const Root* root = GetRootForWriting();
+  for (const Leaf* leaf : root->leaves) {
+    delete leaf;
+  }
+  delete root;
+  for (const Root* retired : retired_roots_) {
+    delete retired;
+  }
+  for (const Root* retired : waiting_roots_) {
+    delete retired;
+  }
+  for (const Leaf* retired : retired_leaves_) {
+    delete retired;
+  }
+  for (const Leaf* retired : waiting_leaves_) {
+    delete retired;
+  }
+}
+
+ssize_t JitCodeIndex::FindLeaf(const Root* root, const void* code_ptr) {
+  auto it = std::upper_bound(
+      root->first_code_ptrs.begin(), root->first_code_ptrs.end(), code_ptr, CodeLess);
+  return static_cast<ssize_t>(it - root->first_code_ptrs.begin()) - 1;
+}
+
+void JitCodeIndex::AddLeaf(Root* root, const Leaf* leaf) {
+  DCHECK(!leaf->entries.empty());
+  DCHECK(root->leaves.empty() || CodeLess(root->leaves.back()->entries.back().code_ptr,
+                                          leaf->entries.front().code_ptr));
+  root->first_code_ptrs.push_back(leaf->entries.front().code_ptr);
+  root->leaves.push_back(leaf);
+  root->size += leaf->entries.size();
+}
+
+JitCodeIndex::Entry JitCodeIndex::Lookup(const void* pc) const {
+  ReadScope scope(this);
+  return LookupIn(scope.GetRoot(), pc);
+}
+
+JitCodeIndex::Entry JitCodeIndex::LookupIn(const Root* root, const void* pc) {
+  ssize_t leaf_index = FindLeaf(root, pc);
+  if (leaf_index < 0) {
+    return Entry{nullptr, nullptr};
+  }
+  const std::vector<Entry>& entries = root->leaves[leaf_index]->entries;
+  // The first entry of the leaf is not above `pc`, so the result is never `begin()`.
+  auto it = std::upper_bound(entries.begin(), entries.end(), pc, EntryGreater);
+  DCHECK(it != entries.begin());
+  return *(it - 1);
+}
+
+ArtMethod* JitCodeIndex::Find(const void* code_ptr) const {
+  Entry entry = Lookup(code_ptr);
+  return entry.code_ptr == code_ptr ? entry.method : nullptr;
+}
+
+size_t JitCodeIndex::Size() const {
+  ReadScope scope(this);
+  return scope.GetRoot()->size;
+}
+
+void JitCodeIndex::Put(const void* code_ptr, ArtMethod* method) {
+  DCHECK(code_ptr != nullptr);
+  const Root* root = GetRootForWriting();
+  std::unique_ptr<Root> new_root(new Root(*root));
+  if (root->leaves.empty()) {
+    AddLeaf(new_root.get(), new Leaf{{Entry{code_ptr, method}}});
+    Publish(new_root.release(), {});
+    return;
+  }
+  // Code below the first leaf goes at the front of the first leaf.
+  size_t leaf_index = static_cast<size_t>(std::max<ssize_t>(FindLeaf(root, code_ptr), 0));
+  const Leaf* leaf = root->leaves[leaf_index];
+  auto it = std::lower_bound(leaf->entries.begin(), leaf->entries.end(), code_ptr, EntryLess);
+  size_t position = it - leaf->entries.begin();
+  if (it != leaf->entries.end() && it->code_ptr == code_ptr) {
+    if (it->method == method) {
+      return;
+    }
+    Leaf* new_leaf = new Leaf(*leaf);
+    new_leaf->entries[position].method = method;
+    new_root->leaves[leaf_index] = new_leaf;
+    Publish(new_root.release(), {leaf});
+    return;
+  }
+
+  new_root->size++;
+  if (leaf->entries.size() == kMaxLeafSize &&
+      position == kMaxLeafSize &&
+      leaf_index == root->leaves.size() - 1u) {
+    // Code is mostly allocated at increasing addresses: start a new leaf rather than split the
+    // last one in two half-empty leaves.
+    new_root->first_code_ptrs.push_back(code_ptr);
+    new_root->leaves.push_back(new Leaf{{Entry{code_ptr, method}}});
+    Publish(new_root.release(), {});
+    return;
+  }
+
+  std::vector<Entry> entries;
+  entries.reserve(leaf->entries.size() + 1u);
+  entries.insert(entries.end(), leaf->entries.begin(), it);
+  entries.push_back(Entry{code_ptr, method});
+  entries.insert(entries.end(), it, leaf->entries.end());
+  if (entries.size() <= kMaxLeafSize) {
+    new_root->first_code_ptrs[leaf_index] = entries.front().code_ptr;
+    new_root->leaves[leaf_index] = new Leaf{std::move(entries)};
+  } else {
+    auto middle = entries.begin() + entries.size() / 2u;
+    Leaf* low = new Leaf{std::vector<Entry>(entries.begin(), middle)};
+    Leaf* high = new Leaf{std::vector<Entry>(middle, entries.end())};
+    new_root->first_code_ptrs[leaf_index] = low->entries.front().code_ptr;
+    new_root->leaves[leaf_index] = low;
+    new_root->first_code_ptrs.insert(new_root->first_code_ptrs.begin() + leaf_index + 1u,
+                                     high->entries.front().code_ptr);
+    new_root->leaves.insert(new_root->leaves.begin() + leaf_index + 1u, high);
+  }
+  Publish(new_root.release(), {leaf});
+}
+
+bool JitCodeIndex::Remove(const void* code_ptr) {
+  const Root* root = GetRootForWriting();
+  ssize_t leaf_index = FindLeaf(root, code_ptr);
+  if (leaf_index < 0) {
+    return false;
+  }
+  const Leaf* leaf = root->leaves[leaf_index];
+  auto it = std::lower_bound(leaf->entries.begin(), leaf->entries.end(), code_ptr, EntryLess);
+  if (it == leaf->entries.end() || it->code_ptr != code_ptr) {
+    return false;
+  }
+  std::unique_ptr<Root> new_root(new Root(*root));
+  new_root->size--;
+  if (leaf->entries.size() == 1u) {
+    new_root->first_code_ptrs.erase(new_root->first_code_ptrs.begin() + leaf_index);
+    new_root->leaves.erase(new_root->leaves.begin() + leaf_index);
+  } else {
+    Leaf* new_leaf = new Leaf(*leaf);
+    new_leaf->entries.erase(new_leaf->entries.begin() + (it - leaf->entries.begin()));
+    new_root->first_code_ptrs[leaf_index] = new_leaf->entries.front().code_ptr;
+    new_root->leaves[leaf_index] = new_leaf;
+  }
+  Publish(new_root.release(), {leaf});
+  return true;
+}
+
+void JitCodeIndex::ReplaceMethod(ArtMethod* old_method, ArtMethod* new_method) {
+  const Root* root = GetRootForWriting();
+  std::unique_ptr<Root> new_root;
+  std::vector<const Leaf*> retired_leaves;
+  for (size_t i = 0; i != root->leaves.size(); ++i) {
+    const Leaf* leaf = root->leaves[i];
+    auto matches = [=](const Entry& entry) { return entry.method == old_method; };
+    if (std::none_of(leaf->entries.begin(), leaf->entries.end(), matches)) {
+      continue;
+    }
+    if (new_root == nullptr) {
+      new_root.reset(new Root(*root));
+    }
+    Leaf* new_leaf = new Leaf(*leaf);
+    for (Entry& entry : new_leaf->entries) {
+      if (entry.method == old_method) {
+        entry.method = new_method;
+      }
+    }
+    new_root->leaves[i] = new_leaf;
+    retired_leaves.push_back(leaf);
+  }
+  if (new_root != nullptr) {
+    Publish(new_root.release(), retired_leaves);
+  }
+}
+
+void JitCodeIndex::Rebuild(const std::vector<Entry>& entries) {
+  const Root* root = GetRootForWriting();
+  Root* new_root = new Root();
+  for (size_t begin = 0; begin < entries.size(); begin += kRebuildLeafSize) {
+    size_t end = std::min(begin + kRebuildLeafSize, entries.size());
+    AddLeaf(new_root, new Leaf{std::vector<Entry>(entries.begin() + begin, entries.begin() + end)});
+  }
+  Publish(new_root, root->leaves);
+}
+
+void JitCodeIndex::Publish(const Root* root, const std::vector<const Leaf*>& retired_leaves) {
+  const Root* old_root = GetRootForWriting();
+  root_.store(root, std::memory_order_release);
+  retired_roots_.push_back(old_root);
+  retired_leaves_.insert(retired_leaves_.end(), retired_leaves.begin(), retired_leaves.end());
+  ReclaimRetired();
+}
+
+void JitCodeIndex::WaitForReaders() {
+  ReclaimRetired(/*wait_for_readers=*/ true);
+}
+
+static void WaitForZero(const Atomic<uint32_t>& counter) {
+  // Readers only hold the counter for a single lookup.
+  while (counter.load(std::memory_order_seq_cst) != 0u) {
+    sched_yield();
+  }
+}
+
+void JitCodeIndex::ReclaimRetired(bool wait_for_readers) {
+  uint32_t epoch = epoch_.load(std::memory_order_relaxed);
+  if (wait_for_readers) {
+    // New readers register in the current epoch, so this terminates.
+    WaitForZero(readers_[epoch ^ 1u]);
+  }
+  if (!waiting_roots_.empty()) {
+    // Arrays retired before the last flip may still be read by readers of the previous epoch.
+    if (readers_[epoch ^ 1u].load(std::memory_order_seq_cst) != 0u) {
+      return;
+    }
+    for (const Root* root : waiting_roots_) {
+      delete root;
+    }
+    for (const Leaf* leaf : waiting_leaves_) {
+      delete leaf;
+    }
+    waiting_roots_.clear();
+    waiting_leaves_.clear();
+  }
+  // Readers which start from now on see the current root, so only readers of the current epoch
+  // may be reading the retired arrays. Flip the epoch and wait for those to finish.
+  waiting_roots_.swap(retired_roots_);
+  waiting_leaves_.swap(retired_leaves_);
+  epoch_.store(epoch ^ 1u, std::memory_order_seq_cst);
+  if (wait_for_readers) {
+    // Readers of both epochs which started before the call are now done.
+    WaitForZero(readers_[epoch]);
+  }
+  if (readers_[epoch].load(std::memory_order_seq_cst) == 0u) {
+    for (const Root* root : waiting_roots_) {
+      delete root;
+    }
+    for (const Leaf* leaf : waiting_leaves_) {
+      delete leaf;
+    }
+    waiting_roots_.clear();
+    waiting_leaves_.clear();
+  }
+}
+
+}  // namespace jit
+}  // namespace art
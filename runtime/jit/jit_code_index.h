@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_JIT_CODE_INDEX_H_
+#define ART_RUNTIME_JIT_JIT_CODE_INDEX_H_
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "base/atomic.h"
+#include "base/macros.h"
+
+namespace art HIDDEN {
+
+class ArtMethod;
+
+namespace jit {
+
+// Sorted map from JIT code pointer to the ArtMethod it was compiled for, optimized for lookups
+// by pc from stack walks, exception delivery and deoptimization.
+//
+// The index is a two-level tree of immutable sorted arrays. Writers copy the leaf they modify
+// and the root, then publish the new root with a single store, so readers never block and never
+// take a lock. Replaced arrays are freed once no reader can still be looking at them: readers
+// announce themselves in one of two epoch counters, and writers free what they retired during an
+// epoch after flipping to the other one and seeing the old counter drop to zero.
+//
+// The same counters protect what the entries point to: a reader that dereferences an entry's code
+// inside Lookup(pc, predicate) is guaranteed that the code is not freed under it, as long as the
+// writer calls WaitForReaders() between removing the entry and freeing the code.
+//
+// Writers must be serialized by the caller; JitCodeCache uses Locks::jit_mutator_lock_.
+class JitCodeIndex {
+ public:
+  struct Entry {
+    const void* code_ptr;
+    ArtMethod* method;
+  };
+
+  // Maximum number of entries in a leaf array. Inserting in a full leaf splits it.
+  static constexpr size_t kMaxLeafSize = 64;
+
+  EXPORT JitCodeIndex();
+  EXPORT ~JitCodeIndex();
+
+  // Lock-free. Return the entry with the highest code pointer not above `pc`, or an entry with a
+  // null code pointer if there is none. The caller checks whether the code contains `pc`.
+  EXPORT Entry Lookup(const void* pc) const;
+
+  // Lock-free. Like Lookup(), but return the entry only if `predicate` returns true for it. The
+  // predicate runs while the reader is registered, so it may read the code of the entry even if
+  // the entry is being removed concurrently, see WaitForReaders().
+  template <typename Predicate>
+  Entry Lookup(const void* pc, const Predicate& predicate) const {
+    ReadScope scope(this);
+    Entry entry = LookupIn(scope.GetRoot(), pc);
+    return (entry.code_ptr != nullptr && predicate(entry)) ? entry : Entry{nullptr, nullptr};
+  }
+
+  // Lock-free. Return the method for `code_ptr`, or null if there is none.
+  ArtMethod* Find(const void* code_ptr) const;
+
+  // Lock-free. Visit the entries in increasing code pointer order, as of the start of the call.
+  template <typename Visitor>
+  void VisitEntries(const Visitor& visitor) const {
+    ReadScope scope(this);
+    for (const Leaf* leaf : scope.GetRoot()->leaves) {
+      for (const Entry& entry : leaf->entries) {
+        visitor(entry);
+      }
+    }
+  }
+
+  size_t Size() const;
+  bool IsEmpty() const { return Size() == 0u; }
+
+  // Add or replace the entry for `code_ptr`.
+  EXPORT void Put(const void* code_ptr, ArtMethod* method);
+
+  // Remove the entry for `code_ptr`. Return whether there was one.
+  bool Remove(const void* code_ptr);
+
+  // Remove all entries for which `predicate` returns true, rebuilding the index once. The
+  // predicate is called exactly once per entry, in increasing code pointer order.
+  template <typename Predicate>
+  size_t RemoveIf(const Predicate& predicate) {
+    std::vector<Entry> kept;
+    kept.reserve(Size());
+    size_t removed = 0u;
+    VisitEntries([&](const Entry& entry) {
+      if (predicate(entry)) {
+        ++removed;
+      } else {
+        kept.push_back(entry);
+      }
+    });
+    if (removed != 0u) {
+      Rebuild(kept);
+    }
+    return removed;
+  }
+
+  // Point all entries for `old_method` to `new_method`.
+  void ReplaceMethod(ArtMethod* old_method, ArtMethod* new_method);
+
+  // Block until all lookups which started before the call have returned. Called by writers after
+  // removing entries and before freeing the code they point to.
+  EXPORT void WaitForReaders();
+
+ private:
+  struct Leaf {
+    std::vector<Entry> entries;  // Sorted by code pointer, never empty once published.
+  };
+
+  struct Root {
+    std::vector<const void*> first_code_ptrs;  // First code pointer of each leaf.
+    std::vector<const Leaf*> leaves;
+    size_t size = 0u;
+  };
+
+  // Registers a reader for its lifetime, so that the root it reads is not freed under it.
+  class ReadScope {
+   public:
+    explicit ReadScope(const JitCodeIndex* index);
+    ~ReadScope();
+
+    const Root* GetRoot() const { return root_; }
+
+   private:
+    const JitCodeIndex* const index_;
+    uint32_t epoch_;
+    const Root* root_;
+
+    DISALLOW_COPY_AND_ASSIGN(ReadScope);
+  };
+
+  // Return the index of the leaf that may contain `code_ptr`, or -1.
+  static ssize_t FindLeaf(const Root* root, const void* code_ptr);
+  EXPORT static Entry LookupIn(const Root* root, const void* pc);
+  static void AddLeaf(Root* root, const Leaf* leaf);
+
+  const Root* GetRootForWriting() const {
+    return root_.load(std::memory_order_relaxed);
+  }
+
+  // Replace the current root with `root` and schedule the old root and `retired_leaves` for
+  // deletion.
+  void Publish(const Root* root, const std::vector<const Leaf*>& retired_leaves);
+  void Rebuild(const std::vector<Entry>& entries);
+  // Free the retired arrays that no reader can see anymore. If `wait_for_readers`, wait for the
+  // readers of both epochs instead of leaving the arrays for a later call.
+  void ReclaimRetired(bool wait_for_readers = false);
+
+  Atomic<const Root*> root_;
+
+  // Number of readers per epoch, and the current epoch (0 or 1).
+  mutable Atomic<uint32_t> readers_[2];
+  Atomic<uint32_t> epoch_;
+
+  // Arrays unlinked during the current epoch, and arrays unlinked during the previous epoch which
+  // are freed once it has no readers left. Only accessed by writers.
+  std::vector<const Root*> retired_roots_;
+  std::vector<const Leaf*> retired_leaves_;
+  std::vector<const Root*> waiting_roots_;
+  std::vector<const Leaf*> waiting_leaves_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitCodeIndex);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_JIT_CODE_INDEX_H_
@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_code_index.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <android-base/logging.h>
+
+#include "gtest/gtest.h"
+
+namespace art HIDDEN {
+namespace jit {
+
+// The index never dereferences its keys and values, so tests use fake ones.
+static const void* Code(uintptr_t value) {
+  return reinterpret_cast<const void*>(value);
+}
+
+static ArtMethod* Method(uintptr_t value) {
+  return reinterpret_cast<ArtMethod*>(value);
+}
+
+static void CheckMatches(const JitCodeIndex& index, const std::map<uintptr_t, uintptr_t>& map) {
+  ASSERT_EQ(map.size(), index.Size());
+  std::vector<JitCodeIndex::Entry> entries;
+  index.VisitEntries([&](const JitCodeIndex::Entry& entry) { entries.push_back(entry); });
+  ASSERT_EQ(map.size(), entries.size());
+  size_t i = 0;
+  for (const auto& [code, method] : map) {
+    EXPECT_EQ(Code(code), entries[i].code_ptr);
+    EXPECT_EQ(Method(method), entries[i].method);
+    EXPECT_EQ(Method(method), index.Find(Code(code)));
+    // Any pc up to the next code pointer resolves to this entry.
+    EXPECT_EQ(Code(code), index.Lookup(Code(code + 1)).code_ptr);
+    ++i;
+  }
+}
+
+TEST(JitCodeIndexTest, Empty) {
+  JitCodeIndex index;
+  EXPECT_TRUE(index.IsEmpty());
+  EXPECT_EQ(nullptr, index.Lookup(Code(0x1000)).code_ptr);
+  EXPECT_EQ(nullptr, index.Find(Code(0x1000)));
+  EXPECT_FALSE(index.Remove(Code(0x1000)));
+}
+
+TEST(JitCodeIndexTest, Lookup) {
+  JitCodeIndex index;
+  index.Put(Code(0x2000), Method(2));
+  index.Put(Code(0x1000), Method(1));
+  index.Put(Code(0x3000), Method(3));
+  EXPECT_EQ(nullptr, index.Lookup(Code(0xfff)).code_ptr);
+  EXPECT_EQ(Code(0x1000), index.Lookup(Code(0x1000)).code_ptr);
+  EXPECT_EQ(Method(1), index.Lookup(Code(0x1fff)).method);
+  EXPECT_EQ(Method(2), index.Lookup(Code(0x2000)).method);
+  EXPECT_EQ(Method(3), index.Lookup(Code(0x100000)).method);
+  EXPECT_EQ(nullptr, index.Find(Code(0x1001)));
+
+  index.Put(Code(0x2000), Method(4));
+  EXPECT_EQ(3u, index.Size());
+  EXPECT_EQ(Method(4), index.Find(Code(0x2000)));
+
+  EXPECT_TRUE(index.Remove(Code(0x2000)));
+  EXPECT_FALSE(index.Remove(Code(0x2000)));
+  EXPECT_EQ(Method(1), index.Lookup(Code(0x2000)).method);
+  EXPECT_EQ(2u, index.Size());
+}
+
+TEST(JitCodeIndexTest, ManyEntries) {
+  JitCodeIndex index;
+  std::map<uintptr_t, uintptr_t> map;
+  std::default_random_engine rng(42);
+  std::uniform_int_distribution<uintptr_t> dist(1u, 1u << 20);
+  // Enough entries for many leaf splits, inserted in increasing and in random order.
+  for (uintptr_t i = 1; i <= 20 * JitCodeIndex::kMaxLeafSize; ++i) {
+    index.Put(Code(i * 0x100), Method(i));
+    map[i * 0x100] = i;
+  }
+  for (size_t i = 0; i != 20 * JitCodeIndex::kMaxLeafSize; ++i) {
+    uintptr_t code = dist(rng) * 16u;
+    index.Put(Code(code), Method(i));
+    map[code] = i;
+  }
+  CheckMatches(index, map);
+
+  for (size_t i = 0; i != 10 * JitCodeIndex::kMaxLeafSize; ++i) {
+    auto it = map.lower_bound(dist(rng) * 16u);
+    if (it == map.end()) {
+      continue;
+    }
+    EXPECT_TRUE(index.Remove(Code(it->first)));
+    map.erase(it);
+  }
+  CheckMatches(index, map);
+}
+
+TEST(JitCodeIndexTest, RemoveIfAndReplaceMethod) {
+  JitCodeIndex index;
+  std::map<uintptr_t, uintptr_t> map;
+  for (uintptr_t i = 1; i <= 5 * JitCodeIndex::kMaxLeafSize; ++i) {
+    index.Put(Code(i * 0x100), Method(i % 7u));
+    map[i * 0x100] = i % 7u;
+  }
+  size_t removed = index.RemoveIf([](const JitCodeIndex::Entry& entry) {
+    return entry.method == Method(3);
+  });
+  EXPECT_EQ(static_cast<size_t>(std::count_if(map.begin(), map.end(), [](const auto& entry) {
+              return entry.second == 3u;
+            })),
+            removed);
+  for (auto it = map.begin(); it != map.end();) {
+    it = (it->second == 3u) ? map.erase(it) : std::next(it);
+  }
+  CheckMatches(index, map);
+
+  index.ReplaceMethod(Method(5), Method(8));
+  for (auto& entry : map) {
+    if (entry.second == 5u) {
+      entry.second = 8u;
+    }
+  }
+  CheckMatches(index, map);
+
+  // New entries can still be added after a rebuild.
+  index.Put(Code(0x80), Method(9));
+  map[0x80] = 9u;
+  CheckMatches(index, map);
+}
+
+TEST(JitCodeIndexTest, ConcurrentReaders) {
+  JitCodeIndex index;
+  // Entries which are never removed, so readers always find them.
+  constexpr uintptr_t kNumStable = 4 * JitCodeIndex::kMaxLeafSize;
+  for (uintptr_t i = 0; i != kNumStable; ++i) {
+    index.Put(Code(0x100000 + i * 0x100), Method(i + 1u));
+  }
+  std::atomic<bool> done(false);
+  std::vector<std::thread> readers;
+  for (size_t t = 0; t != 4u; ++t) {
+    readers.emplace_back([&]() {
+      while (!done.load(std::memory_order_relaxed)) {
+        for (uintptr_t i = 0; i != kNumStable; ++i) {
+          JitCodeIndex::Entry entry = index.Lookup(Code(0x100000 + i * 0x100 + 0x80));
+          ASSERT_EQ(Code(0x100000 + i * 0x100), entry.code_ptr);
+          ASSERT_EQ(Method(i + 1u), entry.method);
+        }
+      }
+    });
+  }
+  // Churn entries around the stable ones, splitting and retiring leaves.
+  for (size_t round = 0; round != 50u; ++round) {
+    for (uintptr_t i = 0; i != kNumStable; ++i) {
+      index.Put(Code(0x100000 + i * 0x100 + 0x90), Method(round));
+    }
+    for (uintptr_t i = 0; i != kNumStable; ++i) {
+      EXPECT_TRUE(index.Remove(Code(0x100000 + i * 0x100 + 0x90)));
+    }
+  }
+  done.store(true, std::memory_order_relaxed);
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(kNumStable, index.Size());
+}
+
+// Mimics JitCodeCache: readers check the header of the code found, as LookupMethodHeader() does,
+// while a collector removes code from the index and frees it.
+TEST(JitCodeIndexTest, LookupDuringCollection) {
+  struct FakeCode {
+    static constexpr uint32_t kLive = 0x600dc0de;
+    static constexpr uint32_t kFreed = 0xdeadc0de;
+    // First, so that the code pointer is the address of the object.
+    uint8_t instructions[0x40];
+    std::atomic<uint32_t> state{kLive};
+
+    bool Contains(const void* pc) const {
+      CHECK_EQ(state.load(std::memory_order_relaxed), kLive) << "Use after free";
+      return pc >= instructions && pc < instructions + sizeof(instructions);
+    }
+  };
+  constexpr size_t kNumCode = 4 * JitCodeIndex::kMaxLeafSize;
+  JitCodeIndex index;
+  std::vector<FakeCode*> live;
+  for (size_t i = 0; i != kNumCode; ++i) {
+    live.push_back(new FakeCode());
+    index.Put(live.back()->instructions, Method(i + 1u));
+  }
+  // Readers look up pcs in and just past every piece of code. The latter hit a neighbour that may
+  // be concurrently collected.
+  std::vector<const void*> pcs;
+  for (FakeCode* code : live) {
+    pcs.push_back(code->instructions + 4);
+    pcs.push_back(code->instructions + sizeof(code->instructions) + 8);
+  }
+  std::atomic<bool> done(false);
+  std::vector<std::thread> readers;
+  for (size_t t = 0; t != 4u; ++t) {
+    readers.emplace_back([&]() {
+      while (!done.load(std::memory_order_relaxed)) {
+        for (const void* pc : pcs) {
+          index.Lookup(pc, [pc](const JitCodeIndex::Entry& entry) {
+            return reinterpret_cast<const FakeCode*>(entry.code_ptr)->Contains(pc);
+          });
+        }
+      }
+    });
+  }
+  // Collect half of the code in each round, then compile new code.
+  std::default_random_engine rng(42);
+  for (size_t round = 0; round != 50u; ++round) {
+    std::shuffle(live.begin(), live.end(), rng);
+    std::vector<FakeCode*> collected(live.begin() + kNumCode / 2, live.end());
+    live.resize(kNumCode / 2);
+    index.RemoveIf([&](const JitCodeIndex::Entry& entry) {
+      return std::any_of(collected.begin(), collected.end(), [&](FakeCode* code) {
+        return code->instructions == entry.code_ptr;
+      });
+    });
+    index.WaitForReaders();
+    // Poison the code before freeing it, so that a racing reader fails its check even without a
+    // memory tool.
+    for (FakeCode* code : collected) {
+      code->state.store(FakeCode::kFreed, std::memory_order_relaxed);
+    }
+    std::this_thread::yield();
+    for (FakeCode* code : collected) {
+      delete code;
+    }
+    for (size_t i = 0; i != collected.size(); ++i) {
+      live.push_back(new FakeCode());
+      index.Put(live.back()->instructions, Method(round * kNumCode + i + 1u));
+    }
+  }
+  done.store(true, std::memory_order_relaxed);
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+  for (FakeCode* code : live) {
+    delete code;
+  }
+}
+
+}  // namespace jit
+}  // namespace art
@@ -19,6 +19,8 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <algorithm>
+
 #include <android-base/unique_fd.h>
 #include <log/log.h>
 #include "base/bit_utils.h"  // For RoundDown, RoundUp
@@ -307,9 +309,49 @@ void JitMemoryRegion::SetFootprintLimit(size_t new_footprint) {
   DCHECK(IsAlignedParam(data_space_footprint, gPageSize));
   DCHECK_EQ(data_space_footprint * kCodeAndDataCapacityDivider, new_footprint);
   if (HasCodeMapping()) {
+    size_t exec_space_footprint = new_footprint - data_space_footprint;
+    if (HasHotCodeSpace()) {
+      // The rest of the code must not grow into the hot code space.
+      exec_space_footprint = std::min(exec_space_footprint, hot_begin_);
+    }
+    ScopedCodeCacheWrite scc(*this);
+    mspace_set_footprint_limit(exec_mspace_, exec_space_footprint);
+  }
+}
+
+bool JitMemoryRegion::InitializeHotCodeSpace(size_t capacity) {
+  DCHECK(!HasHotCodeSpace());
+  if (!HasCodeMapping() || exec_mspace_ == nullptr) {
+    return false;
+  }
+  const size_t exec_capacity = exec_pages_.Size();
+  capacity = RoundDown(capacity, gPageSize);
+  // Keep most of the code pages for the code that is not hot.
+  if (capacity < 2 * gPageSize ||
+      capacity > exec_capacity / 2 ||
+      exec_end_ > exec_capacity - capacity) {
+    return false;
+  }
+  hot_begin_ = exec_capacity - capacity;
+  // The mspace needs one page for its own bookkeeping; it asks for more with MoreCore as needed.
+  hot_end_ = hot_begin_ + gPageSize;
+  {
     ScopedCodeCacheWrite scc(*this);
-    mspace_set_footprint_limit(exec_mspace_, new_footprint - data_space_footprint);
+    hot_mspace_ = create_mspace_with_base(
+        GetUpdatableCodeMapping()->Begin() + hot_begin_, gPageSize, /* locked= */ false);
   }
+  if (hot_mspace_ == nullptr) {
+    hot_begin_ = 0;
+    hot_end_ = 0;
+    return false;
+  }
+  {
+    ScopedCodeCacheWrite scc(*this);
+    mspace_set_footprint_limit(hot_mspace_, capacity);
+  }
+  SetFootprintLimit(current_capacity_);
+  VLOG(jit) << "Created hot code space of " << PrettySize(capacity);
+  return true;
 }
 
 bool JitMemoryRegion::IncreaseCodeCacheCapacity() {
@@ -344,6 +386,11 @@ void* JitMemoryRegion::MoreCore(const void* mspace, intptr_t increment) NO_THREA
     void* result = code_pages->Begin() + exec_end_;
     exec_end_ += increment;
     return result;
+  } else if (mspace == hot_mspace_ && hot_mspace_ != nullptr) {
+    const MemMap* const code_pages = GetUpdatableCodeMapping();
+    void* result = code_pages->Begin() + hot_end_;
+    hot_end_ += increment;
+    return result;
   } else {
     CHECK_EQ(data_mspace_, mspace);
     const MemMap* const writable_data_pages = GetWritableDataMapping();
@@ -463,9 +510,15 @@ bool JitMemoryRegion::CommitData(ArrayRef<const uint8_t> reserved_data,
   return true;
 }
 
-const uint8_t* JitMemoryRegion::AllocateCode(size_t size) {
+const uint8_t* JitMemoryRegion::AllocateCode(size_t size, bool hot) {
   size_t alignment = GetInstructionSetCodeAlignment(kRuntimeISA);
-  void* result = mspace_memalign(exec_mspace_, alignment, size);
+  void* result = nullptr;
+  if (hot && HasHotCodeSpace()) {
+    result = mspace_memalign(hot_mspace_, alignment, size);
+  }
+  if (result == nullptr) {
+    result = mspace_memalign(exec_mspace_, alignment, size);
+  }
   if (UNLIKELY(result == nullptr)) {
     return nullptr;
   }
@@ -474,9 +527,10 @@ const uint8_t* JitMemoryRegion::AllocateCode(size_t size) {
 }
 
 void JitMemoryRegion::FreeCode(const uint8_t* code) {
+  void* mspace = IsInHotCodeSpace(code) ? hot_mspace_ : exec_mspace_;
   code = GetNonExecutableAddress(code);
   used_memory_for_code_ -= mspace_usable_size(code);
-  mspace_free(exec_mspace_, const_cast<uint8_t*>(code));
+  mspace_free(mspace, const_cast<uint8_t*>(code));
 }
 
 const uint8_t* JitMemoryRegion::AllocateData(size_t data_size) {
@@ -56,6 +56,8 @@ class JitMemoryRegion {
         current_capacity_(0),
         data_end_(0),
         exec_end_(0),
+        hot_begin_(0),
+        hot_end_(0),
         used_memory_for_code_(0),
         used_memory_for_data_(0),
         data_pages_(),
@@ -63,7 +65,8 @@ class JitMemoryRegion {
         exec_pages_(),
         non_exec_pages_(),
         data_mspace_(nullptr),
-        exec_mspace_(nullptr) {}
+        exec_mspace_(nullptr),
+        hot_mspace_(nullptr) {}
 
   bool Initialize(size_t initial_capacity,
                   size_t max_capacity,
@@ -79,7 +82,13 @@ class JitMemoryRegion {
   // Set the footprint limit of the code cache.
   void SetFootprintLimit(size_t new_footprint) REQUIRES(Locks::jit_lock_);
 
-  const uint8_t* AllocateCode(size_t code_size) REQUIRES(Locks::jit_lock_);
+  // Set aside the top `capacity` bytes of the code pages for hot code, so that the code of the
+  // hottest methods can be packed together, away from code that is frequently replaced. Return
+  // whether the space could be created.
+  bool InitializeHotCodeSpace(size_t capacity) REQUIRES(Locks::jit_lock_);
+
+  // Allocate code, from the hot code space if `hot` and there is space left in it.
+  const uint8_t* AllocateCode(size_t code_size, bool hot = false) REQUIRES(Locks::jit_lock_);
   void FreeCode(const uint8_t* code) REQUIRES(Locks::jit_lock_);
   const uint8_t* AllocateData(size_t data_size) REQUIRES(Locks::jit_lock_);
   void FreeData(const uint8_t* data) REQUIRES(Locks::jit_lock_);
@@ -107,6 +116,7 @@ class JitMemoryRegion {
     // point to the discarded mappings.
     exec_mspace_ = nullptr;
     data_mspace_ = nullptr;
+    hot_mspace_ = nullptr;
   }
 
   bool IsValid() const NO_THREAD_SAFETY_ANALYSIS {
@@ -145,6 +155,17 @@ class JitMemoryRegion {
     return exec_pages_.HasAddress(ptr);
   }
 
+  bool HasHotCodeSpace() const NO_THREAD_SAFETY_ANALYSIS {
+    return hot_mspace_ != nullptr;
+  }
+
+  bool IsInHotCodeSpace(const void* ptr) const NO_THREAD_SAFETY_ANALYSIS {
+    return HasHotCodeSpace() &&
+           IsInExecSpace(ptr) &&
+           static_cast<size_t>(reinterpret_cast<const uint8_t*>(ptr) - exec_pages_.Begin()) >=
+               hot_begin_;
+  }
+
   const MemMap* GetExecPages() const {
     return &exec_pages_;
   }
@@ -152,7 +173,9 @@ class JitMemoryRegion {
   void* MoreCore(const void* mspace, intptr_t increment);
 
   bool OwnsSpace(const void* mspace) const NO_THREAD_SAFETY_ANALYSIS {
-    return mspace == data_mspace_ || mspace == exec_mspace_;
+    return mspace == data_mspace_ ||
+           mspace == exec_mspace_ ||
+           (mspace != nullptr && mspace == hot_mspace_);
   }
 
   size_t GetCurrentCapacity() const REQUIRES(Locks::jit_lock_) {
@@ -168,7 +191,7 @@ class JitMemoryRegion {
   }
 
   size_t GetResidentMemoryForCode() const REQUIRES(Locks::jit_lock_) {
-    return exec_end_;
+    return exec_end_ + (hot_end_ - hot_begin_);
   }
 
   size_t GetUsedMemoryForData() const REQUIRES(Locks::jit_lock_) {
@@ -251,6 +274,11 @@ class JitMemoryRegion {
   // The current footprint in bytes of the code portion of the region.
   size_t exec_end_ GUARDED_BY(Locks::jit_lock_);
 
+  // Offsets of the start and of the current end of the hot code space in the code pages. The hot
+  // code space, if any, is at the top of the code pages and grows up like the rest of the code.
+  size_t hot_begin_ GUARDED_BY(Locks::jit_lock_);
+  size_t hot_end_ GUARDED_BY(Locks::jit_lock_);
+
   // The size in bytes of used memory for the code portion of the region.
   size_t used_memory_for_code_ GUARDED_BY(Locks::jit_lock_);
 
@@ -277,6 +305,9 @@ class JitMemoryRegion {
   // The opaque mspace for allocating code.
   void* exec_mspace_ GUARDED_BY(Locks::jit_lock_);
 
+  // The opaque mspace for allocating hot code, or null if there is no hot code space.
+  void* hot_mspace_ GUARDED_BY(Locks::jit_lock_);
+
   friend class ScopedCodeCacheWrite;  // For GetUpdatableCodeMapping
   friend class TestZygoteMemory;
 };
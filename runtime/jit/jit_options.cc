@@ -16,6 +16,11 @@
 
 #include "jit_options.h"
 
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "interpreter/mterp/nterp.h"
 #include "runtime_options.h"
 
 namespace art HIDDEN {
@@ -31,7 +36,11 @@ static constexpr uint32_t kJitStressDefaultOptimizeThreshold = kJitDefaultOptimi
 static constexpr uint32_t kJitSlowStressDefaultOptimizeThreshold =
     kJitStressDefaultOptimizeThreshold / 2;
 
-static constexpr uint32_t kJitDefaultWarmupThreshold = 0xffff;
+// Maximum permitted warm-up threshold value. Counters at or above the value where nterp parks
+// them would never reach zero.
+static constexpr uint32_t kJitMaxWarmupThreshold = interpreter::kNterpHotnessParkedValue - 1u;
+
+static constexpr uint32_t kJitDefaultWarmupThreshold = kJitMaxWarmupThreshold;
 // Different warm-up threshold constants. These default to the equivalent warmup thresholds divided
 // by 2, but can be overridden at the command-line.
 static constexpr uint32_t kJitStressDefaultWarmupThreshold = kJitDefaultWarmupThreshold / 2;
@@ -40,6 +49,9 @@ static constexpr uint32_t kJitSlowStressDefaultWarmupThreshold =
 
 static constexpr size_t kDefaultPriorityThreadWeightRatio = 1000;
 static constexpr size_t kDefaultInvokeTransitionWeightRatio = 500;
+// By default, a method seen on top of the stack in that many samples is as hot as one which
+// reached the warmup threshold through its own counter.
+static constexpr size_t kDefaultSampleWeightRatio = 8;
 
 DEFINE_RUNTIME_DEBUG_FLAG(JitOptions, kSlowMode);
 
@@ -53,6 +65,12 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
       options.GetOrDefault(RuntimeArgumentMap::JITCodeCacheInitialCapacity);
   jit_options->code_cache_max_capacity_ =
       options.GetOrDefault(RuntimeArgumentMap::JITCodeCacheMaxCapacity);
+  jit_options->hot_code_capacity_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITHotCodeCapacity);
+  jit_options->compile_time_budget_ms_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITCompileTimeBudget);
+  jit_options->compile_memory_budget_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITCompileMemoryBudget);
   jit_options->dump_info_on_shutdown_ =
       options.Exists(RuntimeArgumentMap::DumpJITInfoOnShutdown);
   jit_options->profile_saver_options_ =
@@ -61,6 +79,16 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
       options.GetOrDefault(RuntimeArgumentMap::JITPoolThreadPthreadPriority);
   jit_options->zygote_thread_pool_pthread_priority_ =
       options.GetOrDefault(RuntimeArgumentMap::JITZygotePoolThreadPthreadPriority);
+  jit_options->thread_pool_size_ = options.GetOrDefault(RuntimeArgumentMap::JITPoolThreadCount);
+  jit_options->persistent_cache_path_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITPersistentCachePath);
+  if (jit_options->thread_pool_size_ == 0) {
+    // Leave half of the cores to the application, which is also busy warming up
+    // when the jit has the most work.
+    const long num_cpus = sysconf(_SC_NPROCESSORS_CONF);  // NOLINT(runtime/int)
+    jit_options->thread_pool_size_ = std::clamp(
+        static_cast<size_t>(std::max(num_cpus, 1L) / 2), size_t{1}, kJitMaxDefaultThreadPoolSize);
+  }
 
   // Set default optimize threshold to aid with checking defaults.
   jit_options->optimize_threshold_ = kIsDebugBuild
@@ -78,9 +106,10 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
   DCHECK_LE(jit_options->optimize_threshold_, kJitMaxThreshold);
 
   if (options.Exists(RuntimeArgumentMap::JITWarmupThreshold)) {
-    jit_options->warmup_threshold_ = *options.Get(RuntimeArgumentMap::JITWarmupThreshold);
+    jit_options->warmup_threshold_ = std::min<uint32_t>(
+        *options.Get(RuntimeArgumentMap::JITWarmupThreshold), kJitMaxWarmupThreshold);
   }
-  DCHECK_LE(jit_options->warmup_threshold_, kJitMaxThreshold);
+  DCHECK_LE(jit_options->warmup_threshold_, kJitMaxWarmupThreshold);
 
   if (options.Exists(RuntimeArgumentMap::JITPriorityThreadWeight)) {
     jit_options->priority_thread_weight_ =
@@ -110,6 +139,27 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
         static_cast<size_t>(1));
   }
 
+  jit_options->sampling_interval_us_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITSamplingInterval);
+  if (options.Exists(RuntimeArgumentMap::JITSampleWeight)) {
+    jit_options->sample_weight_ = *options.Get(RuntimeArgumentMap::JITSampleWeight);
+    if (jit_options->sample_weight_ > jit_options->warmup_threshold_) {
+      LOG(FATAL) << "Sample weight is above the warmup threshold.";
+    } else if (jit_options->sample_weight_ == 0) {
+      LOG(FATAL) << "Sample weight cannot be 0.";
+    }
+  } else {
+    jit_options->sample_weight_ = std::max(
+        jit_options->warmup_threshold_ / kDefaultSampleWeightRatio,
+        static_cast<size_t>(1));
+  }
+  if (jit_options->sampling_interval_us_ != 0 && jit_options->use_jit_compilation_) {
+    // Samples alone make methods hot: they add up to the warm-up threshold in the sampler, and
+    // the hotness counters start right above the value where the interpreter parks them.
+    jit_options->sample_threshold_ = jit_options->warmup_threshold_;
+    jit_options->warmup_threshold_ = interpreter::kNterpHotnessParkedValue + 1u;
+  }
+
   return jit_options;
 }
 
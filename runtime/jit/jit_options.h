@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_JIT_JIT_OPTIONS_H_
 #define ART_RUNTIME_JIT_JIT_OPTIONS_H_
 
+#include <string>
+
 #include "base/macros.h"
 #include "base/runtime_debug.h"
 #include "profile_saver_options.h"
@@ -34,6 +36,9 @@ static constexpr int kJitPoolThreadPthreadDefaultPriority = 9;
 // 19 is the lowest background priority on device.
 // See android/os/Process.java.
 static constexpr int kJitZygotePoolThreadPthreadDefaultPriority = 19;
+// Upper bound on the default number of jit threads, used when the pool size is not set
+// explicitly. The pool only uses more than one thread when the compilation queues back up.
+static constexpr size_t kJitMaxDefaultThreadPoolSize = 4;
 
 class JitOptions {
  public:
@@ -65,6 +70,32 @@ class JitOptions {
     return code_cache_max_capacity_;
   }
 
+  size_t GetHotCodeCapacity() const {
+    return hot_code_capacity_;
+  }
+
+  uint32_t GetCompileTimeBudgetMs() const {
+    return compile_time_budget_ms_;
+  }
+
+  size_t GetCompileMemoryBudget() const {
+    return compile_memory_budget_;
+  }
+
+  uint32_t GetSamplingIntervalUs() const {
+    return sampling_interval_us_;
+  }
+
+  uint16_t GetSampleWeight() const {
+    return sample_weight_;
+  }
+
+  // The sum of sample weights which makes a method hot when sampling. The warm-up threshold is
+  // then only the initial value of the hotness counters, which do not get updated.
+  uint16_t GetSampleThreshold() const {
+    return sample_threshold_;
+  }
+
   bool DumpJitInfoOnShutdown() const {
     return dump_info_on_shutdown_;
   }
@@ -85,6 +116,14 @@ class JitOptions {
     return zygote_thread_pool_pthread_priority_;
   }
 
+  size_t GetThreadPoolSize() const {
+    return thread_pool_size_;
+  }
+
+  const std::string& GetPersistentCachePath() const {
+    return persistent_cache_path_;
+  }
+
   bool UseJitCompilation() const {
     return use_jit_compilation_;
   }
@@ -128,13 +167,21 @@ class JitOptions {
   bool use_baseline_compiler_;
   size_t code_cache_initial_capacity_;
   size_t code_cache_max_capacity_;
+  size_t hot_code_capacity_;
+  uint32_t compile_time_budget_ms_;
+  size_t compile_memory_budget_;
   uint32_t optimize_threshold_;
   uint32_t warmup_threshold_;
   uint16_t priority_thread_weight_;
   uint16_t invoke_transition_weight_;
+  uint32_t sampling_interval_us_;
+  uint16_t sample_weight_;
+  uint16_t sample_threshold_;
   bool dump_info_on_shutdown_;
   int thread_pool_pthread_priority_;
   int zygote_thread_pool_pthread_priority_;
+  size_t thread_pool_size_;
+  std::string persistent_cache_path_;
   ProfileSaverOptions profile_saver_options_;
 
   JitOptions()
@@ -143,13 +190,20 @@ class JitOptions {
         use_baseline_compiler_(false),
         code_cache_initial_capacity_(0),
         code_cache_max_capacity_(0),
+        hot_code_capacity_(0),
+        compile_time_budget_ms_(0),
+        compile_memory_budget_(0),
         optimize_threshold_(0),
         warmup_threshold_(0),
         priority_thread_weight_(0),
         invoke_transition_weight_(0),
+        sampling_interval_us_(0),
+        sample_weight_(0),
+        sample_threshold_(0),
         dump_info_on_shutdown_(false),
         thread_pool_pthread_priority_(kJitPoolThreadPthreadDefaultPriority),
-        zygote_thread_pool_pthread_priority_(kJitZygotePoolThreadPthreadDefaultPriority) {}
+        zygote_thread_pool_pthread_priority_(kJitZygotePoolThreadPthreadDefaultPriority),
+        thread_pool_size_(1) {}
 
   DISALLOW_COPY_AND_ASSIGN(JitOptions);
 };
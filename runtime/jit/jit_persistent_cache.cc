@@ -0,0 +1,523 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_persistent_cache.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include <android-base/logging.h>
+#include <android-base/strings.h>
+
+#include "arch/instruction_set.h"
+#include "art_method-inl.h"
+#include "base/arena_allocator.h"
+#include "base/arena_containers.h"
+#include "base/os.h"
+#include "base/systrace.h"
+#include "base/unix_file/fd_file.h"
+#include "class_linker.h"
+#include "class_loader_utils.h"
+#include "compilation_kind.h"
+#include "gc/heap.h"
+#include "gc/space/image_space.h"
+#include "handle.h"
+#include "handle_scope-inl.h"
+#include "jit/jit_code_cache.h"
+#include "mirror/class-inl.h"
+#include "mirror/class_loader-inl.h"
+#include "mirror/object_array-inl.h"
+#include "oat/oat.h"
+#include "runtime.h"
+#include "thread-current-inl.h"
+#include "well_known_classes.h"
+
+namespace art HIDDEN {
+namespace jit {
+
+static constexpr std::array<uint8_t, 4> kMagic{{'j', 'p', 'c', '\n'}};
+static constexpr uint32_t kFormatVersion = 2;
+
+static size_t EntrySize(const JitPersistentCache::Entry& entry) {
+  return entry.code.size() + entry.stack_map.size();
+}
+
+static void WriteUint32(std::vector<uint8_t>* out, uint32_t value) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+  out->insert(out->end(), bytes, bytes + sizeof(value));
+}
+
+static void WriteBytes(std::vector<uint8_t>* out, const void* data, size_t size) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  out->insert(out->end(), bytes, bytes + size);
+}
+
+// Bounds-checked reader over the contents of the file.
+class Reader {
+ public:
+  explicit Reader(ArrayRef<const uint8_t> data) : data_(data), pos_(0u) {}
+
+  bool ReadBytes(void* out, size_t size) {
+    if (data_.size() - pos_ < size) {
+      return false;
+    }
+    memcpy(out, data_.data() + pos_, size);
+    pos_ += size;
+    return true;
+  }
+
+  bool ReadUint32(uint32_t* value) {
+    return ReadBytes(value, sizeof(*value));
+  }
+
+  bool ReadVector(size_t size, std::vector<uint8_t>* out) {
+    out->resize(size);
+    return ReadBytes(out->data(), size);
+  }
+
+  bool ReadString(std::string* out) {
+    uint32_t size;
+    if (!ReadUint32(&size) || data_.size() - pos_ < size) {
+      return false;
+    }
+    out->assign(reinterpret_cast<const char*>(data_.data() + pos_), size);
+    pos_ += size;
+    return true;
+  }
+
+  bool Done() const {
+    return pos_ == data_.size();
+  }
+
+ private:
+  const ArrayRef<const uint8_t> data_;
+  size_t pos_;
+};
+
+std::vector<uint8_t> JitPersistentCache::Serialize(const std::string& fingerprint,
+                                                   const EntryMap& entries) {
+  std::vector<uint8_t> out;
+  WriteBytes(&out, kMagic.data(), kMagic.size());
+  WriteUint32(&out, kFormatVersion);
+  WriteUint32(&out, fingerprint.size());
+  WriteBytes(&out, fingerprint.data(), fingerprint.size());
+  WriteUint32(&out, entries.size());
+  for (const auto& [key, entry] : entries) {
+    WriteBytes(&out, key.first.data(), key.first.size());
+    WriteUint32(&out, key.second);
+    WriteUint32(&out, entry.code.size());
+    WriteUint32(&out, entry.stack_map.size());
+    WriteUint32(&out, entry.initialized_classes.size());
+    for (const std::string& descriptor : entry.initialized_classes) {
+      WriteUint32(&out, descriptor.size());
+      WriteBytes(&out, descriptor.data(), descriptor.size());
+    }
+    WriteUint32(&out, entry.class_loader_checksums.size());
+    WriteBytes(&out, entry.class_loader_checksums.data(), entry.class_loader_checksums.size());
+    WriteBytes(&out, entry.code.data(), entry.code.size());
+    WriteBytes(&out, entry.stack_map.data(), entry.stack_map.size());
+  }
+  return out;
+}
+
+bool JitPersistentCache::Deserialize(ArrayRef<const uint8_t> data,
+                                     const std::string& fingerprint,
+                                     /*out*/ EntryMap* entries) {
+  Reader reader(data);
+  std::array<uint8_t, 4> magic;
+  uint32_t version;
+  std::string file_fingerprint;
+  if (!reader.ReadBytes(magic.data(), magic.size()) ||
+      magic != kMagic ||
+      !reader.ReadUint32(&version) ||
+      version != kFormatVersion ||
+      !reader.ReadString(&file_fingerprint) ||
+      file_fingerprint != fingerprint) {
+    return false;
+  }
+  uint32_t num_entries;
+  if (!reader.ReadUint32(&num_entries)) {
+    return false;
+  }
+  EntryMap result;
+  for (uint32_t i = 0; i != num_entries; ++i) {
+    Key key;
+    uint32_t code_size;
+    uint32_t stack_map_size;
+    uint32_t num_classes;
+    if (!reader.ReadBytes(key.first.data(), key.first.size()) ||
+        !reader.ReadUint32(&key.second) ||
+        !reader.ReadUint32(&code_size) ||
+        !reader.ReadUint32(&stack_map_size) ||
+        !reader.ReadUint32(&num_classes) ||
+        code_size == 0u ||
+        static_cast<size_t>(code_size) + stack_map_size > kMaxSize) {
+      return false;
+    }
+    Entry entry;
+    for (uint32_t j = 0; j != num_classes; ++j) {
+      std::string descriptor;
+      if (!reader.ReadString(&descriptor)) {
+        return false;
+      }
+      entry.initialized_classes.push_back(std::move(descriptor));
+    }
+    if (!reader.ReadString(&entry.class_loader_checksums) ||
+        !reader.ReadVector(code_size, &entry.code) ||
+        !reader.ReadVector(stack_map_size, &entry.stack_map)) {
+      return false;
+    }
+    result.emplace(key, std::move(entry));
+  }
+  if (!reader.Done()) {
+    return false;
+  }
+  *entries = std::move(result);
+  return true;
+}
+
+std::string JitPersistentCache::GetRuntimeFingerprint() {
+  Runtime* runtime = Runtime::Current();
+  std::ostringstream oss;
+  oss << "version=" << OatHeader::kOatVersion.data()
+      << ";isa=" << GetInstructionSetString(kRuntimeISA)
+      << ";bcp-checksums=" << runtime->GetBootClassPathChecksums()
+      << ";boot-image-begin=" << std::hex << runtime->GetHeap()->GetBootImagesStartAddress()
+      << std::dec
+      << ";read-barrier=" << gUseReadBarrier
+      << ";debuggable=" << runtime->IsJavaDebuggable()
+      << ";implicit-checks=" << runtime->GetImplicitNullChecks()
+      << runtime->GetImplicitStackOverflowChecks() << runtime->GetImplicitSuspendChecks()
+      << ";compiler-options=" << android::base::Join(runtime->GetCompilerOptions(), ' ')
+      << ";boot-image-checksums=" << std::hex;
+  for (gc::space::ImageSpace* space : runtime->GetHeap()->GetBootImageSpaces()) {
+    oss << space->GetImageHeader().GetImageChecksum() << ':';
+  }
+  return oss.str();
+}
+
+static bool AppendClassLoaderChecksums(Thread* self,
+                                       Handle<mirror::ClassLoader> class_loader,
+                                       /*inout*/ std::string* checksums)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (ClassLinker::IsBootClassLoader(class_loader.Get())) {
+    // The boot class path is covered by the runtime fingerprint.
+    return true;
+  }
+  if (!IsInstanceOfBaseDexClassLoader(class_loader)) {
+    return false;
+  }
+  *checksums += IsDelegateLastClassLoader(class_loader) ? "DLC[" : "PCL[";
+  StackHandleScope<3> hs(self);
+  MutableHandle<mirror::ClassLoader> temp_loader = hs.NewHandle<mirror::ClassLoader>(nullptr);
+  auto append_shared_libraries = [&](ArtField* field) REQUIRES_SHARED(Locks::mutator_lock_) {
+    ObjPtr<mirror::Object> raw_libraries = field->GetObject(class_loader.Get());
+    if (raw_libraries == nullptr) {
+      return true;
+    }
+    Handle<mirror::ObjectArray<mirror::ClassLoader>> libraries =
+        hs.NewHandle(raw_libraries->AsObjectArray<mirror::ClassLoader>());
+    *checksums += '{';
+    for (auto library : libraries.Iterate<mirror::ClassLoader>()) {
+      temp_loader.Assign(library);
+      if (!AppendClassLoaderChecksums(self, temp_loader, checksums)) {
+        return false;
+      }
+    }
+    *checksums += '}';
+    return true;
+  };
+  if (!append_shared_libraries(
+          WellKnownClasses::dalvik_system_BaseDexClassLoader_sharedLibraryLoaders)) {
+    return false;
+  }
+  VisitClassLoaderDexFiles(self, class_loader, [&](const DexFile* dex_file) {
+    *checksums += dex_file->GetSha1().ToString();
+    *checksums += ':';
+    return true;
+  });
+  *checksums += ']';
+  if (!append_shared_libraries(
+          WellKnownClasses::dalvik_system_BaseDexClassLoader_sharedLibraryLoadersAfter)) {
+    return false;
+  }
+  *checksums += ';';
+  temp_loader.Assign(class_loader->GetParent());
+  return AppendClassLoaderChecksums(self, temp_loader, checksums);
+}
+
+bool JitPersistentCache::GetClassLoaderChecksums(Thread* self,
+                                                 ObjPtr<mirror::ClassLoader> class_loader,
+                                                 /*out*/ std::string* checksums) {
+  StackHandleScope<1> hs(self);
+  checksums->clear();
+  return AppendClassLoaderChecksums(self, hs.NewHandle(class_loader), checksums);
+}
+
+const JitPersistentCache::Entry* JitPersistentCache::Lookup(
+    const EntryMap& entries, const Key& key, const std::string& class_loader_checksums) {
+  auto it = entries.find(key);
+  if (it == entries.end() || it->second.class_loader_checksums != class_loader_checksums) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+JitPersistentCache::EntryMap JitPersistentCache::SelectEntriesToSave(const EntryMap& recorded,
+                                                                    const EntryMap& loaded,
+                                                                    const std::set<Key>& used,
+                                                                    const std::set<Key>& stale,
+                                                                    size_t max_size,
+                                                                    /*out*/ size_t* evicted) {
+  EntryMap result = recorded;
+  size_t size = 0u;
+  for (const auto& [key, entry] : recorded) {
+    size += EntrySize(entry);
+  }
+  *evicted = 0u;
+  auto add_loaded = [&](bool want_used) {
+    for (const auto& [key, entry] : loaded) {
+      if ((used.find(key) != used.end()) != want_used ||
+          stale.find(key) != stale.end() ||
+          result.find(key) != result.end()) {
+        continue;
+      }
+      if (size + EntrySize(entry) > max_size) {
+        ++*evicted;
+        continue;
+      }
+      size += EntrySize(entry);
+      result.emplace(key, entry);
+    }
+  };
+  add_loaded(/*want_used=*/ true);
+  add_loaded(/*want_used=*/ false);
+  return result;
+}
+
+std::unique_ptr<JitPersistentCache> JitPersistentCache::Create(const std::string& path) {
+  ScopedTrace trace("Load JIT persistent cache");
+  std::string fingerprint = GetRuntimeFingerprint();
+  EntryMap entries;
+  std::unique_ptr<File> file(OS::OpenFileForReading(path.c_str()));
+  if (file != nullptr) {
+    int64_t length = file->GetLength();
+    std::vector<uint8_t> data(std::max<int64_t>(length, 0));
+    if (length < 0 || !file->ReadFully(data.data(), data.size())) {
+      LOG(WARNING) << "Could not read JIT persistent cache " << path;
+    } else if (!Deserialize(ArrayRef<const uint8_t>(data), fingerprint, &entries)) {
+      VLOG(jit) << "Ignoring stale or corrupt JIT persistent cache " << path;
+    }
+  }
+  VLOG(jit) << "Loaded " << entries.size() << " methods from JIT persistent cache " << path;
+  return std::unique_ptr<JitPersistentCache>(
+      new JitPersistentCache(path, fingerprint, std::move(entries)));
+}
+
+JitPersistentCache::JitPersistentCache(const std::string& path,
+                                       const std::string& fingerprint,
+                                       EntryMap&& loaded)
+    : path_(path),
+      fingerprint_(fingerprint),
+      loaded_(std::move(loaded)),
+      loaded_size_(0u),
+      lock_("JIT persistent cache lock", kGenericBottomLock),
+      recorded_size_(0u),
+      dirty_(false),
+      evicted_(0u),
+      installed_(0u),
+      rejected_(0u) {
+  for (const auto& [key, entry] : loaded_) {
+    loaded_size_ += EntrySize(entry);
+  }
+}
+
+bool JitPersistentCache::Install(Thread* self,
+                                 JitCodeCache* code_cache,
+                                 JitMemoryRegion* region,
+                                 ArtMethod* method) {
+  if (loaded_.empty() || method->IsNative()) {
+    return false;
+  }
+  const Key key(method->GetDexFile()->GetSha1(), method->GetDexMethodIndex());
+  if (loaded_.find(key) == loaded_.end()) {
+    return false;
+  }
+  // Field offsets, vtable indexes and type checks of classes from other dex files of the class
+  // loader chain may be compiled into the code, so they must not have changed.
+  std::string class_loader_checksums;
+  const Entry* found = nullptr;
+  if (GetClassLoaderChecksums(self, method->GetClassLoader(), &class_loader_checksums)) {
+    found = Lookup(loaded_, key, class_loader_checksums);
+  }
+  if (found == nullptr) {
+    VLOG(jit) << "Not installing persisted code of " << method->PrettyMethod()
+              << ": class loader chain changed";
+    rejected_.fetch_add(1u, std::memory_order_relaxed);
+    MutexLock mu(self, lock_);
+    stale_.insert(key);
+    dirty_ = true;
+    return false;
+  }
+  const Entry& entry = *found;
+
+  // The code skips the initialization checks of these classes. If one of them is not initialized
+  // yet in this process, compile the method normally instead.
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  ObjPtr<mirror::ClassLoader> class_loader = method->GetClassLoader();
+  for (const std::string& descriptor : entry.initialized_classes) {
+    ObjPtr<mirror::Class> klass = class_linker->LookupClass(self, descriptor.c_str(), class_loader);
+    if (klass == nullptr && class_loader != nullptr) {
+      klass = class_linker->LookupClass(self, descriptor.c_str(), /*class_loader=*/ nullptr);
+    }
+    if (klass == nullptr || !klass->IsInitialized()) {
+      VLOG(jit) << "Not installing persisted code of " << method->PrettyMethod()
+                << ": " << descriptor << " is not initialized";
+      rejected_.fetch_add(1u, std::memory_order_relaxed);
+      return false;
+    }
+  }
+
+  ArrayRef<const uint8_t> reserved_code;
+  ArrayRef<const uint8_t> reserved_data;
+  if (!code_cache->Reserve(self,
+                           region,
+                           entry.code.size(),
+                           entry.stack_map.size(),
+                           /*number_of_roots=*/ 0u,
+                           method,
+                           &reserved_code,
+                           &reserved_data)) {
+    return false;
+  }
+  ArenaAllocator allocator(Runtime::Current()->GetJitArenaPool());
+  ArenaSet<ArtMethod*> cha_single_implementation_list(allocator.Adapter(kArenaAllocCHA));
+  if (!code_cache->Commit(self,
+                          region,
+                          method,
+                          reserved_code,
+                          ArrayRef<const uint8_t>(entry.code),
+                          reserved_data,
+                          /*roots=*/ {},
+                          ArrayRef<const uint8_t>(entry.stack_map),
+                          /*debug_info=*/ {},
+                          /*is_full_debug_info=*/ false,
+                          CompilationKind::kOptimized,
+                          cha_single_implementation_list)) {
+    code_cache->Free(self, region, reserved_code.data(), reserved_data.data());
+    return false;
+  }
+  VLOG(jit) << "Installed persisted code of " << method->PrettyMethod();
+  installed_.fetch_add(1u, std::memory_order_relaxed);
+  MutexLock mu(self, lock_);
+  used_.insert(key);
+  return true;
+}
+
+void JitPersistentCache::Record(ArtMethod* method,
+                                ArrayRef<const uint8_t> code,
+                                ArrayRef<const uint8_t> stack_map,
+                                std::vector<std::string>&& initialized_classes) {
+  Thread* self = Thread::Current();
+  Key key(method->GetDexFile()->GetSha1(), method->GetDexMethodIndex());
+  Entry entry;
+  if (code.size() + stack_map.size() > kMaxSize ||
+      !GetClassLoaderChecksums(self, method->GetClassLoader(), &entry.class_loader_checksums)) {
+    return;
+  }
+  entry.code.assign(code.begin(), code.end());
+  entry.stack_map.assign(stack_map.begin(), stack_map.end());
+  entry.initialized_classes = std::move(initialized_classes);
+  MutexLock mu(self, lock_);
+  auto it = recorded_.find(key);
+  if (it != recorded_.end()) {
+    recorded_size_ -= EntrySize(it->second);
+    recorded_order_.erase(std::find(recorded_order_.begin(), recorded_order_.end(), key));
+  }
+  recorded_size_ += EntrySize(entry);
+  recorded_.insert_or_assign(key, std::move(entry));
+  recorded_order_.push_back(key);
+  // Evict the oldest recorded entries. Loaded entries are evicted by Save().
+  while (recorded_size_ > kMaxSize) {
+    auto oldest = recorded_.find(recorded_order_.front());
+    recorded_size_ -= EntrySize(oldest->second);
+    recorded_.erase(oldest);
+    recorded_order_.pop_front();
+    ++evicted_;
+  }
+  dirty_ = true;
+}
+
+void JitPersistentCache::Save() {
+  ScopedTrace trace("Save JIT persistent cache");
+  std::vector<uint8_t> data;
+  size_t num_entries;
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    if (!dirty_) {
+      return;
+    }
+    // Newly compiled code replaces what was loaded for the same method.
+    size_t evicted;
+    EntryMap entries =
+        SelectEntriesToSave(recorded_, loaded_, used_, stale_, kMaxSize, &evicted);
+    evicted_ += evicted;
+    data = Serialize(fingerprint_, entries);
+    num_entries = entries.size();
+    dirty_ = false;
+  }
+
+  // Write to a temporary file first so that a concurrent reader never sees a partial file.
+  const std::string temp_path = path_ + "." + std::to_string(getpid()) + ".tmp";
+  std::unique_ptr<File> file(OS::CreateEmptyFileWriteOnly(temp_path.c_str()));
+  if (file == nullptr) {
+    LOG(WARNING) << "Could not create JIT persistent cache " << temp_path;
+    return;
+  }
+  if (!file->WriteFully(data.data(), data.size())) {
+    LOG(WARNING) << "Could not write JIT persistent cache " << temp_path;
+    file->Erase(/*unlink=*/ true);
+    return;
+  }
+  if (file->FlushCloseOrErase() != 0) {
+    LOG(WARNING) << "Could not flush JIT persistent cache " << temp_path;
+    unlink(temp_path.c_str());
+    return;
+  }
+  if (rename(temp_path.c_str(), path_.c_str()) != 0) {
+    PLOG(WARNING) << "Could not move JIT persistent cache to " << path_;
+    unlink(temp_path.c_str());
+    return;
+  }
+  VLOG(jit) << "Saved " << num_entries << " methods to JIT persistent cache " << path_;
+}
+
+void JitPersistentCache::DumpInfo(std::ostream& os) {
+  MutexLock mu(Thread::Current(), lock_);
+  os << "JIT persistent cache: loaded=" << loaded_.size()
+     << " installed=" << installed_.load(std::memory_order_relaxed)
+     << " rejected=" << rejected_.load(std::memory_order_relaxed)
+     << " recorded=" << recorded_.size()
+     << " evicted=" << evicted_
+     << " size=" << PrettySize(loaded_size_ + recorded_size_) << "\n";
+}
+
+}  // namespace jit
+}  // namespace art
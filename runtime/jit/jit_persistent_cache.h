@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_JIT_PERSISTENT_CACHE_H_
+#define ART_RUNTIME_JIT_JIT_PERSISTENT_CACHE_H_
+
+#include <deque>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/array_ref.h"
+#include "base/atomic.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "dex/dex_file.h"
+#include "obj_ptr.h"
+
+namespace art HIDDEN {
+
+class ArtMethod;
+class Thread;
+
+namespace mirror {
+class ClassLoader;
+}  // namespace mirror
+
+namespace jit {
+
+class JitCodeCache;
+class JitMemoryRegion;
+
+// Keeps optimized JIT code across runs of a process, for processes which are too short-lived to
+// benefit from the profile and a later dex2oat run.
+//
+// Only code which does not depend on anything allocated by the process that compiled it is
+// recorded: no JIT roots, no CHA assumptions, no inline caches, and only boot image methods and
+// classes embedded in the code or its stack maps. The compiler decides which code qualifies and
+// reports it through Record(). Such code stays valid as long as the dex file, the dex files of
+// its class loader chain (which decide field offsets, vtable indexes and type checks compiled
+// into the code) and everything captured by GetRuntimeFingerprint() (runtime version, boot image
+// checksums, instruction set features, compiler options) are unchanged. The fingerprint is checked
+// for the whole file, the class loader checksums for each entry.
+//
+// The file is read when the JIT is created, and its methods are installed in the code cache when
+// the JIT would otherwise compile them, because the ArtMethods are only known once their classes
+// are loaded.
+class JitPersistentCache {
+ public:
+  // Code and metadata of one compiled method.
+  struct Entry {
+    std::vector<uint8_t> code;
+    std::vector<uint8_t> stack_map;
+    // Descriptors of the classes the code assumes to be initialized.
+    std::vector<std::string> initialized_classes;
+    // Checksums of the class loader chain of the method, see GetClassLoaderChecksums().
+    std::string class_loader_checksums;
+  };
+
+  // Signature of the dex file and index of the method in it.
+  using Key = std::pair<DexFile::Sha1, uint32_t>;
+  using EntryMap = std::map<Key, Entry>;
+
+  // Bound on the total size of code and stack maps kept in the cache. Once it is reached, entries
+  // are evicted, see Record() and SelectEntriesToSave().
+  static constexpr size_t kMaxSize = 8 * MB;
+
+  // Load the cache stored at `path`. A missing, corrupt or stale file is not an error; the cache
+  // then starts empty and the file is replaced on the next Save().
+  static std::unique_ptr<JitPersistentCache> Create(const std::string& path);
+
+  // Install the persisted code of `method` in `code_cache`, if any. Returns whether `method` now
+  // has optimized code.
+  bool Install(Thread* self, JitCodeCache* code_cache, JitMemoryRegion* region, ArtMethod* method)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!lock_);
+
+  // Record code that the JIT has just committed for `method`, to be written by the next Save().
+  // If the entries recorded by this process exceed kMaxSize, the oldest ones are evicted.
+  EXPORT void Record(ArtMethod* method,
+                     ArrayRef<const uint8_t> code,
+                     ArrayRef<const uint8_t> stack_map,
+                     std::vector<std::string>&& initialized_classes)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!lock_);
+
+  // Write the loaded and recorded entries back to the file if anything was recorded since the
+  // last save.
+  void Save() REQUIRES(!lock_);
+
+  void DumpInfo(std::ostream& os) REQUIRES(!lock_);
+
+  // Describes the runtime state that persisted code depends on.
+  static std::string GetRuntimeFingerprint();
+
+  // Describes the dex files of `class_loader`, its shared libraries and its parents, in lookup
+  // order. Returns false if the chain contains a class loader that is not a BaseDexClassLoader,
+  // whose dex files cannot be known.
+  static bool GetClassLoaderChecksums(Thread* self,
+                                      ObjPtr<mirror::ClassLoader> class_loader,
+                                      /*out*/ std::string* checksums)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Returns the entry for `key` if it was compiled with the same class loader chain, or null.
+  static const Entry* Lookup(const EntryMap& entries,
+                             const Key& key,
+                             const std::string& class_loader_checksums);
+
+  // Returns the entries to write to the file: all `recorded` ones, which replace loaded entries
+  // for the same method, then the `loaded` ones that were `used` by this process, then the other
+  // loaded ones, as long as the total size stays within `max_size`. Loaded entries that do not fit
+  // are evicted and counted in `evicted`. `stale` loaded entries are dropped.
+  static EntryMap SelectEntriesToSave(const EntryMap& recorded,
+                                      const EntryMap& loaded,
+                                      const std::set<Key>& used,
+                                      const std::set<Key>& stale,
+                                      size_t max_size,
+                                      /*out*/ size_t* evicted);
+
+  // File format, exposed for testing.
+  static std::vector<uint8_t> Serialize(const std::string& fingerprint, const EntryMap& entries);
+  static bool Deserialize(ArrayRef<const uint8_t> data,
+                          const std::string& fingerprint,
+                          /*out*/ EntryMap* entries);
+
+ private:
+  JitPersistentCache(const std::string& path, const std::string& fingerprint, EntryMap&& loaded);
+
+  const std::string path_;
+  const std::string fingerprint_;
+
+  // Entries read from the file. Not modified after construction, so Install() can read them
+  // without locking.
+  const EntryMap loaded_;
+  size_t loaded_size_;
+
+  Mutex lock_;
+  // Entries compiled by this process, and their keys from oldest to newest.
+  EntryMap recorded_ GUARDED_BY(lock_);
+  std::deque<Key> recorded_order_ GUARDED_BY(lock_);
+  size_t recorded_size_ GUARDED_BY(lock_);
+  // Loaded entries installed by this process. They are kept in preference to the other ones.
+  std::set<Key> used_ GUARDED_BY(lock_);
+  // Loaded entries compiled for another class loader chain. They are dropped on the next Save().
+  std::set<Key> stale_ GUARDED_BY(lock_);
+  bool dirty_ GUARDED_BY(lock_);
+  size_t evicted_ GUARDED_BY(lock_);
+
+  Atomic<uint32_t> installed_;
+  Atomic<uint32_t> rejected_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitPersistentCache);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_JIT_PERSISTENT_CACHE_H_
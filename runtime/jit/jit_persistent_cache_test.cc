@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit/jit_persistent_cache.h"
+
+#include "common_runtime_test.h"
+#include "mirror/class_loader.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art HIDDEN {
+namespace jit {
+
+class JitPersistentCacheTest : public CommonRuntimeTest {
+ protected:
+  std::string GetChecksums(jobject class_loader) {
+    ScopedObjectAccess soa(Thread::Current());
+    std::string checksums;
+    EXPECT_TRUE(JitPersistentCache::GetClassLoaderChecksums(
+        soa.Self(), soa.Decode<mirror::ClassLoader>(class_loader), &checksums));
+    return checksums;
+  }
+};
+
+static JitPersistentCache::EntryMap MakeEntries() {
+  JitPersistentCache::EntryMap entries;
+  DexFile::Sha1 sha1 = {};
+  sha1[0] = 0x12;
+  sha1[19] = 0x34;
+  JitPersistentCache::Entry first;
+  first.code = {0x01, 0x02, 0x03, 0x04};
+  first.stack_map = {0x05, 0x06};
+  first.initialized_classes = {"Ljava/lang/String;", "LMain;"};
+  first.class_loader_checksums = "PCL[0123:];";
+  entries.emplace(JitPersistentCache::Key(sha1, 7u), std::move(first));
+  JitPersistentCache::Entry second;
+  second.code = {0xff};
+  entries.emplace(JitPersistentCache::Key(sha1, 42u), std::move(second));
+  return entries;
+}
+
+static void ExpectEqual(const JitPersistentCache::EntryMap& expected,
+                        const JitPersistentCache::EntryMap& actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (const auto& [key, entry] : expected) {
+    auto it = actual.find(key);
+    ASSERT_TRUE(it != actual.end());
+    EXPECT_EQ(entry.code, it->second.code);
+    EXPECT_EQ(entry.stack_map, it->second.stack_map);
+    EXPECT_EQ(entry.initialized_classes, it->second.initialized_classes);
+    EXPECT_EQ(entry.class_loader_checksums, it->second.class_loader_checksums);
+  }
+}
+
+TEST_F(JitPersistentCacheTest, RoundTrip) {
+  JitPersistentCache::EntryMap entries = MakeEntries();
+  std::vector<uint8_t> data = JitPersistentCache::Serialize("fingerprint", entries);
+  JitPersistentCache::EntryMap loaded;
+  ASSERT_TRUE(JitPersistentCache::Deserialize(ArrayRef<const uint8_t>(data),
+                                              "fingerprint",
+                                              &loaded));
+  ExpectEqual(entries, loaded);
+}
+
+TEST_F(JitPersistentCacheTest, RejectsOtherRuntime) {
+  std::vector<uint8_t> data = JitPersistentCache::Serialize("fingerprint", MakeEntries());
+  JitPersistentCache::EntryMap loaded;
+  EXPECT_FALSE(JitPersistentCache::Deserialize(ArrayRef<const uint8_t>(data),
+                                               "other fingerprint",
+                                               &loaded));
+  EXPECT_TRUE(loaded.empty());
+}
+
+TEST_F(JitPersistentCacheTest, RejectsTruncatedFile) {
+  std::vector<uint8_t> data = JitPersistentCache::Serialize("fingerprint", MakeEntries());
+  for (size_t size = 0; size < data.size(); ++size) {
+    JitPersistentCache::EntryMap loaded;
+    EXPECT_FALSE(JitPersistentCache::Deserialize(ArrayRef<const uint8_t>(data.data(), size),
+                                                 "fingerprint",
+                                                 &loaded)) << size;
+    EXPECT_TRUE(loaded.empty());
+  }
+  data.push_back(0u);
+  JitPersistentCache::EntryMap loaded;
+  EXPECT_FALSE(JitPersistentCache::Deserialize(ArrayRef<const uint8_t>(data),
+                                               "fingerprint",
+                                               &loaded));
+}
+
+TEST_F(JitPersistentCacheTest, RejectsChangedClassLoaderChain) {
+  jobject parent = LoadDexInPathClassLoader("MyClass", nullptr);
+  jobject class_loader = LoadDexInPathClassLoader("MultiDex", parent);
+  // Same dex files for the method's own class loader, but a dependency in the parent changed.
+  jobject other_parent = LoadDexInPathClassLoader("Nested", nullptr);
+  jobject other_class_loader = LoadDexInPathClassLoader("MultiDex", other_parent);
+  std::string checksums = GetChecksums(class_loader);
+  std::string other_checksums = GetChecksums(other_class_loader);
+  EXPECT_EQ(checksums, GetChecksums(class_loader));
+  EXPECT_NE(checksums, other_checksums);
+  EXPECT_NE(checksums, GetChecksums(parent));
+
+  JitPersistentCache::EntryMap entries = MakeEntries();
+  const JitPersistentCache::Key key = entries.begin()->first;
+  entries.begin()->second.class_loader_checksums = checksums;
+  std::vector<uint8_t> data = JitPersistentCache::Serialize("fingerprint", entries);
+  JitPersistentCache::EntryMap loaded;
+  ASSERT_TRUE(JitPersistentCache::Deserialize(ArrayRef<const uint8_t>(data),
+                                              "fingerprint",
+                                              &loaded));
+  EXPECT_NE(nullptr, JitPersistentCache::Lookup(loaded, key, checksums));
+  EXPECT_EQ(nullptr, JitPersistentCache::Lookup(loaded, key, other_checksums));
+}
+
+TEST_F(JitPersistentCacheTest, EvictsUnusedEntries) {
+  DexFile::Sha1 sha1 = {};
+  auto make_entry = [](size_t size) {
+    JitPersistentCache::Entry entry;
+    entry.code.resize(size, 0x01);
+    return entry;
+  };
+  JitPersistentCache::EntryMap loaded;
+  loaded.emplace(JitPersistentCache::Key(sha1, 1u), make_entry(40u));
+  loaded.emplace(JitPersistentCache::Key(sha1, 2u), make_entry(40u));
+  loaded.emplace(JitPersistentCache::Key(sha1, 3u), make_entry(40u));
+  JitPersistentCache::EntryMap recorded;
+  recorded.emplace(JitPersistentCache::Key(sha1, 4u), make_entry(30u));
+  // Recompiled in this run: the recorded code replaces the loaded one.
+  recorded.emplace(JitPersistentCache::Key(sha1, 3u), make_entry(10u));
+  std::set<JitPersistentCache::Key> used = {JitPersistentCache::Key(sha1, 2u)};
+
+  size_t evicted;
+  JitPersistentCache::EntryMap result =
+      JitPersistentCache::SelectEntriesToSave(recorded, loaded, used, {}, 100u, &evicted);
+  ASSERT_EQ(3u, result.size());
+  EXPECT_EQ(1u, evicted);
+  EXPECT_EQ(10u, result.at(JitPersistentCache::Key(sha1, 3u)).code.size());
+  EXPECT_TRUE(result.find(JitPersistentCache::Key(sha1, 2u)) != result.end());
+  EXPECT_TRUE(result.find(JitPersistentCache::Key(sha1, 4u)) != result.end());
+  // Without a size limit, only stale entries are dropped.
+  std::set<JitPersistentCache::Key> stale = {JitPersistentCache::Key(sha1, 1u)};
+  result = JitPersistentCache::SelectEntriesToSave(recorded, loaded, used, stale, 1000u, &evicted);
+  EXPECT_EQ(3u, result.size());
+  EXPECT_EQ(0u, evicted);
+  EXPECT_TRUE(result.find(JitPersistentCache::Key(sha1, 1u)) == result.end());
+}
+
+}  // namespace jit
+}  // namespace art
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_sampler.h"
+
+#include <iterator>
+#include <list>
+#include <ostream>
+
+#include <android-base/logging.h>
+
+#include "art_method-inl.h"
+#include "barrier.h"
+#include "base/logging.h"  // For VLOG.
+#include "base/systrace.h"
+#include "oat/oat_quick_method_header.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "stack.h"
+#include "thread-current-inl.h"
+#include "thread_list.h"
+
+namespace art HIDDEN {
+namespace jit {
+
+// Number of threads sampled per interval. Each sample interrupts a running thread, so the cost
+// of an interval stays the same however many threads the application has.
+static constexpr size_t kMaxThreadsPerSample = 4;
+
+// Bound on the number of methods tracked by the sampler.
+static constexpr size_t kMaxSampledMethods = 1024;
+
+class SampleClosure final : public Closure {
+ public:
+  SampleClosure(JitSampler* sampler, Barrier* barrier) : sampler_(sampler), barrier_(barrier) {}
+
+  void Run(Thread* thread) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    // Checkpoints are only requested from runnable threads, which run them themselves.
+    DCHECK_EQ(thread, Thread::Current());
+    sampler_->SampleStack(thread);
+    barrier_->Pass(thread);
+  }
+
+ private:
+  JitSampler* const sampler_;
+  Barrier* const barrier_;
+};
+
+JitSampler::JitSampler(uint32_t interval_us, uint16_t sample_weight, uint16_t sample_threshold)
+    : interval_us_(interval_us),
+      sample_weight_(sample_weight),
+      sample_threshold_(sample_threshold),
+      sampler_pthread_(0U),
+      next_thread_index_(0u),
+      samples_lock_("JitSampler samples lock", kGenericBottomLock),
+      lock_("JitSampler lock"),
+      shutdown_cond_("JitSampler shutdown condition", lock_),
+      shutting_down_(false),
+      rounds_(0u),
+      interpreted_samples_(0u) {}
+
+std::unique_ptr<JitSampler> JitSampler::Create(uint32_t interval_us,
+                                               uint16_t sample_weight,
+                                               uint16_t sample_threshold) {
+  DCHECK_NE(interval_us, 0u);
+  DCHECK_NE(sample_weight, 0u);
+  std::unique_ptr<JitSampler> sampler(
+      new JitSampler(interval_us, sample_weight, sample_threshold));
+  CHECK_PTHREAD_CALL(
+      pthread_create,
+      (&sampler->sampler_pthread_, nullptr, &RunSamplerThread, sampler.get()),
+      "JIT sampler thread");
+  VLOG(jit) << "Started JIT sampler with interval=" << interval_us << "us"
+            << ", weight=" << sample_weight;
+  return sampler;
+}
+
+JitSampler::~JitSampler() {
+  Stop();
+}
+
+void* JitSampler::RunSamplerThread(void* arg) {
+  Runtime* runtime = Runtime::Current();
+  bool attached = runtime->AttachCurrentThread("Jit sampler",
+                                               /*as_daemon=*/ true,
+                                               /*thread_group=*/ nullptr,
+                                               /*create_peer=*/ false);
+  if (!attached) {
+    CHECK(runtime->IsShuttingDown(Thread::Current()));
+    return nullptr;
+  }
+  reinterpret_cast<JitSampler*>(arg)->Run();
+  runtime->DetachCurrentThread();
+  return nullptr;
+}
+
+void JitSampler::Run() {
+  Thread* self = Thread::Current();
+  while (true) {
+    {
+      MutexLock mu(self, lock_);
+      if (!shutting_down_) {
+        shutdown_cond_.TimedWait(self, interval_us_ / 1000, (interval_us_ % 1000) * 1000);
+      }
+      if (shutting_down_) {
+        break;
+      }
+    }
+    TakeSample(self);
+  }
+}
+
+void JitSampler::TakeSample(Thread* self) {
+  ScopedTrace trace(__PRETTY_FUNCTION__);
+  Barrier barrier(0);
+  SampleClosure closure(this, &barrier);
+  size_t threads_running_checkpoint = 0;
+  {
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    std::list<Thread*> threads = Runtime::Current()->GetThreadList()->GetList();
+    MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
+    // Start where the previous interval stopped, so that all threads get sampled in turn.
+    auto it = threads.begin();
+    std::advance(it, next_thread_index_ < threads.size() ? next_thread_index_ : 0u);
+    for (size_t visited = 0;
+         visited != threads.size() && threads_running_checkpoint != kMaxThreadsPerSample;
+         ++visited) {
+      if (it == threads.end()) {
+        it = threads.begin();
+      }
+      Thread* thread = *it;
+      ++it;
+      // This fails for threads which are not runnable, and thus not running managed code.
+      if (thread != self && thread->RequestCheckpoint(&closure)) {
+        ++threads_running_checkpoint;
+      }
+    }
+    next_thread_index_ = std::distance(threads.begin(), it);
+  }
+  // Wait for the threads to run the checkpoint, as `closure` lives on this stack.
+  if (threads_running_checkpoint != 0) {
+    ScopedThreadStateChange tsc(self, ThreadState::kWaitingForCheckPointsToRun);
+    barrier.Increment(self, threads_running_checkpoint);
+  }
+  rounds_.fetch_add(1u, std::memory_order_relaxed);
+}
+
+void JitSampler::SampleStack(Thread* thread) {
+  DCHECK_EQ(thread, Thread::Current());
+  StackVisitor::WalkStack(
+      [&](const art::StackVisitor* stack_visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+        ArtMethod* method = stack_visitor->GetMethod();
+        if (method == nullptr || method->IsRuntimeMethod()) {
+          return true;
+        }
+        // Only the innermost managed frame is sampled. Compiled and native methods have nothing
+        // to gain from their counter; their callers get their own samples once they return.
+        const OatQuickMethodHeader* method_header =
+            stack_visitor->GetCurrentOatQuickMethodHeader();
+        bool is_interpreted = stack_visitor->GetCurrentShadowFrame() != nullptr ||
+            (method_header != nullptr && method_header->IsNterpMethodHeader());
+        if (is_interpreted && !method->IsNative() && !method->IsMemorySharedMethod()) {
+          AddSample(thread, method);
+          interpreted_samples_.fetch_add(1u, std::memory_order_relaxed);
+        }
+        return false;
+      },
+      thread,
+      /* context= */ nullptr,
+      art::StackVisitor::StackWalkKind::kSkipInlinedFrames);
+}
+
+void JitSampler::AddSample(Thread* self, ArtMethod* method) {
+  if (method->CounterIsHot()) {
+    // Already hot, the interpreter has not checked the counter yet.
+    return;
+  }
+  MutexLock mu(self, samples_lock_);
+  if (method_samples_.size() == kMaxSampledMethods &&
+      method_samples_.find(method) == method_samples_.end()) {
+    method_samples_.clear();
+  }
+  uint32_t& weight = method_samples_[method];
+  weight += sample_weight_;
+  if (weight >= sample_threshold_) {
+    method_samples_.erase(method);
+    method->SetHotCounter();
+  }
+}
+
+void JitSampler::Stop() {
+  Thread* self = Thread::Current();
+  {
+    MutexLock mu(self, lock_);
+    shutting_down_ = true;
+    shutdown_cond_.Signal(self);
+  }
+  CHECK_PTHREAD_CALL(pthread_join, (sampler_pthread_, nullptr), "JIT sampler thread shutdown");
+  VLOG(jit) << "Stopped JIT sampler";
+}
+
+void JitSampler::DumpInfo(std::ostream& os) {
+  os << "JIT sampler rounds=" << rounds_.load(std::memory_order_relaxed)
+     << " interpreted samples=" << interpreted_samples_.load(std::memory_order_relaxed) << "\n";
+}
+
+}  // namespace jit
+}  // namespace art
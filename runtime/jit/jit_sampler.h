@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_JIT_SAMPLER_H_
+#define ART_RUNTIME_JIT_JIT_SAMPLER_H_
+
+#include <pthread.h>
+
+#include <iosfwd>
+#include <memory>
+#include <unordered_map>
+
+#include "base/atomic.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art HIDDEN {
+
+class ArtMethod;
+class Thread;
+
+namespace jit {
+
+// Finds hot interpreted methods by sampling the threads which are running managed code, rather
+// than relying on the counters the interpreter updates on every method entry and back-edge.
+//
+// A daemon thread wakes up every sampling interval and requests a checkpoint on a few runnable
+// threads, taken in turns. Suspended threads are left alone: they are not running managed code.
+// If the method on top of the stack of a sampled thread is interpreted, it is credited with the
+// sample weight. Methods where the application spends its time therefore reach the sample
+// threshold after a handful of samples, regardless of how many times they are invoked. Their
+// hotness counter is then set to hot, so that the interpreter hands them to the JIT the next time
+// it checks it, on entry or on a back-edge (which also allows OSR). This is the only way a counter
+// gets hot while sampling: the interpreter leaves counters parked, see `kNterpHotnessParkedValue`.
+class JitSampler {
+ public:
+  // Start a thread sampling every `interval_us` microseconds. Methods get hot once their samples
+  // add up to `sample_threshold`.
+  static std::unique_ptr<JitSampler> Create(uint32_t interval_us,
+                                            uint16_t sample_weight,
+                                            uint16_t sample_threshold);
+
+  // Stops and joins the sampling thread.
+  ~JitSampler();
+
+  void DumpInfo(std::ostream& os);
+
+  // Attribute a sample to the method on top of the managed stack of `thread`, the current thread.
+  void SampleStack(Thread* thread) REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!samples_lock_);
+
+ private:
+  JitSampler(uint32_t interval_us, uint16_t sample_weight, uint16_t sample_threshold);
+
+  static void* RunSamplerThread(void* arg);
+  void Run() REQUIRES(!lock_);
+  void TakeSample(Thread* self) REQUIRES(!Locks::thread_list_lock_);
+  void AddSample(Thread* self, ArtMethod* method)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!samples_lock_);
+  void Stop() REQUIRES(!lock_);
+
+  const uint32_t interval_us_;
+  const uint16_t sample_weight_;
+  const uint16_t sample_threshold_;
+  pthread_t sampler_pthread_;
+
+  // Position in the thread list of the next thread to sample. Only used by the sampler thread.
+  size_t next_thread_index_;
+
+  // Sample weights of the methods which are not hot yet. Entries are not removed when classes are
+  // unloaded; the map is bounded and cleared when full, at the cost of losing some samples.
+  Mutex samples_lock_ BOTTOM_MUTEX_ACQUIRED_AFTER;
+  std::unordered_map<ArtMethod*, uint32_t> method_samples_ GUARDED_BY(samples_lock_);
+
+  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  ConditionVariable shutdown_cond_ GUARDED_BY(lock_);
+  bool shutting_down_ GUARDED_BY(lock_);
+
+  // Number of checkpoints run, and of the samples taken by them which found an interpreted
+  // method.
+  Atomic<uint64_t> rounds_;
+  Atomic<uint64_t> interpreted_samples_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitSampler);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_JIT_SAMPLER_H_
@@ -26,6 +26,7 @@
 #include "art_method-inl.h"
 #include "base/compiler_filter.h"
 #include "base/logging.h"  // For VLOG.
+#include "base/os.h"
 #include "base/pointer_size.h"
 #include "base/scoped_arena_containers.h"
 #include "base/stl_util.h"
@@ -105,6 +106,9 @@ ProfileSaver::~ProfileSaver() {
   for (auto& it : profile_cache_) {
     delete it.second;
   }
+  for (auto& it : last_delta_infos_) {
+    delete it.second;
+  }
 }
 
 void ProfileSaver::NotifyStartupCompleted() {
@@ -804,6 +808,12 @@ bool ProfileSaver::ProcessProfilingInfo(bool force_save, /*out*/uint16_t* number
           locations, profile_methods, options_.GetInlineCacheThreshold());
       total_number_of_code_cache_queries_++;
     }
+    if (options_.GetDeltaLogMaxBytes() != ProfileSaverOptions::kDeltaLogDisabled) {
+      if (SaveProfileDelta(filename, profile_methods, force_save, number_of_new_methods)) {
+        profile_file_saved = true;
+      }
+      continue;
+    }
     {
       ProfileCompilationInfo info(Runtime::Current()->GetArenaPool(),
                                   /*for_boot_image=*/options_.GetProfileBootClassPath());
@@ -908,6 +918,110 @@ bool ProfileSaver::ProcessProfilingInfo(bool force_save, /*out*/uint16_t* number
   return profile_file_saved;
 }
 
+bool ProfileSaver::SaveProfileDelta(const std::string& filename,
+                                    const std::vector<ProfileMethodInfo>& profile_methods,
+                                    bool force_save,
+                                    /*out*/uint16_t* number_of_new_methods) {
+  ProfileCompilationInfo info(Runtime::Current()->GetArenaPool(),
+                              /*for_boot_image=*/options_.GetProfileBootClassPath());
+  if (!info.AddMethods(
+          profile_methods,
+          AnnotateSampleFlags(Hotness::kFlagHot | Hotness::kFlagPostStartup),
+          GetProfileSampleAnnotation())) {
+    LOG(WARNING) << "Could not add methods to the profile delta of " << filename;
+    return false;
+  }
+
+  MutexLock mu(Thread::Current(), *Locks::profiler_lock_);
+  // Unlike when rewriting the profile, the cached startup data is kept after a save, so
+  // that what this process has profiled only grows from one delta to the next.
+  auto profile_cache_it = profile_cache_.find(filename);
+  if (profile_cache_it != profile_cache_.end() && !info.MergeWith(*(profile_cache_it->second))) {
+    LOG(WARNING) << "Could not merge the cached profile into the profile delta of " << filename;
+    return false;
+  }
+
+  // Only append what this process has profiled since its last save, rather than what is
+  // missing from the data on disk, which we do not want to load.
+  ProfileCompilationInfo delta(Runtime::Current()->GetArenaPool(),
+                               /*for_boot_image=*/options_.GetProfileBootClassPath());
+  if (!delta.MergeWith(info)) {
+    LOG(WARNING) << "Could not create the profile delta of " << filename;
+    return false;
+  }
+  auto last_delta_info_it = last_delta_infos_.find(filename);
+  if (last_delta_info_it != last_delta_infos_.end()) {
+    delta.RemoveDataIn(*(last_delta_info_it->second));
+  }
+  uint32_t delta_number_of_methods = delta.GetNumberOfMethods();
+  uint32_t delta_number_of_classes = delta.GetNumberOfResolvedClasses();
+  if (!force_save &&
+      delta_number_of_methods < options_.GetMinMethodsToSave() &&
+      delta_number_of_classes < options_.GetMinClassesToSave()) {
+    VLOG(profiler) << "Not enough information to save a delta to: " << filename
+                   << " Number of methods: " << delta_number_of_methods
+                   << " Number of classes: " << delta_number_of_classes;
+    total_number_of_skipped_writes_++;
+    return false;
+  }
+  if (number_of_new_methods != nullptr) {
+    *number_of_new_methods =
+        std::max(static_cast<uint16_t>(delta_number_of_methods), *number_of_new_methods);
+  }
+
+  std::string delta_filename = ProfileCompilationInfo::GetDeltaLogFilename(filename);
+  uint64_t bytes_written = 0u;
+  bool saved;
+  if (!force_save &&
+      OS::GetFileSizeBytes(delta_filename.c_str()) <
+          static_cast<int64_t>(options_.GetDeltaLogMaxBytes())) {
+    saved = delta.AppendToDeltaLog(delta_filename, &bytes_written);
+  } else {
+    // Compact the delta log: loading the profile replays it, and saving the profile drops it.
+    ProfileCompilationInfo full_info(Runtime::Current()->GetArenaPool(),
+                                     /*for_boot_image=*/options_.GetProfileBootClassPath());
+    if (!full_info.Load(filename, /*clear_if_invalid=*/true)) {
+      LOG(WARNING) << "Could not forcefully load profile " << filename;
+      return false;
+    }
+    if (!full_info.MergeWith(info)) {
+      // The profile on disk is outdated, replace it with what this process has profiled.
+      LOG(WARNING) << "Could not merge the profile delta. Clearing the profile data.";
+      full_info.ClearData();
+      if (!full_info.MergeWith(info)) {
+        return false;
+      }
+    }
+    saved = full_info.Save(filename, &bytes_written);
+  }
+
+  if (!saved) {
+    LOG(WARNING) << "Could not save profiling info to " << filename;
+    total_number_of_failed_writes_++;
+    return false;
+  }
+  if (last_delta_info_it == last_delta_infos_.end()) {
+    last_delta_info_it = last_delta_infos_.Put(
+        filename,
+        new ProfileCompilationInfo(
+            Runtime::Current()->GetArenaPool(), options_.GetProfileBootClassPath()));
+  } else {
+    last_delta_info_it->second->ClearData();
+  }
+  if (!last_delta_info_it->second->MergeWith(info)) {
+    // Start over with a complete delta at the next save.
+    delete last_delta_info_it->second;
+    last_delta_infos_.erase(last_delta_info_it);
+  }
+  if (bytes_written == 0u) {
+    total_number_of_skipped_writes_++;
+    return false;
+  }
+  total_number_of_writes_++;
+  total_bytes_written_ += bytes_written;
+  return true;
+}
+
 void* ProfileSaver::RunProfileSaverThread(void* arg) {
   Runtime* runtime = Runtime::Current();
 
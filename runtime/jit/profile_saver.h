@@ -84,6 +84,17 @@ class ProfileSaver {
       REQUIRES(!Locks::profiler_lock_)
       REQUIRES(!Locks::mutator_lock_);
 
+  // Append the methods profiled by this process for `filename`, and its cached startup
+  // data, to the delta log of the profile. Once the delta log reaches the configured
+  // size, or if `force_save` is true, compact it into the profile instead.
+  // Returns true if anything was written to disk.
+  bool SaveProfileDelta(const std::string& filename,
+                        const std::vector<ProfileMethodInfo>& profile_methods,
+                        bool force_save,
+                        /*out*/uint16_t* number_of_new_methods)
+      REQUIRES(!Locks::profiler_lock_)
+      REQUIRES(!Locks::mutator_lock_);
+
   void NotifyJitActivityInternal() REQUIRES(!wait_lock_);
   void WakeUpSaver() REQUIRES(wait_lock_);
 
@@ -151,6 +162,11 @@ class ProfileSaver {
   // to just a few hundreds entries in the ProfileCompilationInfo objects.
   SafeMap<std::string, ProfileCompilationInfo*> profile_cache_ GUARDED_BY(Locks::profiler_lock_);
 
+  // What this process had profiled for each tracked file at its last save, when the
+  // profiles are saved through a delta log. Only the data added since is appended.
+  SafeMap<std::string, ProfileCompilationInfo*> last_delta_infos_
+      GUARDED_BY(Locks::profiler_lock_);
+
   // Whether or not this is the first ever profile save.
   // Note this is an approximation and is not 100% precise. It relies on checking
   // whether or not the profiles are empty which is not a precise indication
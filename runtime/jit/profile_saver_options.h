@@ -30,6 +30,9 @@ struct ProfileSaverOptions {
   static constexpr uint32_t kMinNotificationBeforeWake = 10;
   static constexpr uint32_t kMaxNotificationBeforeWake = 50;
   static constexpr uint16_t kInlineCacheThreshold = 4000;
+  // Default value for the max size of the profile delta log, indicating that
+  // the profile is always rewritten rather than appended to.
+  static constexpr uint32_t kDeltaLogDisabled = 0;
 
   ProfileSaverOptions()
       : enabled_(false),
@@ -43,7 +46,8 @@ struct ProfileSaverOptions {
         profile_path_(""),
         profile_boot_class_path_(false),
         profile_aot_code_(false),
-        wait_for_jit_notifications_to_save_(true) {}
+        wait_for_jit_notifications_to_save_(true),
+        delta_log_max_bytes_(kDeltaLogDisabled) {}
 
   ProfileSaverOptions(bool enabled,
                       uint32_t min_save_period_ms,
@@ -68,7 +72,8 @@ struct ProfileSaverOptions {
         profile_path_(profile_path),
         profile_boot_class_path_(profile_boot_class_path),
         profile_aot_code_(profile_aot_code),
-        wait_for_jit_notifications_to_save_(wait_for_jit_notifications_to_save) {}
+        wait_for_jit_notifications_to_save_(wait_for_jit_notifications_to_save),
+        delta_log_max_bytes_(kDeltaLogDisabled) {}
 
   bool IsEnabled() const {
     return enabled_;
@@ -113,6 +118,9 @@ struct ProfileSaverOptions {
   void SetWaitForJitNotificationsToSave(bool value) {
     wait_for_jit_notifications_to_save_ = value;
   }
+  uint32_t GetDeltaLogMaxBytes() const {
+    return delta_log_max_bytes_;
+  }
 
   friend std::ostream & operator<<(std::ostream &os, const ProfileSaverOptions& pso) {
     os << "enabled_" << pso.enabled_
@@ -125,7 +133,8 @@ struct ProfileSaverOptions {
         << ", inline_cache_threshold_" << pso.inline_cache_threshold_
         << ", profile_boot_class_path_" << pso.profile_boot_class_path_
         << ", profile_aot_code_" << pso.profile_aot_code_
-        << ", wait_for_jit_notifications_to_save_" << pso.wait_for_jit_notifications_to_save_;
+        << ", wait_for_jit_notifications_to_save_" << pso.wait_for_jit_notifications_to_save_
+        << ", delta_log_max_bytes_" << pso.delta_log_max_bytes_;
     return os;
   }
 
@@ -141,6 +150,7 @@ struct ProfileSaverOptions {
   bool profile_boot_class_path_;
   bool profile_aot_code_;
   bool wait_for_jit_notifications_to_save_;
+  uint32_t delta_log_max_bytes_;
 };
 
 }  // namespace art
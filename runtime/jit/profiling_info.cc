@@ -32,7 +32,14 @@ ProfilingInfo::ProfilingInfo(ArtMethod* method,
         method_(method),
         number_of_inline_caches_(inline_cache_entries.size()),
         number_of_branch_caches_(branch_cache_entries.size()),
-        current_inline_uses_(0) {
+        current_inline_uses_(0),
+        sample_count_(0),
+        bce_deoptimization_count_(0),
+        optimized_compilation_count_(0),
+        optimized_inline_cache_entries_(0),
+        compile_budget_exceeded_(false),
+        has_hot_loops_(false),
+        failed_osr_entries_(false) {
   InlineCache* inline_caches = GetInlineCaches();
   memset(inline_caches, 0, number_of_inline_caches_ * sizeof(InlineCache));
   for (size_t i = 0; i < number_of_inline_caches_; ++i) {
@@ -112,6 +119,27 @@ BranchCache* ProfilingInfo::GetBranchCache(uint32_t dex_pc) {
   return nullptr;
 }
 
+bool ProfilingInfo::AddInlineCacheDeoptimization(uint32_t dex_pc) {
+  InlineCache* cache = GetInlineCache(dex_pc);
+  if (cache == nullptr || cache->HasFailedSpeculation()) {
+    return false;
+  }
+  return ++cache->deoptimization_count_ == kMaxSpeculativeDeoptimizations;
+}
+
+size_t ProfilingInfo::CountInlineCacheEntries() {
+  size_t count = 0u;
+  InlineCache* caches = GetInlineCaches();
+  for (size_t i = 0; i < number_of_inline_caches_; ++i) {
+    for (const GcRoot<mirror::Class>& root : caches[i].classes_) {
+      if (!root.IsNull()) {
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
 void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
   InlineCache* cache = GetInlineCache(dex_pc);
   if (cache == nullptr) {
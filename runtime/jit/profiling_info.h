@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_JIT_PROFILING_INFO_H_
 #define ART_RUNTIME_JIT_PROFILING_INFO_H_
 
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 #include "base/macros.h"
@@ -40,6 +42,10 @@ namespace mirror {
 class Class;
 }  // namespace mirror
 
+// Number of deoptimizations caused by a failed speculation after which the JIT stops making
+// that speculation.
+static constexpr uint32_t kMaxSpeculativeDeoptimizations = 2;
+
 // Structure to store the classes seen at runtime for a specific instruction.
 // Once the classes_ array is full, we consider the INVOKE to be megamorphic.
 class InlineCache {
@@ -47,6 +53,13 @@ class InlineCache {
   // This is hard coded in the assembly stub art_quick_update_inline_cache.
   static constexpr uint8_t kIndividualCacheSize = 5;
 
+  // Whether optimized code deoptimized at this call site often enough, because of a receiver
+  // type missing from the cache, that inlined code should no longer be guarded with a
+  // deoptimization.
+  bool HasFailedSpeculation() const {
+    return deoptimization_count_ >= kMaxSpeculativeDeoptimizations;
+  }
+
   static constexpr MemberOffset ClassesOffset() {
     return MemberOffset(OFFSETOF_MEMBER(InlineCache, classes_));
   }
@@ -67,6 +80,9 @@ class InlineCache {
   uint32_t dex_pc_;
   GcRoot<mirror::Class> classes_[kIndividualCacheSize];
 
+  // Number of deoptimizations at this call site. Only updated by the runtime.
+  uint32_t deoptimization_count_;
+
   friend class jit::JitCodeCache;
   friend class ProfilingInfo;
 
@@ -128,6 +144,27 @@ class ProfilingInfo {
     return method_;
   }
 
+  // Record a deoptimization of optimized code at the invoke at `dex_pc`. Return whether the
+  // call site just reached the number of deoptimizations after which the JIT stops speculating.
+  bool AddInlineCacheDeoptimization(uint32_t dex_pc);
+
+  // Record a deoptimization of optimized code caused by dynamic bounds check elimination. Return
+  // whether the method just reached the number of deoptimizations after which the JIT stops
+  // using it.
+  bool AddBCEDeoptimization() {
+    if (bce_deoptimization_count_ == kMaxSpeculativeDeoptimizations) {
+      return false;
+    }
+    return ++bce_deoptimization_count_ == kMaxSpeculativeDeoptimizations;
+  }
+
+  bool HasFailedDynamicBCE() const {
+    return bce_deoptimization_count_ >= kMaxSpeculativeDeoptimizations;
+  }
+
+  // Return the number of inline cache entries filled in so far.
+  size_t CountInlineCacheEntries();
+
   InlineCache* GetInlineCache(uint32_t dex_pc);
   BranchCache* GetBranchCache(uint32_t dex_pc);
 
@@ -175,6 +212,72 @@ class ProfilingInfo {
     return baseline_hotness_count_;
   }
 
+  uint16_t GetSampleCount() const {
+    return sample_count_;
+  }
+
+  void AddSample() {
+    if (sample_count_ != std::numeric_limits<uint16_t>::max()) {
+      sample_count_++;
+    }
+  }
+
+  uint16_t GetOptimizedCompilationCount() const {
+    return optimized_compilation_count_;
+  }
+
+  // Called when optimized code of the method is added to the code cache, with the number of
+  // inline cache entries filled in at that point.
+  void AddOptimizedCompilation(size_t inline_cache_entries) {
+    if (optimized_compilation_count_ != std::numeric_limits<uint16_t>::max()) {
+      optimized_compilation_count_++;
+    }
+    SetOptimizedInlineCacheEntries(inline_cache_entries);
+  }
+
+  // Number of inline cache entries filled in when the method was last compiled with
+  // optimizations. Entries added since then were not used for inlining decisions.
+  size_t GetOptimizedInlineCacheEntries() const {
+    return optimized_inline_cache_entries_;
+  }
+
+  void SetOptimizedInlineCacheEntries(size_t inline_cache_entries) {
+    optimized_inline_cache_entries_ = static_cast<uint16_t>(
+        std::min<size_t>(inline_cache_entries, std::numeric_limits<uint16_t>::max()));
+  }
+
+  // Whether an optimized compilation of the method went over the JIT compilation budget. The
+  // method then keeps running its baseline code.
+  bool HasExceededCompileBudget() const {
+    return compile_budget_exceeded_;
+  }
+
+  void SetCompileBudgetExceeded() {
+    compile_budget_exceeded_ = true;
+  }
+
+  // Whether the loops of the method kept it in the interpreter while it had baseline code.
+  // Optimized compilations of the method then also emit OSR entries at loop headers, so that the
+  // interpreter can jump to the optimized code without a separate OSR compilation.
+  bool HasHotLoops() const {
+    return has_hot_loops_;
+  }
+
+  void SetHasHotLoops() {
+    has_hot_loops_ = true;
+  }
+
+  // Whether an optimized compilation failed because of its OSR entries. Later optimized
+  // compilations of the method do not emit them.
+  bool HasFailedOsrEntries() const {
+    return failed_osr_entries_;
+  }
+
+  void SetFailedOsrEntries() {
+    failed_osr_entries_ = true;
+    has_hot_loops_ = false;
+  }
+
   static uint16_t GetOptimizeThreshold();
 
  private:
@@ -202,6 +305,29 @@ class ProfilingInfo {
   // it updates this counter so that the GC does not try to clear the inline caches.
   uint16_t current_inline_uses_;
 
+  // Number of code cache collections which found the compiled code of the method on a thread
+  // stack. Used to pick the code to move to the hot code space.
+  uint16_t sample_count_;
+
+  // Number of deoptimizations of the optimized code of the method caused by dynamic bounds
+  // check elimination.
+  uint16_t bce_deoptimization_count_;
+
+  // Number of optimized compilations of the method added to the code cache.
+  uint16_t optimized_compilation_count_;
+
+  // See GetOptimizedInlineCacheEntries().
+  uint16_t optimized_inline_cache_entries_;
+
+  // See HasExceededCompileBudget().
+  bool compile_budget_exceeded_;
+
+  // See HasHotLoops().
+  bool has_hot_loops_;
+
+  // See HasFailedOsrEntries().
+  bool failed_osr_entries_;
+
   // Memory following the object:
   // - Dynamically allocated array of `InlineCache` of size `number_of_inline_caches_`.
   // - Dynamically allocated array of `BranchCache of size `number_of_branch_caches_`.
@@ -195,6 +195,9 @@ constexpr std::optional<int32_t> EncodeDatumId(DatumId datum_id) {
     case DatumId::kTimeElapsedDelta:
       return std::make_optional(
           statsd::ART_DATUM_DELTA_REPORTED__KIND__ART_DATUM_DELTA_TIME_ELAPSED_MS);
+    case DatumId::kJitMethodCompileArenaPeakBytes:
+      // Not reported to statsd yet.
+      return std::nullopt;
   }
 }
 
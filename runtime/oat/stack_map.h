@@ -515,6 +515,12 @@ class CodeInfo {
     return HasFlag<kIsDebuggable>(code_info_data);
   }
 
+  // Whether the code has OSR stack maps at loop headers. This is the case for OSR code and for
+  // optimized code compiled for a method whose loops got hot in the interpreter.
+  ALWAYS_INLINE static bool HasOsrEntries(const uint8_t* code_info_data) {
+    return HasFlag<kHasOsrEntries>(code_info_data);
+  }
+
   uint32_t GetNumberOfDexRegisters() {
     return number_of_dex_registers_;
   }
@@ -569,6 +575,7 @@ class CodeInfo {
     kHasShouldDeoptimizeFlag = 1 << 1,
     kIsBaseline = 1 << 2,
     kIsDebuggable = 1 << 3,
+    kHasOsrEntries = 1 << 4,
   };
 
   // The CodeInfo starts with sequence of variable-length bit-encoded integers.
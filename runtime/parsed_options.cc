@@ -224,6 +224,16 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:LongGCLogThreshold=_")  // in ms
           .WithType<MillisecondsToNanoseconds>()  // store as ns
           .IntoKey(M::LongGCLogThreshold)
+      .Define("-XX:GcCpuFractionTarget=_")
+          .WithType<double>().WithRange(0.0, 0.9)
+          .WithHelp("Adjust heap growth online so that GC uses at most this fraction of process"
+                    " CPU time. 0 disables the adjustment.")
+          .IntoKey(M::GcCpuFractionTarget)
+      .Define("-XX:GcPauseBudget=_")  // in ms
+          .WithType<MillisecondsToNanoseconds>()  // store as ns
+          .WithHelp("Start concurrent GCs earlier when GC pauses exceed this many milliseconds."
+                    " 0 disables the adjustment.")
+          .IntoKey(M::GcPauseBudget)
       .Define("-XX:DumpGCPerformanceOnShutdown")
           .IntoKey(M::DumpGCPerformanceOnShutdown)
       .Define("-XX:DumpRegionInfoBeforeGC")
@@ -242,6 +252,13 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:UseTLAB")
           .WithValue(true)
           .IntoKey(M::UseTLAB)
+      .Define("-XX:NumaAwareTLAB")
+          .WithHelp("Prefer region-space TLABs whose memory is local to the allocating thread's"
+                    " NUMA node")
+          .IntoKey(M::NumaAwareTLAB)
+      .Define("-XX:AdaptiveTLABSizing")
+          .WithHelp("Size each thread's TLABs from how much it allocated between the last GCs")
+          .IntoKey(M::AdaptiveTLABSizing)
       .Define({"-XX:EnableHSpaceCompactForOOM", "-XX:DisableHSpaceCompactForOOM"})
           .WithValues({true, false})
           .IntoKey(M::EnableHSpaceCompactForOOM)
@@ -277,9 +294,32 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjitmaxsize:_")
           .WithType<MemoryKiB>()
           .IntoKey(M::JITCodeCacheMaxCapacity)
+      .Define("-Xjithotcodesize:_")
+          .WithType<MemoryKiB>()
+          .WithHelp("Size of the part of the JIT code cache where the code of the hottest methods"
+                    " is packed at code cache collections. 0 disables it.")
+          .IntoKey(M::JITHotCodeCapacity)
+      .Define("-Xjitcompiletimebudget:_")
+          .WithType<unsigned int>()
+          .WithHelp("Thread CPU time in milliseconds an optimizing JIT compilation may use before"
+                    " it is abandoned for baseline code. 0 disables the limit.")
+          .IntoKey(M::JITCompileTimeBudget)
+      .Define("-Xjitcompilememorybudget:_")
+          .WithType<MemoryKiB>()
+          .WithHelp("Arena memory an optimizing JIT compilation may use before it is abandoned"
+                    " for baseline code. 0 disables the limit.")
+          .IntoKey(M::JITCompileMemoryBudget)
       .Define("-Xjitwarmupthreshold:_")
           .WithType<unsigned int>()
           .IntoKey(M::JITWarmupThreshold)
+      .Define("-Xjitsamplinginterval:_")
+          .WithType<unsigned int>()
+          .WithHelp("Interval in microseconds at which the JIT samples the threads running managed"
+                    " code to find hot interpreted methods. 0 disables sampling.")
+          .IntoKey(M::JITSamplingInterval)
+      .Define("-Xjitsampleweight:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITSampleWeight)
       .Define("-Xjitprithreadweight:_")
           .WithType<unsigned int>()
           .IntoKey(M::JITPriorityThreadWeight)
@@ -292,6 +332,15 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjitzygotepthreadpriority:_")
           .WithType<int>()
           .IntoKey(M::JITZygotePoolThreadPthreadPriority)
+      .Define("-Xjitthreadpoolsize:_")
+          .WithType<unsigned int>()
+          .WithHelp("Maximum number of JIT compiler threads. 0 picks a default based on the"
+                    " number of CPUs.")
+          .IntoKey(M::JITPoolThreadCount)
+      .Define("-Xjitpersistentcache:_")
+          .WithType<std::string>()
+          .WithHelp("File in which to keep optimized JIT code across runs of this process.")
+          .IntoKey(M::JITPersistentCachePath)
       .Define("-Xjitsaveprofilinginfo")
           .WithType<ProfileSaverOptions>()
           .AppendValues()
@@ -314,6 +363,7 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
                "-Xps-min-notification-before-wake:_",
                "-Xps-max-notification-before-wake:_",
                "-Xps-inline-cache-threshold:_",
+               "-Xps-delta-log-max-bytes:_",
                "-Xps-profile-path:_"})
           .WithHelp("profile-saver options -Xps-<key>:<value>")
           .WithType<ProfileSaverOptions>()
@@ -749,6 +749,9 @@ void QuickExceptionHandler::DeoptimizeSingleFrame(DeoptimizationKind kind) {
         deopt_method, /*aot_code=*/ nullptr);
   }
 
+  // Whether the speculation that failed has now failed often enough that the JIT stops making it.
+  bool disabled_speculation = false;
+
   // If the deoptimization is due to an inline cache, update it with the type
   // that made us deoptimize. This avoids pathological cases of never seeing
   // that type while executing baseline generated code.
@@ -770,7 +773,7 @@ void QuickExceptionHandler::DeoptimizeSingleFrame(DeoptimizationKind kind) {
             runtime->GetJit()->GetJitCompiler()->GetInlineMaxCodeUnits());
         if (encoded_dex_pc != static_cast<uint32_t>(-1)) {
           // The inline cache comes from the top-level method.
-          runtime->GetJit()->GetCodeCache()->MaybeUpdateInlineCache(
+          disabled_speculation = runtime->GetJit()->GetCodeCache()->MaybeUpdateInlineCache(
               visitor.GetSingleFrameDeoptMethod(),
               encoded_dex_pc,
               shadow_frame->GetVRegReference(inst->VRegC())->GetClass(),
@@ -778,7 +781,7 @@ void QuickExceptionHandler::DeoptimizeSingleFrame(DeoptimizationKind kind) {
         } else {
           // If the top-level inline cache did not exist, update the one for the
           // bottom method, we know it's the one that was used for compilation.
-          runtime->GetJit()->GetCodeCache()->MaybeUpdateInlineCache(
+          disabled_speculation = runtime->GetJit()->GetCodeCache()->MaybeUpdateInlineCache(
               shadow_frame->GetMethod(),
               dex_pc,
               shadow_frame->GetVRegReference(inst->VRegC())->GetClass(),
@@ -790,6 +793,18 @@ void QuickExceptionHandler::DeoptimizeSingleFrame(DeoptimizationKind kind) {
         LOG(FATAL) << "Unexpected instruction for inline cache: " << inst->Name();
       }
     }
+  } else if (runtime->UseJitCompilation() &&
+             (kind == DeoptimizationKind::kLoopBoundsBCE ||
+              kind == DeoptimizationKind::kLoopNullBCE ||
+              kind == DeoptimizationKind::kBlockBCE)) {
+    disabled_speculation =
+        runtime->GetJit()->GetCodeCache()->NotifyBCEDeoptimization(deopt_method, self_);
+  }
+
+  // Recompile right away without the failed speculation, rather than waiting for the method to
+  // get hot again in the interpreter and in baseline code.
+  if (disabled_speculation) {
+    runtime->GetJit()->EnqueueRecompilation(deopt_method, self_);
   }
 
   PrepareForLongJumpToInvokeStubOrInterpreterBridge();
@@ -1256,6 +1256,12 @@ void Runtime::InitNonZygoteOrPostFork(
     }
   }
 
+  // Create the heap thread pool used by the mark-compact collector for parallel marking. It is
+  // only created, with ConcGCThreads workers, when they have been explicitly asked for.
+  if (gUseUserfaultfd && heap_->GetConcGCThreadCount() != 0) {
+    heap_->CreateThreadPool(heap_->GetConcGCThreadCount());
+  }
+
   // Create the thread pool for loading app images.
   // Avoid creating the runtime thread pool for system server since it will not be used and would
   // waste memory.
@@ -1743,6 +1749,8 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   // Generational CC collection is currently only compatible with Baker read barriers.
   bool use_generational_cc = kUseBakerReadBarrier && xgc_option.generational_cc;
+  // Generational CMC collection is only applicable when userfaultfd is in use.
+  bool use_generational_cmc = gUseUserfaultfd && xgc_option.generational_cmc;
 
   // Cache the apex versions.
   InitializeApexVersions();
@@ -1779,9 +1787,13 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        runtime_options.Exists(Opt::LowMemoryMode),
                        runtime_options.GetOrDefault(Opt::LongPauseLogThreshold),
                        runtime_options.GetOrDefault(Opt::LongGCLogThreshold),
+                       runtime_options.GetOrDefault(Opt::GcCpuFractionTarget),
+                       runtime_options.GetOrDefault(Opt::GcPauseBudget),
                        runtime_options.Exists(Opt::IgnoreMaxFootprint),
                        runtime_options.GetOrDefault(Opt::AlwaysLogExplicitGcs),
                        runtime_options.GetOrDefault(Opt::UseTLAB),
+                       runtime_options.Exists(Opt::NumaAwareTLAB),
+                       runtime_options.Exists(Opt::AdaptiveTLABSizing),
                        xgc_option.verify_pre_gc_heap_,
                        xgc_option.verify_pre_sweeping_heap_,
                        xgc_option.verify_post_gc_heap_,
@@ -1792,6 +1804,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        xgc_option.measure_,
                        runtime_options.GetOrDefault(Opt::EnableHSpaceCompactForOOM),
                        use_generational_cc,
+                       use_generational_cmc,
                        runtime_options.GetOrDefault(Opt::HSpaceCompactForOOMMinIntervalsMs),
                        runtime_options.Exists(Opt::DumpRegionInfoBeforeGC),
                        runtime_options.Exists(Opt::DumpRegionInfoAfterGC));
@@ -23,6 +23,7 @@
 #include "gc/space/image_space.h"
 #include "gc/space/space-inl.h"
 #include "handle_scope-inl.h"
+#include "jit/jit.h"
 #include "linear_alloc-inl.h"
 #include "mirror/dex_cache.h"
 #include "mirror/object-inl.h"
@@ -66,6 +67,11 @@ void StartupCompletedTask::Run(Thread* self) {
       }
     }
 
+    // Keep what the JIT compiled during startup even if the process gets killed later on.
+    if (runtime->GetJit() != nullptr) {
+      runtime->GetJit()->SavePersistentCache();
+    }
+
     ScopedObjectAccess soa(self);
     DeleteStartupDexCaches(self, /* called_by_gc= */ false);
   }
@@ -483,17 +483,6 @@ inline void Thread::SetThreadLocalAllocationStack(StackReference<mirror::Object>
   tlsPtr_.thread_local_alloc_stack_top = start;
 }
 
-inline void Thread::RevokeThreadLocalAllocationStack() {
-  if (kIsDebugBuild) {
-    // Note: self is not necessarily equal to this thread since thread may be suspended.
-    Thread* self = Thread::Current();
-    DCHECK(this == self || GetState() != ThreadState::kRunnable)
-        << GetState() << " thread " << this << " self " << self;
-  }
-  tlsPtr_.thread_local_alloc_stack_end = nullptr;
-  tlsPtr_.thread_local_alloc_stack_top = nullptr;
-}
-
 inline void Thread::PoisonObjectPointersIfDebug() {
   if (kObjPtrPoisoning) {
     Thread::Current()->PoisonObjectPointers();
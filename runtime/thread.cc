@@ -4664,9 +4664,24 @@ void Thread::ResetTlab() {
                << " adjustment = "
                << (tlsPtr_.thread_local_pos - tlsPtr_.thread_local_start);
   }
+  tlab_bytes_since_resize_ += GetTlabPosOffset();
   SetTlab(nullptr, nullptr, nullptr);
 }
 
+void Thread::RevokeThreadLocalAllocationStack() {
+  if (kIsDebugBuild) {
+    // Note: self is not necessarily equal to this thread since thread may be suspended.
+    Thread* self = Thread::Current();
+    DCHECK(this == self || GetState() != ThreadState::kRunnable)
+        << GetState() << " thread " << this << " self " << self;
+  }
+  if (HasThreadLocalAllocationStack()) {
+    Runtime::Current()->GetHeap()->FlushThreadLocalAllocationStack(this);
+  }
+  tlsPtr_.thread_local_alloc_stack_end = nullptr;
+  tlsPtr_.thread_local_alloc_stack_top = nullptr;
+}
+
 bool Thread::HasTlab() const {
   const bool has_tlab = tlsPtr_.thread_local_pos != nullptr;
   if (has_tlab) {
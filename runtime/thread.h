@@ -47,6 +47,7 @@
 #include "reflective_handle_scope.h"
 #include "runtime_globals.h"
 #include "runtime_stats.h"
+#include "stack_reference.h"
 #include "suspend_reason.h"
 #include "thread_state.h"
 
@@ -1457,6 +1458,28 @@ class EXPORT Thread {
   uint8_t* GetTlabEnd() {
     return tlsPtr_.thread_local_end;
   }
+
+  // Bytes allocated through TLABs since the last time the heap resized this thread's TLAB. Updated
+  // whenever the TLAB is reset.
+  size_t GetTlabBytesSinceResize() const {
+    return tlab_bytes_since_resize_;
+  }
+
+  // Size the heap picked for this thread's next TLAB, or 0 if it has not picked one yet.
+  size_t GetAdaptiveTlabSize() const {
+    return adaptive_tlab_size_;
+  }
+
+  // GC number at which the adaptive TLAB size was last recomputed.
+  uint32_t GetAdaptiveTlabGcNum() const {
+    return adaptive_tlab_gc_num_;
+  }
+
+  void SetAdaptiveTlabSize(size_t size, uint32_t gc_num) {
+    adaptive_tlab_size_ = size;
+    adaptive_tlab_gc_num_ = gc_num;
+    tlab_bytes_since_resize_ = 0;
+  }
   // Remove the suspend trigger for this thread by making the suspend_trigger_ TLS value
   // equal to a valid pointer.
   void RemoveSuspendTrigger() {
@@ -1480,8 +1503,29 @@ class EXPORT Thread {
   void SetThreadLocalAllocationStack(StackReference<mirror::Object>* start,
                                      StackReference<mirror::Object>* end);
 
-  // Resets the thread local allocation pointers.
-  void RevokeThreadLocalAllocationStack();
+  // Hands the objects buffered on the thread local allocation stack over to the heap's allocation
+  // stack and resets the thread local allocation pointers.
+  void RevokeThreadLocalAllocationStack() REQUIRES_SHARED(Locks::mutator_lock_);
+
+  bool HasThreadLocalAllocationStack() const {
+    return tlsPtr_.thread_local_alloc_stack_top != nullptr;
+  }
+
+  // Returns the thread-owned storage backing the thread local allocation stack, or null if the
+  // heap has not handed one out yet.
+  StackReference<mirror::Object>* GetThreadLocalAllocationStackBuffer() const {
+    return thread_local_alloc_stack_buffer_.get();
+  }
+
+  void SetThreadLocalAllocationStackBuffer(
+      std::unique_ptr<StackReference<mirror::Object>[]> buffer) {
+    thread_local_alloc_stack_buffer_ = std::move(buffer);
+  }
+
+  // Number of objects pushed on the thread local allocation stack since it was last set up.
+  size_t GetThreadLocalAllocationStackSize() const {
+    return tlsPtr_.thread_local_alloc_stack_top - thread_local_alloc_stack_buffer_.get();
+  }
 
   size_t GetThreadLocalBytesAllocated() const {
     return tlsPtr_.thread_local_end - tlsPtr_.thread_local_start;
@@ -2397,6 +2441,16 @@ class EXPORT Thread {
   // the caller is allowed to access all fields and methods in the Core Platform API.
   uint32_t core_platform_api_cookie_ = 0;
 
+  // Adaptive TLAB sizing state. Only accessed by the thread itself, or by the GC while the thread
+  // is suspended or its TLAB is being revoked. See Heap::ComputeAdaptiveTlabSize().
+  size_t tlab_bytes_since_resize_ = 0;
+  size_t adaptive_tlab_size_ = 0;
+  uint32_t adaptive_tlab_gc_num_ = 0;
+
+  // Storage for the thread local allocation stack whose top and end are kept in tlsPtr_. Objects
+  // are buffered here and flushed to the heap's allocation stack in batches.
+  std::unique_ptr<StackReference<mirror::Object>[]> thread_local_alloc_stack_buffer_;
+
   friend class gc::collector::SemiSpace;  // For getting stack traces.
   friend class Runtime;  // For CreatePeer.
   friend class QuickExceptionHandler;  // For dumping the stack.
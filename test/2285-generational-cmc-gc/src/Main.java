@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+    static final int NUM_OLD = 4096;
+    static final int ROUNDS = 200;
+
+    static class Node {
+        Node next;
+        Object payload;
+        int value;
+
+        Node(int value) {
+            this.value = value;
+        }
+    }
+
+    static Node[] oldNodes = new Node[NUM_OLD];
+    // Keeps a rotating set of young objects alive so that some survive each young collection.
+    static Object[] survivors = new Object[256];
+
+    public static void main(String[] args) {
+        for (int i = 0; i < NUM_OLD; ++i) {
+            oldNodes[i] = new Node(i);
+        }
+        // Promote the nodes into the old generation.
+        Runtime.getRuntime().gc();
+        Runtime.getRuntime().gc();
+
+        for (int round = 0; round < ROUNDS; ++round) {
+            // Create old-to-young references from (mostly) fully old pages.
+            for (int i = round % 7; i < NUM_OLD; i += 7) {
+                Node young = new Node(round);
+                young.payload = new int[] { i, round };
+                oldNodes[i].next = young;
+            }
+            // Churn garbage to trigger young collections while those references are live.
+            for (int i = 0; i < 2048; ++i) {
+                Object garbage = new byte[128 + (i % 64)];
+                if ((i & 63) == 0) {
+                    survivors[(round * 32 + (i >> 6)) % survivors.length] = garbage;
+                }
+            }
+            verify(round);
+        }
+        Runtime.getRuntime().gc();
+        verify(ROUNDS - 1);
+        System.out.println("passed");
+    }
+
+    static void verify(int round) {
+        for (int i = 0; i < NUM_OLD; ++i) {
+            Node old = oldNodes[i];
+            if (old.value != i) {
+                throw new Error("Old node " + i + " corrupted: " + old.value);
+            }
+            Node young = old.next;
+            if (young == null) {
+                continue;
+            }
+            int[] payload = (int[]) young.payload;
+            if (payload[0] != i || payload[1] != young.value || young.value > round) {
+                throw new Error("Young node of " + i + " corrupted in round " + round);
+            }
+        }
+    }
+}
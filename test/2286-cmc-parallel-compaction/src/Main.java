@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.util.ArrayList;
+
+public class Main {
+    static final int NUM_CHAINS = 64;
+    static final int CHAIN_LENGTH = 2000;
+
+    static class Node {
+        Node next;
+        long id;
+        int[] data;
+
+        Node(long id, Node next) {
+            this.id = id;
+            this.next = next;
+            this.data = new int[(int) (id % 16)];
+            for (int i = 0; i < data.length; ++i) {
+                data[i] = (int) id + i;
+            }
+        }
+    }
+
+    public static void main(String[] args) {
+        Node[] chains = new Node[NUM_CHAINS];
+        for (int round = 0; round < 10; ++round) {
+            // Interleave allocations of live and dead objects so that every page has holes to
+            // compact away.
+            ArrayList<Object> garbage = new ArrayList<>();
+            for (int c = 0; c < NUM_CHAINS; ++c) {
+                chains[c] = null;
+                for (int i = 0; i < CHAIN_LENGTH; ++i) {
+                    chains[c] = new Node((long) c * CHAIN_LENGTH + i, chains[c]);
+                    garbage.add(new byte[48]);
+                }
+            }
+            garbage = null;
+            Runtime.getRuntime().gc();
+            verify(chains);
+        }
+        System.out.println("passed");
+    }
+
+    static void verify(Node[] chains) {
+        for (int c = 0; c < NUM_CHAINS; ++c) {
+            int i = CHAIN_LENGTH - 1;
+            for (Node n = chains[c]; n != null; n = n.next, --i) {
+                long expected = (long) c * CHAIN_LENGTH + i;
+                if (n.id != expected || n.data.length != (int) (expected % 16)) {
+                    throw new Error("Corrupted node " + expected + ": " + n.id);
+                }
+                for (int k = 0; k < n.data.length; ++k) {
+                    if (n.data[k] != (int) expected + k) {
+                        throw new Error("Corrupted data in node " + expected);
+                    }
+                }
+            }
+            if (i != -1) {
+                throw new Error("Chain " + c + " has wrong length");
+            }
+        }
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+    static final int NUM_THREADS = 8;
+    static final int NUM_OBJECTS = 20000;
+
+    static class Item {
+        final int thread;
+        final int index;
+        final long[] words;
+
+        Item(int thread, int index) {
+            this.thread = thread;
+            this.index = index;
+            this.words = new long[index % 8];
+            for (int i = 0; i < words.length; ++i) {
+                words[i] = ((long) thread << 32) | (index + i);
+            }
+        }
+
+        boolean check(int expectedThread, int expectedIndex) {
+            if (thread != expectedThread || index != expectedIndex
+                    || words.length != expectedIndex % 8) {
+                return false;
+            }
+            for (int i = 0; i < words.length; ++i) {
+                if (words[i] != (((long) thread << 32) | (index + i))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    public static void main(String[] args) throws Exception {
+        final Item[][] results = new Item[NUM_THREADS][];
+        final Throwable[] failures = new Throwable[NUM_THREADS];
+        Thread[] threads = new Thread[NUM_THREADS];
+        for (int t = 0; t < NUM_THREADS; ++t) {
+            final int id = t;
+            threads[t] = new Thread(() -> {
+                try {
+                    Item[] items = new Item[NUM_OBJECTS];
+                    for (int round = 0; round < 5; ++round) {
+                        for (int i = 0; i < NUM_OBJECTS; ++i) {
+                            // Replace old items so that earlier TLABs become partially dead.
+                            if (items[i] == null || (i + round) % 3 == 0) {
+                                items[i] = new Item(id, i);
+                            }
+                        }
+                        if (id == 0) {
+                            Runtime.getRuntime().gc();
+                        }
+                    }
+                    results[id] = items;
+                } catch (Throwable e) {
+                    failures[id] = e;
+                }
+            });
+            threads[t].start();
+        }
+        for (Thread thread : threads) {
+            thread.join();
+        }
+        Runtime.getRuntime().gc();
+        for (int t = 0; t < NUM_THREADS; ++t) {
+            if (failures[t] != null) {
+                throw new Error("Thread " + t + " failed", failures[t]);
+            }
+            for (int i = 0; i < NUM_OBJECTS; ++i) {
+                if (!results[t][i].check(t, i)) {
+                    throw new Error("Item " + i + " of thread " + t + " is corrupted");
+                }
+            }
+        }
+        System.out.println("passed");
+    }
+}
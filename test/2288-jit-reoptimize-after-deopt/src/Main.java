@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+    // Matches kMaxSpeculativeDeoptimizations in runtime/jit/profiling_info.h.
+    static final int MAX_SPECULATIVE_DEOPTIMIZATIONS = 2;
+    static final int ATTEMPTS = 6;
+
+    public static void main(String[] args) throws Exception {
+        System.loadLibrary(args[0]);
+        if (!hasJit()) {
+            // Inline caches and deoptimization counts only exist with the JIT.
+            return;
+        }
+        testInlineCache();
+        testDynamicBCE();
+    }
+
+    static class Base {
+        int get() { return 1; }
+    }
+
+    static class A extends Base {
+        int get() { return 2; }
+    }
+
+    static class B extends Base {
+        int get() { return 3; }
+    }
+
+    static class C extends Base {
+        int get() { return 4; }
+    }
+
+    public static int $noinline$callGet(Base b) {
+        return b.get();
+    }
+
+    // Optimized code compiled with only `A` in the inline cache inlines `A.get()` behind a type
+    // guard that deoptimizes. Calls with other receivers deoptimize until the JIT recompiles the
+    // method with a virtual call fallback.
+    private static void testInlineCache() {
+        ensureJitBaselineCompiled(Main.class, "$noinline$callGet");
+        A a = new A();
+        for (int i = 0; i < 1000; ++i) {
+            assertEquals(2, $noinline$callGet(a));
+        }
+        ensureJitCompiled(Main.class, "$noinline$callGet");
+
+        int before = numberOfDeoptimizations();
+        Base[] receivers = { new B(), new C() };
+        for (int i = 0; i < ATTEMPTS; ++i) {
+            Base b = receivers[i % receivers.length];
+            assertEquals(b instanceof B ? 3 : 4, $noinline$callGet(b));
+            waitForCompilation();
+        }
+        int deoptimizations = numberOfDeoptimizations() - before;
+        if (deoptimizations > MAX_SPECULATIVE_DEOPTIMIZATIONS) {
+            throw new Error("Too many inline cache deoptimizations: " + deoptimizations);
+        }
+        // The re-optimized code still works for all receivers.
+        assertEquals(2, $noinline$callGet(a));
+    }
+
+    // The loop bounds checks are hoisted behind a deoptimization which fails when `n` is larger
+    // than the array. Once that happened often enough, the JIT keeps the bounds checks instead.
+    public static int $noinline$sum(int[] array, int n) {
+        int sum = 0;
+        for (int i = 0; i < n; ++i) {
+            sum += array[i];
+        }
+        return sum;
+    }
+
+    private static void testDynamicBCE() {
+        int[] array = { 1, 2, 3, 4, 5, 6, 7, 8 };
+        ensureJitBaselineCompiled(Main.class, "$noinline$sum");
+        for (int i = 0; i < 1000; ++i) {
+            assertEquals(36, $noinline$sum(array, array.length));
+        }
+        ensureJitCompiled(Main.class, "$noinline$sum");
+
+        int before = numberOfDeoptimizations();
+        for (int i = 0; i < ATTEMPTS; ++i) {
+            try {
+                $noinline$sum(array, array.length + 1);
+                throw new Error("Expected ArrayIndexOutOfBoundsException");
+            } catch (ArrayIndexOutOfBoundsException expected) {
+            }
+            waitForCompilation();
+        }
+        int deoptimizations = numberOfDeoptimizations() - before;
+        if (deoptimizations > MAX_SPECULATIVE_DEOPTIMIZATIONS) {
+            throw new Error("Too many BCE deoptimizations: " + deoptimizations);
+        }
+        assertEquals(36, $noinline$sum(array, array.length));
+    }
+
+    private static void assertEquals(int expected, int actual) {
+        if (expected != actual) {
+            throw new Error("Expected " + expected + ", got " + actual);
+        }
+    }
+
+    private static native boolean hasJit();
+    private static native int numberOfDeoptimizations();
+    private static native void waitForCompilation();
+    private static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+    private static native void ensureJitCompiled(Class<?> cls, String methodName);
+}
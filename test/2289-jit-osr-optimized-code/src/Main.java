@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+    public static void main(String[] args) {
+        System.loadLibrary(args[0]);
+        if (!hasJit()) {
+            System.out.println("passed");
+            return;
+        }
+
+        // The first call only returns once nterp has jumped out of its loop into compiled code.
+        if (!$noinline$loop(/* waitForOsr= */ true)) {
+            // The method was compiled before it was called, nothing to check.
+            System.out.println("passed");
+            return;
+        }
+
+        // The method was compiled with OSR entries instead of getting separate OSR code, so a
+        // regular call runs the code that nterp jumped into.
+        if (!hasJitCompiledEntrypoint(Main.class, "$noinline$loop")) {
+            throw new Error("Method was not compiled");
+        }
+        if (!$noinline$loop(/* waitForOsr= */ false)) {
+            throw new Error("Regular call did not enter the OSR code");
+        }
+        System.out.println("passed");
+    }
+
+    // When `waitForOsr` is true, returns whether the method started in the interpreter and waited
+    // for nterp to jump into compiled code. Otherwise returns whether the method was entered in
+    // code that nterp can jump into, which is checked before any loop back edge.
+    public static boolean $noinline$loop(boolean waitForOsr) {
+        boolean enteredInOsrCode = isInOsrCode("$noinline$loop");
+        // If we were unlucky enough to get this method already JITted, skip the wait for OSR code.
+        boolean interpreting = isInInterpreter("$noinline$loop");
+        int i = 0;
+        for (; i < 100000; ++i) {
+        }
+        if (waitForOsr && interpreting) {
+            // Do not request OSR code, the loop makes the JIT compile the method with baseline
+            // and then with optimizations and OSR entries.
+            while (!isInOsrCode("$noinline$loop")) {}
+        }
+        if (i != 100000) {
+            throw new Error("Unexpected loop count " + i);
+        }
+        return waitForOsr ? interpreting : enteredInOsrCode;
+    }
+
+    private static native boolean hasJit();
+    private static native boolean isInOsrCode(String methodName);
+    private static native boolean isInInterpreter(String methodName);
+    private static native boolean hasJitCompiledEntrypoint(Class<?> cls, String methodName);
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+    public static void main(String[] args) {
+        System.loadLibrary(args[0]);
+        if (!hasJit()) {
+            System.out.println("passed");
+            return;
+        }
+        int[] array = new int[100];
+        for (int i = 0; i < array.length; ++i) {
+            array[i] = i;
+        }
+
+        // A method with baseline code keeps running it when its optimized compilation is abandoned.
+        ensureJitBaselineCompiled(Main.class, "$noinline$sum");
+        for (int i = 0; i < 100000; ++i) {
+            assertEquals(4950, $noinline$sum(array));
+        }
+        waitForCompilation();
+        if (!hasJitCompiledEntrypoint(Main.class, "$noinline$sum")) {
+            throw new Error("Expected $noinline$sum to keep its baseline code");
+        }
+        assertEquals(4950, $noinline$sum(array));
+
+        // A method without compiled code gets baseline code instead, or stays compilable when
+        // there is no profiling info, so it eventually runs JIT code.
+        while (!hasJitCompiledEntrypoint(Main.class, "$noinline$max")) {
+            for (int i = 0; i < 10000; ++i) {
+                assertEquals(99, $noinline$max(array));
+            }
+            waitForCompilation();
+        }
+        assertEquals(99, $noinline$max(array));
+        System.out.println("passed");
+    }
+
+    public static int $noinline$sum(int[] array) {
+        int sum = 0;
+        for (int value : array) {
+            sum += value;
+        }
+        return sum;
+    }
+
+    public static int $noinline$max(int[] array) {
+        int max = Integer.MIN_VALUE;
+        for (int value : array) {
+            max = Math.max(max, value);
+        }
+        return max;
+    }
+
+    private static void assertEquals(int expected, int actual) {
+        if (expected != actual) {
+            throw new Error("Expected " + expected + ", got " + actual);
+        }
+    }
+
+    private static native boolean hasJit();
+    private static native void waitForCompilation();
+    private static native boolean hasJitCompiledEntrypoint(Class<?> cls, String methodName);
+    private static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+}
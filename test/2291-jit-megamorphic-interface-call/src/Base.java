@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public abstract class Base implements Itf {
+    public abstract int id();
+
+    public int m0() {
+        return 0 + id();
+    }
+
+    public int m1() {
+        return 1 + id();
+    }
+
+    public int m2() {
+        return 2 + id();
+    }
+
+    public int m3() {
+        return 3 + id();
+    }
+
+    public int m4() {
+        return 4 + id();
+    }
+
+    public int m5() {
+        return 5 + id();
+    }
+
+    public int m6() {
+        return 6 + id();
+    }
+
+    public int m7() {
+        return 7 + id();
+    }
+
+    public int m8() {
+        return 8 + id();
+    }
+
+    public int m9() {
+        return 9 + id();
+    }
+
+    public int m10() {
+        return 10 + id();
+    }
+
+    public int m11() {
+        return 11 + id();
+    }
+
+    public int m12() {
+        return 12 + id();
+    }
+
+    public int m13() {
+        return 13 + id();
+    }
+
+    public int m14() {
+        return 14 + id();
+    }
+
+    public int m15() {
+        return 15 + id();
+    }
+
+    public int m16() {
+        return 16 + id();
+    }
+
+    public int m17() {
+        return 17 + id();
+    }
+
+    public int m18() {
+        return 18 + id();
+    }
+
+    public int m19() {
+        return 19 + id();
+    }
+
+    public int m20() {
+        return 20 + id();
+    }
+
+    public int m21() {
+        return 21 + id();
+    }
+
+    public int m22() {
+        return 22 + id();
+    }
+
+    public int m23() {
+        return 23 + id();
+    }
+
+    public int m24() {
+        return 24 + id();
+    }
+
+    public int m25() {
+        return 25 + id();
+    }
+
+    public int m26() {
+        return 26 + id();
+    }
+
+    public int m27() {
+        return 27 + id();
+    }
+
+    public int m28() {
+        return 28 + id();
+    }
+
+    public int m29() {
+        return 29 + id();
+    }
+
+    public int m30() {
+        return 30 + id();
+    }
+
+    public int m31() {
+        return 31 + id();
+    }
+
+    public int m32() {
+        return 32 + id();
+    }
+
+    public int m33() {
+        return 33 + id();
+    }
+
+    public int m34() {
+        return 34 + id();
+    }
+
+    public int m35() {
+        return 35 + id();
+    }
+
+    public int m36() {
+        return 36 + id();
+    }
+
+    public int m37() {
+        return 37 + id();
+    }
+
+    public int m38() {
+        return 38 + id();
+    }
+
+    public int m39() {
+        return 39 + id();
+    }
+
+    public int m40() {
+        return 40 + id();
+    }
+
+    public int m41() {
+        return 41 + id();
+    }
+
+    public int m42() {
+        return 42 + id();
+    }
+
+    public int m43() {
+        return 43 + id();
+    }
+
+    public int m44() {
+        return 44 + id();
+    }
+
+    public int m45() {
+        return 45 + id();
+    }
+
+    public int m46() {
+        return 46 + id();
+    }
+
+    public int m47() {
+        return 47 + id();
+    }
+
+    public int m48() {
+        return 48 + id();
+    }
+
+    public int m49() {
+        return 49 + id();
+    }
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+    // Matches the sum of the `m<k>()` offsets in Base.
+    static final int SUM_OF_OFFSETS = 1225;
+    static final int NUMBER_OF_METHODS = 50;
+
+    public static void main(String[] args) {
+        System.loadLibrary(args[0]);
+        // More receivers than an inline cache holds, so that the call sites are megamorphic.
+        Itf[] receivers = { new A(), new B(), new C(), new D(), new E(), new F() };
+        for (int i = 0; i < 1000; ++i) {
+            for (Itf itf : receivers) {
+                check(itf);
+            }
+        }
+        if (hasJit()) {
+            ensureJitCompiled(Main.class, "$noinline$callAll");
+        }
+
+        int deoptimizations = numberOfDeoptimizations();
+        for (Itf itf : receivers) {
+            check(itf);
+        }
+        // A receiver the inline caches have not seen takes the interface call fallback.
+        check(new G());
+        if (numberOfDeoptimizations() != deoptimizations) {
+            throw new Error("Unexpected deoptimization in megamorphic dispatch");
+        }
+        System.out.println("passed");
+    }
+
+    private static void check(Itf itf) {
+        int expected = SUM_OF_OFFSETS + NUMBER_OF_METHODS * ((Base) itf).id();
+        int actual = $noinline$callAll(itf);
+        if (expected != actual) {
+            throw new Error("Expected " + expected + ", got " + actual);
+        }
+    }
+
+    public static int $noinline$callAll(Itf itf) {
+        int sum = 0;
+        sum += itf.m0();
+        sum += itf.m1();
+        sum += itf.m2();
+        sum += itf.m3();
+        sum += itf.m4();
+        sum += itf.m5();
+        sum += itf.m6();
+        sum += itf.m7();
+        sum += itf.m8();
+        sum += itf.m9();
+        sum += itf.m10();
+        sum += itf.m11();
+        sum += itf.m12();
+        sum += itf.m13();
+        sum += itf.m14();
+        sum += itf.m15();
+        sum += itf.m16();
+        sum += itf.m17();
+        sum += itf.m18();
+        sum += itf.m19();
+        sum += itf.m20();
+        sum += itf.m21();
+        sum += itf.m22();
+        sum += itf.m23();
+        sum += itf.m24();
+        sum += itf.m25();
+        sum += itf.m26();
+        sum += itf.m27();
+        sum += itf.m28();
+        sum += itf.m29();
+        sum += itf.m30();
+        sum += itf.m31();
+        sum += itf.m32();
+        sum += itf.m33();
+        sum += itf.m34();
+        sum += itf.m35();
+        sum += itf.m36();
+        sum += itf.m37();
+        sum += itf.m38();
+        sum += itf.m39();
+        sum += itf.m40();
+        sum += itf.m41();
+        sum += itf.m42();
+        sum += itf.m43();
+        sum += itf.m44();
+        sum += itf.m45();
+        sum += itf.m46();
+        sum += itf.m47();
+        sum += itf.m48();
+        sum += itf.m49();
+        return sum;
+    }
+
+    private static native boolean hasJit();
+    private static native int numberOfDeoptimizations();
+    private static native void ensureJitCompiled(Class<?> cls, String methodName);
+}
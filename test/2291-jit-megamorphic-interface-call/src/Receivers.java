@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class A extends Base {
+    public int id() {
+        return 100;
+    }
+}
+
+class B extends Base {
+    public int id() {
+        return 200;
+    }
+}
+
+class C extends Base {
+    public int id() {
+        return 300;
+    }
+}
+
+class D extends Base {
+    public int id() {
+        return 400;
+    }
+}
+
+class E extends Base {
+    public int id() {
+        return 500;
+    }
+}
+
+class F extends Base {
+    public int id() {
+        return 600;
+    }
+}
+
+class G extends Base {
+    public int id() {
+        return 700;
+    }
+}
@@ -0,0 +1,24 @@
+#
+# Copyright (C) 2024 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+def run(ctx, args):
+  # Sample every millisecond, and make methods hot after 100 samples. Use
+  # --compiler-filter=verify so that the loop starts in the interpreter.
+  ctx.default_run(args,
+                  runtime_option=["-Xjitsamplinginterval:1000",
+                                  "-Xjitwarmupthreshold:1000",
+                                  "-Xjitsampleweight:10"],
+                  Xcompiler_option=["--compiler-filter=verify"])
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+    public static void main(String[] args) throws Exception {
+        System.loadLibrary(args[0]);
+        // Run the loop on another thread too, so that the sampler takes turns between threads.
+        Thread other = new Thread(() -> $noinline$spin(/* waitForOsr= */ false));
+        other.start();
+        $noinline$spin(/* waitForOsr= */ true);
+        other.join();
+        $noinline$checkCallsDoNotMakeHot();
+        System.out.println("passed");
+    }
+
+    // Calls alone, however many, do not make a method hot: its counter stays parked and only
+    // samples can set it. The calls take a few milliseconds, which is far from enough samples.
+    public static void $noinline$checkCallsDoNotMakeHot() {
+        $noinline$callee(0);
+        if (!hasJit() || hasJitCompiledEntrypoint(Main.class, "$noinline$callee")) {
+            // Compiled on first use, or not JITting at all.
+            return;
+        }
+        int counter = getHotnessCounter(Main.class, "$noinline$callee");
+        // Ten times the warmup threshold set in run.py.
+        for (int i = 0; i < 10000; ++i) {
+            $noinline$callee(i);
+        }
+        if (getHotnessCounter(Main.class, "$noinline$callee") != counter) {
+            throw new Error("Expected the hotness counter to stay parked at " + counter);
+        }
+        if (hasJitCompiledEntrypoint(Main.class, "$noinline$callee")) {
+            throw new Error("Expected $noinline$callee to not be compiled");
+        }
+    }
+
+    public static void $noinline$callee(int i) {
+        sink = i;
+    }
+
+    static volatile int sink;
+
+    // Called once per thread: only samples can make this method hot, through time spent in the
+    // loop. Once it is, the interpreter transitions to OSR code at a back-edge.
+    public static void $noinline$spin(boolean waitForOsr) {
+        // If we were unlucky enough to get this method already JITted, skip the wait for OSR code.
+        boolean interpreting = isInInterpreter("$noinline$spin");
+        if (!waitForOsr || !interpreting) {
+            for (int i = 0; i < 1000000; ++i) {
+                sink = i;
+            }
+            return;
+        }
+        do {
+            for (int i = 0; i < 100000; ++i) {
+                sink = i;
+            }
+        } while (!isInOsrCode("$noinline$spin"));
+    }
+
+    private static native boolean hasJit();
+    private static native boolean hasJitCompiledEntrypoint(Class<?> cls, String methodName);
+    private static native int getHotnessCounter(Class<?> cls, String methodName);
+    private static native boolean isInOsrCode(String methodName);
+    private static native boolean isInInterpreter(String methodName);
+}
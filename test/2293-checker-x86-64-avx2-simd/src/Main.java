@@ -0,0 +1,439 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Tests for 256-bit vectorization on x86-64. With AVX2 the vector loop advances by
+ * 32 bytes per iteration instead of 16, which shows in the induction increment.
+ */
+public class Main {
+
+  static final int M = 100;
+
+  //
+  // Packed types.
+  //
+
+  /// CHECK-START-X86_64: void Main.$noinline$addByte(byte[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx") and hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>   IntConstant 32                                     loop:none
+  ///     CHECK-DAG: <<Load:d\d+>> VecLoad [{{l\d+}},<<I:i\d+>>]                      loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Add:d\d+>>  VecAdd [<<Load>>,{{d\d+}}] packed_type:Int8        loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I>>,<<Add>>]                  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>   IntConstant 16                                     loop:none
+  ///     CHECK-DAG: <<Load:d\d+>> VecLoad [{{l\d+}},<<I:i\d+>>]                      loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Add:d\d+>>  VecAdd [<<Load>>,{{d\d+}}] packed_type:Int8        loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I>>,<<Add>>]                  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void $noinline$addByte(byte[] a) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] += 3;
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.$noinline$addChar(char[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx") and hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>   IntConstant 16                                     loop:none
+  ///     CHECK-DAG: <<Load:d\d+>> VecLoad [{{l\d+}},<<I:i\d+>>]                      loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Add:d\d+>>  VecAdd [<<Load>>,{{d\d+}}] packed_type:Uint16      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I>>,<<Add>>]                  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>   IntConstant 8                                      loop:none
+  ///     CHECK-DAG: <<Load:d\d+>> VecLoad [{{l\d+}},<<I:i\d+>>]                      loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Add:d\d+>>  VecAdd [<<Load>>,{{d\d+}}] packed_type:Uint16      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I>>,<<Add>>]                  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void $noinline$addChar(char[] a) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] += 3;
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.$noinline$addShort(short[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx") and hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>   IntConstant 16                                     loop:none
+  ///     CHECK-DAG: <<Load:d\d+>> VecLoad [{{l\d+}},<<I:i\d+>>]                      loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Add:d\d+>>  VecAdd [<<Load>>,{{d\d+}}] packed_type:Int16       loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I>>,<<Add>>]                  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>   IntConstant 8                                      loop:none
+  ///     CHECK-DAG: <<Load:d\d+>> VecLoad [{{l\d+}},<<I:i\d+>>]                      loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Add:d\d+>>  VecAdd [<<Load>>,{{d\d+}}] packed_type:Int16       loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I>>,<<Add>>]                  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void $noinline$addShort(short[] a) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] += 3;
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.$noinline$addInt(int[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx") and hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>   IntConstant 8                                      loop:none
+  ///     CHECK-DAG: <<Load:d\d+>> VecLoad [{{l\d+}},<<I:i\d+>>]                      loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Add:d\d+>>  VecAdd [<<Load>>,{{d\d+}}] packed_type:Int32       loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I>>,<<Add>>]                  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>   IntConstant 4                                      loop:none
+  ///     CHECK-DAG: <<Load:d\d+>> VecLoad [{{l\d+}},<<I:i\d+>>]                      loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Add:d\d+>>  VecAdd [<<Load>>,{{d\d+}}] packed_type:Int32       loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I>>,<<Add>>]                  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void $noinline$addInt(int[] a) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] += 3;
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.$noinline$addLong(long[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx") and hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>   IntConstant 4                                      loop:none
+  ///     CHECK-DAG: <<Load:d\d+>> VecLoad [{{l\d+}},<<I:i\d+>>]                      loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Add:d\d+>>  VecAdd [<<Load>>,{{d\d+}}] packed_type:Int64       loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I>>,<<Add>>]                  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>   IntConstant 2                                      loop:none
+  ///     CHECK-DAG: <<Load:d\d+>> VecLoad [{{l\d+}},<<I:i\d+>>]                      loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Add:d\d+>>  VecAdd [<<Load>>,{{d\d+}}] packed_type:Int64       loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I>>,<<Add>>]                  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void $noinline$addLong(long[] a) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] += 3L;
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.$noinline$addFloat(float[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx") and hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>   IntConstant 8                                      loop:none
+  ///     CHECK-DAG: <<Load:d\d+>> VecLoad [{{l\d+}},<<I:i\d+>>]                      loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Add:d\d+>>  VecAdd [<<Load>>,{{d\d+}}] packed_type:Float32     loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I>>,<<Add>>]                  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>   IntConstant 4                                      loop:none
+  ///     CHECK-DAG: <<Load:d\d+>> VecLoad [{{l\d+}},<<I:i\d+>>]                      loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Add:d\d+>>  VecAdd [<<Load>>,{{d\d+}}] packed_type:Float32     loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I>>,<<Add>>]                  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void $noinline$addFloat(float[] a) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] += 2.5f;
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.$noinline$addDouble(double[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx") and hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>   IntConstant 4                                      loop:none
+  ///     CHECK-DAG: <<Load:d\d+>> VecLoad [{{l\d+}},<<I:i\d+>>]                      loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Add:d\d+>>  VecAdd [<<Load>>,{{d\d+}}] packed_type:Float64     loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I>>,<<Add>>]                  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>   IntConstant 2                                      loop:none
+  ///     CHECK-DAG: <<Load:d\d+>> VecLoad [{{l\d+}},<<I:i\d+>>]                      loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Add:d\d+>>  VecAdd [<<Load>>,{{d\d+}}] packed_type:Float64     loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I>>,<<Add>>]                  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void $noinline$addDouble(double[] a) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] += 2.5;
+    }
+  }
+
+  //
+  // Reductions, folded from a full YMM register down to a scalar.
+  //
+
+  /// CHECK-START-X86_64: int Main.$noinline$reductionInt(int[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx") and hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>   IntConstant 8                                      loop:none
+  ///     CHECK-DAG: <<Set:d\d+>>  VecSetScalars [{{i\d+}}]                           loop:none
+  ///     CHECK-DAG: <<Phi:d\d+>>  Phi [<<Set>>,{{d\d+}}]                             loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Load:d\d+>> VecLoad [{{l\d+}},<<I:i\d+>>]                      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecAdd [<<Phi>>,<<Load>>]                          loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Red:d\d+>>  VecReduce [<<Phi>>]                                loop:none
+  ///     CHECK-DAG:               VecExtractScalar [<<Red>>]                         loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>   IntConstant 4                                      loop:none
+  ///     CHECK-DAG: <<Set:d\d+>>  VecSetScalars [{{i\d+}}]                           loop:none
+  ///     CHECK-DAG: <<Phi:d\d+>>  Phi [<<Set>>,{{d\d+}}]                             loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Load:d\d+>> VecLoad [{{l\d+}},<<I:i\d+>>]                      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecAdd [<<Phi>>,<<Load>>]                          loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Red:d\d+>>  VecReduce [<<Phi>>]                                loop:none
+  ///     CHECK-DAG:               VecExtractScalar [<<Red>>]                         loop:none
+  //
+  /// CHECK-FI:
+  private static int $noinline$reductionInt(int[] x) {
+    int sum = 0;
+    for (int i = 0; i < x.length; i++) {
+      sum += x[i];
+    }
+    return sum;
+  }
+
+  /// CHECK-START-X86_64: long Main.$noinline$reductionLong(long[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx") and hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>   IntConstant 4                                      loop:none
+  ///     CHECK-DAG: <<Set:d\d+>>  VecSetScalars [{{j\d+}}]                           loop:none
+  ///     CHECK-DAG: <<Phi:d\d+>>  Phi [<<Set>>,{{d\d+}}]                             loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Load:d\d+>> VecLoad [{{l\d+}},<<I:i\d+>>]                      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecAdd [<<Phi>>,<<Load>>]                          loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Red:d\d+>>  VecReduce [<<Phi>>]                                loop:none
+  ///     CHECK-DAG:               VecExtractScalar [<<Red>>]                         loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>   IntConstant 2                                      loop:none
+  ///     CHECK-DAG: <<Set:d\d+>>  VecSetScalars [{{j\d+}}]                           loop:none
+  ///     CHECK-DAG: <<Phi:d\d+>>  Phi [<<Set>>,{{d\d+}}]                             loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Load:d\d+>> VecLoad [{{l\d+}},<<I:i\d+>>]                      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecAdd [<<Phi>>,<<Load>>]                          loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Red:d\d+>>  VecReduce [<<Phi>>]                                loop:none
+  ///     CHECK-DAG:               VecExtractScalar [<<Red>>]                         loop:none
+  //
+  /// CHECK-FI:
+  private static long $noinline$reductionLong(long[] x) {
+    long sum = 0;
+    for (int i = 0; i < x.length; i++) {
+      sum += x[i];
+    }
+    return sum;
+  }
+
+  /// CHECK-START-X86_64: int Main.$noinline$dotProdShort(short[], short[]) loop_optimization (after)
+  /// CHECK-DAG: <<Const0:i\d+>>  IntConstant 0                                         loop:none
+  /// CHECK-DAG: <<Const1:i\d+>>  IntConstant 1                                         loop:none
+  /// CHECK-IF:     hasIsaFeature("avx") and hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>      IntConstant 16                                        loop:none
+  ///     CHECK-DAG: <<Set:d\d+>>     VecSetScalars [<<Const1>>]                            loop:none
+  ///     CHECK-DAG: <<Phi1:i\d+>>    Phi [<<Const0>>,{{i\d+}}]                             loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Phi2:d\d+>>    Phi [<<Set>>,{{d\d+}}]                                loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Load1:d\d+>>   VecLoad [{{l\d+}},<<Phi1>>]                           loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Load2:d\d+>>   VecLoad [{{l\d+}},<<Phi1>>]                           loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                  VecDotProd [<<Phi2>>,<<Load1>>,<<Load2>>] type:Int16  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                  Add [<<Phi1>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  //
+  ///     CHECK-DAG: <<Reduce:d\d+>>  VecReduce [<<Phi2>>]                                  loop:none
+  ///     CHECK-DAG:                  VecExtractScalar [<<Reduce>>]                         loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>      IntConstant 8                                         loop:none
+  ///     CHECK-DAG: <<Set:d\d+>>     VecSetScalars [<<Const1>>]                            loop:none
+  ///     CHECK-DAG: <<Phi1:i\d+>>    Phi [<<Const0>>,{{i\d+}}]                             loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Phi2:d\d+>>    Phi [<<Set>>,{{d\d+}}]                                loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Load1:d\d+>>   VecLoad [{{l\d+}},<<Phi1>>]                           loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Load2:d\d+>>   VecLoad [{{l\d+}},<<Phi1>>]                           loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                  VecDotProd [<<Phi2>>,<<Load1>>,<<Load2>>] type:Int16  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                  Add [<<Phi1>>,<<Vl>>]                                 loop:<<Loop>>      outer_loop:none
+  //
+  ///     CHECK-DAG: <<Reduce:d\d+>>  VecReduce [<<Phi2>>]                                  loop:none
+  ///     CHECK-DAG:                  VecExtractScalar [<<Reduce>>]                         loop:none
+  //
+  /// CHECK-FI:
+  private static int $noinline$dotProdShort(short[] a, short[] b) {
+    int s = 1;
+    for (int i = 0; i < b.length; i++) {
+      int temp = a[i] * b[i];
+      s += temp;
+    }
+    return s - 1;
+  }
+
+  //
+  // The upper YMM halves are cleared before leaving code that used them.
+  //
+
+  /// CHECK-START-X86_64: int Main.$noinline$addIntThenCall(int[]) disassembly (after)
+  /// CHECK-IF:     hasIsaFeature("avx") and hasIsaFeature("avx2")
+  //
+  ///     CHECK:                   vzeroupper
+  ///     CHECK-NEXT:              call
+  ///     CHECK:                   vzeroupper
+  ///     CHECK-NEXT:              ret
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-NOT:               vzeroupper
+  //
+  /// CHECK-FI:
+  private static int $noinline$addIntThenCall(int[] a) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] += 3;
+    }
+    return $noinline$first(a);
+  }
+
+  /// CHECK-START-X86_64: void Main.$noinline$addInt(int[]) disassembly (after)
+  /// CHECK-IF:     hasIsaFeature("avx") and hasIsaFeature("avx2")
+  //
+  ///     CHECK:                   vzeroupper
+  ///     CHECK-NEXT:              ret
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-NOT:               vzeroupper
+  //
+  /// CHECK-FI:
+
+  /// CHECK-START-X86_64: int Main.$noinline$first(int[]) disassembly (after)
+  /// CHECK-NOT:                   vzeroupper
+  private static int $noinline$first(int[] a) {
+    return a[0];
+  }
+
+  //
+  // Test drivers.
+  //
+
+  public static void main(String[] args) {
+    // Every length up to M, so that both the vector loop and the scalar cleanup loop are
+    // exercised with each possible remainder.
+    for (int n = 0; n <= M; n++) {
+      byte[] b = new byte[n];
+      char[] c = new char[n];
+      short[] s = new short[n];
+      int[] i = new int[n];
+      long[] l = new long[n];
+      float[] f = new float[n];
+      double[] d = new double[n];
+      for (int k = 0; k < n; k++) {
+        b[k] = (byte) (k * 7);
+        c[k] = (char) (65530 + k);
+        s[k] = (short) (32760 + k);
+        i[k] = Integer.MAX_VALUE - k;
+        l[k] = Long.MAX_VALUE - k;
+        f[k] = k;
+        d[k] = k;
+      }
+      $noinline$addByte(b);
+      $noinline$addChar(c);
+      $noinline$addShort(s);
+      $noinline$addInt(i);
+      $noinline$addLong(l);
+      $noinline$addFloat(f);
+      $noinline$addDouble(d);
+      for (int k = 0; k < n; k++) {
+        expectEquals((byte) (k * 7 + 3), b[k]);
+        expectEquals((char) (65533 + k), c[k]);
+        expectEquals((short) (32763 + k), s[k]);
+        expectEquals(Integer.MAX_VALUE - k + 3, i[k]);
+        expectEquals(Long.MAX_VALUE - k + 3L, l[k]);
+        expectEquals(k + 2.5f, f[k]);
+        expectEquals(k + 2.5, d[k]);
+      }
+    }
+
+    for (int n = 0; n <= M; n++) {
+      int[] xi = new int[n];
+      long[] xl = new long[n];
+      short[] xa = new short[n];
+      short[] xb = new short[n];
+      for (int k = 0; k < n; k++) {
+        xi[k] = k;
+        xl[k] = (1L << 40) + k;
+        xa[k] = (short) k;
+        xb[k] = (short) (k - 10);
+      }
+      long sum1 = (long) n * (n - 1) / 2;
+      long sum2 = (long) (n - 1) * n * (2 * n - 1) / 6;
+      expectEquals((int) sum1, $noinline$reductionInt(xi));
+      expectEquals((1L << 40) * n + sum1, $noinline$reductionLong(xl));
+      expectEquals((int) (sum2 - 10 * sum1), $noinline$dotProdShort(xa, xb));
+    }
+
+    // The callee runs with the upper YMM halves cleared after a 256-bit loop.
+    int[] a = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17 };
+    expectEquals(4, $noinline$addIntThenCall(a));
+    expectEquals(20, a[16]);
+
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(long expected, long result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(float expected, float result) {
+    if (Float.compare(expected, result) != 0) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(double expected, double result) {
+    if (Double.compare(expected, result) != 0) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,434 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Methods with more values live at the same time than there are registers, so that the
+ * register allocator has to spill some of them, compiled with the speed filter which uses
+ * graph coloring. Each method keeps 32 values live at once.
+ */
+public class Main {
+    public static void main(String[] args) {
+        assertIntEquals(1900548153, $noinline$manyInts(3, 100));
+        assertLongEquals(-5671181170281227569L, $noinline$manyLongs(5L, 100));
+        assertDoubleEquals(872.2591737508774, $noinline$manyDoubles(1.5, 10));
+        assertIntEquals(860455024, $noinline$liveAcrossCalls(7));
+        System.out.println("passed");
+    }
+
+    // Loop phis, all live around the back-edge.
+    public static int $noinline$manyInts(int x, int n) {
+        int a0 = x;
+        int a1 = x * 2 + 1;
+        int a2 = x * 3 + 2;
+        int a3 = x * 4 + 3;
+        int a4 = x * 5 + 4;
+        int a5 = x * 6 + 5;
+        int a6 = x * 7 + 6;
+        int a7 = x * 8 + 7;
+        int a8 = x * 9 + 8;
+        int a9 = x * 10 + 9;
+        int a10 = x * 11 + 10;
+        int a11 = x * 12 + 11;
+        int a12 = x * 13 + 12;
+        int a13 = x * 14 + 13;
+        int a14 = x * 15 + 14;
+        int a15 = x * 16 + 15;
+        int a16 = x * 17 + 16;
+        int a17 = x * 18 + 17;
+        int a18 = x * 19 + 18;
+        int a19 = x * 20 + 19;
+        int a20 = x * 21 + 20;
+        int a21 = x * 22 + 21;
+        int a22 = x * 23 + 22;
+        int a23 = x * 24 + 23;
+        int a24 = x * 25 + 24;
+        int a25 = x * 26 + 25;
+        int a26 = x * 27 + 26;
+        int a27 = x * 28 + 27;
+        int a28 = x * 29 + 28;
+        int a29 = x * 30 + 29;
+        int a30 = x * 31 + 30;
+        int a31 = x * 32 + 31;
+        for (int i = 0; i < n; ++i) {
+            a0 = a0 + a1;
+            a1 = a1 ^ (a2 + i);
+            a2 = a2 + a3;
+            a3 = a3 ^ (a4 + i);
+            a4 = a4 + a5;
+            a5 = a5 ^ (a6 + i);
+            a6 = a6 + a7;
+            a7 = a7 ^ (a8 + i);
+            a8 = a8 + a9;
+            a9 = a9 ^ (a10 + i);
+            a10 = a10 + a11;
+            a11 = a11 ^ (a12 + i);
+            a12 = a12 + a13;
+            a13 = a13 ^ (a14 + i);
+            a14 = a14 + a15;
+            a15 = a15 ^ (a16 + i);
+            a16 = a16 + a17;
+            a17 = a17 ^ (a18 + i);
+            a18 = a18 + a19;
+            a19 = a19 ^ (a20 + i);
+            a20 = a20 + a21;
+            a21 = a21 ^ (a22 + i);
+            a22 = a22 + a23;
+            a23 = a23 ^ (a24 + i);
+            a24 = a24 + a25;
+            a25 = a25 ^ (a26 + i);
+            a26 = a26 + a27;
+            a27 = a27 ^ (a28 + i);
+            a28 = a28 + a29;
+            a29 = a29 ^ (a30 + i);
+            a30 = a30 + a31;
+            a31 = a31 ^ (a0 + i);
+        }
+        int r = 0;
+        r = r * 31 + a0;
+        r = r * 31 + a1;
+        r = r * 31 + a2;
+        r = r * 31 + a3;
+        r = r * 31 + a4;
+        r = r * 31 + a5;
+        r = r * 31 + a6;
+        r = r * 31 + a7;
+        r = r * 31 + a8;
+        r = r * 31 + a9;
+        r = r * 31 + a10;
+        r = r * 31 + a11;
+        r = r * 31 + a12;
+        r = r * 31 + a13;
+        r = r * 31 + a14;
+        r = r * 31 + a15;
+        r = r * 31 + a16;
+        r = r * 31 + a17;
+        r = r * 31 + a18;
+        r = r * 31 + a19;
+        r = r * 31 + a20;
+        r = r * 31 + a21;
+        r = r * 31 + a22;
+        r = r * 31 + a23;
+        r = r * 31 + a24;
+        r = r * 31 + a25;
+        r = r * 31 + a26;
+        r = r * 31 + a27;
+        r = r * 31 + a28;
+        r = r * 31 + a29;
+        r = r * 31 + a30;
+        r = r * 31 + a31;
+        return r;
+    }
+
+    // Loop phis, all live around the back-edge.
+    public static long $noinline$manyLongs(long x, int n) {
+        long a0 = x;
+        long a1 = x * 2 - 1;
+        long a2 = x * 3 - 2;
+        long a3 = x * 4 - 3;
+        long a4 = x * 5 - 4;
+        long a5 = x * 6 - 5;
+        long a6 = x * 7 - 6;
+        long a7 = x * 8 - 7;
+        long a8 = x * 9 - 8;
+        long a9 = x * 10 - 9;
+        long a10 = x * 11 - 10;
+        long a11 = x * 12 - 11;
+        long a12 = x * 13 - 12;
+        long a13 = x * 14 - 13;
+        long a14 = x * 15 - 14;
+        long a15 = x * 16 - 15;
+        long a16 = x * 17 - 16;
+        long a17 = x * 18 - 17;
+        long a18 = x * 19 - 18;
+        long a19 = x * 20 - 19;
+        long a20 = x * 21 - 20;
+        long a21 = x * 22 - 21;
+        long a22 = x * 23 - 22;
+        long a23 = x * 24 - 23;
+        long a24 = x * 25 - 24;
+        long a25 = x * 26 - 25;
+        long a26 = x * 27 - 26;
+        long a27 = x * 28 - 27;
+        long a28 = x * 29 - 28;
+        long a29 = x * 30 - 29;
+        long a30 = x * 31 - 30;
+        long a31 = x * 32 - 31;
+        for (int i = 0; i < n; ++i) {
+            a0 = a0 + a1;
+            a1 = a1 ^ (a2 * 3 + i);
+            a2 = a2 + a3;
+            a3 = a3 ^ (a4 * 3 + i);
+            a4 = a4 + a5;
+            a5 = a5 ^ (a6 * 3 + i);
+            a6 = a6 + a7;
+            a7 = a7 ^ (a8 * 3 + i);
+            a8 = a8 + a9;
+            a9 = a9 ^ (a10 * 3 + i);
+            a10 = a10 + a11;
+            a11 = a11 ^ (a12 * 3 + i);
+            a12 = a12 + a13;
+            a13 = a13 ^ (a14 * 3 + i);
+            a14 = a14 + a15;
+            a15 = a15 ^ (a16 * 3 + i);
+            a16 = a16 + a17;
+            a17 = a17 ^ (a18 * 3 + i);
+            a18 = a18 + a19;
+            a19 = a19 ^ (a20 * 3 + i);
+            a20 = a20 + a21;
+            a21 = a21 ^ (a22 * 3 + i);
+            a22 = a22 + a23;
+            a23 = a23 ^ (a24 * 3 + i);
+            a24 = a24 + a25;
+            a25 = a25 ^ (a26 * 3 + i);
+            a26 = a26 + a27;
+            a27 = a27 ^ (a28 * 3 + i);
+            a28 = a28 + a29;
+            a29 = a29 ^ (a30 * 3 + i);
+            a30 = a30 + a31;
+            a31 = a31 ^ (a0 * 3 + i);
+        }
+        long r = 0;
+        r = r * 31 + a0;
+        r = r * 31 + a1;
+        r = r * 31 + a2;
+        r = r * 31 + a3;
+        r = r * 31 + a4;
+        r = r * 31 + a5;
+        r = r * 31 + a6;
+        r = r * 31 + a7;
+        r = r * 31 + a8;
+        r = r * 31 + a9;
+        r = r * 31 + a10;
+        r = r * 31 + a11;
+        r = r * 31 + a12;
+        r = r * 31 + a13;
+        r = r * 31 + a14;
+        r = r * 31 + a15;
+        r = r * 31 + a16;
+        r = r * 31 + a17;
+        r = r * 31 + a18;
+        r = r * 31 + a19;
+        r = r * 31 + a20;
+        r = r * 31 + a21;
+        r = r * 31 + a22;
+        r = r * 31 + a23;
+        r = r * 31 + a24;
+        r = r * 31 + a25;
+        r = r * 31 + a26;
+        r = r * 31 + a27;
+        r = r * 31 + a28;
+        r = r * 31 + a29;
+        r = r * 31 + a30;
+        r = r * 31 + a31;
+        return r;
+    }
+
+    // Loop phis, all live around the back-edge.
+    public static double $noinline$manyDoubles(double x, int n) {
+        double a0 = x;
+        double a1 = x * 2 + 1;
+        double a2 = x * 3 + 2;
+        double a3 = x * 4 + 3;
+        double a4 = x * 5 + 4;
+        double a5 = x * 6 + 5;
+        double a6 = x * 7 + 6;
+        double a7 = x * 8 + 7;
+        double a8 = x * 9 + 8;
+        double a9 = x * 10 + 9;
+        double a10 = x * 11 + 10;
+        double a11 = x * 12 + 11;
+        double a12 = x * 13 + 12;
+        double a13 = x * 14 + 13;
+        double a14 = x * 15 + 14;
+        double a15 = x * 16 + 15;
+        double a16 = x * 17 + 16;
+        double a17 = x * 18 + 17;
+        double a18 = x * 19 + 18;
+        double a19 = x * 20 + 19;
+        double a20 = x * 21 + 20;
+        double a21 = x * 22 + 21;
+        double a22 = x * 23 + 22;
+        double a23 = x * 24 + 23;
+        double a24 = x * 25 + 24;
+        double a25 = x * 26 + 25;
+        double a26 = x * 27 + 26;
+        double a27 = x * 28 + 27;
+        double a28 = x * 29 + 28;
+        double a29 = x * 30 + 29;
+        double a30 = x * 31 + 30;
+        double a31 = x * 32 + 31;
+        for (int i = 0; i < n; ++i) {
+            a0 = a0 * 0.5 + a1 * 0.25 + i;
+            a1 = a1 * 0.5 + a2 * 0.25 + i;
+            a2 = a2 * 0.5 + a3 * 0.25 + i;
+            a3 = a3 * 0.5 + a4 * 0.25 + i;
+            a4 = a4 * 0.5 + a5 * 0.25 + i;
+            a5 = a5 * 0.5 + a6 * 0.25 + i;
+            a6 = a6 * 0.5 + a7 * 0.25 + i;
+            a7 = a7 * 0.5 + a8 * 0.25 + i;
+            a8 = a8 * 0.5 + a9 * 0.25 + i;
+            a9 = a9 * 0.5 + a10 * 0.25 + i;
+            a10 = a10 * 0.5 + a11 * 0.25 + i;
+            a11 = a11 * 0.5 + a12 * 0.25 + i;
+            a12 = a12 * 0.5 + a13 * 0.25 + i;
+            a13 = a13 * 0.5 + a14 * 0.25 + i;
+            a14 = a14 * 0.5 + a15 * 0.25 + i;
+            a15 = a15 * 0.5 + a16 * 0.25 + i;
+            a16 = a16 * 0.5 + a17 * 0.25 + i;
+            a17 = a17 * 0.5 + a18 * 0.25 + i;
+            a18 = a18 * 0.5 + a19 * 0.25 + i;
+            a19 = a19 * 0.5 + a20 * 0.25 + i;
+            a20 = a20 * 0.5 + a21 * 0.25 + i;
+            a21 = a21 * 0.5 + a22 * 0.25 + i;
+            a22 = a22 * 0.5 + a23 * 0.25 + i;
+            a23 = a23 * 0.5 + a24 * 0.25 + i;
+            a24 = a24 * 0.5 + a25 * 0.25 + i;
+            a25 = a25 * 0.5 + a26 * 0.25 + i;
+            a26 = a26 * 0.5 + a27 * 0.25 + i;
+            a27 = a27 * 0.5 + a28 * 0.25 + i;
+            a28 = a28 * 0.5 + a29 * 0.25 + i;
+            a29 = a29 * 0.5 + a30 * 0.25 + i;
+            a30 = a30 * 0.5 + a31 * 0.25 + i;
+            a31 = a31 * 0.5 + a0 * 0.25 + i;
+        }
+        double r = 0.0;
+        r = r + a0;
+        r = r + a1;
+        r = r + a2;
+        r = r + a3;
+        r = r + a4;
+        r = r + a5;
+        r = r + a6;
+        r = r + a7;
+        r = r + a8;
+        r = r + a9;
+        r = r + a10;
+        r = r + a11;
+        r = r + a12;
+        r = r + a13;
+        r = r + a14;
+        r = r + a15;
+        r = r + a16;
+        r = r + a17;
+        r = r + a18;
+        r = r + a19;
+        r = r + a20;
+        r = r + a21;
+        r = r + a22;
+        r = r + a23;
+        r = r + a24;
+        r = r + a25;
+        r = r + a26;
+        r = r + a27;
+        r = r + a28;
+        r = r + a29;
+        r = r + a30;
+        r = r + a31;
+        return r;
+    }
+
+    // Values live across calls, which clobber the caller-save registers.
+    public static int $noinline$liveAcrossCalls(int x) {
+        int a0 = $noinline$opaque(x);
+        int a1 = $noinline$opaque(x + 1);
+        int a2 = $noinline$opaque(x + 2);
+        int a3 = $noinline$opaque(x + 3);
+        int a4 = $noinline$opaque(x + 4);
+        int a5 = $noinline$opaque(x + 5);
+        int a6 = $noinline$opaque(x + 6);
+        int a7 = $noinline$opaque(x + 7);
+        int a8 = $noinline$opaque(x + 8);
+        int a9 = $noinline$opaque(x + 9);
+        int a10 = $noinline$opaque(x + 10);
+        int a11 = $noinline$opaque(x + 11);
+        int a12 = $noinline$opaque(x + 12);
+        int a13 = $noinline$opaque(x + 13);
+        int a14 = $noinline$opaque(x + 14);
+        int a15 = $noinline$opaque(x + 15);
+        int a16 = $noinline$opaque(x + 16);
+        int a17 = $noinline$opaque(x + 17);
+        int a18 = $noinline$opaque(x + 18);
+        int a19 = $noinline$opaque(x + 19);
+        int a20 = $noinline$opaque(x + 20);
+        int a21 = $noinline$opaque(x + 21);
+        int a22 = $noinline$opaque(x + 22);
+        int a23 = $noinline$opaque(x + 23);
+        int a24 = $noinline$opaque(x + 24);
+        int a25 = $noinline$opaque(x + 25);
+        int a26 = $noinline$opaque(x + 26);
+        int a27 = $noinline$opaque(x + 27);
+        int a28 = $noinline$opaque(x + 28);
+        int a29 = $noinline$opaque(x + 29);
+        int a30 = $noinline$opaque(x + 30);
+        int a31 = $noinline$opaque(x + 31);
+        int r = 0;
+        r = r * 31 + a0;
+        r = r * 31 + a1;
+        r = r * 31 + a2;
+        r = r * 31 + a3;
+        r = r * 31 + a4;
+        r = r * 31 + a5;
+        r = r * 31 + a6;
+        r = r * 31 + a7;
+        r = r * 31 + a8;
+        r = r * 31 + a9;
+        r = r * 31 + a10;
+        r = r * 31 + a11;
+        r = r * 31 + a12;
+        r = r * 31 + a13;
+        r = r * 31 + a14;
+        r = r * 31 + a15;
+        r = r * 31 + a16;
+        r = r * 31 + a17;
+        r = r * 31 + a18;
+        r = r * 31 + a19;
+        r = r * 31 + a20;
+        r = r * 31 + a21;
+        r = r * 31 + a22;
+        r = r * 31 + a23;
+        r = r * 31 + a24;
+        r = r * 31 + a25;
+        r = r * 31 + a26;
+        r = r * 31 + a27;
+        r = r * 31 + a28;
+        r = r * 31 + a29;
+        r = r * 31 + a30;
+        r = r * 31 + a31;
+        return r;
+    }
+
+    public static int $noinline$opaque(int value) {
+        return value * 7 - 1;
+    }
+
+    public static void assertIntEquals(int expected, int result) {
+        if (expected != result) {
+            throw new Error("Expected: " + expected + ", found: " + result);
+        }
+    }
+
+    public static void assertLongEquals(long expected, long result) {
+        if (expected != result) {
+            throw new Error("Expected: " + expected + ", found: " + result);
+        }
+    }
+
+    public static void assertDoubleEquals(double expected, double result) {
+        if (expected != result) {
+            throw new Error("Expected: " + expected + ", found: " + result);
+        }
+    }
+}
@@ -1253,6 +1253,36 @@ public class Main {
     }
   }
 
+  /// CHECK-START: void Main.unswitchingSimple(int[], int, int) loop_optimization (before)
+  /// CHECK-DAG: <<Param:i\d+>> ParameterValue                          loop:none
+  /// CHECK-DAG: <<Check:z\d+>> {{GreaterThan|LessThanOrEqual}} [<<Param>>,{{i\d+}}] loop:none
+  /// CHECK-DAG:                If [<<Check>>]                          loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG:                ArraySet                                loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                ArraySet                                loop:<<Loop>>      outer_loop:none
+
+  // The invariant `if` is hoisted out of the loop, each version of the loop keeps one store.
+  /// CHECK-START: void Main.unswitchingSimple(int[], int, int) dead_code_elimination$before_codegen (after)
+  /// CHECK-DAG: <<Param:i\d+>> ParameterValue                          loop:none
+  /// CHECK-DAG: <<Check:z\d+>> {{GreaterThan|LessThanOrEqual}} [<<Param>>,{{i\d+}}] loop:none
+  /// CHECK-DAG:                If [<<Check>>]                          loop:none
+  /// CHECK-DAG:                ArraySet                                loop:<<Loop1:B\d+>> outer_loop:none
+  /// CHECK-DAG:                ArraySet                                loop:<<Loop2:B\d+>> outer_loop:none
+  /// CHECK-EVAL: "<<Loop1>>" != "<<Loop2>>"
+
+  /// CHECK-START: void Main.unswitchingSimple(int[], int, int) dead_code_elimination$before_codegen (after)
+  /// CHECK:                    ArraySet
+  /// CHECK:                    ArraySet
+  /// CHECK-NOT:                ArraySet
+  private static final void unswitchingSimple(int[] a, int n, int x) {
+    for (int i = 0; i < n; i++) {
+      if (x > 0) {
+        a[i] += x;
+      } else {
+        a[i] = i;
+      }
+    }
+  }
+
   /// CHECK-START: void Main.unrollingFull(int[]) loop_optimization (before)
   /// CHECK-DAG: <<Param:l\d+>>     ParameterValue                          loop:none
   /// CHECK-DAG: <<Const0:i\d+>>    IntConstant 0                           loop:none
@@ -1376,6 +1406,13 @@ public class Main {
     expectEquals(3, peelingHoistTwoControl(1, 1, 0));
     expectEquals(3, peelingHoistTwoControl(1, 1, 1));
 
+    int[] u = new int[LENGTH_B];
+    unswitchingSimple(u, LENGTH_B, 0);
+    unswitchingSimple(u, LENGTH_B, 2);
+    for (int i = 0; i < LENGTH_B; i++) {
+      expectEquals(i + 2, u[i]);
+    }
+
     initIntArray(a);
     peelingSimple(a, false);
     peelingSimple(a, true);
@@ -205,6 +205,63 @@ public class Main {
     }
   }
 
+  // Each array read at a different offset than the array written needs its own a != b runtime
+  // test. Up to three such tests are generated, and the loop falls back to the scalar cleanup
+  // loop if any pair of arrays is the same.
+  //
+  /// CHECK-START-{X86_64,ARM64}: void Main.$noinline$aliasTwoPairs(int[], int[], int[], int) loop_optimization (after)
+  /// CHECK-DAG: <<Test1:z\d+>> NotEqual [{{l\d+}},{{l\d+}}]          loop:none
+  /// CHECK-DAG: <<Test2:z\d+>> NotEqual [{{l\d+}},{{l\d+}}]          loop:none
+  /// CHECK-DAG:                Select [{{i\d+}},{{i\d+}},<<Test1>>]  loop:none
+  /// CHECK-DAG:                Select [{{i\d+}},{{i\d+}},<<Test2>>]  loop:none
+  /// CHECK-DAG:                VecStore                             loop:<<LoopV:B\d+>> outer_loop:none
+  /// CHECK-DAG:                ArraySet                             loop:<<LoopS:B\d+>> outer_loop:none
+  /// CHECK-EVAL: "<<LoopV>>" != "<<LoopS>>"
+  //
+  /// CHECK-START-{X86_64,ARM64}: void Main.$noinline$aliasTwoPairs(int[], int[], int[], int) loop_optimization (after)
+  /// CHECK:                    NotEqual [{{l\d+}},{{l\d+}}]
+  /// CHECK:                    NotEqual [{{l\d+}},{{l\d+}}]
+  /// CHECK-NOT:                NotEqual [{{l\d+}},{{l\d+}}]
+  private static void $noinline$aliasTwoPairs(int[] a, int[] b, int[] c, int n) {
+    for (int i = 1; i < n - 1; i++) {
+      a[i] = b[i - 1] + c[i - 1];
+    }
+  }
+
+  /// CHECK-START-{X86_64,ARM64}: void Main.$noinline$aliasThreePairs(int[], int[], int[], int[], int) loop_optimization (after)
+  /// CHECK-DAG: <<Test1:z\d+>> NotEqual [{{l\d+}},{{l\d+}}]          loop:none
+  /// CHECK-DAG: <<Test2:z\d+>> NotEqual [{{l\d+}},{{l\d+}}]          loop:none
+  /// CHECK-DAG: <<Test3:z\d+>> NotEqual [{{l\d+}},{{l\d+}}]          loop:none
+  /// CHECK-DAG:                Select [{{i\d+}},{{i\d+}},<<Test1>>]  loop:none
+  /// CHECK-DAG:                Select [{{i\d+}},{{i\d+}},<<Test2>>]  loop:none
+  /// CHECK-DAG:                Select [{{i\d+}},{{i\d+}},<<Test3>>]  loop:none
+  /// CHECK-DAG:                VecStore                             loop:<<LoopV:B\d+>> outer_loop:none
+  /// CHECK-DAG:                ArraySet                             loop:<<LoopS:B\d+>> outer_loop:none
+  /// CHECK-EVAL: "<<LoopV>>" != "<<LoopS>>"
+  //
+  /// CHECK-START-{X86_64,ARM64}: void Main.$noinline$aliasThreePairs(int[], int[], int[], int[], int) loop_optimization (after)
+  /// CHECK:                    NotEqual [{{l\d+}},{{l\d+}}]
+  /// CHECK:                    NotEqual [{{l\d+}},{{l\d+}}]
+  /// CHECK:                    NotEqual [{{l\d+}},{{l\d+}}]
+  /// CHECK-NOT:                NotEqual [{{l\d+}},{{l\d+}}]
+  private static void $noinline$aliasThreePairs(int[] a, int[] b, int[] c, int[] d, int n) {
+    for (int i = 1; i < n - 1; i++) {
+      a[i] = b[i - 1] + c[i - 1] + d[i - 1];
+    }
+  }
+
+  // A fourth runtime test is over the limit: the loop is not vectorized.
+  //
+  /// CHECK-START-{X86_64,ARM64}: void Main.$noinline$aliasFourPairs(int[], int[], int[], int[], int[], int) loop_optimization (after)
+  /// CHECK-NOT:                NotEqual [{{l\d+}},{{l\d+}}]
+  /// CHECK-NOT:                VecStore
+  private static void $noinline$aliasFourPairs(
+      int[] a, int[] b, int[] c, int[] d, int[] e, int n) {
+    for (int i = 1; i < n - 1; i++) {
+      a[i] = b[i - 1] + c[i - 1] + d[i - 1] + e[i - 1];
+    }
+  }
+
   private static int $inline$constMinus1() {
     return -1;
   }
@@ -470,6 +527,48 @@ public class Main {
     }
   }
 
+  static void testAliasPairs() {
+    final int n = 100;
+    int[] a = new int[n];
+    int[] b = new int[n];
+    int[] c = new int[n];
+    int[] d = new int[n];
+    int[] e = new int[n];
+    initArrayStencil(b);
+    initArrayStencil(c);
+    initArrayStencil(d);
+    initArrayStencil(e);
+
+    $noinline$aliasTwoPairs(a, b, c, n);
+    for (int i = 1; i < n - 1; i++) {
+      expectEquals(2 * (i - 1), a[i]);
+    }
+    $noinline$aliasThreePairs(a, b, c, d, n);
+    for (int i = 1; i < n - 1; i++) {
+      expectEquals(3 * (i - 1), a[i]);
+    }
+    $noinline$aliasFourPairs(a, b, c, d, e, n);
+    for (int i = 1; i < n - 1; i++) {
+      expectEquals(4 * (i - 1), a[i]);
+    }
+
+    // When the written array is also read, each iteration reads the value stored by the previous
+    // one, which only the scalar loop does.
+    initArrayStencil(b);
+    $noinline$aliasTwoPairs(b, b, c, n);
+    for (int i = 1; i < n - 1; i++) {
+      // b[i] = b[i - 1] + (i - 1), with b[0] = 0.
+      expectEquals(i * (i - 1) / 2, b[i]);
+    }
+    initArrayStencil(a);
+    initArrayStencil(b);
+    $noinline$aliasThreePairs(a, b, a, d, n);
+    for (int i = 1; i < n - 1; i++) {
+      // a[i] = a[i - 1] + 2 * (i - 1), with a[0] = 0.
+      expectEquals(i * (i - 1), a[i]);
+    }
+  }
+
   static void testTypes() {
     int[] a = new int[100];
     int[] b = new int[100];
@@ -491,6 +590,7 @@ public class Main {
     testStencilConstSize();
     testStencil2();
     testStencil3();
+    testAliasPairs();
     testTypes();
     System.out.println("passed");
   }
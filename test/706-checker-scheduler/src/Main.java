@@ -406,6 +406,34 @@ public class Main {
   /// CHECK-DAG:        InstanceFieldSet
   /// CHECK-DAG:        StaticFieldSet
   /// CHECK-DAG:        StaticFieldSet
+
+  /// CHECK-START-{RISCV64,X86_64}: void Main.accessFields() scheduler (before)
+  /// CHECK:            InstanceFieldGet
+  /// CHECK:            Add
+  /// CHECK:            InstanceFieldSet
+  /// CHECK:            InstanceFieldGet
+  /// CHECK:            Add
+  /// CHECK:            InstanceFieldSet
+  /// CHECK:            StaticFieldGet
+  /// CHECK:            Add
+  /// CHECK:            StaticFieldSet
+  /// CHECK:            StaticFieldGet
+  /// CHECK:            Add
+  /// CHECK:            StaticFieldSet
+
+  /// CHECK-START-{RISCV64,X86_64}: void Main.accessFields() scheduler (after)
+  /// CHECK-DAG:        InstanceFieldGet
+  /// CHECK-DAG:        InstanceFieldGet
+  /// CHECK-DAG:        StaticFieldGet
+  /// CHECK-DAG:        StaticFieldGet
+  /// CHECK:            Add
+  /// CHECK:            Add
+  /// CHECK:            Add
+  /// CHECK:            Add
+  /// CHECK-DAG:        InstanceFieldSet
+  /// CHECK-DAG:        InstanceFieldSet
+  /// CHECK-DAG:        StaticFieldSet
+  /// CHECK-DAG:        StaticFieldSet
   public void accessFields() {
     my_obj = new ExampleObj(1, 2);
     for (int i = 0; i < 10; i++) {
@@ -447,6 +475,34 @@ public class Main {
   /// CHECK:            Add
   /// CHECK:            StaticFieldSet
 
+  /// CHECK-START-{RISCV64,X86_64}: void Main.accessFieldsVolatile() scheduler (before)
+  /// CHECK:            InstanceFieldGet
+  /// CHECK:            Add
+  /// CHECK:            InstanceFieldSet
+  /// CHECK:            InstanceFieldGet
+  /// CHECK:            Add
+  /// CHECK:            InstanceFieldSet
+  /// CHECK:            StaticFieldGet
+  /// CHECK:            Add
+  /// CHECK:            StaticFieldSet
+  /// CHECK:            StaticFieldGet
+  /// CHECK:            Add
+  /// CHECK:            StaticFieldSet
+
+  /// CHECK-START-{RISCV64,X86_64}: void Main.accessFieldsVolatile() scheduler (after)
+  /// CHECK:            InstanceFieldGet
+  /// CHECK:            Add
+  /// CHECK:            InstanceFieldSet
+  /// CHECK:            InstanceFieldGet
+  /// CHECK:            Add
+  /// CHECK:            InstanceFieldSet
+  /// CHECK:            StaticFieldGet
+  /// CHECK:            Add
+  /// CHECK:            StaticFieldSet
+  /// CHECK:            StaticFieldGet
+  /// CHECK:            Add
+  /// CHECK:            StaticFieldSet
+
   public void accessFieldsVolatile() {
     my_obj = new ExampleObj(1, 2);
     for (int i = 0; i < 10; i++) {
@@ -487,6 +543,34 @@ public class Main {
   /// CHECK:            Add
   /// CHECK:            UnresolvedStaticFieldSet
 
+  /// CHECK-START-{RISCV64,X86_64}: void Main.accessFieldsUnresolved() scheduler (before)
+  /// CHECK:            InstanceFieldGet
+  /// CHECK:            Add
+  /// CHECK:            InstanceFieldSet
+  /// CHECK:            InstanceFieldGet
+  /// CHECK:            Add
+  /// CHECK:            InstanceFieldSet
+  /// CHECK:            UnresolvedInstanceFieldGet
+  /// CHECK:            Add
+  /// CHECK:            UnresolvedInstanceFieldSet
+  /// CHECK:            UnresolvedStaticFieldGet
+  /// CHECK:            Add
+  /// CHECK:            UnresolvedStaticFieldSet
+
+  /// CHECK-START-{RISCV64,X86_64}: void Main.accessFieldsUnresolved() scheduler (after)
+  /// CHECK:            InstanceFieldGet
+  /// CHECK:            Add
+  /// CHECK:            InstanceFieldSet
+  /// CHECK:            InstanceFieldGet
+  /// CHECK:            Add
+  /// CHECK:            InstanceFieldSet
+  /// CHECK:            UnresolvedInstanceFieldGet
+  /// CHECK:            Add
+  /// CHECK:            UnresolvedInstanceFieldSet
+  /// CHECK:            UnresolvedStaticFieldGet
+  /// CHECK:            Add
+  /// CHECK:            UnresolvedStaticFieldSet
+
   public void accessFieldsUnresolved() {
     my_obj = new ExampleObj(1, 2);
     UnresolvedClass unresolved_obj = new UnresolvedClass();
@@ -587,14 +671,14 @@ public class Main {
   // Check that instructions having cross iteration dependencies are not
   // reordered.
   //
-  /// CHECK-START-{ARM,ARM64}: void Main.testCrossItersDependencies() scheduler (before)
+  /// CHECK-START-{ARM,ARM64,RISCV64,X86_64}: void Main.testCrossItersDependencies() scheduler (before)
   /// CHECK:     <<ID1:i\d+>>  Phi [{{i\d+}},<<ID3:i\d+>>]
   /// CHECK:     <<ID2:i\d+>>  Phi [{{i\d+}},<<ID4:i\d+>>]
   //
   /// CHECK:     <<ID3>>  Sub [<<ID1>>,<<ID2>>]
   /// CHECK:     <<ID4>>  Add [<<ID2>>,{{i\d+}}]
 
-  /// CHECK-START-{ARM,ARM64}: void Main.testCrossItersDependencies() scheduler (after)
+  /// CHECK-START-{ARM,ARM64,RISCV64,X86_64}: void Main.testCrossItersDependencies() scheduler (after)
   /// CHECK:     <<ID1:i\d+>>  Phi [{{i\d+}},<<ID3:i\d+>>]
   /// CHECK:     <<ID2:i\d+>>  Phi [{{i\d+}},<<ID4:i\d+>>]
   //
@@ -236,13 +236,12 @@ public class Test924 {
     Thread[] threads = getAllThreads();
     List<Thread> threadList = new ArrayList<>(Arrays.asList(threads));
 
-    // Filter out JIT thread. It may or may not be there depending on configuration.
+    // Filter out JIT threads. They may or may not be there depending on configuration.
     Iterator<Thread> it = threadList.iterator();
     while (it.hasNext()) {
       Thread t = it.next();
       if (t.getName().startsWith("Jit thread pool worker")) {
         it.remove();
-        break;
       }
     }
 